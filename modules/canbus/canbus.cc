@@ -21,6 +21,7 @@
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/adapters/proto/adapter_config.pb.h"
 #include "modules/common/time/time.h"
+#include "modules/common/util/lineage.h"
 #include "modules/common/util/util.h"
 #include "modules/drivers/canbus/can_client/can_client_factory.h"
 
@@ -79,7 +80,8 @@ Status Canbus::Init() {
   }
   AINFO << "The can receiver is successfully initialized.";
 
-  if (can_sender_.Init(can_client_.get(), canbus_conf_.enable_sender_log()) !=
+  if (can_sender_.Init(can_client_.get(), canbus_conf_.enable_sender_log(),
+                       canbus_conf_.enable_sender_send_on_update()) !=
       ErrorCode::OK) {
     return OnError("Failed to init can sender.");
   }
@@ -147,6 +149,14 @@ Status Canbus::Start() {
 void Canbus::PublishChassis() {
   Chassis chassis = vehicle_controller_->chassis();
   AdapterManager::FillChassisHeader(FLAGS_canbus_node_name, &chassis);
+  {
+    std::lock_guard<std::mutex> lock(applied_command_mutex_);
+    if (has_applied_command_) {
+      common::util::AppendLineage(applied_command_header_,
+                                  chassis.mutable_header());
+      has_applied_command_ = false;
+    }
+  }
 
   AdapterManager::PublishChassis(chassis);
   ADEBUG << chassis.ShortDebugString();
@@ -199,6 +209,10 @@ void Canbus::OnControlCommand(const ControlCommand &control_command) {
     return;
   }
   can_sender_.Update();
+
+  std::lock_guard<std::mutex> lock(applied_command_mutex_);
+  applied_command_header_ = control_command.header();
+  has_applied_command_ = true;
 }
 
 void Canbus::OnGuardianCommand(const GuardianCommand &guardian_command) {
@@ -22,6 +22,7 @@
 #define MODULES_CANBUS_CANBUS_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -101,6 +102,12 @@ class Canbus : public apollo::common::ApolloApp {
   std::unique_ptr<VehicleController> vehicle_controller_;
 
   int64_t last_timestamp_ = 0;
+
+  // Header of the latest control command applied to the vehicle, whose
+  // lineage goes with the next chassis message for latency tracing.
+  std::mutex applied_command_mutex_;
+  apollo::common::Header applied_command_header_;
+  bool has_applied_command_ = false;
   ros::Timer timer_;
   apollo::common::monitor::MonitorLogger monitor_logger_;
 };
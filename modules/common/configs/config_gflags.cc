@@ -52,6 +52,27 @@ DEFINE_string(
     "modules/dreamview/conf/navigation_mode_default_end_way_point.txt",
     "end_way_point file used if navigation mode is set.");
 
+DEFINE_bool(enable_tracing, true,
+            "Whether to record the spans and counters of PERF_* and TRACE_* "
+            "in per-thread rings.");
+DEFINE_int32(trace_buffer_size, 16384,
+             "The number of trace events each thread keeps, rounded up to a "
+             "power of two.");
+DEFINE_bool(enable_trace_dump_on_anomaly, false,
+            "Whether to dump the recent traces to trace_dump_dir when the "
+            "planning or control fails.");
+DEFINE_double(trace_dump_seconds, 10.0,
+              "How many seconds of traces to dump after an anomaly, and the "
+              "least time between two dumps.");
+DEFINE_string(trace_dump_dir, "/apollo/data/log",
+              "The directory to dump traces to after an anomaly.");
+DEFINE_string(trace_dump_format, "json",
+              "The format of the dumped traces: json for chrome://tracing, "
+              "or binary.");
+DEFINE_int32(trace_dump_max_files, 20,
+             "The number of dumps kept in trace_dump_dir; the oldest ones "
+             "are removed beyond it.");
+
 DEFINE_double(look_forward_time_sec, 8.0,
               "look forward time times adc speed to calculate this distance "
               "when creating reference line from routing");
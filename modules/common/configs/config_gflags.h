@@ -42,4 +42,12 @@ DECLARE_string(localization_tf2_child_frame_id);
 DECLARE_bool(use_navigation_mode);
 DECLARE_string(navigation_mode_end_way_point_file);
 
+DECLARE_bool(enable_tracing);
+DECLARE_int32(trace_buffer_size);
+DECLARE_bool(enable_trace_dump_on_anomaly);
+DECLARE_double(trace_dump_seconds);
+DECLARE_string(trace_dump_dir);
+DECLARE_string(trace_dump_format);
+DECLARE_int32(trace_dump_max_files);
+
 #endif  // MODULES_COMMON_CONFIGS_GFLAGS_H_
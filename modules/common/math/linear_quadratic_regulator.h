@@ -22,7 +22,13 @@
 #ifndef MODULES_COMMON_MATH_LINEAR_QUADRATIC_REGULATOR_H_
 #define MODULES_COMMON_MATH_LINEAR_QUADRATIC_REGULATOR_H_
 
+#include <cmath>
+#include <limits>
+
 #include "Eigen/Core"
+#include "Eigen/LU"
+
+#include "modules/common/log.h"
 
 /**
  * @namespace apollo::common::math
@@ -48,6 +54,50 @@ void SolveLQRProblem(const Eigen::MatrixXd &A, const Eigen::MatrixXd &B,
                      const double tolerance, const uint max_num_iteration,
                      Eigen::MatrixXd *ptr_K);
 
+/**
+ * @brief Solver for discrete-time linear quadratic problem with fixed size
+ *        matrices, e.g. the 4-state lateral model. It runs the same Riccati
+ *        iteration as the dynamic size solver, without heap allocation.
+ * @param A The system dynamic matrix
+ * @param B The control matrix
+ * @param Q The cost matrix for system state
+ * @param R The cost matrix for control output
+ * @param tolerance The numerical tolerance for solving
+ *        Algebraic Riccati equation (ARE)
+ * @param max_num_iteration The maximum iterations for solving ARE
+ * @param ptr_K The feedback control matrix (pointer)
+ */
+template <int N, int M>
+void SolveLQRProblem(const Eigen::Matrix<double, N, N> &A,
+                     const Eigen::Matrix<double, N, M> &B,
+                     const Eigen::Matrix<double, N, N> &Q,
+                     const Eigen::Matrix<double, M, M> &R,
+                     const double tolerance, const uint max_num_iteration,
+                     Eigen::Matrix<double, M, N> *ptr_K) {
+  const Eigen::Matrix<double, N, N> AT = A.transpose();
+  const Eigen::Matrix<double, M, N> BT = B.transpose();
+
+  Eigen::Matrix<double, N, N> P = Q;
+  uint num_iteration = 0;
+  double diff = std::numeric_limits<double>::max();
+  while (num_iteration++ < max_num_iteration && diff > tolerance) {
+    const Eigen::Matrix<double, N, N> P_next =
+        AT * P * A - AT * P * B * (R + BT * P * B).inverse() * BT * P * A + Q;
+    diff = std::fabs((P_next - P).maxCoeff());
+    P = P_next;
+  }
+
+  if (num_iteration >= max_num_iteration) {
+    AWARN << "LQR solver cannot converge to a solution, "
+             "last consecutive result diff. is:"
+          << diff;
+  } else {
+    ADEBUG << "LQR solver converged at iteration: " << num_iteration
+           << ", max consecutive result diff.: " << diff;
+  }
+  *ptr_K = (R + BT * P * B).inverse() * BT * P * A;
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of the lateral LQR gain computation per control cycle at
+ * speeds from 1 to 30 m/s: the dynamic size solver, the fixed size solver and
+ * the lookup in a gain table precomputed by speed.
+ **/
+
+#include <cmath>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/linear_quadratic_regulator.h"
+#include "modules/common/math/linear_quadratic_regulator_test_utils.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+constexpr double kTolerance = 0.01;
+constexpr uint kMaxNumIteration = 150;
+constexpr double kTableResolution = 0.2;
+constexpr double kTableMaxSpeed = 40.0;
+
+void BM_LQRDynamicSize(benchmark::State &state) {  // NOLINT
+  Eigen::MatrixXd matrix_ad;
+  Eigen::MatrixXd matrix_bd;
+  LateralModel(static_cast<double>(state.range(0)), &matrix_ad, &matrix_bd);
+  const Eigen::MatrixXd matrix_q = LateralModelMatrixQ();
+  const Eigen::MatrixXd matrix_r = Eigen::MatrixXd::Identity(1, 1);
+  Eigen::MatrixXd matrix_k;
+  while (state.KeepRunning()) {
+    SolveLQRProblem(matrix_ad, matrix_bd, matrix_q, matrix_r, kTolerance,
+                    kMaxNumIteration, &matrix_k);
+    benchmark::DoNotOptimize(matrix_k);
+  }
+}
+BENCHMARK(BM_LQRDynamicSize)->Arg(1)->Arg(5)->Arg(10)->Arg(20)->Arg(30);
+
+void BM_LQRFixedSize(benchmark::State &state) {  // NOLINT
+  Eigen::MatrixXd matrix_ad;
+  Eigen::MatrixXd matrix_bd;
+  LateralModel(static_cast<double>(state.range(0)), &matrix_ad, &matrix_bd);
+  const Eigen::Matrix<double, 4, 4> matrix_ad_fixed = matrix_ad;
+  const Eigen::Matrix<double, 4, 1> matrix_bd_fixed = matrix_bd;
+  const Eigen::Matrix<double, 4, 4> matrix_q = LateralModelMatrixQ();
+  const Eigen::Matrix<double, 1, 1> matrix_r =
+      Eigen::Matrix<double, 1, 1>::Identity();
+  Eigen::Matrix<double, 1, 4> matrix_k;
+  while (state.KeepRunning()) {
+    SolveLQRProblem(matrix_ad_fixed, matrix_bd_fixed, matrix_q, matrix_r,
+                    kTolerance, kMaxNumIteration, &matrix_k);
+    benchmark::DoNotOptimize(matrix_k);
+  }
+}
+BENCHMARK(BM_LQRFixedSize)->Arg(1)->Arg(5)->Arg(10)->Arg(20)->Arg(30);
+
+// Mirrors LatController::ComputeLqrGain with a gain table.
+void BM_LQRGainTable(benchmark::State &state) {  // NOLINT
+  std::vector<Eigen::MatrixXd> gain_table;
+  const Eigen::MatrixXd matrix_q = LateralModelMatrixQ();
+  const Eigen::MatrixXd matrix_r = Eigen::MatrixXd::Identity(1, 1);
+  for (double v = 0.0; v <= kTableMaxSpeed; v += kTableResolution) {
+    Eigen::MatrixXd matrix_ad;
+    Eigen::MatrixXd matrix_bd;
+    LateralModel(std::fmax(v, 0.1), &matrix_ad, &matrix_bd);
+    Eigen::MatrixXd matrix_k;
+    SolveLQRProblem(matrix_ad, matrix_bd, matrix_q, matrix_r, kTolerance,
+                    kMaxNumIteration, &matrix_k);
+    gain_table.push_back(matrix_k);
+  }
+  // Off the table grid, so that every lookup interpolates.
+  const double speed = static_cast<double>(state.range(0)) + 0.05;
+  Eigen::MatrixXd matrix_k = Eigen::MatrixXd::Zero(1, 4);
+  while (state.KeepRunning()) {
+    const double index = speed / kTableResolution;
+    const std::size_t lower = static_cast<std::size_t>(index);
+    const double ratio = index - static_cast<double>(lower);
+    matrix_k = (1.0 - ratio) * gain_table[lower] +
+               ratio * gain_table[lower + 1];
+    benchmark::DoNotOptimize(matrix_k);
+  }
+}
+BENCHMARK(BM_LQRGainTable)->Arg(1)->Arg(5)->Arg(10)->Arg(20)->Arg(30);
+
+}  // namespace
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/linear_quadratic_regulator.h"
+
+#include <cmath>
+
+#include "Eigen/Dense"
+#include "gtest/gtest.h"
+
+#include "modules/common/math/linear_quadratic_regulator_test_utils.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+TEST(LinearQuadraticRegulatorTest, FixedSizeMatchesDynamicSize) {
+  const Eigen::MatrixXd matrix_q = LateralModelMatrixQ();
+  const Eigen::MatrixXd matrix_r = Eigen::MatrixXd::Identity(1, 1);
+
+  for (const double v : {0.1, 1.0, 5.0, 15.0, 30.0}) {
+    Eigen::MatrixXd matrix_ad;
+    Eigen::MatrixXd matrix_bd;
+    LateralModel(v, &matrix_ad, &matrix_bd);
+
+    Eigen::MatrixXd matrix_k;
+    SolveLQRProblem(matrix_ad, matrix_bd, matrix_q, matrix_r, 0.01, 150,
+                    &matrix_k);
+
+    const Eigen::Matrix<double, 4, 4> matrix_ad_fixed = matrix_ad;
+    const Eigen::Matrix<double, 4, 1> matrix_bd_fixed = matrix_bd;
+    const Eigen::Matrix<double, 4, 4> matrix_q_fixed = matrix_q;
+    const Eigen::Matrix<double, 1, 1> matrix_r_fixed = matrix_r;
+    Eigen::Matrix<double, 1, 4> matrix_k_fixed;
+    SolveLQRProblem(matrix_ad_fixed, matrix_bd_fixed, matrix_q_fixed,
+                    matrix_r_fixed, 0.01, 150, &matrix_k_fixed);
+
+    ASSERT_EQ(1, matrix_k.rows());
+    ASSERT_EQ(4, matrix_k.cols());
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_NEAR(matrix_k(0, i), matrix_k_fixed(0, i), 1e-9) << "v: " << v;
+    }
+  }
+}
+
+TEST(LinearQuadraticRegulatorTest, ScalarSystem) {
+  // x' = x + u with q = r = 1, the Riccati equation p^2 - p - 1 = 0 gives
+  // p = (1 + sqrt(5)) / 2 and k = p / (1 + p).
+  const Eigen::Matrix<double, 1, 1> one = Eigen::Matrix<double, 1, 1>::Ones();
+  Eigen::Matrix<double, 1, 1> k;
+  SolveLQRProblem(one, one, one, one, 1e-12, 1000, &k);
+  const double p = (1.0 + std::sqrt(5.0)) / 2.0;
+  EXPECT_NEAR(p / (1.0 + p), k(0, 0), 1e-9);
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/linear_quadratic_regulator_test_utils.h"
+
+#include "Eigen/LU"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+void LateralModel(const double v, Eigen::MatrixXd *matrix_ad,
+                  Eigen::MatrixXd *matrix_bd) {
+  const double cf = 155494.663;
+  const double cr = 155494.663;
+  const double mass = 2080.0;
+  const double lf = 1.4;
+  const double lr = 1.4;
+  const double iz = lf * lf * mass / 2.0 + lr * lr * mass / 2.0;
+  const double ts = 0.01;
+
+  Eigen::MatrixXd matrix_a = Eigen::MatrixXd::Zero(4, 4);
+  matrix_a(0, 1) = 1.0;
+  matrix_a(1, 1) = -(cf + cr) / mass / v;
+  matrix_a(1, 2) = (cf + cr) / mass;
+  matrix_a(1, 3) = (lr * cr - lf * cf) / mass / v;
+  matrix_a(2, 3) = 1.0;
+  matrix_a(3, 1) = (lr * cr - lf * cf) / iz / v;
+  matrix_a(3, 2) = (lf * cf - lr * cr) / iz;
+  matrix_a(3, 3) = -(lf * lf * cf + lr * lr * cr) / iz / v;
+  Eigen::MatrixXd matrix_b = Eigen::MatrixXd::Zero(4, 1);
+  matrix_b(1, 0) = cf / mass;
+  matrix_b(3, 0) = lf * cf / iz;
+
+  const Eigen::MatrixXd matrix_i = Eigen::MatrixXd::Identity(4, 4);
+  *matrix_ad = (matrix_i - ts * 0.5 * matrix_a).inverse() *
+               (matrix_i + ts * 0.5 * matrix_a);
+  *matrix_bd = matrix_b * ts;
+}
+
+Eigen::MatrixXd LateralModelMatrixQ() {
+  Eigen::MatrixXd matrix_q = Eigen::MatrixXd::Zero(4, 4);
+  matrix_q(0, 0) = 0.05;
+  matrix_q(2, 2) = 1.0;
+  return matrix_q;
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
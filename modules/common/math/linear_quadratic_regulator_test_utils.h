@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Lateral error model shared by the LQR tests and benchmark.
+ */
+
+#ifndef MODULES_COMMON_MATH_LINEAR_QUADRATIC_REGULATOR_TEST_UTILS_H_
+#define MODULES_COMMON_MATH_LINEAR_QUADRATIC_REGULATOR_TEST_UTILS_H_
+
+#include "Eigen/Core"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @brief Discrete 4-state lateral error model of a Lincoln MKZ at the given
+ *        speed, sampled at 0.01s.
+ */
+void LateralModel(const double v, Eigen::MatrixXd *matrix_ad,
+                  Eigen::MatrixXd *matrix_bd);
+
+/**
+ * @brief State weights on the lateral and heading errors of the model.
+ */
+Eigen::MatrixXd LateralModelMatrixQ();
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+#endif  // MODULES_COMMON_MATH_LINEAR_QUADRATIC_REGULATOR_TEST_UTILS_H_
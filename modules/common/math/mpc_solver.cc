@@ -15,8 +15,11 @@
 #include "modules/common/math/mpc_solver.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
+#include "Eigen/Cholesky"
+
 #include "modules/common/log.h"
 #include "modules/common/math/qp_solver/active_set_qp_solver.h"
 #include "modules/common/math/qp_solver/qp_solver.h"
@@ -170,6 +173,144 @@ bool SolveLinearMPC(const Matrix &matrix_a, const Matrix &matrix_b,
   return true;
 }
 
+namespace {
+
+// ADMM penalty and over-relaxation of SolveSparseLinearMPC.
+constexpr double kAdmmRho = 1.0;
+constexpr double kAdmmAlpha = 1.6;
+
+}  // namespace
+
+// min sum_i 0.5 * (x(i + 1) - t(i))^T Q (x(i + 1) - t(i)) + 0.5 * u(i)^T R u(i)
+// s.t. x(i + 1) = A * x(i) + B * u(i) + C, lower <= u(i) <= upper,
+// solved by ADMM on the split u(i) = z(i), z(i) in the box.
+bool SolveSparseLinearMPC(const Matrix &matrix_a, const Matrix &matrix_b,
+                          const Matrix &matrix_c, const Matrix &matrix_q,
+                          const Matrix &matrix_r, const Matrix &matrix_lower,
+                          const Matrix &matrix_upper,
+                          const Matrix &matrix_initial_state,
+                          const std::vector<Matrix> &reference,
+                          const double eps, const int max_iter,
+                          std::vector<Matrix> *control,
+                          SparseMPCWarmStart *warm_start) {
+  if (matrix_a.rows() != matrix_a.cols() ||
+      matrix_b.rows() != matrix_a.rows() ||
+      matrix_lower.rows() != matrix_upper.rows() ||
+      matrix_lower.rows() != matrix_b.cols()) {
+    AERROR << "One or more matrices have incompatible dimensions. Aborting.";
+    return false;
+  }
+  const std::size_t horizon = reference.size();
+  if (horizon == 0 || control->size() != horizon) {
+    AERROR << "Invalid horizon: " << horizon
+           << ", control size: " << control->size();
+    return false;
+  }
+  const int num_states = matrix_a.rows();
+  const int num_controls = matrix_b.cols();
+
+  // z is the box feasible copy of u, w the scaled dual of u = z.
+  std::vector<Matrix> matrix_z(horizon);
+  std::vector<Matrix> matrix_w(horizon, Matrix::Zero(num_controls, 1));
+  if (warm_start != nullptr && warm_start->control.size() == horizon &&
+      warm_start->dual.size() == horizon) {
+    // Shift the previous solution by one step, repeating the last one.
+    for (std::size_t i = 0; i < horizon; ++i) {
+      const std::size_t j = std::min(i + 1, horizon - 1);
+      matrix_z[i] = warm_start->control[j];
+      matrix_w[i] = warm_start->dual[j];
+    }
+  } else {
+    for (std::size_t i = 0; i < horizon; ++i) {
+      matrix_z[i] = (*control)[i].cwiseMax(matrix_lower).cwiseMin(matrix_upper);
+    }
+  }
+
+  // Riccati factorization of the unconstrained problem with the ADMM penalty
+  // added to R. It only depends on the model, so it is shared by all
+  // iterations. matrix_p[i] is the cost-to-go Hessian of x(i + 1).
+  const Matrix matrix_at = matrix_a.transpose();
+  const Matrix matrix_bt = matrix_b.transpose();
+  const Matrix matrix_rho =
+      kAdmmRho * Matrix::Identity(num_controls, num_controls);
+  std::vector<Matrix> matrix_p(horizon);
+  std::vector<Matrix> matrix_gain(horizon);
+  std::vector<Eigen::LDLT<Matrix>> matrix_h(horizon);
+  matrix_p[horizon - 1] = matrix_q;
+  for (std::size_t i = horizon; i-- > 0;) {
+    const Matrix matrix_bt_p = matrix_bt * matrix_p[i];
+    matrix_h[i].compute(matrix_r + matrix_rho + matrix_bt_p * matrix_b);
+    matrix_gain[i] = -matrix_h[i].solve(matrix_bt_p * matrix_a);
+    if (i > 0) {
+      const Matrix matrix_at_p = matrix_at * matrix_p[i];
+      const Matrix matrix_p_prev = matrix_q + matrix_at_p * matrix_a +
+                                   matrix_at_p * matrix_b * matrix_gain[i];
+      matrix_p[i - 1] = 0.5 * (matrix_p_prev + matrix_p_prev.transpose());
+    }
+  }
+
+  std::vector<Matrix> matrix_u(horizon);
+  std::vector<Matrix> matrix_feedforward(horizon);
+  int num_iteration = 0;
+  double primal_residual = 0.0;
+  double dual_residual = 0.0;
+  while (num_iteration++ < max_iter) {
+    // Backward pass for the linear cost-to-go terms.
+    Matrix matrix_lin = -matrix_q * reference[horizon - 1];
+    for (std::size_t i = horizon; i-- > 0;) {
+      const Matrix matrix_next = matrix_p[i] * matrix_c + matrix_lin;
+      matrix_feedforward[i] = -matrix_h[i].solve(
+          matrix_bt * matrix_next - kAdmmRho * (matrix_z[i] - matrix_w[i]));
+      if (i > 0) {
+        matrix_lin = -matrix_q * reference[i - 1] +
+                     matrix_at * (matrix_next +
+                                  matrix_p[i] * matrix_b *
+                                      matrix_feedforward[i]);
+      }
+    }
+    // Forward rollout, then the box projection and the dual update.
+    Matrix matrix_x = matrix_initial_state;
+    primal_residual = 0.0;
+    dual_residual = 0.0;
+    for (std::size_t i = 0; i < horizon; ++i) {
+      matrix_u[i] = matrix_gain[i] * matrix_x + matrix_feedforward[i];
+      matrix_x = matrix_a * matrix_x + matrix_b * matrix_u[i] + matrix_c;
+
+      const Matrix matrix_relaxed =
+          kAdmmAlpha * matrix_u[i] + (1.0 - kAdmmAlpha) * matrix_z[i];
+      const Matrix matrix_z_prev = matrix_z[i];
+      matrix_z[i] = (matrix_relaxed + matrix_w[i])
+                        .cwiseMax(matrix_lower)
+                        .cwiseMin(matrix_upper);
+      matrix_w[i] += matrix_relaxed - matrix_z[i];
+      primal_residual = std::max(
+          primal_residual, (matrix_u[i] - matrix_z[i]).cwiseAbs().maxCoeff());
+      dual_residual = std::max(
+          dual_residual,
+          kAdmmRho * (matrix_z[i] - matrix_z_prev).cwiseAbs().maxCoeff());
+    }
+    if (primal_residual < eps && dual_residual < eps) {
+      break;
+    }
+  }
+  if (num_iteration > max_iter) {
+    AWARN << "Sparse MPC solver did not converge in " << max_iter
+          << " iterations, primal residual: " << primal_residual
+          << ", dual residual: " << dual_residual;
+  } else {
+    ADEBUG << "Sparse MPC solver converged at iteration: " << num_iteration;
+  }
+
+  for (std::size_t i = 0; i < horizon; ++i) {
+    (*control)[i] = matrix_z[i];
+  }
+  if (warm_start != nullptr) {
+    warm_start->control = matrix_z;
+    warm_start->dual = matrix_w;
+  }
+  return true;
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
@@ -56,6 +56,46 @@ bool SolveLinearMPC(
     const std::vector<Eigen::MatrixXd> &reference, const double eps,
     const int max_iter, std::vector<Eigen::MatrixXd> *control);
 
+/**
+ * @brief The ADMM iterates of SolveSparseLinearMPC, kept between control
+ *        cycles to warm start the next solve.
+ */
+struct SparseMPCWarmStart {
+  std::vector<Eigen::MatrixXd> control;
+  std::vector<Eigen::MatrixXd> dual;
+};
+
+/**
+ * @brief Solver for discrete-time model predictive control problem in the
+ *        sparse form, i.e. without condensing the states into powers of A.
+ *        The box constrained QP is solved by ADMM. Each iteration solves the
+ *        unconstrained tracking problem by a Riccati recursion, so the cost
+ *        grows linearly with the horizon.
+ * @param matrix_a The system dynamic matrix
+ * @param matrix_b The control matrix
+ * @param matrix_c The disturbance matrix
+ * @param matrix_q The cost matrix for control state
+ * @param matrix_lower The lower bound control constrain matrix
+ * @param matrix_upper The upper bound control constrain matrix
+ * @param matrix_initial_state The initial state matrix
+ * @param reference The control reference vector with respect to time
+ * @param eps The tolerance of the primal and dual residuals
+ * @param max_iter The maximum ADMM iterations
+ * @param control The feedback control matrix (pointer), also the initial
+ *        guess when there is no warm start
+ * @param warm_start The iterates of the previous cycle, shifted by one step
+ *        before use and updated on return. nullptr to start cold.
+ */
+bool SolveSparseLinearMPC(
+    const Eigen::MatrixXd &matrix_a, const Eigen::MatrixXd &matrix_b,
+    const Eigen::MatrixXd &matrix_c, const Eigen::MatrixXd &matrix_q,
+    const Eigen::MatrixXd &matrix_r, const Eigen::MatrixXd &matrix_lower,
+    const Eigen::MatrixXd &matrix_upper,
+    const Eigen::MatrixXd &matrix_initial_state,
+    const std::vector<Eigen::MatrixXd> &reference, const double eps,
+    const int max_iter, std::vector<Eigen::MatrixXd> *control,
+    SparseMPCWarmStart *warm_start);
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
@@ -0,0 +1,163 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of one MPC control cycle on the 6-state lateral and
+ * longitudinal model of MPCController at 10 m/s, for horizons of 10 to 50:
+ * the condensed active set QP against the sparse ADMM solver, cold and warm
+ * started.
+ **/
+
+#include <vector>
+
+#include "Eigen/Dense"
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/mpc_solver.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+constexpr double kEps = 0.01;
+constexpr int kMaxIteration = 150;
+
+struct MPCProblem {
+  Eigen::MatrixXd matrix_a;
+  Eigen::MatrixXd matrix_b;
+  Eigen::MatrixXd matrix_c;
+  Eigen::MatrixXd matrix_q;
+  Eigen::MatrixXd matrix_r;
+  Eigen::MatrixXd lower_bound;
+  Eigen::MatrixXd upper_bound;
+  Eigen::MatrixXd initial_state;
+};
+
+MPCProblem MakeProblem() {
+  const double v = 10.0;
+  const double cf = 155494.663;
+  const double cr = 155494.663;
+  const double mass = 2080.0;
+  const double lf = 1.4;
+  const double lr = 1.4;
+  const double iz = lf * lf * mass / 2.0 + lr * lr * mass / 2.0;
+  const double ts = 0.01;
+
+  Eigen::MatrixXd matrix_a = Eigen::MatrixXd::Zero(6, 6);
+  matrix_a(0, 1) = 1.0;
+  matrix_a(1, 1) = -(cf + cr) / mass / v;
+  matrix_a(1, 2) = (cf + cr) / mass;
+  matrix_a(1, 3) = (lr * cr - lf * cf) / mass / v;
+  matrix_a(2, 3) = 1.0;
+  matrix_a(3, 1) = (lr * cr - lf * cf) / iz / v;
+  matrix_a(3, 2) = (lf * cf - lr * cr) / iz;
+  matrix_a(3, 3) = -(lf * lf * cf + lr * lr * cr) / iz / v;
+  matrix_a(4, 5) = 1.0;
+  Eigen::MatrixXd matrix_b = Eigen::MatrixXd::Zero(6, 2);
+  matrix_b(1, 0) = cf / mass;
+  matrix_b(3, 0) = lf * cf / iz;
+  matrix_b(5, 1) = -1.0;
+  Eigen::MatrixXd matrix_c = Eigen::MatrixXd::Zero(6, 1);
+  matrix_c(1, 0) = (lr * cr - lf * cf) / mass / v - v;
+  matrix_c(3, 0) = -(lf * lf * cf + lr * lr * cr) / iz / v;
+
+  const Eigen::MatrixXd matrix_i = Eigen::MatrixXd::Identity(6, 6);
+  MPCProblem problem;
+  problem.matrix_a = (matrix_i - ts * 0.5 * matrix_a).inverse() *
+                     (matrix_i + ts * 0.5 * matrix_a);
+  problem.matrix_b = matrix_b * ts;
+  problem.matrix_c = matrix_c * 0.01 * ts;
+  problem.matrix_q = Eigen::MatrixXd::Zero(6, 6);
+  problem.matrix_q(0, 0) = 0.05;
+  problem.matrix_q(2, 2) = 1.0;
+  problem.matrix_q(4, 4) = 0.1;
+  problem.matrix_q(5, 5) = 0.1;
+  problem.matrix_r = Eigen::MatrixXd::Identity(2, 2);
+  problem.lower_bound = Eigen::MatrixXd(2, 1);
+  problem.lower_bound << -0.14, -4.0;
+  problem.upper_bound = Eigen::MatrixXd(2, 1);
+  problem.upper_bound << 0.14, 2.0;
+  problem.initial_state = Eigen::MatrixXd(6, 1);
+  problem.initial_state << 0.5, 0.1, 0.05, 0.0, 1.0, 0.5;
+  return problem;
+}
+
+void BM_CondensedMPC(benchmark::State &state) {  // NOLINT
+  const MPCProblem problem = MakeProblem();
+  const std::vector<Eigen::MatrixXd> reference(
+      state.range(0), Eigen::MatrixXd::Zero(6, 1));
+  while (state.KeepRunning()) {
+    std::vector<Eigen::MatrixXd> control(state.range(0),
+                                         Eigen::MatrixXd::Zero(2, 1));
+    SolveLinearMPC(problem.matrix_a, problem.matrix_b, problem.matrix_c,
+                   problem.matrix_q, problem.matrix_r, problem.lower_bound,
+                   problem.upper_bound, problem.initial_state, reference,
+                   kEps, kMaxIteration, &control);
+    benchmark::DoNotOptimize(control);
+  }
+}
+BENCHMARK(BM_CondensedMPC)->Arg(10)->Arg(20)->Arg(30)->Arg(40)->Arg(50);
+
+void BM_SparseMPCCold(benchmark::State &state) {  // NOLINT
+  const MPCProblem problem = MakeProblem();
+  const std::vector<Eigen::MatrixXd> reference(
+      state.range(0), Eigen::MatrixXd::Zero(6, 1));
+  while (state.KeepRunning()) {
+    std::vector<Eigen::MatrixXd> control(state.range(0),
+                                         Eigen::MatrixXd::Zero(2, 1));
+    SolveSparseLinearMPC(problem.matrix_a, problem.matrix_b,
+                         problem.matrix_c, problem.matrix_q, problem.matrix_r,
+                         problem.lower_bound, problem.upper_bound,
+                         problem.initial_state, reference, kEps, kMaxIteration,
+                         &control, nullptr);
+    benchmark::DoNotOptimize(control);
+  }
+}
+BENCHMARK(BM_SparseMPCCold)->Arg(10)->Arg(20)->Arg(30)->Arg(40)->Arg(50);
+
+void BM_SparseMPCWarm(benchmark::State &state) {  // NOLINT
+  const MPCProblem problem = MakeProblem();
+  const std::vector<Eigen::MatrixXd> reference(
+      state.range(0), Eigen::MatrixXd::Zero(6, 1));
+  SparseMPCWarmStart warm_start;
+  std::vector<Eigen::MatrixXd> control(state.range(0),
+                                       Eigen::MatrixXd::Zero(2, 1));
+  // Follow the closed loop, so that each cycle starts from the shifted
+  // solution of the previous one.
+  Eigen::MatrixXd matrix_state = problem.initial_state;
+  while (state.KeepRunning()) {
+    SolveSparseLinearMPC(problem.matrix_a, problem.matrix_b,
+                         problem.matrix_c, problem.matrix_q, problem.matrix_r,
+                         problem.lower_bound, problem.upper_bound,
+                         matrix_state, reference, kEps, kMaxIteration,
+                         &control, &warm_start);
+    matrix_state = problem.matrix_a * matrix_state +
+                   problem.matrix_b * control[0] + problem.matrix_c;
+    if (matrix_state.norm() < 1e-3) {
+      matrix_state = problem.initial_state;
+    }
+  }
+}
+BENCHMARK(BM_SparseMPCWarm)->Arg(10)->Arg(20)->Arg(30)->Arg(40)->Arg(50);
+
+}  // namespace
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -138,6 +138,91 @@ TEST(MPCSolverTest, MPC) {
     EXPECT_NEAR(0.0, control2[0](0), 1e-7);
   }
 }
+
+TEST(MPCSolverTest, SparseMPC) {
+  const int STATES = 4;
+  const int HORIZON = 10;
+  const double EPS = 1e-6;
+  const int MAX_ITER = 1000;
+
+  Eigen::MatrixXd A(STATES, STATES);
+  A << 1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 1;
+
+  Eigen::MatrixXd B(STATES, 2);
+  B << 0, 1, 0, 0, 1, 0, 0, 1;
+
+  Eigen::MatrixXd C(STATES, 1);
+  C << 0, 0, 0, 0.1;
+
+  Eigen::MatrixXd Q(STATES, STATES);
+  Q << 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0;
+
+  Eigen::MatrixXd R = Eigen::MatrixXd::Identity(2, 2);
+
+  Eigen::MatrixXd lower_bound(2, 1);
+  lower_bound << -10, -10;
+
+  Eigen::MatrixXd upper_bound(2, 1);
+  upper_bound << 10, 10;
+
+  Eigen::MatrixXd initial_state = Eigen::MatrixXd::Zero(STATES, 1);
+
+  Eigen::MatrixXd reference_state(STATES, 1);
+  reference_state << 200, 200, 0, 0;
+  std::vector<Eigen::MatrixXd> reference(HORIZON, reference_state);
+
+  std::vector<Eigen::MatrixXd> control(HORIZON, Eigen::MatrixXd::Zero(2, 1));
+  SparseMPCWarmStart warm_start;
+  for (int i = 0; i < HORIZON; ++i) {
+    EXPECT_TRUE(SolveSparseLinearMPC(A, B, C, Q, R, lower_bound, upper_bound,
+                                     initial_state, reference, EPS, MAX_ITER,
+                                     &control, &warm_start));
+    EXPECT_NEAR(upper_bound(0), control[0](0), 1e-6);
+  }
+
+  Eigen::MatrixXd B1(STATES, 1);
+  B1 << 0, 0, 1, 0;
+
+  Eigen::MatrixXd R1(1, 1);
+  R1 << 1;
+
+  Eigen::MatrixXd lower_bound1(1, 1);
+  lower_bound1 << -5;
+
+  Eigen::MatrixXd upper_bound1(1, 1);
+  upper_bound1 << 5;
+
+  Eigen::MatrixXd initial_state1(STATES, 1);
+  initial_state1 << 30, 30, 0, 0;
+
+  std::vector<Eigen::MatrixXd> reference1(HORIZON,
+                                          Eigen::MatrixXd::Zero(STATES, 1));
+  std::vector<Eigen::MatrixXd> control1(HORIZON, Eigen::MatrixXd::Zero(1, 1));
+  SparseMPCWarmStart warm_start1;
+  for (int i = 0; i < HORIZON; ++i) {
+    EXPECT_TRUE(SolveSparseLinearMPC(A, B1, C, Q, R1, lower_bound1,
+                                     upper_bound1, initial_state1, reference1,
+                                     EPS, MAX_ITER, &control1, &warm_start1));
+    EXPECT_NEAR(lower_bound1(0), control1[0](0), 1e-6);
+  }
+
+  Eigen::MatrixXd upper_bound2(1, 1);
+  upper_bound2 << 10;
+  Eigen::MatrixXd lower_bound2(1, 1);
+  lower_bound2 << -10;
+  std::vector<Eigen::MatrixXd> reference2(HORIZON, initial_state1);
+  std::vector<Eigen::MatrixXd> control2(HORIZON, Eigen::MatrixXd::Zero(1, 1));
+  EXPECT_TRUE(SolveSparseLinearMPC(A, B1, C, Q, R1, lower_bound2, upper_bound2,
+                                   initial_state1, reference2, EPS, MAX_ITER,
+                                   &control2, nullptr));
+  EXPECT_NEAR(0.0, control2[0](0), 1e-5);
+
+  // Dimension mismatch between the bounds and the controls.
+  EXPECT_FALSE(SolveSparseLinearMPC(A, B, C, Q, R, lower_bound1, upper_bound1,
+                                    initial_state, reference, EPS, MAX_ITER,
+                                    &control, nullptr));
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
@@ -27,17 +27,25 @@ using std::string;
 using std::chrono::duration_cast;
 using std::chrono::milliseconds;
 
-void Timer::Start() { start_time_ = Clock::Now(); }
+void Timer::Start() {
+  start_time_ = Clock::Now();
+  trace_start_ns_ = Tracer::NowNanos();
+}
 
 uint64_t Timer::End(const string &msg) {
   end_time_ = Clock::Now();
+  const int64_t trace_end_ns = Tracer::NowNanos();
   uint64_t elapsed_time =
       duration_cast<milliseconds>(end_time_ - start_time_).count();
 
   ADEBUG << "TIMER " << msg << " elapsed_time: " << elapsed_time << " ms";
+  if (Tracer::enabled() && !msg.empty()) {
+    Tracer::instance()->AddSpan(msg, trace_start_ns_, trace_end_ns);
+  }
 
   // start new timer.
   start_time_ = end_time_;
+  trace_start_ns_ = trace_end_ns;
   return elapsed_time;
 }
 
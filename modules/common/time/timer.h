@@ -22,6 +22,7 @@
 #include <string>
 
 #include "modules/common/macro.h"
+#include "modules/common/time/tracer.h"
 
 namespace apollo {
 namespace common {
@@ -37,7 +38,8 @@ class Timer {
   void Start();
 
   // return the elapsed time,
-  // also output msg and time in glog.
+  // also output msg and time in glog, and record a span named msg in the
+  // tracer.
   // automatically start a new timer.
   // no-thread safe.
   uint64_t End(const std::string &msg);
@@ -46,19 +48,38 @@ class Timer {
   // in ms.
   TimePoint start_time_;
   TimePoint end_time_;
+  // On the steady clock of the tracer.
+  int64_t trace_start_ns_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(Timer);
 };
 
+// The spans of the timers in its scope are nested in its own.
 class TimerWrapper {
  public:
-  explicit TimerWrapper(const std::string &msg) : msg_(msg) { timer_.Start(); }
-
-  ~TimerWrapper() { timer_.End(msg_); }
+  explicit TimerWrapper(const std::string &msg) : msg_(msg) {
+    if (Tracer::enabled()) {
+      Tracer::instance()->BeginSpan();
+      nested_ = true;
+    }
+    timer_.Start();
+  }
+
+  // Named after the function if msg is empty.
+  TimerWrapper(const char *function_name, const std::string &msg)
+      : TimerWrapper(msg.empty() ? function_name : msg) {}
+
+  ~TimerWrapper() {
+    if (nested_) {
+      Tracer::instance()->EndSpan();
+    }
+    timer_.End(msg_);
+  }
 
  private:
   Timer timer_;
   std::string msg_;
+  bool nested_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(TimerWrapper);
 };
@@ -67,8 +88,9 @@ class TimerWrapper {
 }  // namespace common
 }  // namespace apollo
 
-#define PERF_FUNCTION(function_name) \
-  apollo::common::time::TimerWrapper _timer_wrapper_(function_name)
+#define PERF_FUNCTION(...)                             \
+  apollo::common::time::TimerWrapper _timer_wrapper_( \
+      __FUNCTION__, std::string(__VA_ARGS__))
 
 #define PERF_BLOCK_START()             \
   apollo::common::time::Timer _timer_; \
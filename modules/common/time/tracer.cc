@@ -0,0 +1,517 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/time/tracer.h"
+
+#include <glob.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <utility>
+
+#include "ctpl/ctpl_stl.h"
+
+#include "modules/common/log.h"
+
+namespace apollo {
+namespace common {
+namespace time {
+
+/**
+ * @class TraceBuffer
+ * @brief A ring of the events of one thread. Only the owner thread adds
+ * events, any thread may read them.
+ *
+ * An event is written after claimed_ announces its index and before size_
+ * publishes it, so a reader drops the slots that were overwritten while it
+ * read them, as with a seqlock.
+ */
+class TraceBuffer {
+ public:
+  explicit TraceBuffer(size_t capacity)
+      : capacity_(capacity), slots_(new Slot[capacity]) {}
+
+  void Add(const TraceEvent &event) {
+    const uint64_t index = size_.load(std::memory_order_relaxed);
+    claimed_.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot &slot = slots_[index & (capacity_ - 1)];
+    slot.header.store(static_cast<uint64_t>(event.type) |
+                          (static_cast<uint64_t>(event.depth) << 8) |
+                          (static_cast<uint64_t>(event.name) << 32),
+                      std::memory_order_relaxed);
+    slot.begin_ns.store(event.begin_ns, std::memory_order_relaxed);
+    slot.value.store(event.value, std::memory_order_relaxed);
+    size_.store(index + 1, std::memory_order_release);
+  }
+
+  // Appends the events which end at or after since_ns.
+  void Read(int64_t since_ns, std::vector<TraceEvent> *events) const {
+    const uint64_t end = size_.load(std::memory_order_acquire);
+    const uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+    const size_t first = events->size();
+    std::vector<uint64_t> indices;
+    for (uint64_t index = begin; index < end; ++index) {
+      const Slot &slot = slots_[index & (capacity_ - 1)];
+      const uint64_t header = slot.header.load(std::memory_order_relaxed);
+      TraceEvent event;
+      event.type = static_cast<TraceEvent::Type>(header & 0xFF);
+      event.depth = static_cast<uint8_t>((header >> 8) & 0xFF);
+      event.name = static_cast<uint32_t>(header >> 32);
+      event.begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+      event.value = slot.value.load(std::memory_order_relaxed);
+      const int64_t end_ns =
+          event.begin_ns + (event.type == TraceEvent::SPAN ? event.value : 0);
+      if (end_ns >= since_ns) {
+        events->push_back(event);
+        indices.push_back(index);
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t claimed = claimed_.load(std::memory_order_relaxed);
+    const uint64_t valid_begin = claimed > capacity_ ? claimed - capacity_ : 0;
+    const auto overwritten =
+        std::lower_bound(indices.begin(), indices.end(), valid_begin) -
+        indices.begin();
+    events->erase(events->begin() + first,
+                  events->begin() + first + overwritten);
+  }
+
+  // When the last event ended, or 0 if there is none.
+  int64_t LastEventNanos() const {
+    const uint64_t end = size_.load(std::memory_order_acquire);
+    if (end == 0) {
+      return 0;
+    }
+    const Slot &slot = slots_[(end - 1) & (capacity_ - 1)];
+    const uint64_t header = slot.header.load(std::memory_order_relaxed);
+    const int64_t begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+    return (header & 0xFF) == TraceEvent::SPAN
+               ? begin_ns + slot.value.load(std::memory_order_relaxed)
+               : begin_ns;
+  }
+
+  // Hands the ring over to a new thread.
+  void Reset(int tid) {
+    size_.store(0, std::memory_order_relaxed);
+    claimed_.store(0, std::memory_order_relaxed);
+    tid_ = tid;
+    name_.clear();
+    depth_ = 0;
+    alive_.store(true);
+  }
+
+  int tid() const { return tid_; }
+  std::string *mutable_name() { return &name_; }
+  int *mutable_depth() { return &depth_; }
+  std::unordered_map<std::string, uint32_t> *name_cache() {
+    return &name_cache_;
+  }
+  bool alive() const { return alive_.load(); }
+  void set_alive(bool alive) { alive_.store(alive); }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> header{0};
+    std::atomic<int64_t> begin_ns{0};
+    std::atomic<int64_t> value{0};
+  };
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> size_{0};
+  std::atomic<uint64_t> claimed_{0};
+  std::atomic<bool> alive_{true};
+
+  // Guarded by the buffers mutex of the tracer.
+  int tid_ = 0;
+  std::string name_;
+  // Owner thread only.
+  int depth_ = 0;
+  std::unordered_map<std::string, uint32_t> name_cache_;
+};
+
+namespace {
+
+thread_local TraceBuffer *thread_buffer = nullptr;
+
+// Frees the ring for another thread when its owner exits.
+struct ThreadBufferReleaser {
+  ~ThreadBufferReleaser() {
+    if (thread_buffer != nullptr) {
+      thread_buffer->set_alive(false);
+    }
+  }
+};
+
+thread_local ThreadBufferReleaser thread_buffer_releaser;
+
+size_t BufferCapacity() {
+  size_t capacity = 64;
+  while (capacity < static_cast<size_t>(FLAGS_trace_buffer_size)) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+void WriteJsonString(const std::string &str, std::ostream *out) {
+  *out << '"';
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        *out << "\\\"";
+        break;
+      case '\\':
+        *out << "\\\\";
+        break;
+      case '\n':
+        *out << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          *out << escaped;
+        } else {
+          *out << c;
+        }
+    }
+  }
+  *out << '"';
+}
+
+void WriteMicros(int64_t ns, std::ostream *out) {
+  char micros[32];
+  snprintf(micros, sizeof(micros), "%lld.%03lld",
+           static_cast<long long>(ns / 1000),  // NOLINT
+           static_cast<long long>(ns % 1000));  // NOLINT
+  *out << micros;
+}
+
+template <typename T>
+void WriteBinary(const T &value, std::ostream *out) {
+  out->write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void WriteBinary(const std::string &str, std::ostream *out) {
+  WriteBinary(static_cast<uint32_t>(str.size()), out);
+  out->write(str.data(), str.size());
+}
+
+// Removes the oldest dumps in the directory beyond the given number.
+void RemoveOldDumps(const std::string &dir, int max_files) {
+  glob_t globs = {};
+  if (glob((dir + "/trace_*").c_str(), 0, nullptr, &globs) != 0) {
+    globfree(&globs);
+    return;
+  }
+  std::vector<std::pair<int64_t, std::string>> dumps;
+  for (size_t i = 0; i < globs.gl_pathc; ++i) {
+    const std::string file = globs.gl_pathv[i];
+    struct stat file_stat;
+    // Skip the ones being written.
+    if ((file.size() >= 4 && file.compare(file.size() - 4, 4, ".tmp") == 0) ||
+        stat(file.c_str(), &file_stat) != 0) {
+      continue;
+    }
+    dumps.emplace_back(static_cast<int64_t>(file_stat.st_mtim.tv_sec) *
+                               1000000000 +
+                           file_stat.st_mtim.tv_nsec,
+                       file);
+  }
+  globfree(&globs);
+  if (static_cast<int>(dumps.size()) <= max_files) {
+    return;
+  }
+  std::sort(dumps.begin(), dumps.end());
+  for (size_t i = 0; i + std::max(max_files, 0) < dumps.size(); ++i) {
+    if (std::remove(dumps[i].second.c_str()) != 0) {
+      AWARN << "Failed to remove the old trace dump " << dumps[i].second;
+    }
+  }
+}
+
+}  // namespace
+
+Tracer::Tracer() {}
+
+Tracer::~Tracer() {}
+
+int64_t Tracer::NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint32_t Tracer::InternName(const std::string &name) {
+  std::lock_guard<std::mutex> lock(names_mutex_);
+  auto iter = name_ids_.find(name);
+  if (iter != name_ids_.end()) {
+    return iter->second;
+  }
+  const uint32_t id = static_cast<uint32_t>(names_.size());
+  names_.push_back(name);
+  name_ids_.emplace(name, id);
+  return id;
+}
+
+TraceBuffer *Tracer::GetThreadBuffer() {
+  if (thread_buffer != nullptr) {
+    return thread_buffer;
+  }
+  const int tid = static_cast<int>(syscall(SYS_gettid));
+  // The events of an exited thread are kept as long as they may be dumped.
+  const int64_t expired_ns =
+      NowNanos() - static_cast<int64_t>(FLAGS_trace_dump_seconds * 1e9);
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  for (auto &buffer : buffers_) {
+    if (!buffer->alive() && buffer->LastEventNanos() < expired_ns) {
+      buffer->Reset(tid);
+      thread_buffer = buffer.get();
+      return thread_buffer;
+    }
+  }
+  buffers_.emplace_back(new TraceBuffer(BufferCapacity()));
+  buffers_.back()->Reset(tid);
+  thread_buffer = buffers_.back().get();
+  // Touches the releaser, so that it is destroyed with the thread.
+  (void)&thread_buffer_releaser;
+  return thread_buffer;
+}
+
+void Tracer::AddSpan(uint32_t name, int64_t begin_ns, int64_t end_ns) {
+  TraceBuffer *buffer = GetThreadBuffer();
+  TraceEvent event;
+  event.type = TraceEvent::SPAN;
+  event.depth = static_cast<uint8_t>(std::min(*buffer->mutable_depth(), 255));
+  event.name = name;
+  event.begin_ns = begin_ns;
+  event.value = end_ns - begin_ns;
+  buffer->Add(event);
+}
+
+void Tracer::AddSpan(const std::string &name, int64_t begin_ns,
+                     int64_t end_ns) {
+  auto *name_cache = GetThreadBuffer()->name_cache();
+  auto iter = name_cache->find(name);
+  if (iter == name_cache->end()) {
+    iter = name_cache->emplace(name, InternName(name)).first;
+  }
+  AddSpan(iter->second, begin_ns, end_ns);
+}
+
+void Tracer::AddCounter(uint32_t name, int64_t value) {
+  TraceBuffer *buffer = GetThreadBuffer();
+  TraceEvent event;
+  event.type = TraceEvent::COUNTER;
+  event.depth = static_cast<uint8_t>(std::min(*buffer->mutable_depth(), 255));
+  event.name = name;
+  event.begin_ns = NowNanos();
+  event.value = value;
+  buffer->Add(event);
+}
+
+void Tracer::BeginSpan() { ++*GetThreadBuffer()->mutable_depth(); }
+
+void Tracer::EndSpan() { --*GetThreadBuffer()->mutable_depth(); }
+
+void Tracer::SetThreadName(const std::string &name) {
+  TraceBuffer *buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  *buffer->mutable_name() = name;
+}
+
+std::vector<Tracer::ThreadEvents> Tracer::CollectEvents(double last_seconds) {
+  const int64_t since_ns =
+      NowNanos() - static_cast<int64_t>(last_seconds * 1e9);
+  std::vector<ThreadEvents> threads;
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  for (const auto &buffer : buffers_) {
+    ThreadEvents thread;
+    thread.tid = buffer->tid();
+    thread.name = *buffer->mutable_name();
+    buffer->Read(since_ns, &thread.events);
+    if (!thread.events.empty()) {
+      threads.push_back(std::move(thread));
+    }
+  }
+  return threads;
+}
+
+std::vector<std::string> Tracer::Names() {
+  std::lock_guard<std::mutex> lock(names_mutex_);
+  return names_;
+}
+
+void Tracer::ExportChromeTrace(double last_seconds, std::ostream *out) {
+  const auto threads = CollectEvents(last_seconds);
+  WriteChromeTrace(threads, Names(), out);
+}
+
+void Tracer::ExportBinary(double last_seconds, std::ostream *out) {
+  const auto threads = CollectEvents(last_seconds);
+  WriteBinaryTrace(threads, Names(), out);
+}
+
+bool Tracer::DumpToFile(const std::string &file, double last_seconds) {
+  const bool binary =
+      file.size() >= 4 && file.compare(file.size() - 4, 4, ".bin") == 0;
+  const auto threads = CollectEvents(last_seconds);
+  return WriteTraceFile(file, binary, threads, Names());
+}
+
+void Tracer::WriteChromeTrace(const std::vector<ThreadEvents> &threads,
+                              const std::vector<std::string> &names,
+                              std::ostream *out) {
+  const int pid = static_cast<int>(getpid());
+  *out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (const auto &thread : threads) {
+    if (!thread.name.empty()) {
+      *out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+           << "\"pid\":" << pid << ",\"tid\":" << thread.tid
+           << ",\"args\":{\"name\":";
+      WriteJsonString(thread.name, out);
+      *out << "}}";
+      first = false;
+    }
+    for (const auto &event : thread.events) {
+      *out << (first ? "" : ",") << "\n{\"name\":";
+      WriteJsonString(event.name < names.size() ? names[event.name] : "",
+                      out);
+      *out << ",\"ph\":\"" << (event.type == TraceEvent::SPAN ? 'X' : 'C')
+           << "\",\"ts\":";
+      WriteMicros(event.begin_ns, out);
+      if (event.type == TraceEvent::SPAN) {
+        *out << ",\"dur\":";
+        WriteMicros(event.value, out);
+      }
+      *out << ",\"pid\":" << pid << ",\"tid\":" << thread.tid;
+      if (event.type == TraceEvent::COUNTER) {
+        *out << ",\"args\":{\"value\":" << event.value << "}";
+      }
+      *out << "}";
+      first = false;
+    }
+  }
+  *out << "\n]}\n";
+}
+
+void Tracer::WriteBinaryTrace(const std::vector<ThreadEvents> &threads,
+                              const std::vector<std::string> &names,
+                              std::ostream *out) {
+  out->write("APTRACE1", 8);
+  WriteBinary(static_cast<uint32_t>(names.size()), out);
+  for (const auto &name : names) {
+    WriteBinary(name, out);
+  }
+  WriteBinary(static_cast<uint32_t>(threads.size()), out);
+  for (const auto &thread : threads) {
+    WriteBinary(static_cast<int32_t>(thread.tid), out);
+    WriteBinary(thread.name, out);
+    WriteBinary(static_cast<uint32_t>(thread.events.size()), out);
+    for (const auto &event : thread.events) {
+      WriteBinary(static_cast<uint8_t>(event.type), out);
+      WriteBinary(event.depth, out);
+      WriteBinary(static_cast<uint16_t>(0), out);
+      WriteBinary(event.name, out);
+      WriteBinary(event.begin_ns, out);
+      WriteBinary(event.value, out);
+    }
+  }
+}
+
+bool Tracer::WriteTraceFile(const std::string &file, bool binary,
+                            const std::vector<ThreadEvents> &threads,
+                            const std::vector<std::string> &names) {
+  std::ofstream fout(file, binary ? std::ios::binary : std::ios::out);
+  if (!fout) {
+    AERROR << "Failed to open trace file " << file;
+    return false;
+  }
+  if (binary) {
+    WriteBinaryTrace(threads, names, &fout);
+  } else {
+    WriteChromeTrace(threads, names, &fout);
+  }
+  return static_cast<bool>(fout);
+}
+
+std::string Tracer::DumpOnAnomaly(const std::string &reason) {
+  if (!enabled() || !FLAGS_enable_trace_dump_on_anomaly) {
+    return "";
+  }
+  const int64_t now_ns = NowNanos();
+  int64_t last_dump_ns = last_dump_ns_.load();
+  if (last_dump_ns != 0 &&
+      now_ns - last_dump_ns < static_cast<int64_t>(FLAGS_trace_dump_seconds *
+                                                   1e9)) {
+    return "";
+  }
+  if (!last_dump_ns_.compare_exchange_strong(last_dump_ns, now_ns)) {
+    return "";
+  }
+
+  // The flags are read here only, as they may change meanwhile.
+  const std::string dir = FLAGS_trace_dump_dir;
+  const int max_files = FLAGS_trace_dump_max_files;
+  const double seconds = FLAGS_trace_dump_seconds;
+  mkdir(dir.c_str(), 0755);
+  const std::time_t now = std::time(nullptr);
+  std::tm local_time;
+  localtime_r(&now, &local_time);
+  char time_str[32];
+  std::strftime(time_str, sizeof(time_str), "%Y%m%d_%H%M%S", &local_time);
+  const bool binary = FLAGS_trace_dump_format == "binary";
+  const std::string file = dir + "/trace_" + reason + "_" + time_str +
+                           (binary ? ".bin" : ".json");
+
+  struct Dump {
+    std::vector<ThreadEvents> threads;
+    std::vector<std::string> names;
+  };
+  std::shared_ptr<Dump> dump(new Dump);
+  dump->threads = CollectEvents(seconds);
+  dump->names = Names();
+  std::call_once(dump_thread_once_,
+                 [this]() { dump_thread_.reset(new ctpl::thread_pool(1)); });
+  dump_thread_->push([file, binary, reason, dump, dir, max_files,
+                      seconds](int) {
+    // Written aside and renamed, so that a file under the name is complete.
+    const std::string temp_file = file + ".tmp";
+    if (!WriteTraceFile(temp_file, binary, dump->threads, dump->names) ||
+        std::rename(temp_file.c_str(), file.c_str()) != 0) {
+      AERROR << "Failed to dump traces after " << reason << " to " << file;
+      std::remove(temp_file.c_str());
+      return;
+    }
+    AINFO << "Dumped the last " << seconds << " seconds of traces after "
+          << reason << " to " << file;
+    RemoveOldDumps(dir, max_files);
+  });
+  return file;
+}
+
+}  // namespace time
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,235 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Records nested spans and counters of every thread in lock-free
+ * rings, and exports the recent ones as Chrome trace events or in a compact
+ * binary format.
+ *
+ * Usage:
+ *   void Foo() {
+ *     TRACE_SCOPE("Foo");
+ *     ...
+ *     TRACE_COUNTER("foo_obstacles", obstacles.size());
+ *   }
+ *
+ * Each thread writes to its own ring of FLAGS_trace_buffer_size events, so
+ * recording takes two clock reads and a few stores, without locks. The
+ * oldest events are overwritten when a ring is full.
+ */
+
+#ifndef MODULES_COMMON_TIME_TRACER_H_
+#define MODULES_COMMON_TIME_TRACER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/common/configs/config_gflags.h"
+#include "modules/common/macro.h"
+
+namespace ctpl {
+class thread_pool;
+}  // namespace ctpl
+
+/**
+ * @namespace apollo::common::time
+ * @brief apollo::common::time
+ */
+namespace apollo {
+namespace common {
+namespace time {
+
+struct TraceEvent {
+  enum Type : uint8_t {
+    SPAN = 0,
+    COUNTER = 1,
+  };
+  Type type = SPAN;
+  // Number of spans the event is nested in, on its thread.
+  uint8_t depth = 0;
+  uint32_t name = 0;
+  // On the steady clock.
+  int64_t begin_ns = 0;
+  // Duration of a span, or value of a counter.
+  int64_t value = 0;
+};
+
+class TraceBuffer;
+
+/**
+ * @class Tracer
+ * @brief Collects the trace events of all threads.
+ *
+ * The binary format is, in host byte order:
+ *   char[8] "APTRACE1"
+ *   uint32 number of names, then for each: uint32 length, chars
+ *   uint32 number of threads, then for each: int32 tid, uint32 name length,
+ *     chars, uint32 number of events, then for each event: uint8 type,
+ *     uint8 depth, uint16 zero, uint32 name, int64 begin_ns, int64 value
+ */
+class Tracer {
+ public:
+  static bool enabled() { return FLAGS_enable_tracing; }
+
+  static int64_t NowNanos();
+
+  /**
+   * @brief Returns the id of a name, to record events with.
+   */
+  uint32_t InternName(const std::string &name);
+
+  void AddSpan(uint32_t name, int64_t begin_ns, int64_t end_ns);
+  void AddSpan(const std::string &name, int64_t begin_ns, int64_t end_ns);
+  void AddCounter(uint32_t name, int64_t value);
+
+  // Spans added on this thread in between are nested in the span.
+  void BeginSpan();
+  void EndSpan();
+
+  /**
+   * @brief Names the calling thread in the exported traces.
+   */
+  void SetThreadName(const std::string &name);
+
+  /**
+   * @brief Writes the events of the last seconds as Chrome trace-event JSON,
+   * which chrome://tracing and Perfetto load.
+   */
+  void ExportChromeTrace(double last_seconds, std::ostream *out);
+
+  /**
+   * @brief Writes the events of the last seconds in the binary format.
+   */
+  void ExportBinary(double last_seconds, std::ostream *out);
+
+  /**
+   * @brief Writes the events of the last seconds to a file, in the binary
+   * format if it ends with ".bin" and as JSON otherwise.
+   */
+  bool DumpToFile(const std::string &file, double last_seconds);
+
+  /**
+   * @brief Dumps the last FLAGS_trace_dump_seconds of events to
+   * FLAGS_trace_dump_dir, after something went wrong, if
+   * FLAGS_enable_trace_dump_on_anomaly. Dumps at most once in that many
+   * seconds, so the dumps don't overlap, and keeps the latest
+   * FLAGS_trace_dump_max_files dumps.
+   *
+   * Only the events are copied on the calling thread; the file is written on
+   * a background thread, and appears under its name once complete.
+   * @return The file to be written, or empty if none.
+   */
+  std::string DumpOnAnomaly(const std::string &reason);
+
+ private:
+  // Defined where TraceBuffer is complete.
+  ~Tracer();
+
+  struct ThreadEvents {
+    int tid = 0;
+    std::string name;
+    std::vector<TraceEvent> events;
+  };
+
+  TraceBuffer *GetThreadBuffer();
+  std::vector<ThreadEvents> CollectEvents(double last_seconds);
+  std::vector<std::string> Names();
+
+  static void WriteChromeTrace(const std::vector<ThreadEvents> &threads,
+                               const std::vector<std::string> &names,
+                               std::ostream *out);
+  static void WriteBinaryTrace(const std::vector<ThreadEvents> &threads,
+                               const std::vector<std::string> &names,
+                               std::ostream *out);
+  static bool WriteTraceFile(const std::string &file, bool binary,
+                             const std::vector<ThreadEvents> &threads,
+                             const std::vector<std::string> &names);
+
+  std::mutex names_mutex_;
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, uint32_t> name_ids_;
+
+  std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+
+  std::atomic<int64_t> last_dump_ns_{0};
+  // Writes the anomaly dumps, created on the first one.
+  std::once_flag dump_thread_once_;
+  std::unique_ptr<ctpl::thread_pool> dump_thread_;
+
+  DECLARE_SINGLETON(Tracer);
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records a span from its construction to its destruction.
+ */
+class TraceSpan {
+ public:
+  explicit TraceSpan(uint32_t name) : name_(name) {
+    if (Tracer::enabled()) {
+      Tracer::instance()->BeginSpan();
+      begin_ns_ = Tracer::NowNanos();
+    }
+  }
+
+  ~TraceSpan() {
+    if (begin_ns_ != 0) {
+      const int64_t end_ns = Tracer::NowNanos();
+      Tracer::instance()->EndSpan();
+      Tracer::instance()->AddSpan(name_, begin_ns_, end_ns);
+    }
+  }
+
+ private:
+  uint32_t name_;
+  int64_t begin_ns_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceSpan);
+};
+
+}  // namespace time
+}  // namespace common
+}  // namespace apollo
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+// The name is interned once per call site.
+#define TRACE_SCOPE(name)                                                  \
+  static const uint32_t TRACE_CONCAT(_trace_name_, __LINE__) =             \
+      apollo::common::time::Tracer::instance()->InternName(name);          \
+  apollo::common::time::TraceSpan TRACE_CONCAT(_trace_span_, __LINE__)(    \
+      TRACE_CONCAT(_trace_name_, __LINE__))
+
+#define TRACE_COUNTER(name, value)                                         \
+  do {                                                                     \
+    if (apollo::common::time::Tracer::enabled()) {                         \
+      static const uint32_t _trace_counter_name_ =                         \
+          apollo::common::time::Tracer::instance()->InternName(name);      \
+      apollo::common::time::Tracer::instance()->AddCounter(                \
+          _trace_counter_name_, static_cast<int64_t>(value));              \
+    }                                                                      \
+  } while (0)
+
+#endif  // MODULES_COMMON_TIME_TRACER_H_
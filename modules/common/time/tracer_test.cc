@@ -0,0 +1,192 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/time/tracer.h"
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/common/time/timer.h"
+
+namespace apollo {
+namespace common {
+namespace time {
+
+namespace {
+
+std::string ChromeTrace() {
+  std::ostringstream out;
+  Tracer::instance()->ExportChromeTrace(60.0, &out);
+  return out.str();
+}
+
+int Count(const std::string &str, const std::string &pattern) {
+  int count = 0;
+  for (auto pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(TracerTest, NestedSpans) {
+  {
+    TRACE_SCOPE("TracerTest.outer");
+    {
+      TRACE_SCOPE("TracerTest.inner");
+      usleep(1000);
+    }
+    TRACE_COUNTER("TracerTest.counter", 42);
+  }
+  const std::string trace = ChromeTrace();
+  EXPECT_EQ(1, Count(trace, "{\"name\":\"TracerTest.outer\",\"ph\":\"X\""));
+  EXPECT_EQ(1, Count(trace, "{\"name\":\"TracerTest.inner\",\"ph\":\"X\""));
+  EXPECT_EQ(1, Count(trace, "{\"name\":\"TracerTest.counter\",\"ph\":\"C\""));
+  EXPECT_NE(std::string::npos, trace.find("\"args\":{\"value\":42}"));
+}
+
+TEST(TracerTest, Timers) {
+  {
+    PERF_FUNCTION("TracerTest.function");
+    Timer timer;
+    timer.Start();
+    timer.End("TracerTest.timer");
+  }
+  {
+    PERF_FUNCTION();
+  }
+  const std::string trace = ChromeTrace();
+  EXPECT_EQ(1, Count(trace, "\"TracerTest.function\""));
+  EXPECT_EQ(1, Count(trace, "\"TracerTest.timer\""));
+  EXPECT_EQ(1, Count(trace, "\"TestBody\""));
+}
+
+TEST(TracerTest, Disabled) {
+  FLAGS_enable_tracing = false;
+  {
+    TRACE_SCOPE("TracerTest.disabled");
+  }
+  FLAGS_enable_tracing = true;
+  EXPECT_EQ(0, Count(ChromeTrace(), "\"TracerTest.disabled\""));
+}
+
+TEST(TracerTest, Threads) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([i] {
+      Tracer::instance()->SetThreadName("tracer_test_" + std::to_string(i));
+      for (int j = 0; j < 100; ++j) {
+        TRACE_SCOPE("TracerTest.thread");
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const std::string trace = ChromeTrace();
+  EXPECT_EQ(400, Count(trace, "\"TracerTest.thread\""));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(1, Count(trace, "\"tracer_test_" + std::to_string(i) + "\""));
+  }
+}
+
+TEST(TracerTest, OverwritesOldest) {
+  std::thread thread([] {
+    const uint32_t old_name = Tracer::instance()->InternName("TracerTest.old");
+    const uint32_t new_name = Tracer::instance()->InternName("TracerTest.new");
+    const int64_t now_ns = Tracer::NowNanos();
+    Tracer::instance()->AddSpan(old_name, now_ns, now_ns);
+    // Rings of exited threads are reused, so this one may be larger.
+    for (int i = 0; i < 2 * FLAGS_trace_buffer_size + 2; ++i) {
+      Tracer::instance()->AddSpan(new_name, now_ns, now_ns);
+    }
+  });
+  thread.join();
+  const std::string trace = ChromeTrace();
+  EXPECT_EQ(0, Count(trace, "\"TracerTest.old\""));
+  EXPECT_GE(Count(trace, "\"TracerTest.new\""), FLAGS_trace_buffer_size);
+}
+
+TEST(TracerTest, Binary) {
+  {
+    TRACE_SCOPE("TracerTest.binary");
+  }
+  std::ostringstream out;
+  Tracer::instance()->ExportBinary(60.0, &out);
+  const std::string trace = out.str();
+  EXPECT_EQ("APTRACE1", trace.substr(0, 8));
+  EXPECT_NE(std::string::npos, trace.find("TracerTest.binary"));
+}
+
+TEST(TracerTest, DumpOnAnomaly) {
+  char dir[] = "/tmp/tracer_test_XXXXXX";
+  FLAGS_trace_dump_dir = mkdtemp(dir);
+  {
+    TRACE_SCOPE("TracerTest.anomaly");
+  }
+  // Off by default.
+  EXPECT_TRUE(Tracer::instance()->DumpOnAnomaly("test").empty());
+  FLAGS_enable_trace_dump_on_anomaly = true;
+
+  // Older dumps, of which only the latest is kept with the new one.
+  const int saved_max_files = FLAGS_trace_dump_max_files;
+  FLAGS_trace_dump_max_files = 2;
+  std::vector<std::string> old_files;
+  for (int i = 0; i < 3; ++i) {
+    old_files.push_back(std::string(dir) + "/trace_old_" +
+                        std::to_string(i) + ".json");
+    std::ofstream(old_files.back()) << "{}";
+    const struct timeval times[2] = {{1000 + i, 0}, {1000 + i, 0}};
+    utimes(old_files.back().c_str(), times);
+  }
+
+  const std::string file = Tracer::instance()->DumpOnAnomaly("test");
+  ASSERT_FALSE(file.empty());
+  // Written in the background, then the old dumps are removed.
+  for (int i = 0; i < 500 && access(old_files[1].c_str(), F_OK) == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  std::ifstream fin(file);
+  const std::string trace((std::istreambuf_iterator<char>(fin)),
+                          std::istreambuf_iterator<char>());
+  EXPECT_NE(std::string::npos, trace.find("\"TracerTest.anomaly\""));
+  EXPECT_NE(0, access(old_files[0].c_str(), F_OK));
+  EXPECT_NE(0, access(old_files[1].c_str(), F_OK));
+  EXPECT_EQ(0, access(old_files[2].c_str(), F_OK));
+
+  // Rate limited.
+  EXPECT_TRUE(Tracer::instance()->DumpOnAnomaly("test").empty());
+  FLAGS_enable_trace_dump_on_anomaly = false;
+  FLAGS_trace_dump_max_files = saved_max_files;
+  unlink(old_files[2].c_str());
+  unlink(file.c_str());
+  rmdir(dir);
+}
+
+}  // namespace time
+}  // namespace common
+}  // namespace apollo
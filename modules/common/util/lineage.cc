@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/util/lineage.h"
+
+#include <algorithm>
+
+namespace apollo {
+namespace common {
+namespace util {
+
+void AppendLineage(const Header& input, Header* output) {
+  output->clear_lineage();
+  const int begin =
+      std::max(0, input.lineage_size() - (kMaxLineageLength - 1));
+  for (int i = begin; i < input.lineage_size(); ++i) {
+    *output->add_lineage() = input.lineage(i);
+  }
+  auto* record = output->add_lineage();
+  record->set_module_name(input.module_name());
+  record->set_sequence_num(input.sequence_num());
+  record->set_timestamp_sec(input.timestamp_sec());
+  if (input.has_lidar_timestamp()) {
+    record->set_lidar_timestamp(input.lidar_timestamp());
+  }
+}
+
+}  // namespace util
+}  // namespace common
+}  // namespace apollo
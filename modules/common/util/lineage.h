@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Propagates the lineage of messages through their headers, to trace
+ * the latency from the sensors to the actuators.
+ */
+
+#ifndef MODULES_COMMON_UTIL_LINEAGE_H_
+#define MODULES_COMMON_UTIL_LINEAGE_H_
+
+#include "modules/common/proto/header.pb.h"
+
+/**
+ * @namespace apollo::common::util
+ * @brief apollo::common::util
+ */
+namespace apollo {
+namespace common {
+namespace util {
+
+// At most so many upstream messages are kept in a lineage, the oldest are
+// dropped first.
+constexpr int kMaxLineageLength = 8;
+
+/**
+ * @brief Sets the lineage of an output message to the lineage of the input
+ * message it was computed from, followed by the input message itself.
+ * @param input The header of the input message.
+ * @param output The header of the output message.
+ */
+void AppendLineage(const Header& input, Header* output);
+
+}  // namespace util
+}  // namespace common
+}  // namespace apollo
+
+#endif  // MODULES_COMMON_UTIL_LINEAGE_H_
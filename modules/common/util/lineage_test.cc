@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/util/lineage.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace util {
+
+namespace {
+
+Header MakeHeader(const std::string& module_name, const uint32_t sequence_num,
+                  const double timestamp_sec) {
+  Header header;
+  header.set_module_name(module_name);
+  header.set_sequence_num(sequence_num);
+  header.set_timestamp_sec(timestamp_sec);
+  return header;
+}
+
+}  // namespace
+
+TEST(LineageTest, AppendLineage) {
+  Header perception = MakeHeader("perception_obstacle", 10, 100.1);
+  perception.set_lidar_timestamp(100000000000);
+  Header prediction = MakeHeader("prediction", 20, 100.2);
+  AppendLineage(perception, &prediction);
+  Header planning = MakeHeader("planning", 30, 100.3);
+  AppendLineage(prediction, &planning);
+
+  ASSERT_EQ(2, planning.lineage_size());
+  EXPECT_EQ("perception_obstacle", planning.lineage(0).module_name());
+  EXPECT_EQ(10, planning.lineage(0).sequence_num());
+  EXPECT_EQ(100000000000, planning.lineage(0).lidar_timestamp());
+  EXPECT_EQ("prediction", planning.lineage(1).module_name());
+  EXPECT_EQ(20, planning.lineage(1).sequence_num());
+  EXPECT_DOUBLE_EQ(100.2, planning.lineage(1).timestamp_sec());
+  EXPECT_FALSE(planning.lineage(1).has_lidar_timestamp());
+
+  // A reused output message gets a new lineage.
+  AppendLineage(perception, &planning);
+  ASSERT_EQ(1, planning.lineage_size());
+  EXPECT_EQ("perception_obstacle", planning.lineage(0).module_name());
+}
+
+TEST(LineageTest, DropOldest) {
+  Header header = MakeHeader("module", 0, 0.0);
+  for (uint32_t i = 1; i <= 2 * kMaxLineageLength; ++i) {
+    Header output = MakeHeader("module", i, i);
+    AppendLineage(header, &output);
+    header = output;
+  }
+  ASSERT_EQ(kMaxLineageLength, header.lineage_size());
+  EXPECT_EQ(kMaxLineageLength, header.lineage(0).sequence_num());
+  EXPECT_EQ(2 * kMaxLineageLength - 1,
+            header.lineage(kMaxLineageLength - 1).sequence_num());
+}
+
+}  // namespace util
+}  // namespace common
+}  // namespace apollo
@@ -49,6 +49,16 @@ DEFINE_double(steer_angle_rate, 100.0,
               "Steer angle change rate in percentage.");
 DEFINE_bool(enable_gain_scheduler, false,
             "Enable gain scheduler for higher vehicle speed");
+DEFINE_bool(enable_lqr_gain_table, false,
+            "Look up the lateral LQR gain from a table precomputed by speed "
+            "instead of solving the Riccati equation every cycle");
+DEFINE_double(lqr_gain_table_speed_resolution, 0.2,
+              "Speed resolution of the lateral LQR gain table, in m/s");
+DEFINE_double(lqr_gain_table_max_speed, 40.0,
+              "Max speed covered by the lateral LQR gain table, in m/s");
+DEFINE_bool(use_sparse_mpc_solver, false,
+            "Solve the MPC problem in the sparse form with a warm started "
+            "ADMM solver instead of the condensed active set QP");
 DEFINE_bool(set_steer_limit, false, "Set steer limit");
 
 DEFINE_bool(enable_slope_offset, false, "Enable slope offset compensation");
@@ -45,6 +45,10 @@ DECLARE_double(max_acceleration_when_stopped);
 
 DECLARE_double(steer_angle_rate);
 DECLARE_bool(enable_gain_scheduler);
+DECLARE_bool(enable_lqr_gain_table);
+DECLARE_double(lqr_gain_table_speed_resolution);
+DECLARE_double(lqr_gain_table_max_speed);
+DECLARE_bool(use_sparse_mpc_solver);
 DECLARE_bool(set_steer_limit);
 DECLARE_bool(enable_slope_offset);
 
@@ -25,6 +25,8 @@
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/log.h"
 #include "modules/common/time/time.h"
+#include "modules/common/time/tracer.h"
+#include "modules/common/util/lineage.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/control/common/control_gflags.h"
 
@@ -38,6 +40,7 @@ using apollo::common::VehicleStateProvider;
 using apollo::common::adapter::AdapterManager;
 using apollo::common::monitor::MonitorMessageItem;
 using apollo::common::time::Clock;
+using apollo::common::time::Tracer;
 using apollo::localization::LocalizationEstimate;
 using apollo::planning::ADCTrajectory;
 
@@ -186,8 +189,12 @@ Status Control::ProduceControlCommand(ControlCommand *control_command) {
     debug->mutable_canbus_header()->CopyFrom(chassis_.header());
     debug->mutable_trajectory_header()->CopyFrom(trajectory_.header());
 
-    Status status_compute = controller_agent_.ComputeControlCommand(
-        &localization_, &chassis_, &trajectory_, control_command);
+    Status status_compute;
+    {
+      TRACE_SCOPE("Control::ComputeControlCommand");
+      status_compute = controller_agent_.ComputeControlCommand(
+          &localization_, &chassis_, &trajectory_, control_command);
+    }
 
     if (!status_compute.ok()) {
       AERROR << "Control main function failed"
@@ -199,6 +206,7 @@ Status Control::ProduceControlCommand(ControlCommand *control_command) {
       estop_ = true;
       estop_reason_ = status_compute.error_message();
       status = status_compute;
+      Tracer::instance()->DumpOnAnomaly("control_failure");
     }
   }
 
@@ -219,6 +227,7 @@ Status Control::ProduceControlCommand(ControlCommand *control_command) {
 }
 
 void Control::OnTimer(const ros::TimerEvent &) {
+  TRACE_SCOPE("Control::OnTimer");
   double start_timestamp = Clock::NowInSeconds();
 
   if (FLAGS_is_control_test_mode && FLAGS_control_test_duration > 0 &&
@@ -350,6 +359,8 @@ void Control::SendCmd(ControlCommand *control_command) {
         planning.header().camera_timestamp());
     control_command->mutable_header()->set_radar_timestamp(
         planning.header().radar_timestamp());
+    common::util::AppendLineage(planning.header(),
+                                control_command->mutable_header());
   }
   AdapterManager::FillControlCommandHeader(Name(), control_command);
 
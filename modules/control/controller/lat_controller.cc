@@ -229,6 +229,7 @@ Status LatController::Init(const ControlConf *control_conf) {
   InitializeFilters(control_conf);
   auto &lat_controller_conf = control_conf->lat_controller_conf();
   LoadLatGainScheduler(lat_controller_conf);
+  LoadLqrGainTable();
   LogInitParameters();
   return Status::OK();
 }
@@ -356,24 +357,7 @@ Status LatController::ComputeControlCommand(
   // Compound discrete matrix with road preview model
   UpdateMatrixCompound();
 
-  // Add gain scheduler for higher speed steering
-  if (FLAGS_enable_gain_scheduler) {
-    matrix_q_updated_(0, 0) =
-        matrix_q_(0, 0) *
-        lat_err_interpolation_->Interpolate(
-            VehicleStateProvider::instance()->linear_velocity());
-    matrix_q_updated_(2, 2) =
-        matrix_q_(2, 2) *
-        heading_err_interpolation_->Interpolate(
-            VehicleStateProvider::instance()->linear_velocity());
-    common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_, matrix_q_updated_,
-                                  matrix_r_, lqr_eps_, lqr_max_iteration_,
-                                  &matrix_k_);
-  } else {
-    common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_, matrix_q_,
-                                  matrix_r_, lqr_eps_, lqr_max_iteration_,
-                                  &matrix_k_);
-  }
+  ComputeLqrGain(VehicleStateProvider::instance()->linear_velocity());
 
   // feedback = - K * state
   // Convert vehicle steer angle from rad to degree and then to steer degree
@@ -505,8 +489,11 @@ void LatController::UpdateState(SimpleLateralDebug *debug) {
 }
 
 void LatController::UpdateMatrix() {
-  const double v = std::max(VehicleStateProvider::instance()->linear_velocity(),
-                            minimum_speed_protection_);
+  UpdateMatrix(VehicleStateProvider::instance()->linear_velocity());
+}
+
+void LatController::UpdateMatrix(const double linear_velocity) {
+  const double v = std::max(linear_velocity, minimum_speed_protection_);
   matrix_a_(1, 1) = matrix_a_coeff_(1, 1) / v;
   matrix_a_(1, 3) = matrix_a_coeff_(1, 3) / v;
   matrix_a_(3, 1) = matrix_a_coeff_(3, 1) / v;
@@ -516,6 +503,83 @@ void LatController::UpdateMatrix() {
                (matrix_i + ts_ * 0.5 * matrix_a_);
 }
 
+void LatController::ComputeLqrGain(const double linear_velocity) {
+  if (lqr_gain_table_.empty() || linear_velocity < 0.0 ||
+      linear_velocity > FLAGS_lqr_gain_table_max_speed) {
+    SolveLqrProblem(linear_velocity, &matrix_k_);
+    return;
+  }
+  const double index = linear_velocity / FLAGS_lqr_gain_table_speed_resolution;
+  const std::size_t lower = std::min(static_cast<std::size_t>(index),
+                                     lqr_gain_table_.size() - 1);
+  if (lower + 1 == lqr_gain_table_.size()) {
+    matrix_k_ = lqr_gain_table_[lower];
+    return;
+  }
+  const double ratio = index - static_cast<double>(lower);
+  matrix_k_ = (1.0 - ratio) * lqr_gain_table_[lower] +
+              ratio * lqr_gain_table_[lower + 1];
+}
+
+void LatController::SolveLqrProblem(const double linear_velocity,
+                                    Matrix *matrix_k) {
+  // Add gain scheduler for higher speed steering
+  const Matrix *matrix_q = &matrix_q_;
+  if (FLAGS_enable_gain_scheduler) {
+    matrix_q_updated_(0, 0) =
+        matrix_q_(0, 0) * lat_err_interpolation_->Interpolate(linear_velocity);
+    matrix_q_updated_(2, 2) =
+        matrix_q_(2, 2) *
+        heading_err_interpolation_->Interpolate(linear_velocity);
+    matrix_q = &matrix_q_updated_;
+  }
+
+  if (preview_window_ == 0) {
+    // The basic lateral model is solved with fixed size matrices.
+    const Eigen::Matrix<double, 4, 4> matrix_adc = matrix_adc_;
+    const Eigen::Matrix<double, 4, 1> matrix_bdc = matrix_bdc_;
+    const Eigen::Matrix<double, 4, 4> matrix_q_fixed = *matrix_q;
+    const Eigen::Matrix<double, 1, 1> matrix_r = matrix_r_;
+    Eigen::Matrix<double, 1, 4> matrix_k_fixed;
+    common::math::SolveLQRProblem(matrix_adc, matrix_bdc, matrix_q_fixed,
+                                  matrix_r, lqr_eps_, lqr_max_iteration_,
+                                  &matrix_k_fixed);
+    *matrix_k = matrix_k_fixed;
+    return;
+  }
+  common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_, *matrix_q, matrix_r_,
+                                lqr_eps_, lqr_max_iteration_, matrix_k);
+}
+
+void LatController::LoadLqrGainTable() {
+  lqr_gain_table_.clear();
+  if (!FLAGS_enable_lqr_gain_table) {
+    return;
+  }
+  if (FLAGS_lqr_gain_table_speed_resolution <= 0.0 ||
+      FLAGS_lqr_gain_table_max_speed <= 0.0) {
+    AERROR << "Invalid lqr gain table speed resolution: "
+           << FLAGS_lqr_gain_table_speed_resolution
+           << ", max speed: " << FLAGS_lqr_gain_table_max_speed;
+    return;
+  }
+  const std::size_t num_speeds =
+      static_cast<std::size_t>(std::ceil(
+          FLAGS_lqr_gain_table_max_speed /
+          FLAGS_lqr_gain_table_speed_resolution)) + 1;
+  lqr_gain_table_.reserve(num_speeds);
+  for (std::size_t i = 0; i < num_speeds; ++i) {
+    const double v = static_cast<double>(i) *
+                     FLAGS_lqr_gain_table_speed_resolution;
+    UpdateMatrix(v);
+    UpdateMatrixCompound();
+    Matrix matrix_k;
+    SolveLqrProblem(v, &matrix_k);
+    lqr_gain_table_.push_back(matrix_k);
+  }
+  AINFO << "Lateral LQR gain table loaded with " << num_speeds << " speeds";
+}
+
 void LatController::UpdateMatrixCompound() {
   // Initialize preview matrix
   matrix_adc_.block(0, 0, basic_state_size_, basic_state_size_) = matrix_ad_;
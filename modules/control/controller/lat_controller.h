@@ -25,6 +25,7 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Eigen/Core"
 
@@ -106,8 +107,21 @@ class LatController : public Controller {
 
   void UpdateMatrix();
 
+  void UpdateMatrix(const double linear_velocity);
+
   void UpdateMatrixCompound();
 
+  /**
+   * @brief compute the LQR gain matrix_k_ at the given speed, from the gain
+   *        table if it covers the speed, otherwise by solving the LQR problem.
+   *        Expects the matrices to be updated for the speed.
+   */
+  void ComputeLqrGain(const double linear_velocity);
+
+  void SolveLqrProblem(const double linear_velocity, Eigen::MatrixXd *matrix_k);
+
+  void LoadLqrGainTable();
+
   double ComputeFeedForward(double ref_curvature) const;
 
   void ComputeLateralErrors(const double x, const double y, const double theta,
@@ -188,6 +202,8 @@ class LatController : public Controller {
   int lqr_max_iteration_ = 0;
   // parameters for lqr solver; threshold for computation
   double lqr_eps_ = 0.0;
+  // lqr gain matrix by speed, sampled every lqr_gain_table_speed_resolution
+  std::vector<Eigen::MatrixXd> lqr_gain_table_;
 
   common::DigitalFilter digital_filter_;
 
@@ -16,6 +16,7 @@
 
 #include "modules/control/controller/lat_controller.h"
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
@@ -46,12 +47,19 @@ class LatControllerTest : public ::testing::Test, LatController {
     FLAGS_v = 3;
     std::string control_conf_file =
         "modules/control/testdata/conf/lincoln.pb.txt";
-    ControlConf control_conf;
     CHECK(apollo::common::util::GetProtoFromFile(control_conf_file,
-                                                 &control_conf));
-    lateral_conf_ = control_conf.lat_controller_conf();
+                                                 &control_conf_));
+    lateral_conf_ = control_conf_.lat_controller_conf();
 
     timestamp_ = Clock::NowInSeconds();
+
+    enable_lqr_gain_table_ = FLAGS_enable_lqr_gain_table;
+    enable_gain_scheduler_ = FLAGS_enable_gain_scheduler;
+  }
+
+  virtual void TearDown() {
+    FLAGS_enable_lqr_gain_table = enable_lqr_gain_table_;
+    FLAGS_enable_gain_scheduler = enable_gain_scheduler_;
   }
 
   void ComputeLateralErrors(const double x, const double y, const double theta,
@@ -62,6 +70,29 @@ class LatControllerTest : public ::testing::Test, LatController {
                                         trajectory_analyzer, debug);
   }
 
+  common::Status Init(const ControlConf *control_conf) {
+    return LatController::Init(control_conf);
+  }
+
+  // The gain used at the speed, from the gain table if it covers the speed.
+  Eigen::MatrixXd LqrGain(const double linear_velocity) {
+    UpdateMatrix(linear_velocity);
+    UpdateMatrixCompound();
+    ComputeLqrGain(linear_velocity);
+    return matrix_k_;
+  }
+
+  // The gain solved at the speed.
+  Eigen::MatrixXd SolvedLqrGain(const double linear_velocity) {
+    UpdateMatrix(linear_velocity);
+    UpdateMatrixCompound();
+    Eigen::MatrixXd matrix_k;
+    SolveLqrProblem(linear_velocity, &matrix_k);
+    return matrix_k;
+  }
+
+  std::size_t lqr_gain_table_size() const { return lqr_gain_table_.size(); }
+
  protected:
   LocalizationPb LoadLocalizaionPb(const std::string &filename) {
     LocalizationPb localization_pb;
@@ -88,9 +119,12 @@ class LatControllerTest : public ::testing::Test, LatController {
     return planning_trajectory_pb;
   }
 
+  ControlConf control_conf_;
   LatControllerConf lateral_conf_;
 
   double timestamp_ = 0.0;
+  bool enable_lqr_gain_table_ = false;
+  bool enable_gain_scheduler_ = false;
 };
 
 TEST_F(LatControllerTest, ComputeLateralErrors) {
@@ -131,5 +165,45 @@ TEST_F(LatControllerTest, ComputeLateralErrors) {
   EXPECT_NEAR(debug->curvature(), matched_kappa_expected, 0.001);
 }
 
+TEST_F(LatControllerTest, LqrGainTable) {
+  FLAGS_enable_lqr_gain_table = true;
+  FLAGS_enable_gain_scheduler = true;
+  ASSERT_TRUE(Init(&control_conf_).ok());
+  EXPECT_EQ(static_cast<std::size_t>(
+                std::ceil(FLAGS_lqr_gain_table_max_speed /
+                          FLAGS_lqr_gain_table_speed_resolution)) +
+                1,
+            lqr_gain_table_size());
+
+  // At the table speeds, the gain is the solved one.
+  for (const int index : {0, 5, 27, 100, 150}) {
+    const double v = index * FLAGS_lqr_gain_table_speed_resolution;
+    const Eigen::MatrixXd matrix_k = LqrGain(v);
+    const Eigen::MatrixXd matrix_k_solved = SolvedLqrGain(v);
+    ASSERT_EQ(matrix_k_solved.cols(), matrix_k.cols());
+    for (int i = 0; i < matrix_k.cols(); ++i) {
+      EXPECT_NEAR(matrix_k_solved(0, i), matrix_k(0, i), 1e-6) << "v: " << v;
+    }
+  }
+
+  // In between, it is interpolated close to the solved one, across the gain
+  // scheduler breakpoints too.
+  for (const double v : {0.55, 3.9, 4.1, 7.33, 12.05, 19.97, 33.3}) {
+    const Eigen::MatrixXd matrix_k = LqrGain(v);
+    const Eigen::MatrixXd matrix_k_solved = SolvedLqrGain(v);
+    EXPECT_LT((matrix_k - matrix_k_solved).norm(),
+              0.01 * matrix_k_solved.norm())
+        << "v: " << v;
+  }
+
+  // Beyond the table, the gain is solved.
+  const double v = FLAGS_lqr_gain_table_max_speed + 5.0;
+  const Eigen::MatrixXd matrix_k = LqrGain(v);
+  const Eigen::MatrixXd matrix_k_solved = SolvedLqrGain(v);
+  for (int i = 0; i < matrix_k.cols(); ++i) {
+    EXPECT_DOUBLE_EQ(matrix_k_solved(0, i), matrix_k(0, i));
+  }
+}
+
 }  // namespace control
 }  // namespace apollo
@@ -347,10 +347,19 @@ Status MPCController::ComputeControlCommand(
   double mpc_start_timestamp = Clock::NowInSeconds();
   double steer_angle_feedback = 0.0;
   double acc_feedback = 0.0;
-  if (common::math::SolveLinearMPC(
-          matrix_ad_, matrix_bd_, matrix_cd_, matrix_q_updated_,
-          matrix_r_updated_, lower_bound, upper_bound, matrix_state_, reference,
-          mpc_eps_, mpc_max_iteration_, &control) != true) {
+  bool mpc_solved = false;
+  if (FLAGS_use_sparse_mpc_solver) {
+    mpc_solved = common::math::SolveSparseLinearMPC(
+        matrix_ad_, matrix_bd_, matrix_cd_, matrix_q_updated_,
+        matrix_r_updated_, lower_bound, upper_bound, matrix_state_, reference,
+        mpc_eps_, mpc_max_iteration_, &control, &mpc_warm_start_);
+  } else {
+    mpc_solved = common::math::SolveLinearMPC(
+        matrix_ad_, matrix_bd_, matrix_cd_, matrix_q_updated_,
+        matrix_r_updated_, lower_bound, upper_bound, matrix_state_, reference,
+        mpc_eps_, mpc_max_iteration_, &control);
+  }
+  if (!mpc_solved) {
     AERROR << "MPC solver failed";
     steer_angle_feedback = 0.0;
     acc_feedback = 0.0;
@@ -458,6 +467,7 @@ Status MPCController::ComputeControlCommand(
 Status MPCController::Reset() {
   previous_heading_error_ = 0.0;
   previous_lateral_error_ = 0.0;
+  mpc_warm_start_ = common::math::SparseMPCWarmStart();
   return Status::OK();
 }
 
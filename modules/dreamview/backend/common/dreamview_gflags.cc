@@ -75,6 +75,15 @@ DEFINE_uint32(max_update_size, 1000000,
 DEFINE_bool(sim_world_with_routing_path, false,
             "Whether the routing_path is included in sim_world proto.");
 
+DEFINE_bool(enable_sim_world_delta, false,
+            "True to answer a frontend acknowledging the sim_world frame it "
+            "holds with the changes since that frame only.");
+
+DEFINE_int32(sim_world_delta_history_size, 10,
+             "Number of the latest sim_world frames kept as the base of a "
+             "delta update. A frontend acknowledging an older frame gets the "
+             "full sim_world.");
+
 DEFINE_string(
     request_timeout_ms, "2000",
     "Timeout for network read and network write operations, in milliseconds.");
@@ -84,6 +93,13 @@ DEFINE_double(voxel_filter_size, 0.3, "VoxelGrid pointcloud filter leaf size");
 DEFINE_double(voxel_filter_height, 0.2,
               "VoxelGrid pointcloud filter leaf height");
 
+DEFINE_bool(enable_voxel_hash_filter, false,
+            "Whether to downsample the pointcloud by voxel hashing straight "
+            "from the PointCloud2 buffer instead of with pcl VoxelGrid.");
+
+DEFINE_int32(voxel_hash_filter_threads, 4,
+             "Number of threads of the voxel hashing pointcloud filter.");
+
 DEFINE_double(system_status_lifetime_seconds, 30,
               "Lifetime of a valid SystemStatus message. It's more like a "
               "replay message if the timestamp is old, where we should ignore "
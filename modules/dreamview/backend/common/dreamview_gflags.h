@@ -51,12 +51,20 @@ DECLARE_uint32(max_update_size);
 
 DECLARE_bool(sim_world_with_routing_path);
 
+DECLARE_bool(enable_sim_world_delta);
+
+DECLARE_int32(sim_world_delta_history_size);
+
 DECLARE_string(request_timeout_ms);
 
 DECLARE_double(voxel_filter_size);
 
 DECLARE_double(voxel_filter_height);
 
+DECLARE_bool(enable_voxel_hash_filter);
+
+DECLARE_int32(voxel_hash_filter_threads);
+
 DECLARE_double(system_status_lifetime_seconds);
 
 #endif  // MODULES_DREAMVIEW_BACKEND_COMMON_DREAMVIEW_GFLAGS_H_
@@ -430,5 +430,49 @@ size_t MapService::CalculateMapHash(const MapElementIds &ids) const {
   return hash_function(ids.DebugString());
 }
 
+nlohmann::json MapElementIdsToJson(const MapElementIds &ids) {
+  // All the fields of MapElementIds are repeated strings.
+  const auto *descriptor = MapElementIds::descriptor();
+  const auto *reflection = MapElementIds::GetReflection();
+  nlohmann::json json = nlohmann::json::object();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const auto *field = descriptor->field(i);
+    const int size = reflection->FieldSize(ids, field);
+    if (size == 0) {
+      continue;
+    }
+    auto &values = json[field->json_name()];
+    for (int j = 0; j < size; ++j) {
+      values.push_back(reflection->GetRepeatedString(ids, field, j));
+    }
+  }
+  return json;
+}
+
+bool JsonToMapElementIds(const nlohmann::json &json, MapElementIds *ids) {
+  if (!json.is_object()) {
+    return false;
+  }
+  const auto *descriptor = MapElementIds::descriptor();
+  const auto *reflection = MapElementIds::GetReflection();
+  ids->Clear();
+  for (auto iter = json.begin(); iter != json.end(); ++iter) {
+    const auto *field = descriptor->FindFieldByName(iter.key());
+    if (field == nullptr) {
+      field = descriptor->FindFieldByCamelcaseName(iter.key());
+    }
+    if (field == nullptr || !iter.value().is_array()) {
+      return false;
+    }
+    for (const auto &value : iter.value()) {
+      if (!value.is_string()) {
+        return false;
+      }
+      reflection->AddString(ids, field, value.get<std::string>());
+    }
+  }
+  return true;
+}
+
 }  // namespace dreamview
 }  // namespace apollo
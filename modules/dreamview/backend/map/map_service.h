@@ -109,6 +109,19 @@ class MapService {
   mutable boost::shared_mutex mutex_;
 };
 
+/**
+ * @brief Converts the MapElementIds to json, keyed by the camelCase field
+ * names as MessageToJsonString() does, without the json string in between.
+ */
+nlohmann::json MapElementIdsToJson(const MapElementIds &ids);
+
+/**
+ * @brief Converts the json form of MapElementIds, keyed by either the
+ * camelCase or the original field names, back to the proto.
+ * @return False if the json has an unknown field or a non-string id.
+ */
+bool JsonToMapElementIds(const nlohmann::json &json, MapElementIds *ids);
+
 }  // namespace dreamview
 }  // namespace apollo
 
@@ -96,5 +96,29 @@ TEST_F(MapServiceTest, CalculateMapHash) {
   EXPECT_EQ(7655793271563537204, hash_code);
 }
 
+TEST(MapElementIdsJsonTest, RoundTrip) {
+  MapElementIds ids;
+  ids.add_lane("l1");
+  ids.add_lane("l2");
+  ids.add_stop_sign("s1");
+
+  const nlohmann::json json = MapElementIdsToJson(ids);
+  EXPECT_EQ(nlohmann::json::parse(R"({"lane": ["l1", "l2"],
+                                      "stopSign": ["s1"]})"),
+            json);
+
+  MapElementIds parsed;
+  EXPECT_TRUE(JsonToMapElementIds(json, &parsed));
+  EXPECT_EQ(ids.DebugString(), parsed.DebugString());
+
+  EXPECT_TRUE(JsonToMapElementIds(
+      nlohmann::json::parse(R"({"stop_sign": ["s1"]})"), &parsed));
+  EXPECT_EQ("s1", parsed.stop_sign(0));
+  EXPECT_FALSE(JsonToMapElementIds(
+      nlohmann::json::parse(R"({"lanes": ["l1"]})"), &parsed));
+  EXPECT_FALSE(JsonToMapElementIds(nlohmann::json::parse(R"({"lane": [1]})"),
+                                   &parsed));
+}
+
 }  // namespace dreamview
 }  // namespace apollo
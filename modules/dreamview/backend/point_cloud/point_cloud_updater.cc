@@ -16,15 +16,16 @@
 
 #include "modules/dreamview/backend/point_cloud/point_cloud_updater.h"
 
+#include <string>
 #include <utility>
 
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/log.h"
 #include "modules/common/time/time.h"
 #include "modules/dreamview/backend/common/dreamview_gflags.h"
-#include "modules/dreamview/proto/point_cloud.pb.h"
 #include "pcl/filters/voxel_grid.h"
 #include "pcl_conversions/pcl_conversions.h"
+#include "sensor_msgs/PointField.h"
 #include "third_party/json/json.hpp"
 
 namespace apollo {
@@ -34,10 +35,70 @@ using apollo::common::adapter::AdapterManager;
 using apollo::common::time::Clock;
 using apollo::localization::LocalizationEstimate;
 using sensor_msgs::PointCloud2;
+using sensor_msgs::PointField;
 using Json = nlohmann::json;
 
+namespace {
+
+// TODO(unacao): velodyne height should be updated by hmi store
+// upon vehicle change.
+constexpr float kVelodyneHeight = 1.91f;
+
+// Finds the little-endian float32 x, y and z fields of the point cloud.
+bool GetPointCloudLayout(const PointCloud2 &point_cloud,
+                         PointCloudLayout *layout) {
+  if (point_cloud.is_bigendian) {
+    AERROR << "Big-endian point cloud is not supported.";
+    return false;
+  }
+  int found_fields = 0;
+  for (const auto &field : point_cloud.fields) {
+    size_t *offset = nullptr;
+    if (field.name == "x") {
+      offset = &layout->x_offset;
+    } else if (field.name == "y") {
+      offset = &layout->y_offset;
+    } else if (field.name == "z") {
+      offset = &layout->z_offset;
+    } else {
+      continue;
+    }
+    if (field.datatype != PointField::FLOAT32) {
+      AERROR << "Point cloud field " << field.name << " is not float32.";
+      return false;
+    }
+    *offset = field.offset;
+    ++found_fields;
+  }
+  if (found_fields != 3) {
+    AERROR << "Point cloud has no x, y and z fields.";
+    return false;
+  }
+  if (point_cloud.data.size() <
+      static_cast<size_t>(point_cloud.height) * point_cloud.row_step) {
+    AERROR << "Point cloud data size " << point_cloud.data.size()
+           << " is smaller than its height " << point_cloud.height
+           << " times its row step " << point_cloud.row_step;
+    return false;
+  }
+  layout->data = point_cloud.data.data();
+  layout->width = point_cloud.width;
+  layout->height = point_cloud.height;
+  layout->point_step = point_cloud.point_step;
+  layout->row_step = point_cloud.row_step;
+  return true;
+}
+
+}  // namespace
+
 PointCloudUpdater::PointCloudUpdater(WebSocketHandler *websocket)
-    : websocket_(websocket), point_cloud_str_(""), future_ready_(true) {
+    : websocket_(websocket),
+      point_cloud_str_(""),
+      future_ready_(true),
+      dropped_frames_(0),
+      downsampler_(FLAGS_voxel_filter_size, FLAGS_voxel_filter_height,
+                   FLAGS_voxel_hash_filter_threads),
+      downsampler_thread_(new ctpl::thread_pool(1)) {
   RegisterMessageHandlers();
 }
 
@@ -97,7 +158,7 @@ void PointCloudUpdater::Start() {
 }
 
 void PointCloudUpdater::Stop() {
-  if (enabled_) {
+  if (async_future_.valid()) {
     async_future_.wait();
   }
 }
@@ -111,6 +172,13 @@ void PointCloudUpdater::UpdatePointCloud(const PointCloud2 &point_cloud) {
   // Check if last filter process has finished before processing new data.
   if (future_ready_) {
     future_ready_ = false;
+    if (FLAGS_enable_voxel_hash_filter) {
+      // Only the buffer is copied here, it keeps its capacity across frames.
+      pending_point_cloud_ = point_cloud;
+      async_future_ = downsampler_thread_->push(
+          [this](int) { DownsamplePointCloud(); });
+      return;
+    }
     // transform from ros to pcl
     pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr(
         new pcl::PointCloud<pcl::PointXYZ>);
@@ -119,11 +187,14 @@ void PointCloudUpdater::UpdatePointCloud(const PointCloud2 &point_cloud) {
         std::async(std::launch::async, &PointCloudUpdater::FilterPointCloud,
                    this, pcl_ptr);
     async_future_ = std::move(f);
+  } else {
+    ++dropped_frames_;
   }
 }
 
 void PointCloudUpdater::FilterPointCloud(
     pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr) {
+  const double start_time = Clock::NowInSeconds();
   pcl::VoxelGrid<pcl::PointXYZ> voxel_grid;
   voxel_grid.setInputCloud(pcl_ptr);
   voxel_grid.setLeafSize(FLAGS_voxel_filter_size, FLAGS_voxel_filter_size,
@@ -131,7 +202,6 @@ void PointCloudUpdater::FilterPointCloud(
   pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_filtered_ptr(
     new pcl::PointCloud<pcl::PointXYZ>);
   voxel_grid.filter(*pcl_filtered_ptr);
-  AINFO << "filtered point cloud data size: " << pcl_filtered_ptr->size();
 
   PointCloud point_cloud_pb;
   for (size_t idx = 0; idx < pcl_filtered_ptr->size(); ++idx) {
@@ -139,9 +209,7 @@ void PointCloudUpdater::FilterPointCloud(
     if (!std::isnan(pt.x) && !std::isnan(pt.y) && !std::isnan(pt.z)) {
       point_cloud_pb.add_num(pt.x);
       point_cloud_pb.add_num(pt.y);
-      // TODO(unacao): velodyne height should be updated by hmi store
-      // upon vehicle change.
-      point_cloud_pb.add_num(pt.z + 1.91f);
+      point_cloud_pb.add_num(pt.z + kVelodyneHeight);
     }
   }
   {
@@ -149,6 +217,38 @@ void PointCloudUpdater::FilterPointCloud(
     point_cloud_pb.SerializeToString(&point_cloud_str_);
     future_ready_ = true;
   }
+  AINFO << "filtered point cloud data size: " << pcl_filtered_ptr->size()
+        << ", processing time: " << (Clock::NowInSeconds() - start_time) * 1000
+        << " ms, dropped frames: " << dropped_frames_;
+}
+
+void PointCloudUpdater::DownsamplePointCloud() {
+  const double start_time = Clock::NowInSeconds();
+  PointCloudLayout layout;
+  if (!GetPointCloudLayout(pending_point_cloud_, &layout) ||
+      !downsampler_.Downsample(layout, &filtered_points_)) {
+    future_ready_ = true;
+    return;
+  }
+
+  auto *num = point_cloud_pb_.mutable_num();
+  num->Resize(static_cast<int>(filtered_points_.size()), 0.0f);
+  float *data = num->mutable_data();
+  for (size_t i = 0; i + 2 < filtered_points_.size(); i += 3) {
+    data[i] = filtered_points_[i];
+    data[i + 1] = filtered_points_[i + 1];
+    data[i + 2] = filtered_points_[i + 2] + kVelodyneHeight;
+  }
+  std::string point_cloud_str;
+  point_cloud_pb_.SerializeToString(&point_cloud_str);
+  {
+    boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
+    point_cloud_str_.swap(point_cloud_str);
+    future_ready_ = true;
+  }
+  AINFO << "filtered point cloud data size: " << filtered_points_.size() / 3
+        << ", processing time: " << (Clock::NowInSeconds() - start_time) * 1000
+        << " ms, dropped frames: " << dropped_frames_;
 }
 
 void PointCloudUpdater::UpdateLocalizationTime(
@@ -22,15 +22,21 @@
 #define MODULES_DREAMVIEW_BACKEND_POINT_CLOUD_POINT_CLOUD_UPDATER_H_
 
 #include <atomic>
+#include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "boost/thread/locks.hpp"
 #include "boost/thread/shared_mutex.hpp"
+#include "ctpl/ctpl_stl.h"
 
 #include "modules/common/log.h"
 #include "modules/common/util/string_util.h"
 #include "modules/dreamview/backend/handlers/websocket_handler.h"
+#include "modules/dreamview/backend/point_cloud/voxel_hash_downsampler.h"
+#include "modules/dreamview/proto/point_cloud.pb.h"
 #include "modules/localization/proto/localization.pb.h"
 #include "pcl/point_cloud.h"
 #include "pcl/point_types.h"
@@ -71,6 +77,10 @@ class PointCloudUpdater {
 
   void FilterPointCloud(pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr);
 
+  // Downsamples pending_point_cloud_ by voxel hashing, straight from its
+  // buffer.
+  void DownsamplePointCloud();
+
   void UpdateLocalizationTime(
       const apollo::localization::LocalizationEstimate &localization);
 
@@ -87,6 +97,19 @@ class PointCloudUpdater {
   std::future<void> async_future_;
   std::atomic<bool> future_ready_;
 
+  // Frames received while the previous one is still being filtered.
+  std::atomic<uint64_t> dropped_frames_;
+
+  // The voxel hashing filter runs on its own thread, with the buffers kept
+  // across frames. The callback copies the frame into pending_point_cloud_
+  // only while no filter is in flight.
+  VoxelHashDownsampler downsampler_;
+  sensor_msgs::PointCloud2 pending_point_cloud_;
+  std::vector<float> filtered_points_;
+  PointCloud point_cloud_pb_;
+  // Declared after what it works on, so it is joined first.
+  std::unique_ptr<ctpl::thread_pool> downsampler_thread_;
+
   double last_point_cloud_time_ = 0.0;
   double last_localization_time_ = 0.0;
 };
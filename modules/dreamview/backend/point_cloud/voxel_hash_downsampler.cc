@@ -0,0 +1,212 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/point_cloud/voxel_hash_downsampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+
+#include "modules/common/log.h"
+
+namespace apollo {
+namespace dreamview {
+
+namespace {
+
+// Voxel indices take 21 bits per axis in the key.
+constexpr int64_t kMaxVoxelIndex = 1 << 20;
+constexpr uint64_t kEmptyKey = ~0ULL;
+
+uint64_t MixKey(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+bool VoxelKey(const float x, const float y, const float z,
+              const float inverse_leaf_size, const float inverse_leaf_height,
+              uint64_t *key) {
+  if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) {
+    return false;
+  }
+  const float fx = std::floor(x * inverse_leaf_size);
+  const float fy = std::floor(y * inverse_leaf_size);
+  const float fz = std::floor(z * inverse_leaf_height);
+  if (std::fabs(fx) >= kMaxVoxelIndex || std::fabs(fy) >= kMaxVoxelIndex ||
+      std::fabs(fz) >= kMaxVoxelIndex) {
+    return false;
+  }
+  *key = (static_cast<uint64_t>(static_cast<int64_t>(fx) + kMaxVoxelIndex)
+          << 42) |
+         (static_cast<uint64_t>(static_cast<int64_t>(fy) + kMaxVoxelIndex)
+          << 21) |
+         static_cast<uint64_t>(static_cast<int64_t>(fz) + kMaxVoxelIndex);
+  return true;
+}
+
+float ReadFloat(const uint8_t *data) {
+  float value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+VoxelHashDownsampler::VoxelHashDownsampler(float leaf_size, float leaf_height,
+                                           int num_threads)
+    : inverse_leaf_size_(1.0f / leaf_size),
+      inverse_leaf_height_(1.0f / leaf_height),
+      num_threads_(std::max(num_threads, 1)),
+      buckets_(num_threads_, std::vector<std::vector<Entry>>(num_threads_)),
+      shards_(num_threads_) {
+  if (num_threads_ > 1) {
+    thread_pool_.reset(new ctpl::thread_pool(num_threads_ - 1));
+  }
+}
+
+bool VoxelHashDownsampler::Downsample(const PointCloudLayout &layout,
+                                      std::vector<float> *points) {
+  points->clear();
+  const size_t num_points = layout.width * layout.height;
+  if (num_points == 0) {
+    return true;
+  }
+  const size_t max_offset =
+      std::max({layout.x_offset, layout.y_offset, layout.z_offset});
+  if (layout.data == nullptr || max_offset + sizeof(float) > layout.point_step ||
+      layout.width * layout.point_step > layout.row_step) {
+    AERROR << "Invalid point cloud layout, point_step: " << layout.point_step
+           << " row_step: " << layout.row_step;
+    return false;
+  }
+
+  // Split the points, not the rows, as most clouds are a single row.
+  std::vector<std::future<void>> futures;
+  for (int i = 1; i < num_threads_; ++i) {
+    const size_t begin = num_points * i / num_threads_;
+    const size_t end = num_points * (i + 1) / num_threads_;
+    futures.push_back(thread_pool_->push([this, &layout, begin, end, i](int) {
+      HashPoints(layout, begin, end, &buckets_[i]);
+    }));
+  }
+  HashPoints(layout, 0, num_points / num_threads_, &buckets_[0]);
+  for (auto &future : futures) {
+    future.get();
+  }
+
+  futures.clear();
+  for (int i = 1; i < num_threads_; ++i) {
+    futures.push_back(thread_pool_->push([this, i](int) { ReduceShard(i); }));
+  }
+  ReduceShard(0);
+  for (auto &future : futures) {
+    future.get();
+  }
+
+  size_t size = 0;
+  for (const Shard &shard : shards_) {
+    size += shard.points.size();
+  }
+  points->reserve(size);
+  for (const Shard &shard : shards_) {
+    points->insert(points->end(), shard.points.begin(), shard.points.end());
+  }
+  return true;
+}
+
+void VoxelHashDownsampler::HashPoints(
+    const PointCloudLayout &layout, size_t begin, size_t end,
+    std::vector<std::vector<Entry>> *buckets) {
+  for (auto &bucket : *buckets) {
+    bucket.clear();
+  }
+  size_t row = begin / layout.width;
+  size_t column = begin % layout.width;
+  const uint8_t *point =
+      layout.data + row * layout.row_step + column * layout.point_step;
+  for (size_t i = begin; i < end; ++i) {
+    const float x = ReadFloat(point + layout.x_offset);
+    const float y = ReadFloat(point + layout.y_offset);
+    const float z = ReadFloat(point + layout.z_offset);
+    uint64_t key = 0;
+    if (VoxelKey(x, y, z, inverse_leaf_size_, inverse_leaf_height_, &key)) {
+      (*buckets)[MixKey(key) % num_threads_].push_back({key, x, y, z});
+    }
+    if (++column == layout.width) {
+      column = 0;
+      ++row;
+      point = layout.data + row * layout.row_step;
+    } else {
+      point += layout.point_step;
+    }
+  }
+}
+
+void VoxelHashDownsampler::ReduceShard(int shard_index) {
+  Shard &shard = shards_[shard_index];
+  size_t num_entries = 0;
+  for (const auto &thread_buckets : buckets_) {
+    num_entries += thread_buckets[shard_index].size();
+  }
+  size_t capacity = 16;
+  while (capacity < 2 * num_entries) {
+    capacity <<= 1;
+  }
+  const size_t mask = capacity - 1;
+  shard.keys.assign(capacity, kEmptyKey);
+  shard.indices.resize(capacity);
+  shard.voxels.clear();
+
+  // Voxels are kept in the order they are first seen, so the output does not
+  // depend on the table size.
+  for (const auto &thread_buckets : buckets_) {
+    for (const Entry &entry : thread_buckets[shard_index]) {
+      size_t slot = (MixKey(entry.key) / num_threads_) & mask;
+      while (shard.keys[slot] != kEmptyKey && shard.keys[slot] != entry.key) {
+        slot = (slot + 1) & mask;
+      }
+      if (shard.keys[slot] == kEmptyKey) {
+        shard.keys[slot] = entry.key;
+        shard.indices[slot] = static_cast<uint32_t>(shard.voxels.size());
+        shard.voxels.push_back({entry.x, entry.y, entry.z, 1});
+      } else {
+        Voxel &voxel = shard.voxels[shard.indices[slot]];
+        voxel.x += entry.x;
+        voxel.y += entry.y;
+        voxel.z += entry.z;
+        ++voxel.count;
+      }
+    }
+  }
+
+  shard.points.resize(shard.voxels.size() * 3);
+  float *point = shard.points.data();
+  for (const Voxel &voxel : shard.voxels) {
+    const float inverse_count = 1.0f / static_cast<float>(voxel.count);
+    point[0] = voxel.x * inverse_count;
+    point[1] = voxel.y * inverse_count;
+    point[2] = voxel.z * inverse_count;
+    point += 3;
+  }
+}
+
+}  // namespace dreamview
+}  // namespace apollo
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ */
+
+#ifndef MODULES_DREAMVIEW_BACKEND_POINT_CLOUD_VOXEL_HASH_DOWNSAMPLER_H_
+#define MODULES_DREAMVIEW_BACKEND_POINT_CLOUD_VOXEL_HASH_DOWNSAMPLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ctpl/ctpl_stl.h"
+
+/**
+ * @namespace apollo::dreamview
+ * @brief apollo::dreamview
+ */
+namespace apollo {
+namespace dreamview {
+
+/**
+ * @struct PointCloudLayout
+ * @brief Where the coordinates of the points are in a raw point cloud
+ * buffer, as described by the fields of a PointCloud2. The coordinates are
+ * little-endian float32.
+ */
+struct PointCloudLayout {
+  const uint8_t *data = nullptr;
+  size_t width = 0;
+  size_t height = 0;
+  size_t point_step = 0;
+  size_t row_step = 0;
+  size_t x_offset = 0;
+  size_t y_offset = 0;
+  size_t z_offset = 0;
+};
+
+/**
+ * @class VoxelHashDownsampler
+ * @brief Downsamples a point cloud to the centroids of its occupied voxels,
+ * like pcl::VoxelGrid, reading the points straight from the raw buffer.
+ *
+ * The points are split across threads, each thread hashes its points to
+ * voxels and buckets them by shard, then each thread accumulates the
+ * centroids of one shard in an open-addressing table. The threads and all
+ * buffers are kept across calls.
+ */
+class VoxelHashDownsampler {
+ public:
+  /**
+   * @brief Constructor.
+   * @param leaf_size voxel size along x and y.
+   * @param leaf_height voxel size along z.
+   * @param num_threads number of threads, including the calling one.
+   */
+  VoxelHashDownsampler(float leaf_size, float leaf_height, int num_threads);
+
+  /**
+   * @brief Downsamples the points of the buffer. Points that are not finite
+   * or too far away for the voxel index are skipped.
+   * @param layout the buffer and the layout of its points.
+   * @param points the voxel centroids as packed x, y, z.
+   * @return False if the layout does not fit the buffer description.
+   */
+  bool Downsample(const PointCloudLayout &layout, std::vector<float> *points);
+
+ private:
+  struct Entry {
+    uint64_t key;
+    float x;
+    float y;
+    float z;
+  };
+
+  struct Voxel {
+    float x;
+    float y;
+    float z;
+    uint32_t count;
+  };
+
+  struct Shard {
+    // Open-addressing table from voxel key to the index in voxels.
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> indices;
+    std::vector<Voxel> voxels;
+    std::vector<float> points;
+  };
+
+  // Hashes the points [begin, end) into the buckets of a thread.
+  void HashPoints(const PointCloudLayout &layout, size_t begin, size_t end,
+                  std::vector<std::vector<Entry>> *buckets);
+
+  // Accumulates the centroids of a shard from the buckets of all threads.
+  void ReduceShard(int shard_index);
+
+  const float inverse_leaf_size_;
+  const float inverse_leaf_height_;
+  const int num_threads_;
+
+  // buckets_[thread][shard]
+  std::vector<std::vector<std::vector<Entry>>> buckets_;
+  std::vector<Shard> shards_;
+
+  // The threads besides the calling one.
+  std::unique_ptr<ctpl::thread_pool> thread_pool_;
+};
+
+}  // namespace dreamview
+}  // namespace apollo
+
+#endif  // MODULES_DREAMVIEW_BACKEND_POINT_CLOUD_VOXEL_HASH_DOWNSAMPLER_H_
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/point_cloud/voxel_hash_downsampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace dreamview {
+
+namespace {
+
+const float kLeafSize = 0.3f;
+const float kLeafHeight = 0.2f;
+
+// x, y, z and intensity, with rows padded by one point.
+const size_t kPointStep = 16;
+
+using Point = std::array<float, 3>;
+
+std::vector<uint8_t> MakeBuffer(const std::vector<Point> &points,
+                                const size_t width, PointCloudLayout *layout) {
+  layout->width = width;
+  layout->height = points.size() / width;
+  layout->point_step = kPointStep;
+  layout->row_step = (width + 1) * kPointStep;
+  layout->x_offset = 0;
+  layout->y_offset = 4;
+  layout->z_offset = 8;
+  std::vector<uint8_t> buffer(layout->height * layout->row_step, 0xff);
+  for (size_t i = 0; i < points.size(); ++i) {
+    uint8_t *point = buffer.data() + (i / width) * layout->row_step +
+                     (i % width) * kPointStep;
+    std::memcpy(point, points[i].data(), sizeof(float) * 3);
+  }
+  layout->data = buffer.data();
+  return buffer;
+}
+
+std::vector<Point> MakePoints(const size_t num_points) {
+  std::mt19937 random_engine(7);
+  std::uniform_real_distribution<float> uniform(-20.0f, 20.0f);
+  std::vector<Point> points;
+  for (size_t i = 0; i < num_points; ++i) {
+    points.push_back({uniform(random_engine), uniform(random_engine),
+                      uniform(random_engine) * 0.1f});
+  }
+  points[3][0] = std::numeric_limits<float>::quiet_NaN();
+  points[5][2] = std::numeric_limits<float>::infinity();
+  return points;
+}
+
+// The voxel centroids, sorted.
+std::vector<Point> ReferenceDownsample(const std::vector<Point> &points) {
+  std::map<std::tuple<int, int, int>, std::array<double, 4>> voxels;
+  for (const Point &point : points) {
+    if (!std::isfinite(point[0]) || !std::isfinite(point[1]) ||
+        !std::isfinite(point[2])) {
+      continue;
+    }
+    auto &voxel = voxels[std::make_tuple(
+        static_cast<int>(std::floor(point[0] * (1.0f / kLeafSize))),
+        static_cast<int>(std::floor(point[1] * (1.0f / kLeafSize))),
+        static_cast<int>(std::floor(point[2] * (1.0f / kLeafHeight))))];
+    voxel[0] += point[0];
+    voxel[1] += point[1];
+    voxel[2] += point[2];
+    voxel[3] += 1.0;
+  }
+  std::vector<Point> centroids;
+  for (const auto &voxel : voxels) {
+    const auto &sum = voxel.second;
+    centroids.push_back({static_cast<float>(sum[0] / sum[3]),
+                         static_cast<float>(sum[1] / sum[3]),
+                         static_cast<float>(sum[2] / sum[3])});
+  }
+  std::sort(centroids.begin(), centroids.end());
+  return centroids;
+}
+
+std::vector<Point> SortedPoints(const std::vector<float> &packed) {
+  std::vector<Point> points;
+  for (size_t i = 0; i + 2 < packed.size(); i += 3) {
+    points.push_back({packed[i], packed[i + 1], packed[i + 2]});
+  }
+  std::sort(points.begin(), points.end());
+  return points;
+}
+
+}  // namespace
+
+TEST(VoxelHashDownsamplerTest, SameAsReference) {
+  const std::vector<Point> points = MakePoints(20000);
+  const std::vector<Point> expected = ReferenceDownsample(points);
+
+  for (const size_t width : {points.size(), size_t(100)}) {
+    PointCloudLayout layout;
+    const std::vector<uint8_t> buffer = MakeBuffer(points, width, &layout);
+    for (const int num_threads : {1, 4}) {
+      VoxelHashDownsampler downsampler(kLeafSize, kLeafHeight, num_threads);
+      std::vector<float> packed;
+      // The second call reuses the buffers of the first one.
+      for (int i = 0; i < 2; ++i) {
+        EXPECT_TRUE(downsampler.Downsample(layout, &packed));
+        const std::vector<Point> actual = SortedPoints(packed);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t j = 0; j < expected.size(); ++j) {
+          EXPECT_NEAR(expected[j][0], actual[j][0], 1e-4);
+          EXPECT_NEAR(expected[j][1], actual[j][1], 1e-4);
+          EXPECT_NEAR(expected[j][2], actual[j][2], 1e-4);
+        }
+      }
+    }
+  }
+}
+
+TEST(VoxelHashDownsamplerTest, InvalidLayout) {
+  const std::vector<Point> points = MakePoints(10);
+  PointCloudLayout layout;
+  const std::vector<uint8_t> buffer = MakeBuffer(points, 5, &layout);
+  VoxelHashDownsampler downsampler(kLeafSize, kLeafHeight, 2);
+  std::vector<float> packed = {1.0f};
+
+  layout.z_offset = kPointStep - 2;
+  EXPECT_FALSE(downsampler.Downsample(layout, &packed));
+  EXPECT_TRUE(packed.empty());
+
+  layout.z_offset = 8;
+  layout.row_step = 4 * kPointStep;
+  EXPECT_FALSE(downsampler.Downsample(layout, &packed));
+
+  layout.height = 0;
+  EXPECT_TRUE(downsampler.Downsample(layout, &packed));
+  EXPECT_TRUE(packed.empty());
+}
+
+}  // namespace dreamview
+}  // namespace apollo
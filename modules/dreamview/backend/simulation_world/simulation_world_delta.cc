@@ -0,0 +1,309 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/simulation_world/simulation_world_delta.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/util/message_differencer.h"
+
+#include "modules/common/log.h"
+
+namespace apollo {
+namespace dreamview {
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+using google::protobuf::util::MessageDifferencer;
+
+namespace {
+
+bool HasField(const Message &message, const FieldDescriptor *field) {
+  const Reflection *reflection = message.GetReflection();
+  return field->is_repeated() ? reflection->FieldSize(message, field) > 0
+                              : reflection->HasField(message, field);
+}
+
+// Copies one field of a message into an empty field of another message of
+// the same type.
+void CopyField(const Message &from, const FieldDescriptor *field,
+               Message *to) {
+  const Reflection *reflection = from.GetReflection();
+  if (!field->is_repeated()) {
+    switch (field->cpp_type()) {
+#define COPY_SINGULAR(CPPTYPE, METHOD)                    \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                \
+    reflection->Set##METHOD(                              \
+        to, field, reflection->Get##METHOD(from, field)); \
+    break;
+      COPY_SINGULAR(INT32, Int32)
+      COPY_SINGULAR(INT64, Int64)
+      COPY_SINGULAR(UINT32, UInt32)
+      COPY_SINGULAR(UINT64, UInt64)
+      COPY_SINGULAR(DOUBLE, Double)
+      COPY_SINGULAR(FLOAT, Float)
+      COPY_SINGULAR(BOOL, Bool)
+      COPY_SINGULAR(ENUM, Enum)
+      COPY_SINGULAR(STRING, String)
+#undef COPY_SINGULAR
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        reflection->MutableMessage(to, field)
+            ->CopyFrom(reflection->GetMessage(from, field));
+        break;
+    }
+    return;
+  }
+
+  const int size = reflection->FieldSize(from, field);
+  for (int i = 0; i < size; ++i) {
+    switch (field->cpp_type()) {
+#define COPY_REPEATED(CPPTYPE, METHOD)                               \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                           \
+    reflection->Add##METHOD(                                         \
+        to, field, reflection->GetRepeated##METHOD(from, field, i)); \
+    break;
+      COPY_REPEATED(INT32, Int32)
+      COPY_REPEATED(INT64, Int64)
+      COPY_REPEATED(UINT32, UInt32)
+      COPY_REPEATED(UINT64, UInt64)
+      COPY_REPEATED(DOUBLE, Double)
+      COPY_REPEATED(FLOAT, Float)
+      COPY_REPEATED(BOOL, Bool)
+      COPY_REPEATED(ENUM, Enum)
+      COPY_REPEATED(STRING, String)
+#undef COPY_REPEATED
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        reflection->AddMessage(to, field)
+            ->CopyFrom(reflection->GetRepeatedMessage(from, field, i));
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+SimulationWorldDeltaEncoder::SimulationWorldDeltaEncoder(size_t history_size)
+    : history_size_(std::max<size_t>(history_size, 1)) {}
+
+uint32_t SimulationWorldDeltaEncoder::AddFrame(
+    std::shared_ptr<const SimulationWorld> world) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint32_t frame_id = next_frame_id_++;
+  if (next_frame_id_ == 0) {
+    // 0 stands for no frame.
+    next_frame_id_ = 1;
+  }
+  frames_.push_back({frame_id, std::move(world)});
+  while (frames_.size() > history_size_) {
+    frames_.pop_front();
+  }
+  encoded_frames_.clear();
+  return frame_id;
+}
+
+void SimulationWorldDeltaEncoder::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  frames_.clear();
+  encoded_frames_.clear();
+}
+
+uint32_t SimulationWorldDeltaEncoder::latest_frame_id() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frames_.empty() ? 0 : frames_.back().id;
+}
+
+bool SimulationWorldDeltaEncoder::Encode(uint32_t base_frame_id,
+                                         bool with_planning_data,
+                                         SimulationWorldDelta *delta) const {
+  Frame latest;
+  std::shared_ptr<const SimulationWorld> base;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frames_.empty()) {
+      return false;
+    }
+    latest = frames_.back();
+    if (base_frame_id != 0) {
+      for (const auto &frame : frames_) {
+        if (frame.id == base_frame_id) {
+          base = frame.world;
+          break;
+        }
+      }
+    }
+  }
+
+  delta->Clear();
+  delta->set_frame_id(latest.id);
+  SimulationWorld *world = delta->mutable_world();
+  if (base == nullptr) {
+    *world = *latest.world;
+    if (!with_planning_data) {
+      world->clear_planning_data();
+    }
+    return true;
+  }
+  delta->set_base_frame_id(base_frame_id);
+  if (!with_planning_data) {
+    // The frontend may hold planning data from a frame sent with it.
+    delta->add_cleared_field(SimulationWorld::kPlanningDataFieldNumber);
+  }
+
+  // Top-level fields.
+  const auto *descriptor = SimulationWorld::descriptor();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor *field = descriptor->field(i);
+    if (field->number() == SimulationWorld::kObjectFieldNumber ||
+        (!with_planning_data &&
+         field->number() == SimulationWorld::kPlanningDataFieldNumber)) {
+      continue;
+    }
+    const bool in_latest = HasField(*latest.world, field);
+    const bool in_base = HasField(*base, field);
+    if (!in_latest) {
+      if (in_base) {
+        delta->add_cleared_field(field->number());
+      }
+      continue;
+    }
+    if (in_base) {
+      MessageDifferencer differencer;
+      if (differencer.CompareWithFields(*latest.world, *base, {field},
+                                        {field})) {
+        continue;
+      }
+    }
+    CopyField(*latest.world, field, world);
+  }
+
+  // Objects, by id.
+  std::unordered_map<std::string, const Object *> base_objects;
+  for (const auto &object : base->object()) {
+    base_objects.emplace(object.id(), &object);
+  }
+  std::unordered_set<std::string> latest_object_ids;
+  for (const auto &object : latest.world->object()) {
+    latest_object_ids.insert(object.id());
+    auto iter = base_objects.find(object.id());
+    if (iter == base_objects.end() ||
+        !MessageDifferencer::Equals(object, *iter->second)) {
+      *world->add_object() = object;
+    }
+  }
+  for (const auto &object : base->object()) {
+    if (latest_object_ids.count(object.id()) == 0) {
+      delta->add_removed_object_id(object.id());
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<const std::string> SimulationWorldDeltaEncoder::EncodeToString(
+    uint32_t base_frame_id, bool with_planning_data,
+    uint32_t *frame_id) const {
+  const auto key = std::make_pair(base_frame_id, with_planning_data);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frames_.empty()) {
+      return nullptr;
+    }
+    auto iter = encoded_frames_.find(key);
+    if (iter != encoded_frames_.end()) {
+      *frame_id = frames_.back().id;
+      return iter->second;
+    }
+  }
+
+  SimulationWorldDelta delta;
+  if (!Encode(base_frame_id, with_planning_data, &delta)) {
+    return nullptr;
+  }
+  auto encoded = std::make_shared<std::string>();
+  delta.SerializeToString(encoded.get());
+  *frame_id = delta.frame_id();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Unless a newer frame came in meanwhile.
+  if (!frames_.empty() && frames_.back().id == delta.frame_id()) {
+    encoded_frames_.emplace(key, encoded);
+  }
+  return encoded;
+}
+
+void ApplySimulationWorldDelta(const SimulationWorldDelta &delta,
+                               const SimulationWorld &base,
+                               SimulationWorld *world) {
+  if (!delta.has_base_frame_id()) {
+    *world = delta.world();
+    return;
+  }
+
+  const auto *descriptor = SimulationWorld::descriptor();
+  const Reflection *reflection = SimulationWorld::GetReflection();
+  *world = base;
+  for (const int field_number : delta.cleared_field()) {
+    const FieldDescriptor *field = descriptor->FindFieldByNumber(field_number);
+    if (field == nullptr) {
+      AWARN << "Unknown SimulationWorld field " << field_number;
+      continue;
+    }
+    reflection->ClearField(world, field);
+  }
+
+  SimulationWorld changes = delta.world();
+  std::unordered_map<std::string, const Object *> changed_objects;
+  for (const auto &object : changes.object()) {
+    changed_objects.emplace(object.id(), &object);
+  }
+  const std::unordered_set<std::string> removed_object_ids(
+      delta.removed_object_id().begin(), delta.removed_object_id().end());
+  google::protobuf::RepeatedPtrField<Object> objects;
+  for (const auto &object : base.object()) {
+    if (removed_object_ids.count(object.id()) > 0) {
+      continue;
+    }
+    auto iter = changed_objects.find(object.id());
+    if (iter == changed_objects.end()) {
+      *objects.Add() = object;
+    } else {
+      *objects.Add() = *iter->second;
+      changed_objects.erase(iter);
+    }
+  }
+  for (const auto &object : changes.object()) {
+    if (changed_objects.count(object.id()) > 0) {
+      *objects.Add() = object;
+    }
+  }
+  world->mutable_object()->Swap(&objects);
+  changes.clear_object();
+
+  std::vector<const FieldDescriptor *> changed_fields;
+  reflection->ListFields(changes, &changed_fields);
+  for (const FieldDescriptor *field : changed_fields) {
+    reflection->ClearField(world, field);
+  }
+  world->MergeFrom(changes);
+}
+
+}  // namespace dreamview
+}  // namespace apollo
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ */
+
+#ifndef MODULES_DREAMVIEW_BACKEND_SIMULATION_WORLD_SIMULATION_WORLD_DELTA_H_
+#define MODULES_DREAMVIEW_BACKEND_SIMULATION_WORLD_SIMULATION_WORLD_DELTA_H_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "modules/dreamview/proto/simulation_world.pb.h"
+
+/**
+ * @namespace apollo::dreamview
+ * @brief apollo::dreamview
+ */
+namespace apollo {
+namespace dreamview {
+
+/**
+ * @class SimulationWorldDeltaEncoder
+ * @brief Keeps the latest frames of the SimulationWorld and encodes the
+ * latest one as the changes since a frame the frontend acknowledged: the
+ * top-level fields that changed and the objects that are new or changed.
+ * Frames older than the kept ones are sent in full.
+ */
+class SimulationWorldDeltaEncoder {
+ public:
+  /**
+   * @brief Constructor.
+   * @param history_size number of frames kept as the base of a delta.
+   */
+  explicit SimulationWorldDeltaEncoder(size_t history_size);
+
+  /**
+   * @brief Adds a frame, which becomes the latest one.
+   * @param world the simulation world with planning data.
+   * @return id of the frame.
+   */
+  uint32_t AddFrame(std::shared_ptr<const SimulationWorld> world);
+
+  /**
+   * @brief Returns the id of the latest frame, 0 if there is none.
+   */
+  uint32_t latest_frame_id() const;
+
+  /**
+   * @brief Encodes the latest frame against the given base frame, or in
+   * full if the base frame is not kept.
+   * @param base_frame_id id of the frame the frontend holds, 0 for none.
+   * @param with_planning_data whether to send the planning data.
+   * @param delta the encoded frame.
+   * @return False if there is no frame yet.
+   */
+  bool Encode(uint32_t base_frame_id, bool with_planning_data,
+              SimulationWorldDelta *delta) const;
+
+  /**
+   * @brief Encodes the latest frame as Encode() does, in wire format. The
+   * encoding of the latest frame is kept for each base frame, so the
+   * frontends holding the same frame share it.
+   * @param base_frame_id id of the frame the frontend holds, 0 for none.
+   * @param with_planning_data whether to send the planning data.
+   * @param frame_id id of the encoded frame.
+   * @return The encoded frame, or null if there is no frame yet.
+   */
+  std::shared_ptr<const std::string> EncodeToString(uint32_t base_frame_id,
+                                                    bool with_planning_data,
+                                                    uint32_t *frame_id) const;
+
+  /**
+   * @brief Drops the kept frames and encodings.
+   */
+  void Clear();
+
+ private:
+  struct Frame {
+    uint32_t id;
+    std::shared_ptr<const SimulationWorld> world;
+  };
+
+  const size_t history_size_;
+  uint32_t next_frame_id_ = 1;
+  std::deque<Frame> frames_;
+  // Encodings of the latest frame, by base frame id and whether with the
+  // planning data.
+  mutable std::map<std::pair<uint32_t, bool>,
+                   std::shared_ptr<const std::string>>
+      encoded_frames_;
+  mutable std::mutex mutex_;
+};
+
+/**
+ * @brief Applies a delta to the frame it is based on, as the frontend does.
+ * @param delta the delta.
+ * @param base the base frame, ignored for a full frame.
+ * @param world the resulting frame.
+ */
+void ApplySimulationWorldDelta(const SimulationWorldDelta &delta,
+                               const SimulationWorld &base,
+                               SimulationWorld *world);
+
+}  // namespace dreamview
+}  // namespace apollo
+
+#endif  // MODULES_DREAMVIEW_BACKEND_SIMULATION_WORLD_SIMULATION_WORLD_DELTA_H_
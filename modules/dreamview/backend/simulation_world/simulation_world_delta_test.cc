@@ -0,0 +1,187 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/simulation_world/simulation_world_delta.h"
+
+#include <memory>
+#include <string>
+
+#include "google/protobuf/util/message_differencer.h"
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace dreamview {
+
+using google::protobuf::util::MessageDifferencer;
+
+namespace {
+
+void AddObject(const std::string &id, double position_x,
+               SimulationWorld *world) {
+  Object *object = world->add_object();
+  object->set_id(id);
+  object->set_position_x(position_x);
+}
+
+SimulationWorld BaseWorld() {
+  SimulationWorld world;
+  world.set_sequence_num(1);
+  world.set_timestamp(100.0);
+  world.set_speed_limit(10.0);
+  world.mutable_auto_driving_car()->set_position_x(1.0);
+  world.add_route_path()->add_point()->set_x(1.0);
+  world.mutable_planning_data()->mutable_init_point()->set_v(1.0);
+  AddObject("a", 1.0, &world);
+  AddObject("b", 2.0, &world);
+  AddObject("c", 3.0, &world);
+  return world;
+}
+
+// The car moved, object a moved, b stayed, c is gone and d is new. The route
+// stays and the speed limit is gone.
+SimulationWorld LatestWorld() {
+  SimulationWorld world;
+  world.set_sequence_num(2);
+  world.set_timestamp(200.0);
+  world.mutable_auto_driving_car()->set_position_x(2.0);
+  world.add_route_path()->add_point()->set_x(1.0);
+  world.mutable_planning_data()->mutable_init_point()->set_v(2.0);
+  AddObject("a", 1.5, &world);
+  AddObject("b", 2.0, &world);
+  AddObject("d", 4.0, &world);
+  return world;
+}
+
+}  // namespace
+
+TEST(SimulationWorldDeltaTest, FullFrame) {
+  SimulationWorldDeltaEncoder encoder(3);
+  SimulationWorldDelta delta;
+  EXPECT_FALSE(encoder.Encode(0, true, &delta));
+
+  const auto world = std::make_shared<SimulationWorld>(BaseWorld());
+  EXPECT_EQ(1, encoder.AddFrame(world));
+
+  // No base frame, or an unknown one.
+  for (const uint32_t base_frame_id : {0, 7}) {
+    EXPECT_TRUE(encoder.Encode(base_frame_id, true, &delta));
+    EXPECT_EQ(1, delta.frame_id());
+    EXPECT_FALSE(delta.has_base_frame_id());
+    EXPECT_TRUE(MessageDifferencer::Equals(*world, delta.world()));
+  }
+
+  EXPECT_TRUE(encoder.Encode(0, false, &delta));
+  EXPECT_FALSE(delta.world().has_planning_data());
+}
+
+TEST(SimulationWorldDeltaTest, ChangedFieldsAndObjects) {
+  SimulationWorldDeltaEncoder encoder(3);
+  const auto base = std::make_shared<SimulationWorld>(BaseWorld());
+  const auto latest = std::make_shared<SimulationWorld>(LatestWorld());
+  const uint32_t base_frame_id = encoder.AddFrame(base);
+  const uint32_t latest_frame_id = encoder.AddFrame(latest);
+
+  SimulationWorldDelta delta;
+  EXPECT_TRUE(encoder.Encode(base_frame_id, true, &delta));
+  EXPECT_EQ(latest_frame_id, delta.frame_id());
+  EXPECT_EQ(base_frame_id, delta.base_frame_id());
+
+  const SimulationWorld &changes = delta.world();
+  EXPECT_EQ(2, changes.sequence_num());
+  EXPECT_TRUE(changes.has_auto_driving_car());
+  EXPECT_TRUE(changes.has_planning_data());
+  EXPECT_EQ(0, changes.route_path_size());
+  ASSERT_EQ(2, changes.object_size());
+  EXPECT_EQ("a", changes.object(0).id());
+  EXPECT_EQ("d", changes.object(1).id());
+  ASSERT_EQ(1, delta.removed_object_id_size());
+  EXPECT_EQ("c", delta.removed_object_id(0));
+  ASSERT_EQ(1, delta.cleared_field_size());
+  EXPECT_EQ(SimulationWorld::kSpeedLimitFieldNumber, delta.cleared_field(0));
+
+  SimulationWorld applied;
+  ApplySimulationWorldDelta(delta, *base, &applied);
+  EXPECT_TRUE(MessageDifferencer::Equals(*latest, applied))
+      << applied.DebugString();
+}
+
+TEST(SimulationWorldDeltaTest, WithoutPlanningData) {
+  SimulationWorldDeltaEncoder encoder(3);
+  const uint32_t base_frame_id =
+      encoder.AddFrame(std::make_shared<SimulationWorld>(BaseWorld()));
+  encoder.AddFrame(std::make_shared<SimulationWorld>(LatestWorld()));
+
+  SimulationWorldDelta delta;
+  EXPECT_TRUE(encoder.Encode(base_frame_id, false, &delta));
+  EXPECT_FALSE(delta.world().has_planning_data());
+
+  // The planning data the frontend got with an earlier frame is cleared.
+  SimulationWorld expected = LatestWorld();
+  expected.clear_planning_data();
+  SimulationWorld applied;
+  ApplySimulationWorldDelta(delta, BaseWorld(), &applied);
+  EXPECT_TRUE(MessageDifferencer::Equals(expected, applied))
+      << applied.DebugString();
+}
+
+TEST(SimulationWorldDeltaTest, EncodingSharedByBaseFrame) {
+  SimulationWorldDeltaEncoder encoder(3);
+  uint32_t frame_id = 0;
+  EXPECT_EQ(nullptr, encoder.EncodeToString(0, true, &frame_id));
+
+  const uint32_t base_frame_id =
+      encoder.AddFrame(std::make_shared<SimulationWorld>(BaseWorld()));
+  const uint32_t latest_frame_id =
+      encoder.AddFrame(std::make_shared<SimulationWorld>(LatestWorld()));
+  const auto encoded = encoder.EncodeToString(base_frame_id, true, &frame_id);
+  ASSERT_NE(nullptr, encoded);
+  EXPECT_EQ(latest_frame_id, frame_id);
+  EXPECT_EQ(encoded, encoder.EncodeToString(base_frame_id, true, &frame_id));
+  EXPECT_NE(encoded, encoder.EncodeToString(base_frame_id, false, &frame_id));
+
+  SimulationWorldDelta expected;
+  EXPECT_TRUE(encoder.Encode(base_frame_id, true, &expected));
+  SimulationWorldDelta delta;
+  ASSERT_TRUE(delta.ParseFromString(*encoded));
+  EXPECT_TRUE(MessageDifferencer::Equals(expected, delta));
+
+  // A new frame is encoded anew.
+  const uint32_t newest_frame_id =
+      encoder.AddFrame(std::make_shared<SimulationWorld>(BaseWorld()));
+  const auto newest = encoder.EncodeToString(base_frame_id, true, &frame_id);
+  EXPECT_NE(encoded, newest);
+  EXPECT_EQ(newest_frame_id, frame_id);
+
+  encoder.Clear();
+  EXPECT_EQ(0, encoder.latest_frame_id());
+  EXPECT_EQ(nullptr, encoder.EncodeToString(base_frame_id, true, &frame_id));
+}
+
+TEST(SimulationWorldDeltaTest, EvictedBaseFrame) {
+  SimulationWorldDeltaEncoder encoder(2);
+  const uint32_t base_frame_id =
+      encoder.AddFrame(std::make_shared<SimulationWorld>(BaseWorld()));
+  encoder.AddFrame(std::make_shared<SimulationWorld>(BaseWorld()));
+  encoder.AddFrame(std::make_shared<SimulationWorld>(LatestWorld()));
+
+  SimulationWorldDelta delta;
+  EXPECT_TRUE(encoder.Encode(base_frame_id, true, &delta));
+  EXPECT_FALSE(delta.has_base_frame_id());
+  EXPECT_TRUE(MessageDifferencer::Equals(LatestWorld(), delta.world()));
+}
+
+}  // namespace dreamview
+}  // namespace apollo
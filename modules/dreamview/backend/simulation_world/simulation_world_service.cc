@@ -319,10 +319,14 @@ void SimulationWorldService::UpdateDelays() {
 
 void SimulationWorldService::GetWireFormatString(
     double radius, std::string *sim_world,
-    std::string *sim_world_with_planning_data) {
+    std::string *sim_world_with_planning_data,
+    SimulationWorld *world_with_planning_data) {
   PopulateMapInfo(radius);
 
   world_.SerializeToString(sim_world_with_planning_data);
+  if (world_with_planning_data != nullptr) {
+    *world_with_planning_data = world_;
+  }
 
   world_.clear_planning_data();
   world_.SerializeToString(sim_world);
@@ -88,9 +88,12 @@ class SimulationWorldService {
    * @param sim_world output of binary format sim_world string.
    * @param sim_world_with_planning_data output of binary format sim_world
    * string with planning_data.
+   * @param world_with_planning_data optional output of the sim_world with
+   * planning_data.
    */
   void GetWireFormatString(double radius, std::string *sim_world,
-                           std::string *sim_world_with_planning_data);
+                           std::string *sim_world_with_planning_data,
+                           SimulationWorld *world_with_planning_data = nullptr);
 
   /**
    * @brief Returns the json representation of the map element Ids and hash
@@ -16,7 +16,8 @@
 
 #include "modules/dreamview/backend/simulation_world/simulation_world_updater.h"
 
-#include "google/protobuf/util/json_util.h"
+#include <memory>
+
 #include "modules/common/util/json_util.h"
 #include "modules/common/util/map_util.h"
 #include "modules/dreamview/backend/common/dreamview_gflags.h"
@@ -33,8 +34,6 @@ using apollo::common::util::JsonUtil;
 using apollo::hdmap::EndWayPointFile;
 using apollo::routing::RoutingRequest;
 using Json = nlohmann::json;
-using google::protobuf::util::JsonStringToMessage;
-using google::protobuf::util::MessageToJsonString;
 
 SimulationWorldUpdater::SimulationWorldUpdater(WebSocketHandler *websocket,
                                                WebSocketHandler *map_ws,
@@ -45,7 +44,8 @@ SimulationWorldUpdater::SimulationWorldUpdater(WebSocketHandler *websocket,
       map_service_(map_service),
       websocket_(websocket),
       map_ws_(map_ws),
-      sim_control_(sim_control) {
+      sim_control_(sim_control),
+      delta_encoder_(FLAGS_sim_world_delta_history_size) {
   RegisterMessageHandlers();
 }
 
@@ -59,25 +59,44 @@ void SimulationWorldUpdater::RegisterMessageHandlers() {
         websocket_->SendData(conn, response.dump());
       });
 
+  websocket_->RegisterConnectionCloseHandler(
+      [this](WebSocketHandler::Connection *conn) {
+        std::lock_guard<std::mutex> lock(last_sent_frame_ids_mutex_);
+        if (last_sent_frame_ids_.erase(conn) > 0 &&
+            last_sent_frame_ids_.empty()) {
+          // The last frontend asking for deltas is gone.
+          delta_requested_ = false;
+          delta_encoder_.Clear();
+        }
+      });
+
   map_ws_->RegisterMessageHandler(
       "RetrieveMapData",
       [this](const Json &json, WebSocketHandler::Connection *conn) {
         auto iter = json.find("elements");
         if (iter != json.end()) {
           MapElementIds map_element_ids;
-          if (JsonStringToMessage(iter->dump(), &map_element_ids).ok()) {
-            auto retrieved = map_service_->RetrieveMapElements(map_element_ids);
-
-            std::string retrieved_map_string;
-            retrieved.SerializeToString(&retrieved_map_string);
-
-            map_ws_->SendBinaryData(conn, retrieved_map_string, true);
+          if (JsonToMapElementIds(*iter, &map_element_ids)) {
+            SendMapElements(conn, map_element_ids);
           } else {
             AERROR << "Failed to parse MapElementIds from json";
           }
         }
       });
 
+  map_ws_->RegisterMessageHandler(
+      "Binary",
+      [this](const std::string &data, WebSocketHandler::Connection *conn) {
+        // MapElementIds in binary format
+        MapElementIds map_element_ids;
+        if (map_element_ids.ParseFromString(data)) {
+          SendMapElements(conn, map_element_ids);
+        } else {
+          AERROR << "Failed to parse MapElementIds from string. String size: "
+                 << data.size();
+        }
+      });
+
   map_ws_->RegisterMessageHandler(
       "RetrieveRelativeMapData",
       [this](const Json &json, WebSocketHandler::Connection *conn) {
@@ -125,9 +144,7 @@ void SimulationWorldUpdater::RegisterMessageHandlers() {
 
         MapElementIds ids;
         sim_world_service_.GetMapElementIds(*radius, &ids);
-        std::string elementIds;
-        MessageToJsonString(ids, &elementIds);
-        response["mapElementIds"] = Json::parse(elementIds);
+        response["mapElementIds"] = MapElementIdsToJson(ids);
 
         websocket_->SendData(conn, response.dump());
       });
@@ -168,6 +185,16 @@ void SimulationWorldUpdater::RegisterMessageHandlers() {
         if (planning != json.end() && planning->is_boolean()) {
           enable_pnc_monitor = json["planning"];
         }
+
+        // A frontend acknowledging the frame it holds gets the changes only.
+        auto delta_base = json.find("deltaBase");
+        if (FLAGS_enable_sim_world_delta && delta_base != json.end() &&
+            delta_base->is_number_unsigned()) {
+          SendSimulationWorldDelta(conn, delta_base->get<uint32_t>(),
+                                   enable_pnc_monitor);
+          return;
+        }
+
         std::string to_send;
         {
           // Pay the price to copy the data instead of sending data over the
@@ -346,14 +373,77 @@ void SimulationWorldUpdater::Start() {
 void SimulationWorldUpdater::OnTimer(const ros::TimerEvent &event) {
   sim_world_service_.Update();
 
+  std::shared_ptr<SimulationWorld> world;
+  if (delta_requested_) {
+    world = std::make_shared<SimulationWorld>();
+  }
   {
     boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
     sim_world_service_.GetWireFormatString(
         FLAGS_sim_map_radius, &simulation_world_,
-        &simulation_world_with_planning_data_);
+        &simulation_world_with_planning_data_, world.get());
     sim_world_service_.GetRelativeMap().SerializeToString(
         &relative_map_string_);
   }
+  if (world != nullptr) {
+    delta_encoder_.AddFrame(world);
+  }
+}
+
+void SimulationWorldUpdater::SendSimulationWorldDelta(
+    WebSocketHandler::Connection *conn, uint32_t base_frame_id,
+    bool with_planning_data) {
+  {
+    std::lock_guard<std::mutex> lock(last_sent_frame_ids_mutex_);
+    if (last_sent_frame_ids_.emplace(conn, 0).second) {
+      delta_requested_ = true;
+    }
+  }
+
+  // Slow frontends keep asking while the last frame is still on the way,
+  // answer each new frame once instead of queueing copies of it.
+  const uint32_t latest_frame_id = delta_encoder_.latest_frame_id();
+  if (latest_frame_id == 0 || latest_frame_id == base_frame_id) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(last_sent_frame_ids_mutex_);
+    auto iter = last_sent_frame_ids_.find(conn);
+    if (iter != last_sent_frame_ids_.end() &&
+        iter->second == latest_frame_id) {
+      return;
+    }
+  }
+
+  // Frontends holding the same frame share the encoding.
+  uint32_t frame_id = 0;
+  const auto to_send = delta_encoder_.EncodeToString(
+      base_frame_id, with_planning_data, &frame_id);
+  if (to_send == nullptr) {
+    return;
+  }
+  if (FLAGS_enable_update_size_check && !with_planning_data &&
+      to_send->size() > FLAGS_max_update_size) {
+    AWARN << "update size is too big:" << to_send->size();
+    return;
+  }
+  if (websocket_->SendBinaryData(conn, *to_send, true)) {
+    std::lock_guard<std::mutex> lock(last_sent_frame_ids_mutex_);
+    auto iter = last_sent_frame_ids_.find(conn);
+    if (iter != last_sent_frame_ids_.end()) {
+      iter->second = frame_id;
+    }
+  }
+}
+
+void SimulationWorldUpdater::SendMapElements(
+    WebSocketHandler::Connection *conn, const MapElementIds &map_element_ids) {
+  auto retrieved = map_service_->RetrieveMapElements(map_element_ids);
+
+  std::string retrieved_map_string;
+  retrieved.SerializeToString(&retrieved_map_string);
+
+  map_ws_->SendBinaryData(conn, retrieved_map_string, true);
 }
 
 bool SimulationWorldUpdater::LoadPOI() {
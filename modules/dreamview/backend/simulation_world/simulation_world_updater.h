@@ -21,7 +21,11 @@
 #ifndef MODULES_DREAMVIEW_BACKEND_SIMULATION_WORLD_SIM_WORLD_UPDATER_H_
 #define MODULES_DREAMVIEW_BACKEND_SIMULATION_WORLD_SIM_WORLD_UPDATER_H_
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "boost/thread/locks.hpp"
 #include "boost/thread/shared_mutex.hpp"
@@ -31,6 +35,7 @@
 #include "modules/dreamview/backend/handlers/websocket_handler.h"
 #include "modules/dreamview/backend/map/map_service.h"
 #include "modules/dreamview/backend/sim_control/sim_control.h"
+#include "modules/dreamview/backend/simulation_world/simulation_world_delta.h"
 #include "modules/dreamview/backend/simulation_world/simulation_world_service.h"
 #include "modules/routing/proto/poi.pb.h"
 
@@ -121,6 +126,20 @@ class SimulationWorldUpdater {
 
   void RegisterMessageHandlers();
 
+  /**
+   * @brief Sends the latest SimulationWorld as a SimulationWorldDelta, unless
+   * the connection already got it.
+   * @param conn the connection
+   * @param base_frame_id id of the frame the frontend holds, 0 for none
+   * @param with_planning_data whether to send the planning data
+   */
+  void SendSimulationWorldDelta(WebSocketHandler::Connection *conn,
+                                uint32_t base_frame_id,
+                                bool with_planning_data);
+
+  void SendMapElements(WebSocketHandler::Connection *conn,
+                       const MapElementIds &map_element_ids);
+
   ros::Timer timer_;
   SimulationWorldService sim_world_service_;
   const MapService *map_service_ = nullptr;
@@ -139,6 +158,18 @@ class SimulationWorldUpdater {
   // Received relative map data in wire format.
   std::string relative_map_string_;
 
+  // The latest frames for the frontends asking for deltas. Frames are kept
+  // only while a frontend asking for deltas is connected.
+  SimulationWorldDeltaEncoder delta_encoder_;
+  std::atomic<bool> delta_requested_{false};
+
+  // The latest frame sent to each connection asking for deltas, 0 for none,
+  // so that a frontend asking again before a new frame gets nothing instead
+  // of a queue of copies.
+  std::unordered_map<WebSocketHandler::Connection *, uint32_t>
+      last_sent_frame_ids_;
+  std::mutex last_sent_frame_ids_mutex_;
+
   // Mutex to protect concurrent access to simulation_world_json_.
   // NOTE: Use boost until we have std version of rwlock support.
   boost::shared_mutex mutex_;
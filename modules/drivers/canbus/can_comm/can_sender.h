@@ -24,14 +24,18 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include "gtest/gtest_prod.h"
-
 #include "modules/common/log.h"
 #include "modules/common/macro.h"
 #include "modules/common/proto/error_code.pb.h"
@@ -80,17 +84,12 @@ class SenderMessage {
    */
   ~SenderMessage() = default;
 
-  /**
-   * @brief Update the current period for sending messages by a difference.
-   * @param delta_period Update the current period by reducing delta_period.
-   */
-  void UpdateCurrPeriod(const int32_t delta_period);
-
   /**
    * @brief Update the protocol data. But the updating process depends on
    *        the real type of protocol data which inherites ProtocolData.
+   * @return True if the content of the CAN frame to send has changed.
    */
-  void Update();
+  bool Update();
 
   /**
    * @brief Get the CAN frame to send.
@@ -105,18 +104,16 @@ class SenderMessage {
   uint32_t message_id() const;
 
   /**
-   * @brief Get the current period to send messages. It may be different from
-   *        the period from protocol data by updating.
-   * @return The current period.
+   * @brief Get the period to send messages from the protocol data.
+   * @return The period in microseconds.
    */
-  int32_t curr_period() const;
+  int32_t period() const;
 
  private:
   uint32_t message_id_ = 0;
   ProtocolData<SensorType> *protocol_data_ = nullptr;
 
   int32_t period_ = 0;
-  int32_t curr_period_ = 0;
 
  private:
   static std::mutex mutex_;
@@ -145,9 +142,13 @@ class CanSender {
    * @brief Initialize by a CAN client based on its brand.
    * @param can_client The CAN client to use for sending messages.
    * @param enable_log whether enable record the send can frame log
+   * @param send_on_update whether a message whose content is changed by
+   *        Update() is sent right away instead of at its next period. Its
+   *        period restarts from the time it is sent.
    * @return An error code indicating the status of this initialization.
    */
-  common::ErrorCode Init(CanClient *can_client, bool enable_log);
+  common::ErrorCode Init(CanClient *can_client, bool enable_log,
+                         bool send_on_update = false);
 
   /**
    * @brief Add a message with its ID, protocol data.
@@ -167,7 +168,8 @@ class CanSender {
   apollo::common::ErrorCode Start();
 
   /*
-   * @brief Update the protocol data based the types.
+   * @brief Update the protocol data based the types. With send_on_update,
+   *        the sender thread is woken up to send the changed messages.
    */
   void Update();
 
@@ -183,14 +185,13 @@ class CanSender {
    */
   bool IsRunning() const;
   bool enable_log() const;
-
-  FRIEND_TEST(CanSenderTest, OneRunCase);
+  bool send_on_update() const;
 
  private:
   void PowerSendThreadFunc();
 
-  bool NeedSend(const SenderMessage<SensorType> &msg,
-                const int32_t delta_period);
+  void SendMessage(SenderMessage<SensorType> *message);
+
   bool is_init_ = false;
   bool is_running_ = false;
 
@@ -198,11 +199,21 @@ class CanSender {
   std::vector<SenderMessage<SensorType>> send_messages_;
   std::unique_ptr<std::thread> thread_;
   bool enable_log_ = false;
+  bool send_on_update_ = false;
+
+  // Guards is_running_ and pending_messages_, and wakes up the sender thread
+  // on Update() and Stop().
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Indices of the messages changed by Update() but not sent yet.
+  std::vector<std::size_t> pending_messages_;
 
   DISALLOW_COPY_AND_ASSIGN(CanSender);
 };
 
-const uint32_t kSenderInterval = 6000;
+// The period used for a message whose protocol data reports a non-positive
+// period.
+const int32_t kDefaultSendPeriod = 5000;
 
 template <typename SensorType>
 std::mutex SenderMessage<SensorType>::mutex_;
@@ -228,29 +239,24 @@ SenderMessage<SensorType>::SenderMessage(
   can_frame_to_update_.len = len;
 
   period_ = protocol_data_->GetPeriod();
-  curr_period_ = period_;
 
   Update();
 }
 
 template <typename SensorType>
-void SenderMessage<SensorType>::UpdateCurrPeriod(const int32_t period_delta) {
-  curr_period_ -= period_delta;
-  if (curr_period_ <= 0) {
-    curr_period_ = period_;
-  }
-}
-
-template <typename SensorType>
-void SenderMessage<SensorType>::Update() {
+bool SenderMessage<SensorType>::Update() {
   if (protocol_data_ == nullptr) {
     AERROR << "Attention: ProtocolData is nullptr!";
-    return;
+    return false;
   }
   protocol_data_->UpdateData(can_frame_to_update_.data);
 
   std::lock_guard<std::mutex> lock(mutex_);
+  const bool changed =
+      std::memcmp(can_frame_to_send_.data, can_frame_to_update_.data,
+                  sizeof(can_frame_to_update_.data)) != 0;
   can_frame_to_send_ = can_frame_to_update_;
+  return changed;
 }
 
 template <typename SensorType>
@@ -265,8 +271,8 @@ struct CanFrame SenderMessage<SensorType>::CanFrame() {
 }
 
 template <typename SensorType>
-int32_t SenderMessage<SensorType>::curr_period() const {
-  return curr_period_;
+int32_t SenderMessage<SensorType>::period() const {
+  return period_ > 0 ? period_ : kDefaultSendPeriod;
 }
 
 template <typename SensorType>
@@ -276,58 +282,97 @@ void CanSender<SensorType>::PowerSendThreadFunc() {
   sch.sched_priority = 99;
   pthread_setschedparam(pthread_self(), SCHED_FIFO, &sch);
 
-  const int32_t INIT_PERIOD = 5000;  // 5ms
-  int32_t delta_period = INIT_PERIOD;
-  int32_t new_delta_period = INIT_PERIOD;
+  using SteadyClock = std::chrono::steady_clock;
+  using Deadline = std::pair<SteadyClock::time_point, std::size_t>;
+
+  // Min-heap of the next due time of each message. An entry is stale once
+  // the message has been sent ahead of it on Update(); next_due holds the
+  // live deadline of each message.
+  std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>
+      deadlines;
+  std::vector<SteadyClock::time_point> next_due(send_messages_.size());
+  const auto start_time = SteadyClock::now();
+  for (std::size_t i = 0; i < send_messages_.size(); ++i) {
+    next_due[i] = start_time +
+                  std::chrono::microseconds(send_messages_[i].period());
+    deadlines.emplace(next_due[i], i);
+  }
 
-  int64_t tm_start = 0;
-  int64_t tm_end = 0;
-  int64_t sleep_interval = 0;
+  std::vector<std::size_t> to_send;
+  std::vector<std::size_t> pending;
 
   AINFO << "Can client sender thread starts.";
 
+  std::unique_lock<std::mutex> lock(mutex_);
   while (is_running_) {
-    tm_start = common::time::AsInt64<common::time::micros>(
-        common::time::Clock::Now());
-    new_delta_period = INIT_PERIOD;
-
-    for (auto &message : send_messages_) {
-      bool need_send = NeedSend(message, delta_period);
-      message.UpdateCurrPeriod(delta_period);
-      new_delta_period = std::min(new_delta_period, message.curr_period());
-
-      if (!need_send) {
+    pending.swap(pending_messages_);
+    lock.unlock();
+
+    // Messages changed by Update() go out right away and restart their
+    // period from now.
+    auto now = SteadyClock::now();
+    for (const std::size_t i : pending) {
+      SendMessage(&send_messages_[i]);
+      next_due[i] =
+          now + std::chrono::microseconds(send_messages_[i].period());
+      deadlines.emplace(next_due[i], i);
+    }
+    pending.clear();
+
+    now = SteadyClock::now();
+    to_send.clear();
+    while (!deadlines.empty() && deadlines.top().first <= now) {
+      const Deadline deadline = deadlines.top();
+      deadlines.pop();
+      if (deadline.first != next_due[deadline.second]) {
         continue;
       }
-      std::vector<CanFrame> can_frames;
-      CanFrame can_frame = message.CanFrame();
-      can_frames.push_back(can_frame);
-      if (can_client_->SendSingleFrame(can_frames) != common::ErrorCode::OK) {
-        AERROR << "Send msg failed:" << can_frame.CanFrameString();
-      }
-      if (enable_log()) {
-        ADEBUG << "send_can_frame#" << can_frame.CanFrameString();
+      to_send.push_back(deadline.second);
+    }
+    for (const std::size_t i : to_send) {
+      SendMessage(&send_messages_[i]);
+      const auto period =
+          std::chrono::microseconds(send_messages_[i].period());
+      next_due[i] += period;
+      if (next_due[i] <= now) {
+        AWARN << "Can sender is late by more than one period ("
+              << period.count() << "us) for message: " << std::hex
+              << send_messages_[i].message_id();
+        next_due[i] = now + period;
       }
+      deadlines.emplace(next_due[i], i);
     }
-    delta_period = new_delta_period;
-    tm_end = common::time::AsInt64<common::time::micros>(
-        common::time::Clock::Now());
-    sleep_interval = delta_period - (tm_end - tm_start);
 
-    if (sleep_interval > 0) {
-      std::this_thread::sleep_for(std::chrono::microseconds(sleep_interval));
+    lock.lock();
+    const auto wake_up = [this] {
+      return !is_running_ || !pending_messages_.empty();
+    };
+    if (deadlines.empty()) {
+      cv_.wait(lock, wake_up);
     } else {
-      // do not sleep
-      AWARN << "Too much time for calculation: " << tm_end - tm_start
-            << "us is more than minimum period: " << delta_period << "us";
+      cv_.wait_until(lock, deadlines.top().first, wake_up);
     }
   }
   AINFO << "Can client sender thread stopped!";
 }
 
+template <typename SensorType>
+void CanSender<SensorType>::SendMessage(SenderMessage<SensorType> *message) {
+  std::vector<CanFrame> can_frames;
+  CanFrame can_frame = message->CanFrame();
+  can_frames.push_back(can_frame);
+  if (can_client_->SendSingleFrame(can_frames) != common::ErrorCode::OK) {
+    AERROR << "Send msg failed:" << can_frame.CanFrameString();
+  }
+  if (enable_log()) {
+    ADEBUG << "send_can_frame#" << can_frame.CanFrameString();
+  }
+}
+
 template <typename SensorType>
 common::ErrorCode CanSender<SensorType>::Init(CanClient *can_client,
-                                              bool enable_log) {
+                                              bool enable_log,
+                                              bool send_on_update) {
   if (is_init_) {
     AERROR << "Duplicated Init request.";
     return common::ErrorCode::CANBUS_ERROR;
@@ -339,6 +384,7 @@ common::ErrorCode CanSender<SensorType>::Init(CanClient *can_client,
   is_init_ = true;
   can_client_ = can_client;
   enable_log_ = enable_log;
+  send_on_update_ = send_on_update;
   return common::ErrorCode::OK;
 }
 
@@ -361,7 +407,11 @@ common::ErrorCode CanSender<SensorType>::Start() {
     AERROR << "Cansender has already started.";
     return common::ErrorCode::CANBUS_ERROR;
   }
-  is_running_ = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_running_ = true;
+    pending_messages_.clear();
+  }
   thread_.reset(new std::thread([this] { PowerSendThreadFunc(); }));
 
   return common::ErrorCode::OK;
@@ -369,16 +419,39 @@ common::ErrorCode CanSender<SensorType>::Start() {
 
 template <typename SensorType>
 void CanSender<SensorType>::Update() {
-  for (auto &message : send_messages_) {
-    message.Update();
+  std::vector<std::size_t> changed;
+  for (std::size_t i = 0; i < send_messages_.size(); ++i) {
+    if (send_messages_[i].Update()) {
+      changed.push_back(i);
+    }
+  }
+  if (!send_on_update_ || changed.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_running_) {
+      return;
+    }
+    for (const std::size_t i : changed) {
+      if (std::find(pending_messages_.begin(), pending_messages_.end(), i) ==
+          pending_messages_.end()) {
+        pending_messages_.push_back(i);
+      }
+    }
   }
+  cv_.notify_one();
 }
 
 template <typename SensorType>
 void CanSender<SensorType>::Stop() {
   if (is_running_) {
     AINFO << "Stopping can sender ...";
-    is_running_ = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_running_ = false;
+    }
+    cv_.notify_one();
     if (thread_ != nullptr && thread_->joinable()) {
       thread_->join();
     }
@@ -401,9 +474,8 @@ bool CanSender<SensorType>::enable_log() const {
 }
 
 template <typename SensorType>
-bool CanSender<SensorType>::NeedSend(const SenderMessage<SensorType> &msg,
-                                     const int32_t delta_period) {
-  return msg.curr_period() <= delta_period;
+bool CanSender<SensorType>::send_on_update() const {
+  return send_on_update_;
 }
 
 }  // namespace canbus
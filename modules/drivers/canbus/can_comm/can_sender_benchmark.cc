@@ -0,0 +1,136 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of the command-to-wire latency of CanSender: the time from
+ * CanSender::Update() with a new command to the frame reaching a fake CAN
+ * client, for a 20ms message sent periodically and sent on update. The label
+ * of each run reports the worst latency.
+ **/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/canbus/proto/chassis_detail.pb.h"
+#include "modules/drivers/canbus/can_client/fake/fake_can_client.h"
+#include "modules/drivers/canbus/can_comm/can_sender.h"
+#include "modules/drivers/canbus/can_comm/protocol_data.h"
+
+namespace apollo {
+namespace drivers {
+namespace canbus {
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr uint32_t kCommandPeriod = 20 * 1000;
+
+class CommandProtocolData
+    : public ProtocolData<::apollo::canbus::ChassisDetail> {
+ public:
+  uint32_t GetPeriod() const override { return kCommandPeriod; }
+
+  void UpdateData(uint8_t *data) override { data[0] = command_; }
+
+  void set_command(const uint8_t command) { command_ = command; }
+
+ private:
+  uint8_t command_ = 0;
+};
+
+// Records when the latest command reached the wire.
+class TimedCanClient : public can::FakeCanClient {
+ public:
+  common::ErrorCode Send(const std::vector<CanFrame> &frames,
+                         int32_t *const frame_num) override {
+    const auto now = SteadyClock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &frame : frames) {
+      if (frame.data[0] != command_) {
+        command_ = frame.data[0];
+        command_time_ = now;
+      }
+    }
+    cv_.notify_all();
+    return common::ErrorCode::OK;
+  }
+
+  SteadyClock::time_point WaitForCommand(const uint8_t command) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, command] { return command_ == command; });
+    return command_time_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint8_t command_ = 0;
+  SteadyClock::time_point command_time_;
+};
+
+void BM_CommandToWireLatency(benchmark::State &state) {  // NOLINT
+  CanSender<::apollo::canbus::ChassisDetail> sender;
+  TimedCanClient can_client;
+  sender.Init(&can_client, false, state.range(0) != 0);
+  CommandProtocolData command;
+  sender.AddMessage(1, &command);
+  sender.Start();
+
+  // Commands arrive at a random phase of the send period.
+  std::mt19937 random_engine(0);
+  std::uniform_int_distribution<int> phase(0, kCommandPeriod);
+  uint8_t value = 0;
+  double max_latency = 0.0;
+  while (state.KeepRunning()) {
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(phase(random_engine)));
+    value = value == 255 ? 1 : value + 1;
+    command.set_command(value);
+    const auto update_time = SteadyClock::now();
+    sender.Update();
+    const double latency = std::chrono::duration<double>(
+                               can_client.WaitForCommand(value) - update_time)
+                               .count();
+    max_latency = std::max(max_latency, latency);
+    state.SetIterationTime(latency);
+  }
+  sender.Stop();
+  state.SetLabel("max_latency_us=" +
+                 std::to_string(static_cast<int>(max_latency * 1e6)));
+}
+// Arg 0 sends the command at its next period, arg 1 sends it on update.
+BENCHMARK(BM_CommandToWireLatency)
+    ->Arg(0)
+    ->Arg(1)
+    ->Iterations(100)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace canbus
+}  // namespace drivers
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -16,6 +16,11 @@
 
 #include "modules/drivers/canbus/can_comm/can_sender.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "modules/canbus/proto/chassis_detail.pb.h"
@@ -27,6 +32,52 @@ namespace apollo {
 namespace drivers {
 namespace canbus {
 
+namespace {
+
+class CommandProtocolData
+    : public ProtocolData<::apollo::canbus::ChassisDetail> {
+ public:
+  uint32_t GetPeriod() const override { return 1000 * 1000; }
+
+  void UpdateData(uint8_t *data) override { data[0] = command_; }
+
+  void set_command(const uint8_t command) { command_ = command; }
+
+ private:
+  uint8_t command_ = 0;
+};
+
+class RecordingCanClient : public can::FakeCanClient {
+ public:
+  common::ErrorCode Send(const std::vector<CanFrame> &frames,
+                         int32_t *const frame_num) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent_frames_.insert(sent_frames_.end(), frames.begin(), frames.end());
+    cv_.notify_all();
+    return common::ErrorCode::OK;
+  }
+
+  bool WaitForCommand(const uint8_t command,
+                      const std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [this, command] {
+      return !sent_frames_.empty() && sent_frames_.back().data[0] == command;
+    });
+  }
+
+  std::size_t num_sent_frames() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sent_frames_.size();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<CanFrame> sent_frames_;
+};
+
+}  // namespace
+
 TEST(CanSenderTest, OneRunCase) {
   CanSender<::apollo::canbus::ChassisDetail> sender;
   can::FakeCanClient can_client;
@@ -34,11 +85,7 @@ TEST(CanSenderTest, OneRunCase) {
 
   ProtocolData<::apollo::canbus::ChassisDetail> mpd;
   SenderMessage<::apollo::canbus::ChassisDetail> msg(1, &mpd);
-  EXPECT_FALSE(sender.NeedSend(msg, 1));
   EXPECT_EQ(msg.message_id(), 1);
-  int32_t period = msg.curr_period();
-  msg.UpdateCurrPeriod(-50);
-  EXPECT_EQ(msg.curr_period(), period + 50);
   EXPECT_EQ(msg.CanFrame().id, 1);
 
   sender.AddMessage(1, &mpd);
@@ -51,6 +98,56 @@ TEST(CanSenderTest, OneRunCase) {
   EXPECT_FALSE(sender.IsRunning());
 }
 
+TEST(CanSenderTest, SendOnUpdate) {
+  CanSender<::apollo::canbus::ChassisDetail> sender;
+  RecordingCanClient can_client;
+  EXPECT_EQ(sender.Init(&can_client, false, true), common::ErrorCode::OK);
+  EXPECT_TRUE(sender.send_on_update());
+
+  CommandProtocolData command;
+  sender.AddMessage(1, &command);
+  EXPECT_EQ(sender.Start(), common::ErrorCode::OK);
+
+  // The period is one second, so the frames below can only come from the
+  // sends triggered by Update().
+  command.set_command(1);
+  sender.Update();
+  EXPECT_TRUE(can_client.WaitForCommand(1, std::chrono::milliseconds(200)));
+
+  command.set_command(2);
+  sender.Update();
+  EXPECT_TRUE(can_client.WaitForCommand(2, std::chrono::milliseconds(200)));
+  EXPECT_EQ(can_client.num_sent_frames(), 2);
+
+  // An update which does not change the frame is not sent again.
+  sender.Update();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(can_client.num_sent_frames(), 2);
+
+  sender.Stop();
+  EXPECT_FALSE(sender.IsRunning());
+}
+
+TEST(CanSenderTest, SendPeriodically) {
+  CanSender<::apollo::canbus::ChassisDetail> sender;
+  RecordingCanClient can_client;
+  EXPECT_EQ(sender.Init(&can_client, false), common::ErrorCode::OK);
+  EXPECT_FALSE(sender.send_on_update());
+
+  CommandProtocolData command;
+  sender.AddMessage(1, &command);
+  EXPECT_EQ(sender.Start(), common::ErrorCode::OK);
+
+  // Without send_on_update the changed frame waits for its period.
+  command.set_command(1);
+  sender.Update();
+  EXPECT_FALSE(can_client.WaitForCommand(1, std::chrono::milliseconds(200)));
+  EXPECT_TRUE(can_client.WaitForCommand(1, std::chrono::milliseconds(2000)));
+
+  sender.Stop();
+  EXPECT_FALSE(sender.IsRunning());
+}
+
 }  // namespace canbus
 }  // namespace drivers
 }  // namespace apollo
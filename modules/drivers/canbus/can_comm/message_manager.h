@@ -32,6 +32,7 @@
 #include "modules/common/log.h"
 #include "modules/common/proto/error_code.pb.h"
 #include "modules/common/time/time.h"
+#include "modules/drivers/canbus/can_client/can_client.h"
 #include "modules/drivers/canbus/can_comm/protocol_data.h"
 #include "modules/drivers/canbus/common/byte.h"
 
@@ -59,6 +60,48 @@ struct CheckIdArg {
   int32_t error_count = 0;
 };
 
+/**
+ * @class ProtocolDataTable
+ *
+ * @brief flat open addressed table from message id to protocol data, for the
+ * per frame lookup on the receive path.
+ */
+template <typename SensorType>
+class ProtocolDataTable {
+ public:
+  /**
+   * @brief add or replace the protocol data of a message id
+   * @param message_id the id of the message
+   * @param protocol_data a pointer to the protocol data
+   */
+  void Insert(const uint32_t message_id,
+              ProtocolData<SensorType> *protocol_data);
+
+  /**
+   * @brief find the protocol data of a message id
+   * @param message_id the id of the message
+   * @return a pointer to the protocol data, nullptr if not found
+   */
+  ProtocolData<SensorType> *Find(const uint32_t message_id) const;
+
+ private:
+  struct Slot {
+    uint32_t message_id = 0;
+    ProtocolData<SensorType> *protocol_data = nullptr;
+  };
+
+  std::size_t SlotIndex(const uint32_t message_id) const {
+    // Fibonacci hashing keeps the consecutive ids of a CAN bus apart.
+    return (message_id * 2654435769u) >> (32 - bits_);
+  }
+
+  void Rehash(const int bits);
+
+  std::vector<Slot> slots_;
+  std::size_t size_ = 0;
+  int bits_ = 0;
+};
+
 /**
  * @class MessageManager
  *
@@ -86,6 +129,13 @@ class MessageManager {
   virtual void Parse(const uint32_t message_id, const uint8_t *data,
                      int32_t length);
 
+  /**
+   * @brief parse a batch of received frames in their order of arrival,
+   * holding the sensor data lock once for the whole batch
+   * @param frames the frames to be parsed
+   */
+  void ParseFrames(const std::vector<CanFrame> &frames);
+
   void ClearSensorData();
 
   std::condition_variable* GetMutableCVar();
@@ -111,6 +161,23 @@ class MessageManager {
   void ResetSendMessages();
 
  protected:
+  /**
+   * @brief parse data into sensor data with sensor_data_mutex_ held
+   * @param message_id the id of the message
+   * @param data a pointer to the data array to be parsed
+   * @param length the length of data array
+   * @return true if the message is consumed and counted as received
+   */
+  virtual bool ParseLocked(const uint32_t message_id, const uint8_t *data,
+                           int32_t length);
+
+  /**
+   * @brief record the arrival of a message for the period check
+   * @param message_id the id of the message
+   * @param time the arrival time in microseconds
+   */
+  void UpdateReceivedId(const uint32_t message_id, const int64_t time);
+
   template <class T, bool need_check>
   void AddRecvProtocolData();
 
@@ -121,6 +188,7 @@ class MessageManager {
   std::vector<std::unique_ptr<ProtocolData<SensorType>>> recv_protocol_data_;
 
   std::unordered_map<uint32_t, ProtocolData<SensorType> *> protocol_data_map_;
+  ProtocolDataTable<SensorType> protocol_data_table_;
   std::unordered_map<uint32_t, CheckIdArg> check_ids_;
   std::set<uint32_t> received_ids_;
 
@@ -131,6 +199,60 @@ class MessageManager {
   std::condition_variable cvar_;
 };
 
+template <typename SensorType>
+void ProtocolDataTable<SensorType>::Insert(
+    const uint32_t message_id, ProtocolData<SensorType> *protocol_data) {
+  // keep the load factor at most 1/2
+  if ((size_ + 1) * 2 > slots_.size()) {
+    Rehash(bits_ == 0 ? 4 : bits_ + 1);
+  }
+  const std::size_t mask = slots_.size() - 1;
+  for (std::size_t i = SlotIndex(message_id);; i = (i + 1) & mask) {
+    Slot &slot = slots_[i];
+    if (slot.protocol_data == nullptr) {
+      slot.message_id = message_id;
+      slot.protocol_data = protocol_data;
+      ++size_;
+      return;
+    }
+    if (slot.message_id == message_id) {
+      slot.protocol_data = protocol_data;
+      return;
+    }
+  }
+}
+
+template <typename SensorType>
+ProtocolData<SensorType> *ProtocolDataTable<SensorType>::Find(
+    const uint32_t message_id) const {
+  if (slots_.empty()) {
+    return nullptr;
+  }
+  const std::size_t mask = slots_.size() - 1;
+  for (std::size_t i = SlotIndex(message_id);; i = (i + 1) & mask) {
+    const Slot &slot = slots_[i];
+    if (slot.protocol_data == nullptr) {
+      return nullptr;
+    }
+    if (slot.message_id == message_id) {
+      return slot.protocol_data;
+    }
+  }
+}
+
+template <typename SensorType>
+void ProtocolDataTable<SensorType>::Rehash(const int bits) {
+  std::vector<Slot> slots(std::size_t(1) << bits);
+  slots.swap(slots_);
+  bits_ = bits;
+  size_ = 0;
+  for (const Slot &slot : slots) {
+    if (slot.protocol_data != nullptr) {
+      Insert(slot.message_id, slot.protocol_data);
+    }
+  }
+}
+
 template <typename SensorType>
 template <class T, bool need_check>
 void MessageManager<SensorType>::AddRecvProtocolData() {
@@ -140,6 +262,7 @@ void MessageManager<SensorType>::AddRecvProtocolData() {
     return;
   }
   protocol_data_map_[T::ID] = dt;
+  protocol_data_table_.Insert(T::ID, dt);
   if (need_check) {
     check_ids_[T::ID].period = dt->GetPeriod();
     check_ids_[T::ID].real_period = 0;
@@ -157,6 +280,7 @@ void MessageManager<SensorType>::AddSendProtocolData() {
     return;
   }
   protocol_data_map_[T::ID] = dt;
+  protocol_data_table_.Insert(T::ID, dt);
   if (need_check) {
     check_ids_[T::ID].period = dt->GetPeriod();
     check_ids_[T::ID].real_period = 0;
@@ -169,31 +293,64 @@ template <typename SensorType>
 ProtocolData<SensorType>
     *MessageManager<SensorType>::GetMutableProtocolDataById(
         const uint32_t message_id) {
-  if (protocol_data_map_.find(message_id) == protocol_data_map_.end()) {
+  ProtocolData<SensorType> *protocol_data =
+      protocol_data_table_.Find(message_id);
+  if (protocol_data == nullptr) {
     ADEBUG << "Unable to get protocol data because of invalid message_id:"
            << Byte::byte_to_hex(message_id);
-    return nullptr;
   }
-  return protocol_data_map_[message_id];
+  return protocol_data;
 }
 
 template <typename SensorType>
 void MessageManager<SensorType>::Parse(const uint32_t message_id,
                                        const uint8_t *data, int32_t length) {
+  bool parsed = false;
+  {
+    std::lock_guard<std::mutex> lock(sensor_data_mutex_);
+    parsed = ParseLocked(message_id, data, length);
+  }
+  if (parsed) {
+    UpdateReceivedId(message_id,
+                     apollo::common::time::AsInt64<micros>(Clock::Now()));
+  }
+}
+
+template <typename SensorType>
+void MessageManager<SensorType>::ParseFrames(
+    const std::vector<CanFrame> &frames) {
+  // The frames of one batch arrived together, so they share one time stamp.
+  // They are parsed in order of arrival: a list status message starts a new
+  // list which the messages after it fill in.
+  const int64_t time = apollo::common::time::AsInt64<micros>(Clock::Now());
+  std::lock_guard<std::mutex> lock(sensor_data_mutex_);
+  for (const auto &frame : frames) {
+    if (ParseLocked(frame.id, frame.data, frame.len)) {
+      UpdateReceivedId(frame.id, time);
+    }
+  }
+}
+
+template <typename SensorType>
+bool MessageManager<SensorType>::ParseLocked(const uint32_t message_id,
+                                             const uint8_t *data,
+                                             int32_t length) {
   ProtocolData<SensorType> *protocol_data =
       GetMutableProtocolDataById(message_id);
   if (protocol_data == nullptr) {
-    return;
-  }
-  {
-    std::lock_guard<std::mutex> lock(sensor_data_mutex_);
-    protocol_data->Parse(data, length, &sensor_data_);
+    return false;
   }
+  protocol_data->Parse(data, length, &sensor_data_);
+  return true;
+}
+
+template <typename SensorType>
+void MessageManager<SensorType>::UpdateReceivedId(const uint32_t message_id,
+                                                  const int64_t time) {
   received_ids_.insert(message_id);
   // check if need to check period
   const auto it = check_ids_.find(message_id);
   if (it != check_ids_.end()) {
-    const int64_t time = apollo::common::time::AsInt64<micros>(Clock::Now());
     it->second.real_period = time - it->second.last_time;
     // if period 1.5 large than base period, inc error_count
     const double period_multiplier = 1.5;
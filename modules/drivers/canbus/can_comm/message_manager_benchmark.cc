@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of the receive path of MessageManager on a radar cluster
+ * list: a batch of frames from the fake CAN client parsed frame by frame with
+ * a lock each, and as one batch under one lock. Items are frames.
+ **/
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/canbus/proto/chassis_detail.pb.h"
+#include "modules/drivers/canbus/can_client/fake/fake_can_client.h"
+#include "modules/drivers/canbus/can_comm/message_manager.h"
+#include "modules/drivers/canbus/can_comm/protocol_data.h"
+#include "modules/drivers/canbus/common/canbus_consts.h"
+
+namespace apollo {
+namespace drivers {
+namespace canbus {
+namespace {
+
+using ::apollo::canbus::ChassisDetail;
+
+constexpr uint32_t kListStatusId = 0x600;
+constexpr uint32_t kGeneralInfoId = 0x701;
+constexpr uint32_t kQualityInfoId = 0x702;
+
+template <uint32_t kId>
+class ClusterProtocolData : public ProtocolData<ChassisDetail> {
+ public:
+  static const int32_t ID = kId;
+  void Parse(const uint8_t *bytes, int32_t length,
+             ChassisDetail *chassis_detail) const override {
+    chassis_detail->mutable_gas()->set_throttle_output(bytes[0]);
+  }
+};
+
+// The receive messages of a radar: the list status, general and quality
+// info of the clusters and objects, and the radar state.
+class RadarMessageManager : public MessageManager<ChassisDetail> {
+ public:
+  RadarMessageManager() {
+    AddRecvProtocolData<ClusterProtocolData<0x201>, true>();
+    AddRecvProtocolData<ClusterProtocolData<kListStatusId>, true>();
+    AddRecvProtocolData<ClusterProtocolData<kGeneralInfoId>, true>();
+    AddRecvProtocolData<ClusterProtocolData<kQualityInfoId>, true>();
+    AddRecvProtocolData<ClusterProtocolData<0x60A>, true>();
+    AddRecvProtocolData<ClusterProtocolData<0x60B>, true>();
+    AddRecvProtocolData<ClusterProtocolData<0x60C>, true>();
+    AddRecvProtocolData<ClusterProtocolData<0x60D>, true>();
+  }
+
+  const std::unordered_map<uint32_t, ProtocolData<ChassisDetail> *>
+      &protocol_data_map() const {
+    return protocol_data_map_;
+  }
+};
+
+// One receive call of the fake CAN client, relabeled as a cluster list: the
+// list status followed by the general and quality info of each cluster.
+std::vector<CanFrame> ReceiveClusterList(const int num_frames) {
+  can::FakeCanClient can_client;
+  std::vector<CanFrame> frames;
+  int32_t frame_num = num_frames;
+  can_client.Receive(&frames, &frame_num);
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    frames[i].id =
+        i == 0 ? kListStatusId : (i % 2 == 1 ? kGeneralInfoId : kQualityInfoId);
+  }
+  return frames;
+}
+
+void BM_ParsePerFrame(benchmark::State &state) {  // NOLINT
+  RadarMessageManager manager;
+  const std::vector<CanFrame> frames = ReceiveClusterList(state.range(0));
+  while (state.KeepRunning()) {
+    for (const auto &frame : frames) {
+      manager.Parse(frame.id, frame.data, frame.len);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * frames.size());
+}
+BENCHMARK(BM_ParsePerFrame)->Arg(MAX_CAN_RECV_FRAME_LEN)->Arg(100);
+
+void BM_ParseFrames(benchmark::State &state) {  // NOLINT
+  RadarMessageManager manager;
+  const std::vector<CanFrame> frames = ReceiveClusterList(state.range(0));
+  while (state.KeepRunning()) {
+    manager.ParseFrames(frames);
+  }
+  state.SetItemsProcessed(state.iterations() * frames.size());
+}
+BENCHMARK(BM_ParseFrames)->Arg(MAX_CAN_RECV_FRAME_LEN)->Arg(100);
+
+// The message id lookup alone: the std::unordered_map of the protocol data
+// against the open addressed table.
+void BM_LookupProtocolDataMap(benchmark::State &state) {  // NOLINT
+  RadarMessageManager manager;
+  const auto &protocol_data_map = manager.protocol_data_map();
+  const std::vector<CanFrame> frames =
+      ReceiveClusterList(MAX_CAN_RECV_FRAME_LEN);
+  while (state.KeepRunning()) {
+    for (const auto &frame : frames) {
+      benchmark::DoNotOptimize(protocol_data_map.find(frame.id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * frames.size());
+}
+BENCHMARK(BM_LookupProtocolDataMap);
+
+void BM_LookupProtocolDataTable(benchmark::State &state) {  // NOLINT
+  RadarMessageManager manager;
+  const std::vector<CanFrame> frames =
+      ReceiveClusterList(MAX_CAN_RECV_FRAME_LEN);
+  while (state.KeepRunning()) {
+    for (const auto &frame : frames) {
+      benchmark::DoNotOptimize(manager.GetMutableProtocolDataById(frame.id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * frames.size());
+}
+BENCHMARK(BM_LookupProtocolDataTable);
+
+}  // namespace
+}  // namespace canbus
+}  // namespace drivers
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -36,6 +37,20 @@ class MockProtocolData : public ProtocolData<::apollo::canbus::ChassisDetail> {
   MockProtocolData() {}
 };
 
+// Appends the first data byte to the throttle output, to record the order of
+// parsing.
+template <int32_t kId>
+class OrderedProtocolData
+    : public ProtocolData<::apollo::canbus::ChassisDetail> {
+ public:
+  static const int32_t ID = kId;
+  void Parse(const uint8_t *bytes, int32_t length,
+             ::apollo::canbus::ChassisDetail *chassis_detail) const override {
+    auto *gas = chassis_detail->mutable_gas();
+    gas->set_throttle_output(gas->throttle_output() * 10 + bytes[0]);
+  }
+};
+
 class MockMessageManager
     : public MessageManager<::apollo::canbus::ChassisDetail> {
  public:
@@ -45,6 +60,15 @@ class MockMessageManager
   }
 };
 
+class OrderedMessageManager
+    : public MessageManager<::apollo::canbus::ChassisDetail> {
+ public:
+  OrderedMessageManager() {
+    AddRecvProtocolData<OrderedProtocolData<0x600>, false>();
+    AddRecvProtocolData<OrderedProtocolData<0x701>, false>();
+  }
+};
+
 TEST(MessageManagerTest, GetMutableProtocolDataById) {
   uint8_t mock_data = 1;
   MockMessageManager manager;
@@ -59,6 +83,50 @@ TEST(MessageManagerTest, GetMutableProtocolDataById) {
   EXPECT_EQ(manager.GetSensorData(nullptr), ErrorCode::CANBUS_ERROR);
 }
 
+TEST(MessageManagerTest, ParseFrames) {
+  OrderedMessageManager manager;
+  std::vector<CanFrame> frames(5);
+  const uint32_t ids[] = {0x701, 0x600, 0x123, 0x701, 0x701};
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    frames[i].id = ids[i];
+    frames[i].len = 8;
+    frames[i].data[0] = static_cast<uint8_t>(i + 1);
+  }
+  manager.ParseFrames(frames);
+
+  // Frames are parsed in their order of arrival, the unknown id is skipped.
+  ::apollo::canbus::ChassisDetail chassis_detail;
+  EXPECT_EQ(manager.GetSensorData(&chassis_detail), ErrorCode::OK);
+  EXPECT_DOUBLE_EQ(chassis_detail.gas().throttle_output(), 1245.0);
+}
+
+TEST(ProtocolDataTableTest, InsertAndFind) {
+  std::vector<std::unique_ptr<MockProtocolData>> protocol_data;
+  ProtocolDataTable<::apollo::canbus::ChassisDetail> table;
+  EXPECT_EQ(table.Find(0x111), nullptr);
+  // A radar cluster list range and a few sparse extended ids.
+  std::vector<uint32_t> ids;
+  for (uint32_t id = 0x700; id < 0x740; ++id) {
+    ids.push_back(id);
+  }
+  ids.push_back(0x18FF0000);
+  ids.push_back(0x1FFFFFFF);
+  ids.push_back(0);
+  for (const uint32_t id : ids) {
+    protocol_data.emplace_back(new MockProtocolData());
+    table.Insert(id, protocol_data.back().get());
+  }
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(table.Find(ids[i]), protocol_data[i].get());
+  }
+  EXPECT_EQ(table.Find(0x6FF), nullptr);
+  EXPECT_EQ(table.Find(0x740), nullptr);
+
+  // Inserting an existing id replaces its protocol data.
+  table.Insert(0x701, protocol_data.front().get());
+  EXPECT_EQ(table.Find(0x701), protocol_data.front().get());
+}
+
 }  // namespace canbus
 }  // namespace drivers
 }  // namespace apollo
@@ -0,0 +1,214 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/gnss/parser/novatel_framer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "modules/common/log.h"
+#include "modules/drivers/gnss/parser/novatel_messages.h"
+
+namespace apollo {
+namespace drivers {
+namespace gnss {
+
+// Anonymous namespace that contains helper constants and functions.
+namespace {
+
+constexpr size_t SYNC_LENGTH = 3;
+
+constexpr size_t MAX_FRAME_LENGTH =
+    sizeof(novatel::LongHeader) + std::numeric_limits<uint16_t>::max() +
+    novatel::CRC_LENGTH;
+
+// table[k][b] is the CRC of byte b followed by k zero bytes.
+struct Crc32Tables {
+  Crc32Tables() {
+    for (uint32_t b = 0; b < 256; ++b) {
+      uint32_t word = b;
+      for (int j = 0; j < 8; ++j) {
+        word = (word & 1) ? (word >> 1) ^ 0xEDB88320 : word >> 1;
+      }
+      table[0][b] = word;
+    }
+    for (uint32_t b = 0; b < 256; ++b) {
+      for (int k = 1; k < 8; ++k) {
+        const uint32_t previous = table[k - 1][b];
+        table[k][b] = (previous >> 8) ^ table[0][previous & 0xFF];
+      }
+    }
+  }
+
+  uint32_t table[8][256];
+};
+
+bool SyncByteMatches(size_t index, uint8_t byte) {
+  switch (index) {
+    case 0:
+      return byte == novatel::SYNC_0;
+    case 1:
+      return byte == novatel::SYNC_1;
+    default:
+      return byte == novatel::SYNC_2_LONG_HEADER ||
+             byte == novatel::SYNC_2_SHORT_HEADER;
+  }
+}
+
+// The sync bytes must be complete.
+size_t HeaderLength(const uint8_t *frame) {
+  return frame[2] == novatel::SYNC_2_LONG_HEADER ? sizeof(novatel::LongHeader)
+                                                 : sizeof(novatel::ShortHeader);
+}
+
+// The header must be complete.
+size_t FrameLength(const uint8_t *frame) {
+  if (frame[2] == novatel::SYNC_2_LONG_HEADER) {
+    return sizeof(novatel::LongHeader) + novatel::CRC_LENGTH +
+           reinterpret_cast<const novatel::LongHeader *>(frame)->message_length;
+  }
+  return sizeof(novatel::ShortHeader) + novatel::CRC_LENGTH +
+         reinterpret_cast<const novatel::ShortHeader *>(frame)->message_length;
+}
+
+}  // namespace
+
+uint32_t NovatelCrc32(const uint8_t *buffer, size_t length) {
+  static const Crc32Tables tables;
+  const auto &table = tables.table;
+  uint32_t word = 0;
+  while (length >= 8) {
+    uint32_t low;
+    uint32_t high;
+    std::memcpy(&low, buffer, sizeof(low));
+    std::memcpy(&high, buffer + 4, sizeof(high));
+    // The words are read little-endian, as the NovAtel logs are.
+    low ^= word;
+    word = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^
+           table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+           table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^
+           table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+    buffer += 8;
+    length -= 8;
+  }
+  while (length--) {
+    word = (word >> 8) ^ table[0][(word ^ *buffer++) & 0xFF];
+  }
+  return word;
+}
+
+NovatelFramer::NovatelFramer() : carry_(MAX_FRAME_LENGTH) {}
+
+void NovatelFramer::Reset() {
+  carry_size_ = 0;
+  frame_length_ = 0;
+}
+
+bool NovatelFramer::CheckFrame(const uint8_t *frame, size_t frame_length) {
+  const size_t length = frame_length - novatel::CRC_LENGTH;
+  uint32_t crc;
+  std::memcpy(&crc, frame + length, sizeof(crc));
+  if (NovatelCrc32(frame, length) != crc) {
+    AERROR << "CRC check failed.";
+    ++crc_errors_;
+    return false;
+  }
+  return true;
+}
+
+bool NovatelFramer::Next(const uint8_t **data, const uint8_t *data_end,
+                         const uint8_t **frame, size_t *frame_length) {
+  while (*data < data_end) {
+    if (carry_size_ > 0) {
+      // Continue the frame split across updates.
+      if (carry_size_ < SYNC_LENGTH) {
+        if (!SyncByteMatches(carry_size_, **data)) {
+          // The byte may start the next frame.
+          Reset();
+          continue;
+        }
+        carry_[carry_size_++] = *(*data)++;
+        continue;
+      }
+      const size_t wanted =
+          frame_length_ > 0 ? frame_length_ : HeaderLength(carry_.data());
+      const size_t length = std::min<size_t>(wanted - carry_size_,
+                                             data_end - *data);
+      std::memcpy(carry_.data() + carry_size_, *data, length);
+      carry_size_ += length;
+      *data += length;
+      if (carry_size_ < wanted) {
+        return false;
+      }
+      if (frame_length_ == 0) {
+        frame_length_ = FrameLength(carry_.data());
+        continue;
+      }
+      const size_t length_of_frame = frame_length_;
+      Reset();
+      if (CheckFrame(carry_.data(), length_of_frame)) {
+        *frame = carry_.data();
+        *frame_length = length_of_frame;
+        return true;
+      }
+      continue;
+    }
+
+    // Look for a frame within the data.
+    const uint8_t *begin = static_cast<const uint8_t *>(
+        std::memchr(*data, novatel::SYNC_0, data_end - *data));
+    if (begin == nullptr) {
+      *data = data_end;
+      return false;
+    }
+    const size_t available = data_end - begin;
+    size_t matched = 1;
+    while (matched < SYNC_LENGTH && matched < available &&
+           SyncByteMatches(matched, begin[matched])) {
+      ++matched;
+    }
+    if (matched < SYNC_LENGTH && matched < available) {
+      // The mismatching byte may start the next frame.
+      *data = begin + matched;
+      continue;
+    }
+    size_t length = 0;
+    if (matched == SYNC_LENGTH && available >= HeaderLength(begin)) {
+      length = FrameLength(begin);
+      if (available >= length) {
+        *data = begin + length;
+        if (CheckFrame(begin, length)) {
+          *frame = begin;
+          *frame_length = length;
+          return true;
+        }
+        continue;
+      }
+    }
+    // The frame goes on in the next update.
+    std::memcpy(carry_.data(), begin, available);
+    carry_size_ = available;
+    frame_length_ = length;
+    *data = data_end;
+    return false;
+  }
+  return false;
+}
+
+}  // namespace gnss
+}  // namespace drivers
+}  // namespace apollo
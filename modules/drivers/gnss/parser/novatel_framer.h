@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Splits a stream of NovAtel binary logs into CRC checked frames. A frame
+// that lies within the data of a single Update() is returned in place;
+// only a frame split across updates is copied, into a carry buffer that is
+// allocated once for the longest possible frame.
+
+#ifndef MODULES_DRIVERS_GNSS_NOVATEL_FRAMER_H_
+#define MODULES_DRIVERS_GNSS_NOVATEL_FRAMER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace apollo {
+namespace drivers {
+namespace gnss {
+
+// CRC32 of the NovAtel documents (reflected 0xEDB88320, initial value 0, no
+// final xor), computed 8 bytes at a time with slicing-by-8 tables.
+uint32_t NovatelCrc32(const uint8_t *buffer, size_t length);
+
+class NovatelFramer {
+ public:
+  NovatelFramer();
+
+  // Finds the next frame with a valid CRC in [*data, data_end) and advances
+  // *data past it. The frame, header and CRC included, stays valid until the
+  // next call, and points either into the data or into the carry buffer.
+  // Returns false once all the data is consumed.
+  bool Next(const uint8_t **data, const uint8_t *data_end,
+            const uint8_t **frame, size_t *frame_length);
+
+  // Drops a partial frame.
+  void Reset();
+
+  size_t crc_errors() const { return crc_errors_; }
+
+ private:
+  bool CheckFrame(const uint8_t *frame, size_t frame_length);
+
+  // Bytes of a frame split across updates.
+  std::vector<uint8_t> carry_;
+  size_t carry_size_ = 0;
+
+  // Length of the frame in the carry buffer, 0 until its header is complete.
+  size_t frame_length_ = 0;
+
+  size_t crc_errors_ = 0;
+};
+
+}  // namespace gnss
+}  // namespace drivers
+}  // namespace apollo
+
+#endif  // MODULES_DRIVERS_GNSS_NOVATEL_FRAMER_H_
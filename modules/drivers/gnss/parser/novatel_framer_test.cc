@@ -0,0 +1,164 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/gnss/parser/novatel_framer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/drivers/gnss/parser/novatel_messages.h"
+
+namespace apollo {
+namespace drivers {
+namespace gnss {
+
+namespace {
+
+// The bitwise CRC of the NovAtel documents.
+uint32_t ReferenceCrc32(const uint8_t* buffer, size_t length) {
+  uint32_t word = 0;
+  while (length--) {
+    uint32_t t = (word ^ *buffer++) & 0xFF;
+    for (int j = 0; j < 8; ++j) {
+      t = (t & 1) ? (t >> 1) ^ 0xEDB88320 : t >> 1;
+    }
+    word = ((word >> 8) & 0xFFFFFF) ^ t;
+  }
+  return word;
+}
+
+void AppendCrc(std::vector<uint8_t>* frame) {
+  const uint32_t crc = ReferenceCrc32(frame->data(), frame->size());
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&crc);
+  frame->insert(frame->end(), bytes, bytes + sizeof(crc));
+}
+
+std::vector<uint8_t> LongFrame(uint16_t message_length, uint8_t fill) {
+  novatel::LongHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.sync[0] = novatel::SYNC_0;
+  header.sync[1] = novatel::SYNC_1;
+  header.sync[2] = novatel::SYNC_2_LONG_HEADER;
+  header.header_length = sizeof(header);
+  header.message_length = message_length;
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+  std::vector<uint8_t> frame(bytes, bytes + sizeof(header));
+  frame.resize(frame.size() + message_length, fill);
+  AppendCrc(&frame);
+  return frame;
+}
+
+std::vector<uint8_t> ShortFrame(uint8_t message_length, uint8_t fill) {
+  novatel::ShortHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.sync[0] = novatel::SYNC_0;
+  header.sync[1] = novatel::SYNC_1;
+  header.sync[2] = novatel::SYNC_2_SHORT_HEADER;
+  header.message_length = message_length;
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+  std::vector<uint8_t> frame(bytes, bytes + sizeof(header));
+  frame.resize(frame.size() + message_length, fill);
+  AppendCrc(&frame);
+  return frame;
+}
+
+// Feeds the stream in chunks of chunk_size bytes and collects the frames.
+std::vector<std::vector<uint8_t>> Split(const std::vector<uint8_t>& stream,
+                                        size_t chunk_size,
+                                        NovatelFramer* framer) {
+  std::vector<std::vector<uint8_t>> frames;
+  for (size_t begin = 0; begin < stream.size(); begin += chunk_size) {
+    const uint8_t* data = stream.data() + begin;
+    const uint8_t* data_end =
+        stream.data() + std::min(begin + chunk_size, stream.size());
+    const uint8_t* frame = nullptr;
+    size_t frame_length = 0;
+    while (framer->Next(&data, data_end, &frame, &frame_length)) {
+      frames.emplace_back(frame, frame + frame_length);
+    }
+    EXPECT_EQ(data_end, data);
+  }
+  return frames;
+}
+
+}  // namespace
+
+TEST(NovatelCrc32Test, SameAsReference) {
+  std::mt19937 random_engine(3);
+  std::vector<uint8_t> buffer(1000);
+  for (auto& byte : buffer) {
+    byte = static_cast<uint8_t>(random_engine());
+  }
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t length = 0; length < 40; ++length) {
+      EXPECT_EQ(ReferenceCrc32(buffer.data() + offset, length),
+                NovatelCrc32(buffer.data() + offset, length));
+    }
+  }
+  EXPECT_EQ(ReferenceCrc32(buffer.data(), buffer.size()),
+            NovatelCrc32(buffer.data(), buffer.size()));
+}
+
+TEST(NovatelFramerTest, SplitFrames) {
+  std::vector<std::vector<uint8_t>> expected = {
+      LongFrame(40, 0x01), ShortFrame(30, 0x02), LongFrame(300, 0xAA),
+      ShortFrame(0, 0x03), LongFrame(88, 0x44)};
+  std::vector<uint8_t> corrupted = LongFrame(20, 0x05);
+  corrupted[30] ^= 0xFF;
+
+  // Frames with garbage, a partial sync and a corrupted frame in between.
+  std::vector<uint8_t> stream = {0x00, novatel::SYNC_0, 0x01};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    stream.insert(stream.end(), expected[i].begin(), expected[i].end());
+    if (i == 1) {
+      stream.insert(stream.end(), corrupted.begin(), corrupted.end());
+    }
+    if (i == 2) {
+      stream.push_back(novatel::SYNC_0);
+      stream.push_back(novatel::SYNC_1);
+      stream.push_back(0x77);
+    }
+  }
+
+  for (const size_t chunk_size : {size_t(1), size_t(3), size_t(17),
+                                  size_t(64), stream.size()}) {
+    NovatelFramer framer;
+    EXPECT_EQ(expected, Split(stream, chunk_size, &framer)) << chunk_size;
+    EXPECT_EQ(1, framer.crc_errors());
+  }
+}
+
+TEST(NovatelFramerTest, FramesInPlace) {
+  const std::vector<uint8_t> stream = LongFrame(40, 0x01);
+  NovatelFramer framer;
+  const uint8_t* data = stream.data();
+  const uint8_t* frame = nullptr;
+  size_t frame_length = 0;
+  EXPECT_TRUE(framer.Next(&data, stream.data() + stream.size(), &frame,
+                          &frame_length));
+  EXPECT_EQ(stream.data(), frame);
+  EXPECT_EQ(stream.size(), frame_length);
+  EXPECT_FALSE(framer.Next(&data, stream.data() + stream.size(), &frame,
+                           &frame_length));
+}
+
+}  // namespace gnss
+}  // namespace drivers
+}  // namespace apollo
@@ -27,6 +27,7 @@
 #include "ros/include/ros/ros.h"
 
 #include "modules/common/log.h"
+#include "modules/drivers/gnss/parser/novatel_framer.h"
 #include "modules/drivers/gnss/parser/novatel_messages.h"
 #include "modules/drivers/gnss/parser/parser.h"
 #include "modules/drivers/gnss/parser/rtcm_decode.h"
@@ -45,8 +46,6 @@ namespace gnss {
 // Anonymous namespace that contains helper constants and functions.
 namespace {
 
-constexpr size_t BUFFER_SIZE = 256;
-
 constexpr int SECONDS_PER_WEEK = 60 * 60 * 24 * 7;
 
 constexpr double DEG_TO_RAD = M_PI / 180.0;
@@ -65,28 +64,6 @@ constexpr bool is_zero(T value) {
   return value == static_cast<T>(0);
 }
 
-// CRC algorithm from the NovAtel document.
-inline uint32_t crc32_word(uint32_t word) {
-  for (int j = 0; j < 8; ++j) {
-    if (word & 1) {
-      word = (word >> 1) ^ 0xEDB88320;
-    } else {
-      word >>= 1;
-    }
-  }
-  return word;
-}
-
-inline uint32_t crc32_block(const uint8_t* buffer, size_t length) {
-  uint32_t word = 0;
-  while (length--) {
-    uint32_t t1 = (word >> 8) & 0xFFFFFF;
-    uint32_t t2 = crc32_word((word ^ *buffer++) & 0xFF);
-    word = t1 ^ t2;
-  }
-  return word;
-}
-
 // Converts NovAtel's azimuth (north = 0, east = 90) to FLU yaw (east = 0, north
 // = pi/2).
 constexpr double azimuth_deg_to_yaw_rad(double azimuth) {
@@ -112,9 +89,9 @@ class NovatelParser : public Parser {
   virtual MessageType GetMessage(MessagePtr* message_ptr);
 
  private:
-  bool check_crc();
-
-  Parser::MessageType PrepareMessage(MessagePtr* message_ptr);
+  // The frame has been CRC checked by the framer.
+  Parser::MessageType PrepareMessage(const uint8_t* frame, size_t frame_length,
+                                     MessagePtr* message_ptr);
 
   // The handle_xxx functions return whether a message is ready.
   bool HandleBestPos(const novatel::BestPos* pos, uint16_t gps_week,
@@ -163,11 +140,7 @@ class NovatelParser : public Parser {
 
   double imu_measurement_time_previous_ = -1.0;
 
-  std::vector<uint8_t> buffer_;
-
-  size_t header_length_ = 0;
-
-  size_t total_length_ = 0;
+  NovatelFramer framer_;
 
   config::ImuType imu_type_ = config::ImuType::ADIS16488;
 
@@ -195,7 +168,6 @@ Parser* Parser::CreateNovatel(const config::Config& config) {
 }
 
 NovatelParser::NovatelParser() {
-  buffer_.reserve(BUFFER_SIZE);
   ins_.mutable_position_covariance()->Resize(9, FLOAT_NAN);
   ins_.mutable_euler_angles_covariance()->Resize(9, FLOAT_NAN);
   ins_.mutable_linear_velocity_covariance()->Resize(9, FLOAT_NAN);
@@ -206,7 +178,6 @@ NovatelParser::NovatelParser() {
 }
 
 NovatelParser::NovatelParser(const config::Config& config) {
-  buffer_.reserve(BUFFER_SIZE);
   ins_.mutable_position_covariance()->Resize(9, FLOAT_NAN);
   ins_.mutable_euler_angles_covariance()->Resize(9, FLOAT_NAN);
   ins_.mutable_linear_velocity_covariance()->Resize(9, FLOAT_NAN);
@@ -225,93 +196,35 @@ Parser::MessageType NovatelParser::GetMessage(MessagePtr* message_ptr) {
     return MessageType::NONE;
   }
 
-  while (data_ < data_end_) {
-    if (buffer_.size() == 0) {  // Looking for SYNC0
-      if (*data_ == novatel::SYNC_0) {
-        buffer_.push_back(*data_);
-      }
-      ++data_;
-    } else if (buffer_.size() == 1) {  // Looking for SYNC1
-      if (*data_ == novatel::SYNC_1) {
-        buffer_.push_back(*data_++);
-      } else {
-        buffer_.clear();
-      }
-    } else if (buffer_.size() == 2) {  // Looking for SYNC2
-      switch (*data_) {
-        case novatel::SYNC_2_LONG_HEADER:
-          buffer_.push_back(*data_++);
-          header_length_ = sizeof(novatel::LongHeader);
-          break;
-        case novatel::SYNC_2_SHORT_HEADER:
-          buffer_.push_back(*data_++);
-          header_length_ = sizeof(novatel::ShortHeader);
-          break;
-        default:
-          buffer_.clear();
-      }
-    } else if (header_length_ > 0) {  // Working on header.
-      if (buffer_.size() < header_length_) {
-        buffer_.push_back(*data_++);
-      } else {
-        if (header_length_ == sizeof(novatel::LongHeader)) {
-          total_length_ = header_length_ + novatel::CRC_LENGTH +
-                          reinterpret_cast<novatel::LongHeader*>(buffer_.data())
-                              ->message_length;
-        } else if (header_length_ == sizeof(novatel::ShortHeader)) {
-          total_length_ =
-              header_length_ + novatel::CRC_LENGTH +
-              reinterpret_cast<novatel::ShortHeader*>(buffer_.data())
-                  ->message_length;
-        } else {
-          AERROR << "Incorrect header_length_. Should never reach here.";
-          buffer_.clear();
-        }
-        header_length_ = 0;
-      }
-    } else if (total_length_ > 0) {
-      if (buffer_.size() < total_length_) {  // Working on body.
-        buffer_.push_back(*data_++);
-        continue;
-      }
-      MessageType type = PrepareMessage(message_ptr);
-      buffer_.clear();
-      total_length_ = 0;
-      if (type != MessageType::NONE) {
-        return type;
-      }
+  const uint8_t* frame = nullptr;
+  size_t frame_length = 0;
+  while (framer_.Next(&data_, data_end_, &frame, &frame_length)) {
+    MessageType type = PrepareMessage(frame, frame_length, message_ptr);
+    if (type != MessageType::NONE) {
+      return type;
     }
   }
   return MessageType::NONE;
 }
 
-bool NovatelParser::check_crc() {
-  size_t l = buffer_.size() - novatel::CRC_LENGTH;
-  return crc32_block(buffer_.data(), l) ==
-         *reinterpret_cast<uint32_t*>(buffer_.data() + l);
-}
-
-Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
-  if (!check_crc()) {
-    AERROR << "CRC check failed.";
-    return MessageType::NONE;
-  }
-
-  uint8_t* message = nullptr;
+Parser::MessageType NovatelParser::PrepareMessage(const uint8_t* frame,
+                                                  size_t frame_length,
+                                                  MessagePtr* message_ptr) {
+  const uint8_t* message = nullptr;
   novatel::MessageId message_id;
   uint16_t message_length;
   uint16_t gps_week;
   uint32_t gps_millisecs;
-  if (buffer_[2] == novatel::SYNC_2_LONG_HEADER) {
-    auto header = reinterpret_cast<const novatel::LongHeader*>(buffer_.data());
-    message = buffer_.data() + sizeof(novatel::LongHeader);
+  if (frame[2] == novatel::SYNC_2_LONG_HEADER) {
+    auto header = reinterpret_cast<const novatel::LongHeader*>(frame);
+    message = frame + sizeof(novatel::LongHeader);
     gps_week = header->gps_week;
     gps_millisecs = header->gps_millisecs;
     message_id = header->message_id;
     message_length = header->message_length;
   } else {
-    auto header = reinterpret_cast<const novatel::ShortHeader*>(buffer_.data());
-    message = buffer_.data() + sizeof(novatel::ShortHeader);
+    auto header = reinterpret_cast<const novatel::ShortHeader*>(frame);
+    message = frame + sizeof(novatel::ShortHeader);
     gps_week = header->gps_week;
     gps_millisecs = header->gps_millisecs;
     message_id = header->message_id;
@@ -323,7 +236,7 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         AERROR << "Incorrect message_length";
         break;
       }
-      if (HandleGnssBestpos(reinterpret_cast<novatel::BestPos*>(message),
+      if (HandleGnssBestpos(reinterpret_cast<const novatel::BestPos*>(message),
                             gps_week, gps_millisecs)) {
         *message_ptr = &bestpos_;
         return MessageType::BEST_GNSS_POS;
@@ -336,8 +249,8 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         AERROR << "Incorrect message_length";
         break;
       }
-      if (HandleBestPos(reinterpret_cast<novatel::BestPos*>(message), gps_week,
-                        gps_millisecs)) {
+      if (HandleBestPos(reinterpret_cast<const novatel::BestPos*>(message),
+                        gps_week, gps_millisecs)) {
         *message_ptr = &gnss_;
         return MessageType::GNSS;
       }
@@ -350,8 +263,8 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         AERROR << "Incorrect message_length";
         break;
       }
-      if (HandleBestVel(reinterpret_cast<novatel::BestVel*>(message), gps_week,
-                        gps_millisecs)) {
+      if (HandleBestVel(reinterpret_cast<const novatel::BestVel*>(message),
+                        gps_week, gps_millisecs)) {
         *message_ptr = &gnss_;
         return MessageType::GNSS;
       }
@@ -364,7 +277,8 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         break;
       }
 
-      if (HandleCorrImuData(reinterpret_cast<novatel::CorrImuData*>(message))) {
+      if (HandleCorrImuData(
+              reinterpret_cast<const novatel::CorrImuData*>(message))) {
         *message_ptr = &ins_;
         return MessageType::INS;
       }
@@ -377,7 +291,7 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         break;
       }
 
-      if (HandleInsCov(reinterpret_cast<novatel::InsCov*>(message))) {
+      if (HandleInsCov(reinterpret_cast<const novatel::InsCov*>(message))) {
         *message_ptr = &ins_;
         return MessageType::INS;
       }
@@ -390,7 +304,7 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         break;
       }
 
-      if (HandleInsPva(reinterpret_cast<novatel::InsPva*>(message))) {
+      if (HandleInsPva(reinterpret_cast<const novatel::InsPva*>(message))) {
         *message_ptr = &ins_;
         return MessageType::INS;
       }
@@ -403,7 +317,7 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         break;
       }
 
-      if (HandleRawImuX(reinterpret_cast<novatel::RawImuX*>(message))) {
+      if (HandleRawImuX(reinterpret_cast<const novatel::RawImuX*>(message))) {
         *message_ptr = &imu_;
         return MessageType::IMU;
       }
@@ -416,7 +330,7 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         break;
       }
 
-      if (HandleRawImu(reinterpret_cast<novatel::RawImu*>(message))) {
+      if (HandleRawImu(reinterpret_cast<const novatel::RawImu*>(message))) {
         *message_ptr = &imu_;
         return MessageType::IMU;
       }
@@ -428,8 +342,8 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         break;
       }
 
-      if (HandleInsPvax(reinterpret_cast<novatel::InsPvaX*>(message), gps_week,
-                        gps_millisecs)) {
+      if (HandleInsPvax(reinterpret_cast<const novatel::InsPvaX*>(message),
+                        gps_week, gps_millisecs)) {
         *message_ptr = &ins_stat_;
         return MessageType::INS_STAT;
       }
@@ -440,7 +354,8 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         AERROR << "Incorrect BDSEPHEMERIS message_length";
         break;
       }
-      if (HandleBdsEph(reinterpret_cast<novatel::BDS_Ephemeris*>(message))) {
+      if (HandleBdsEph(
+              reinterpret_cast<const novatel::BDS_Ephemeris*>(message))) {
         *message_ptr = &gnss_ephemeris_;
         return MessageType::BDSEPHEMERIDES;
       }
@@ -451,7 +366,8 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         AERROR << "Incorrect GPSEPHEMERIS message_length";
         break;
       }
-      if (HandleGpsEph(reinterpret_cast<novatel::GPS_Ephemeris*>(message))) {
+      if (HandleGpsEph(
+              reinterpret_cast<const novatel::GPS_Ephemeris*>(message))) {
         *message_ptr = &gnss_ephemeris_;
         return MessageType::GPSEPHEMERIDES;
       }
@@ -462,15 +378,15 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         AERROR << "Incorrect GLOEPHEMERIS message length";
         break;
       }
-      if (HandleGloEph(reinterpret_cast<novatel::GLO_Ephemeris*>(message))) {
+      if (HandleGloEph(
+              reinterpret_cast<const novatel::GLO_Ephemeris*>(message))) {
         *message_ptr = &gnss_ephemeris_;
         return MessageType::GLOEPHEMERIDES;
       }
       break;
 
     case novatel::RANGE:
-      if (DecodeGnssObservation(buffer_.data(),
-                                buffer_.data() + buffer_.size())) {
+      if (DecodeGnssObservation(frame, frame + frame_length)) {
         *message_ptr = &gnss_observation_;
         return MessageType::OBSERVATION;
       }
@@ -481,8 +397,8 @@ Parser::MessageType NovatelParser::PrepareMessage(MessagePtr* message_ptr) {
         AERROR << "Incorrect message_length";
         break;
       }
-      if (HandleHeading(reinterpret_cast<novatel::Heading*>(message), gps_week,
-                        gps_millisecs)) {
+      if (HandleHeading(reinterpret_cast<const novatel::Heading*>(message),
+                        gps_week, gps_millisecs)) {
         *message_ptr = &heading_;
         return MessageType::HEADING;
       }
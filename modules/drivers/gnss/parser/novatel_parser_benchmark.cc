@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Throughput of the NovAtel parser over a binary log, fed in chunks as the
+// serial stream delivers it:
+//
+//   novatel_parser_benchmark [--novatel_log=<recorded binary log>]
+//
+// Without a log, one minute of 200 Hz CORRIMUDATA with 20 Hz INSPVA and
+// 1 Hz BESTPOS is generated.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/drivers/gnss/parser/novatel_framer.h"
+#include "modules/drivers/gnss/parser/novatel_messages.h"
+#include "modules/drivers/gnss/parser/parser.h"
+
+namespace apollo {
+namespace drivers {
+namespace gnss {
+namespace {
+
+const char kLogFlag[] = "--novatel_log=";
+
+std::string log_file;  // NOLINT
+
+// The bitwise CRC of the NovAtel documents, which the parser used.
+uint32_t BitwiseCrc32(const uint8_t *buffer, size_t length) {
+  uint32_t word = 0;
+  while (length--) {
+    uint32_t t = (word ^ *buffer++) & 0xFF;
+    for (int j = 0; j < 8; ++j) {
+      t = (t & 1) ? (t >> 1) ^ 0xEDB88320 : t >> 1;
+    }
+    word = ((word >> 8) & 0xFFFFFF) ^ t;
+  }
+  return word;
+}
+
+void AppendFrame(novatel::MessageId message_id, uint16_t message_length,
+                 uint32_t gps_millisecs, std::vector<uint8_t> *stream) {
+  novatel::LongHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.sync[0] = novatel::SYNC_0;
+  header.sync[1] = novatel::SYNC_1;
+  header.sync[2] = novatel::SYNC_2_LONG_HEADER;
+  header.header_length = sizeof(header);
+  header.message_id = message_id;
+  header.message_length = message_length;
+  header.gps_week = 2000;
+  header.gps_millisecs = gps_millisecs;
+  const size_t begin = stream->size();
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&header);
+  stream->insert(stream->end(), bytes, bytes + sizeof(header));
+  stream->resize(stream->size() + message_length, 0);
+  const uint32_t crc =
+      BitwiseCrc32(stream->data() + begin, stream->size() - begin);
+  bytes = reinterpret_cast<const uint8_t *>(&crc);
+  stream->insert(stream->end(), bytes, bytes + sizeof(crc));
+}
+
+const std::vector<uint8_t> &Log() {
+  static const std::vector<uint8_t> log = [] {
+    std::vector<uint8_t> stream;
+    if (!log_file.empty()) {
+      std::ifstream fin(log_file, std::ios::binary);
+      stream.assign(std::istreambuf_iterator<char>(fin),
+                    std::istreambuf_iterator<char>());
+      return stream;
+    }
+    for (uint32_t i = 0; i < 60 * 200; ++i) {
+      const uint32_t gps_millisecs = i * 5;
+      AppendFrame(novatel::CORRIMUDATA, sizeof(novatel::CorrImuData),
+                  gps_millisecs, &stream);
+      if (i % 10 == 0) {
+        AppendFrame(novatel::INSPVA, sizeof(novatel::InsPva), gps_millisecs,
+                    &stream);
+      }
+      if (i % 200 == 0) {
+        AppendFrame(novatel::BESTPOS, sizeof(novatel::BestPos), gps_millisecs,
+                    &stream);
+      }
+    }
+    return stream;
+  }();
+  return log;
+}
+
+void SetThroughput(benchmark::State &state, size_t frames) {  // NOLINT
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          Log().size());
+  state.SetLabel("frames=" + std::to_string(frames));
+}
+
+void BM_NovatelParser(benchmark::State &state) {  // NOLINT
+  const std::vector<uint8_t> &log = Log();
+  const size_t chunk_size = state.range(0);
+  config::Config config;
+  std::unique_ptr<Parser> parser(Parser::CreateNovatel(config));
+  size_t frames = 0;
+  while (state.KeepRunning()) {
+    frames = 0;
+    for (size_t begin = 0; begin < log.size(); begin += chunk_size) {
+      parser->Update(log.data() + begin,
+                     std::min(chunk_size, log.size() - begin));
+      MessagePtr message = nullptr;
+      while (parser->GetMessage(&message) != Parser::MessageType::NONE) {
+        ++frames;
+      }
+    }
+  }
+  SetThroughput(state, frames);
+}
+BENCHMARK(BM_NovatelParser)->Arg(64)->Arg(1024);
+
+// Framing and CRC only.
+void BM_NovatelFramer(benchmark::State &state) {  // NOLINT
+  const std::vector<uint8_t> &log = Log();
+  const size_t chunk_size = state.range(0);
+  NovatelFramer framer;
+  size_t frames = 0;
+  while (state.KeepRunning()) {
+    frames = 0;
+    for (size_t begin = 0; begin < log.size(); begin += chunk_size) {
+      const uint8_t *data = log.data() + begin;
+      const uint8_t *data_end = data + std::min(chunk_size, log.size() - begin);
+      const uint8_t *frame = nullptr;
+      size_t frame_length = 0;
+      while (framer.Next(&data, data_end, &frame, &frame_length)) {
+        ++frames;
+      }
+    }
+  }
+  SetThroughput(state, frames);
+}
+BENCHMARK(BM_NovatelFramer)->Arg(64)->Arg(1024);
+
+void BM_BitwiseCrc32(benchmark::State &state) {  // NOLINT
+  const std::vector<uint8_t> &log = Log();
+  uint32_t crc = 0;
+  while (state.KeepRunning()) {
+    crc ^= BitwiseCrc32(log.data(), log.size());
+  }
+  benchmark::DoNotOptimize(crc);
+  SetThroughput(state, 0);
+}
+BENCHMARK(BM_BitwiseCrc32);
+
+void BM_NovatelCrc32(benchmark::State &state) {  // NOLINT
+  const std::vector<uint8_t> &log = Log();
+  uint32_t crc = 0;
+  while (state.KeepRunning()) {
+    crc ^= NovatelCrc32(log.data(), log.size());
+  }
+  benchmark::DoNotOptimize(crc);
+  SetThroughput(state, 0);
+}
+BENCHMARK(BM_NovatelCrc32);
+
+}  // namespace
+}  // namespace gnss
+}  // namespace drivers
+}  // namespace apollo
+
+int main(int argc, char **argv) {
+  // Takes out the log flag before the benchmark flags are parsed.
+  int benchmark_argc = 0;
+  for (int i = 0; i < argc; ++i) {
+    if (std::strncmp(argv[i], apollo::drivers::gnss::kLogFlag,
+                     sizeof(apollo::drivers::gnss::kLogFlag) - 1) == 0) {
+      apollo::drivers::gnss::log_file =
+          argv[i] + sizeof(apollo::drivers::gnss::kLogFlag) - 1;
+    } else {
+      argv[benchmark_argc++] = argv[i];
+    }
+  }
+  benchmark::Initialize(&benchmark_argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
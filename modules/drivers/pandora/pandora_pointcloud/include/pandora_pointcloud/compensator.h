@@ -26,6 +26,8 @@
 #include <Eigen/Eigen>
 #include <string>
 
+#include "modules/drivers/point_cloud_shm/point_cloud_shm_ring.h"
+
 namespace apollo {
 namespace drivers {
 namespace pandora {
@@ -71,6 +73,10 @@ class Compensator {
   * @brief get point field size by sensor_msgs::datatype
   */
   inline uint get_field_size(const int data_type);
+  /**
+  * @brief copy the compensated point cloud into the shared memory ring
+  */
+  void write_shm(const sensor_msgs::PointCloud2& msg);
 
   // subsrcibe pandora pointcloud2 msg.
   ros::Subscriber pointcloud_sub_;
@@ -97,6 +103,10 @@ class Compensator {
   std::string topic_pointcloud_;
   // ros queue size for publisher and subscriber
   int queue_size_;
+
+  // name of the shared memory ring to also write point clouds to, if any
+  std::string shm_name_;
+  PointCloudShmRing shm_ring_;
 };
 
 }  // namespace pandora
@@ -0,0 +1,356 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/point_cloud_shm/point_cloud_shm_ring.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+
+namespace apollo {
+namespace drivers {
+namespace {
+
+// The atomics below are shared between processes, which only works when they
+// need no lock.
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "atomics in shared memory must be lock free");
+
+constexpr uint32_t kMagic = 0x48534350;  // "PCSH"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kAlignment = 64;
+
+size_t AlignUp(const size_t size) {
+  return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::string ErrnoMessage(const std::string& what, const std::string& name) {
+  return what + " " + name + ": " + std::strerror(errno);
+}
+
+// The futexes are not private, so that they work across processes.
+void FutexWait(const std::atomic<uint32_t>* word, const uint32_t value,
+               const timespec* timeout) {
+  syscall(SYS_futex, word, FUTEX_WAIT, value, timeout, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+const uint32_t PointCloudShmRing::kMaxFrameIdLength;
+
+struct PointCloudShmRing::Header {
+  // Set last by the writer, once the ring is ready.
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t max_points;
+  uint64_t slot_size;
+  // Number of the latest frame written.
+  std::atomic<uint64_t> latest_frame;
+  // Bumped with every frame, for the readers to wait on.
+  std::atomic<uint32_t> futex_word;
+};
+
+struct PointCloudShmRing::SlotHeader {
+  // 2n - 1 while frame n is being written, 2n once it is.
+  std::atomic<uint64_t> sequence;
+  double timestamp;
+  uint32_t num_points;
+  uint32_t width;
+  uint32_t height;
+  uint32_t is_dense;
+  char frame_id[kMaxFrameIdLength];
+};
+
+PointCloudShmRing::~PointCloudShmRing() { Close(); }
+
+bool PointCloudShmRing::Create(const std::string& name,
+                               const uint32_t num_slots,
+                               const uint32_t max_points, std::string* error) {
+  Close();
+  if (num_slots == 0 || max_points == 0) {
+    *error = "a point cloud ring needs slots and points: " + name;
+    return false;
+  }
+  // A writer which died leaves its ring behind; its readers keep their
+  // mapping of the old one until they open the ring again.
+  shm_unlink(name.c_str());
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+  if (fd < 0) {
+    *error = ErrnoMessage("failed to create", name);
+    return false;
+  }
+  SetLayout(num_slots, max_points);
+  const size_t size = AlignUp(sizeof(Header)) + num_slots * slot_size_;
+  if (ftruncate(fd, size) != 0) {
+    *error = ErrnoMessage("failed to resize", name);
+    close(fd);
+    shm_unlink(name.c_str());
+    return false;
+  }
+  if (!Map(name, fd, size, true, error)) {
+    shm_unlink(name.c_str());
+    return false;
+  }
+  name_ = name;
+  is_writer_ = true;
+  header_ = new (memory_) Header();
+  header_->version = kVersion;
+  header_->num_slots = num_slots;
+  header_->max_points = max_points;
+  header_->slot_size = slot_size_;
+  for (uint64_t frame = 1; frame <= num_slots; ++frame) {
+    new (GetSlot(frame)) SlotHeader();
+  }
+  header_->magic.store(kMagic, std::memory_order_release);
+  return true;
+}
+
+bool PointCloudShmRing::Open(const std::string& name, std::string* error) {
+  Close();
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    *error = ErrnoMessage("failed to open", name);
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    *error = ErrnoMessage("failed to stat", name);
+    close(fd);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  if (size < AlignUp(sizeof(Header))) {
+    *error = "point cloud ring is not ready: " + name;
+    close(fd);
+    return false;
+  }
+  if (!Map(name, fd, size, false, error)) {
+    return false;
+  }
+  Header* header = static_cast<Header*>(memory_);
+  if (header->magic.load(std::memory_order_acquire) != kMagic ||
+      header->version != kVersion) {
+    *error = "point cloud ring is not ready or of another version: " + name;
+    Close();
+    return false;
+  }
+  SetLayout(header->num_slots, header->max_points);
+  if (header->slot_size != slot_size_ ||
+      size < AlignUp(sizeof(Header)) + num_slots_ * slot_size_) {
+    *error = "point cloud ring has a different layout: " + name;
+    Close();
+    return false;
+  }
+  name_ = name;
+  header_ = header;
+  return true;
+}
+
+void PointCloudShmRing::Close() {
+  if (memory_ != nullptr) {
+    munmap(memory_, size_);
+  }
+  if (is_writer_) {
+    shm_unlink(name_.c_str());
+  }
+  name_.clear();
+  is_writer_ = false;
+  memory_ = nullptr;
+  size_ = 0;
+  header_ = nullptr;
+  SetLayout(0, 0);
+}
+
+bool PointCloudShmRing::Write(const uint8_t* points, const size_t size,
+                              const uint32_t num_points,
+                              const PackedPointLayout& layout,
+                              const FrameInfo& info) {
+  if (!is_writer_ || num_points > max_points_) {
+    return false;
+  }
+  if (layout.x_offset + sizeof(float) > layout.point_step ||
+      layout.y_offset + sizeof(float) > layout.point_step ||
+      layout.z_offset + sizeof(float) > layout.point_step ||
+      layout.timestamp_offset + sizeof(double) > layout.point_step ||
+      layout.intensity_offset + sizeof(uint8_t) > layout.point_step) {
+    return false;
+  }
+  // The offsets above leave point_step nonzero.
+  if (size / layout.point_step < num_points) {
+    return false;
+  }
+  const uint64_t frame =
+      header_->latest_frame.load(std::memory_order_relaxed) + 1;
+  SlotHeader* slot = GetSlot(frame);
+  slot->sequence.store(2 * frame - 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  char* base = reinterpret_cast<char*>(slot);
+  float* x = reinterpret_cast<float*>(base + x_offset_);
+  float* y = reinterpret_cast<float*>(base + y_offset_);
+  float* z = reinterpret_cast<float*>(base + z_offset_);
+  double* timestamp = reinterpret_cast<double*>(base + timestamp_offset_);
+  uint8_t* intensity = reinterpret_cast<uint8_t*>(base + intensity_offset_);
+  for (uint32_t i = 0; i < num_points; ++i) {
+    const uint8_t* point = points + static_cast<size_t>(i) * layout.point_step;
+    std::memcpy(&x[i], point + layout.x_offset, sizeof(float));
+    std::memcpy(&y[i], point + layout.y_offset, sizeof(float));
+    std::memcpy(&z[i], point + layout.z_offset, sizeof(float));
+    std::memcpy(&timestamp[i], point + layout.timestamp_offset,
+                sizeof(double));
+    intensity[i] = point[layout.intensity_offset];
+  }
+  slot->timestamp = info.timestamp;
+  slot->num_points = num_points;
+  slot->width = info.width;
+  slot->height = info.height;
+  slot->is_dense = info.is_dense ? 1 : 0;
+  const size_t frame_id_length =
+      std::min<size_t>(info.frame_id.size(), kMaxFrameIdLength - 1);
+  std::memcpy(slot->frame_id, info.frame_id.data(), frame_id_length);
+  slot->frame_id[frame_id_length] = '\0';
+
+  slot->sequence.store(2 * frame, std::memory_order_release);
+  header_->latest_frame.store(frame, std::memory_order_release);
+  header_->futex_word.fetch_add(1, std::memory_order_release);
+  FutexWakeAll(&header_->futex_word);
+  return true;
+}
+
+uint64_t PointCloudShmRing::LatestFrame() const {
+  if (header_ == nullptr) {
+    return 0;
+  }
+  return header_->latest_frame.load(std::memory_order_acquire);
+}
+
+uint64_t PointCloudShmRing::WaitForFrame(const uint64_t last_frame,
+                                         const int timeout_ms) const {
+  if (header_ == nullptr) {
+    return last_frame;
+  }
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+  while (true) {
+    // Load the word before the frame: if a frame comes in between, the word
+    // has changed and the wait returns at once.
+    const uint32_t word = header_->futex_word.load(std::memory_order_acquire);
+    const uint64_t frame =
+        header_->latest_frame.load(std::memory_order_acquire);
+    if (frame > last_frame) {
+      return frame;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return last_frame;
+    }
+    const int64_t remaining =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now)
+            .count();
+    timespec timeout;
+    timeout.tv_sec = remaining / 1000000000;
+    timeout.tv_nsec = remaining % 1000000000;
+    FutexWait(&header_->futex_word, word, &timeout);
+  }
+}
+
+void PointCloudShmRing::SetLayout(const uint32_t num_slots,
+                                  const uint32_t max_points) {
+  num_slots_ = num_slots;
+  max_points_ = max_points;
+  const size_t float_array_size = AlignUp(max_points * sizeof(float));
+  x_offset_ = AlignUp(sizeof(SlotHeader));
+  y_offset_ = x_offset_ + float_array_size;
+  z_offset_ = y_offset_ + float_array_size;
+  timestamp_offset_ = z_offset_ + float_array_size;
+  intensity_offset_ = timestamp_offset_ + AlignUp(max_points * sizeof(double));
+  slot_size_ = intensity_offset_ + AlignUp(max_points * sizeof(uint8_t));
+}
+
+bool PointCloudShmRing::Map(const std::string& name, const int fd,
+                            const size_t size, const bool writable,
+                            std::string* error) {
+  void* memory =
+      mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+           MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    *error = ErrnoMessage("failed to map", name);
+    return false;
+  }
+  memory_ = memory;
+  size_ = size;
+  return true;
+}
+
+PointCloudShmRing::SlotHeader* PointCloudShmRing::GetSlot(
+    const uint64_t frame) const {
+  char* slots = static_cast<char*>(memory_) + AlignUp(sizeof(Header));
+  return reinterpret_cast<SlotHeader*>(slots +
+                                       (frame - 1) % num_slots_ * slot_size_);
+}
+
+bool PointCloudShmRing::BeginRead(const uint64_t frame, FrameInfo* info,
+                                  FrameView* view) const {
+  if (header_ == nullptr || frame == 0) {
+    return false;
+  }
+  const SlotHeader* slot = GetSlot(frame);
+  if (slot->sequence.load(std::memory_order_acquire) != 2 * frame) {
+    return false;
+  }
+  info->timestamp = slot->timestamp;
+  info->width = slot->width;
+  info->height = slot->height;
+  info->is_dense = slot->is_dense != 0;
+  info->frame_id.assign(slot->frame_id,
+                        strnlen(slot->frame_id, kMaxFrameIdLength));
+
+  const char* base = reinterpret_cast<const char*>(slot);
+  // Bounded in case the writer is already overwriting the slot.
+  view->num_points = std::min(slot->num_points, max_points_);
+  view->x = reinterpret_cast<const float*>(base + x_offset_);
+  view->y = reinterpret_cast<const float*>(base + y_offset_);
+  view->z = reinterpret_cast<const float*>(base + z_offset_);
+  view->timestamp = reinterpret_cast<const double*>(base + timestamp_offset_);
+  view->intensity = reinterpret_cast<const uint8_t*>(base + intensity_offset_);
+  return true;
+}
+
+bool PointCloudShmRing::EndRead(const uint64_t frame) const {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return GetSlot(frame)->sequence.load(std::memory_order_relaxed) == 2 * frame;
+}
+
+}  // namespace drivers
+}  // namespace apollo
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A ring of point clouds in POSIX shared memory, to pass the clouds of
+ * a lidar driver to the processes on the same host without going through ROS.
+ *
+ * It depends on nothing but the C++11 library and Linux, so that the catkin
+ * drivers can build it as well.
+ **/
+
+#ifndef MODULES_DRIVERS_POINT_CLOUD_SHM_POINT_CLOUD_SHM_RING_H_
+#define MODULES_DRIVERS_POINT_CLOUD_SHM_POINT_CLOUD_SHM_RING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace apollo::drivers
+ * @brief apollo::drivers
+ */
+namespace apollo {
+namespace drivers {
+
+/**
+ * @class PointCloudShmRing
+ *
+ * @brief A ring of point cloud frames in shared memory, with one writer and
+ * any number of readers.
+ *
+ * The writer creates the ring under a name, e.g. "/apollo_velodyne64", and
+ * the readers open it read-only. Each slot of the ring holds one frame in a
+ * fixed struct-of-arrays layout: the x, y, z, per-point timestamp and
+ * intensity of up to max_points() points, each array 64-byte aligned.
+ *
+ * Frames are numbered from 1 and frame n goes to slot (n - 1) % num_slots.
+ * Every slot has a sequence number which is odd while the writer fills it,
+ * so that a reader can tell when the frame it read was overwritten meanwhile
+ * and drop it. The writer never waits for the readers.
+ */
+class PointCloudShmRing {
+ public:
+  static const uint32_t kMaxFrameIdLength = 64;
+
+  /**
+   * @brief Header of a frame, as that of the PointCloud2 it comes from.
+   */
+  struct FrameInfo {
+    double timestamp = 0.0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool is_dense = false;
+    std::string frame_id;
+  };
+
+  /**
+   * @brief Byte offsets of the fields of packed points, e.g. the data of a
+   * PointCloud2 with float x, y and z, uint8 intensity and double timestamp.
+   */
+  struct PackedPointLayout {
+    uint32_t point_step = 0;
+    uint32_t x_offset = 0;
+    uint32_t y_offset = 0;
+    uint32_t z_offset = 0;
+    uint32_t intensity_offset = 0;
+    uint32_t timestamp_offset = 0;
+  };
+
+  /**
+   * @brief The arrays of a frame in the ring. They point into the shared
+   * memory and are only valid within PointCloudShmRing::Read().
+   */
+  struct FrameView {
+    uint32_t num_points = 0;
+    const float* x = nullptr;
+    const float* y = nullptr;
+    const float* z = nullptr;
+    const double* timestamp = nullptr;
+    const uint8_t* intensity = nullptr;
+  };
+
+  PointCloudShmRing() = default;
+  ~PointCloudShmRing();
+
+  PointCloudShmRing(const PointCloudShmRing&) = delete;
+  PointCloudShmRing& operator=(const PointCloudShmRing&) = delete;
+
+  /**
+   * @brief Creates the ring as its writer, replacing any ring left under the
+   * same name. The ring is removed when the writer closes it.
+   */
+  bool Create(const std::string& name, const uint32_t num_slots,
+              const uint32_t max_points, std::string* error);
+
+  /**
+   * @brief Opens the ring created by a writer, as a reader.
+   */
+  bool Open(const std::string& name, std::string* error);
+
+  void Close();
+
+  bool IsOpen() const { return header_ != nullptr; }
+  uint32_t num_slots() const { return num_slots_; }
+  uint32_t max_points() const { return max_points_; }
+
+  /**
+   * @brief Copies packed points into the next slot and publishes them as the
+   * latest frame. Fails if there are more points than max_points(), or if
+   * the size bytes at points are fewer than num_points points.
+   */
+  bool Write(const uint8_t* points, const size_t size,
+             const uint32_t num_points, const PackedPointLayout& layout,
+             const FrameInfo& info);
+
+  /**
+   * @brief Number of the latest frame written, 0 if there is none.
+   */
+  uint64_t LatestFrame() const;
+
+  /**
+   * @brief Waits up to timeout_ms for a frame newer than last_frame, and
+   * returns the number of the latest frame, or last_frame on timeout.
+   */
+  uint64_t WaitForFrame(const uint64_t last_frame, const int timeout_ms) const;
+
+  /**
+   * @brief Calls reader(const FrameView&) on the arrays of a frame, in place.
+   * Returns false if the frame has been or was being overwritten, in which
+   * case whatever reader got from the view must be dropped.
+   */
+  template <typename Reader>
+  bool Read(const uint64_t frame, FrameInfo* info, Reader reader) const {
+    FrameView view;
+    if (!BeginRead(frame, info, &view)) {
+      return false;
+    }
+    reader(static_cast<const FrameView&>(view));
+    return EndRead(frame);
+  }
+
+ private:
+  struct Header;
+  struct SlotHeader;
+
+  void SetLayout(const uint32_t num_slots, const uint32_t max_points);
+  bool Map(const std::string& name, const int fd, const size_t size,
+           const bool writable, std::string* error);
+  SlotHeader* GetSlot(const uint64_t frame) const;
+  bool BeginRead(const uint64_t frame, FrameInfo* info, FrameView* view) const;
+  bool EndRead(const uint64_t frame) const;
+
+  std::string name_;
+  bool is_writer_ = false;
+  void* memory_ = nullptr;
+  size_t size_ = 0;
+  Header* header_ = nullptr;
+  uint32_t num_slots_ = 0;
+  uint32_t max_points_ = 0;
+  // Byte offsets of the arrays in a slot, and the size of a slot.
+  size_t x_offset_ = 0;
+  size_t y_offset_ = 0;
+  size_t z_offset_ = 0;
+  size_t timestamp_offset_ = 0;
+  size_t intensity_offset_ = 0;
+  size_t slot_size_ = 0;
+};
+
+}  // namespace drivers
+}  // namespace apollo
+
+#endif  // MODULES_DRIVERS_POINT_CLOUD_SHM_POINT_CLOUD_SHM_RING_H_
@@ -0,0 +1,234 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/point_cloud_shm/point_cloud_shm_ring.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace drivers {
+
+// As the points of the PointCloud2 published by the lidar drivers.
+struct PackedPoint {
+  float x;
+  float y;
+  float z;
+  float padding;
+  uint8_t intensity;
+  double timestamp;
+};
+
+class PointCloudShmRingTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    name_ = "/point_cloud_shm_ring_test_" + std::to_string(getpid());
+    layout_.point_step = sizeof(PackedPoint);
+    layout_.x_offset = offsetof(PackedPoint, x);
+    layout_.y_offset = offsetof(PackedPoint, y);
+    layout_.z_offset = offsetof(PackedPoint, z);
+    layout_.intensity_offset = offsetof(PackedPoint, intensity);
+    layout_.timestamp_offset = offsetof(PackedPoint, timestamp);
+  }
+
+  std::vector<PackedPoint> MakePoints(const int num_points, const int frame) {
+    std::vector<PackedPoint> points(num_points);
+    for (int i = 0; i < num_points; ++i) {
+      points[i].x = frame + i * 0.5f;
+      points[i].y = -i * 0.25f;
+      points[i].z = i * 0.125f;
+      points[i].intensity = static_cast<uint8_t>(i + frame);
+      points[i].timestamp = frame + i * 1e-6;
+    }
+    return points;
+  }
+
+  bool Write(PointCloudShmRing* ring, const int num_points, const int frame) {
+    const std::vector<PackedPoint> points = MakePoints(num_points, frame);
+    PointCloudShmRing::FrameInfo info;
+    info.timestamp = frame + 0.1;
+    info.width = num_points;
+    info.height = 1;
+    info.frame_id = "velodyne64";
+    return ring->Write(reinterpret_cast<const uint8_t*>(points.data()),
+                       points.size() * sizeof(PackedPoint), num_points,
+                       layout_, info);
+  }
+
+  void ExpectFrame(const PointCloudShmRing& ring, const uint64_t frame,
+                   const int num_points, const int frame_content) {
+    const std::vector<PackedPoint> expected =
+        MakePoints(num_points, frame_content);
+    std::vector<PackedPoint> points;
+    PointCloudShmRing::FrameInfo info;
+    ASSERT_TRUE(ring.Read(frame, &info,
+                          [&](const PointCloudShmRing::FrameView& view) {
+                            for (uint32_t i = 0; i < view.num_points; ++i) {
+                              PackedPoint point;
+                              point.x = view.x[i];
+                              point.y = view.y[i];
+                              point.z = view.z[i];
+                              point.intensity = view.intensity[i];
+                              point.timestamp = view.timestamp[i];
+                              points.push_back(point);
+                            }
+                          }));
+    EXPECT_DOUBLE_EQ(frame_content + 0.1, info.timestamp);
+    EXPECT_EQ(num_points, info.width);
+    EXPECT_EQ(1, info.height);
+    EXPECT_FALSE(info.is_dense);
+    EXPECT_EQ("velodyne64", info.frame_id);
+    ASSERT_EQ(expected.size(), points.size());
+    for (int i = 0; i < num_points; ++i) {
+      EXPECT_EQ(expected[i].x, points[i].x);
+      EXPECT_EQ(expected[i].y, points[i].y);
+      EXPECT_EQ(expected[i].z, points[i].z);
+      EXPECT_EQ(expected[i].intensity, points[i].intensity);
+      EXPECT_EQ(expected[i].timestamp, points[i].timestamp);
+    }
+  }
+
+  std::string name_;
+  PointCloudShmRing::PackedPointLayout layout_;
+};
+
+TEST_F(PointCloudShmRingTest, WriteAndRead) {
+  std::string error;
+  PointCloudShmRing writer;
+  ASSERT_TRUE(writer.Create(name_, 4, 1000, &error)) << error;
+  PointCloudShmRing reader;
+  ASSERT_TRUE(reader.Open(name_, &error)) << error;
+  EXPECT_EQ(4, reader.num_slots());
+  EXPECT_EQ(1000, reader.max_points());
+  EXPECT_EQ(0, reader.LatestFrame());
+
+  ASSERT_TRUE(Write(&writer, 1000, 1));
+  ASSERT_TRUE(Write(&writer, 10, 2));
+  EXPECT_EQ(2, reader.LatestFrame());
+  ExpectFrame(reader, 1, 1000, 1);
+  ExpectFrame(reader, 2, 10, 2);
+  PointCloudShmRing::FrameInfo info;
+  EXPECT_FALSE(
+      reader.Read(3, &info, [](const PointCloudShmRing::FrameView&) {}));
+  // Readers can not write.
+  EXPECT_FALSE(Write(&reader, 10, 3));
+}
+
+TEST_F(PointCloudShmRingTest, DropOverwrittenFrames) {
+  std::string error;
+  PointCloudShmRing writer;
+  ASSERT_TRUE(writer.Create(name_, 2, 100, &error)) << error;
+  PointCloudShmRing reader;
+  ASSERT_TRUE(reader.Open(name_, &error)) << error;
+  for (int frame = 1; frame <= 3; ++frame) {
+    ASSERT_TRUE(Write(&writer, 100, frame));
+  }
+  PointCloudShmRing::FrameInfo info;
+  EXPECT_FALSE(
+      reader.Read(1, &info, [](const PointCloudShmRing::FrameView&) {}));
+  ExpectFrame(reader, 2, 100, 2);
+  ExpectFrame(reader, 3, 100, 3);
+
+  // The writer laps the reader while it reads.
+  EXPECT_FALSE(reader.Read(3, &info,
+                           [&](const PointCloudShmRing::FrameView&) {
+                             Write(&writer, 100, 4);
+                             Write(&writer, 100, 5);
+                           }));
+  ExpectFrame(reader, 5, 100, 5);
+}
+
+TEST_F(PointCloudShmRingTest, RejectTooManyPoints) {
+  std::string error;
+  PointCloudShmRing writer;
+  ASSERT_TRUE(writer.Create(name_, 2, 100, &error)) << error;
+  EXPECT_FALSE(Write(&writer, 101, 1));
+  EXPECT_EQ(0, writer.LatestFrame());
+
+  PointCloudShmRing::PackedPointLayout layout = layout_;
+  layout.timestamp_offset = layout.point_step - 4;
+  std::vector<PackedPoint> points = MakePoints(10, 1);
+  EXPECT_FALSE(writer.Write(reinterpret_cast<const uint8_t*>(points.data()),
+                            points.size() * sizeof(PackedPoint), 10, layout,
+                            PointCloudShmRing::FrameInfo()));
+  EXPECT_EQ(0, writer.LatestFrame());
+}
+
+TEST_F(PointCloudShmRingTest, RejectShortBuffers) {
+  std::string error;
+  PointCloudShmRing writer;
+  ASSERT_TRUE(writer.Create(name_, 2, 100, &error)) << error;
+  const std::vector<PackedPoint> points = MakePoints(10, 1);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(points.data());
+  const size_t size = points.size() * sizeof(PackedPoint);
+  EXPECT_FALSE(writer.Write(data, size - 1, 10, layout_,
+                            PointCloudShmRing::FrameInfo()));
+  EXPECT_FALSE(writer.Write(data, 0, 1, layout_,
+                            PointCloudShmRing::FrameInfo()));
+  EXPECT_EQ(0, writer.LatestFrame());
+
+  PointCloudShmRing::PackedPointLayout layout = layout_;
+  layout.point_step = 0;
+  EXPECT_FALSE(
+      writer.Write(data, size, 10, layout, PointCloudShmRing::FrameInfo()));
+  EXPECT_EQ(0, writer.LatestFrame());
+
+  // A buffer may hold more than the points written.
+  EXPECT_TRUE(
+      writer.Write(data, size, 9, layout_, PointCloudShmRing::FrameInfo()));
+  EXPECT_EQ(1, writer.LatestFrame());
+}
+
+TEST_F(PointCloudShmRingTest, WaitForFrame) {
+  std::string error;
+  PointCloudShmRing writer;
+  ASSERT_TRUE(writer.Create(name_, 2, 100, &error)) << error;
+  PointCloudShmRing reader;
+  ASSERT_TRUE(reader.Open(name_, &error)) << error;
+  EXPECT_EQ(0, reader.WaitForFrame(0, 10));
+
+  std::thread writer_thread([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Write(&writer, 100, 1);
+  });
+  EXPECT_EQ(1, reader.WaitForFrame(0, 10000));
+  writer_thread.join();
+  EXPECT_EQ(1, reader.WaitForFrame(0, 0));
+  ExpectFrame(reader, 1, 100, 1);
+}
+
+TEST_F(PointCloudShmRingTest, OpenMissingRing) {
+  std::string error;
+  PointCloudShmRing reader;
+  EXPECT_FALSE(reader.Open(name_, &error));
+  EXPECT_FALSE(reader.IsOpen());
+
+  PointCloudShmRing writer;
+  ASSERT_TRUE(writer.Create(name_, 2, 100, &error)) << error;
+  ASSERT_TRUE(reader.Open(name_, &error)) << error;
+  writer.Close();
+  EXPECT_FALSE(PointCloudShmRing().Open(name_, &error));
+}
+
+}  // namespace drivers
+}  // namespace apollo
@@ -58,28 +58,21 @@ void ContiRadarMessageManager::set_can_client(
 
 ProtocolData<ContiRadar> *ContiRadarMessageManager::GetMutableProtocolDataById(
     const uint32_t message_id) {
-  uint32_t converted_message_id = message_id;
-  if (protocol_data_map_.find(converted_message_id) ==
-      protocol_data_map_.end()) {
-    ADEBUG << "Unable to get protocol data because of invalid message_id:"
-           << message_id;
-    return nullptr;
-  }
-  return protocol_data_map_[converted_message_id];
+  return MessageManager<ContiRadar>::GetMutableProtocolDataById(message_id);
 }
 
-void ContiRadarMessageManager::Parse(const uint32_t message_id,
-                                     const uint8_t *data, int32_t length) {
+bool ContiRadarMessageManager::ParseLocked(const uint32_t message_id,
+                                           const uint8_t *data,
+                                           int32_t length) {
   ProtocolData<ContiRadar> *sensor_protocol_data =
       GetMutableProtocolDataById(message_id);
   if (sensor_protocol_data == nullptr) {
-    return;
+    return false;
   }
 
-  std::lock_guard<std::mutex> lock(sensor_data_mutex_);
   if (!is_configured_ && message_id != RadarState201::ID) {
     // read radar state message first
-    return;
+    return false;
   }
 
   // trigger publishment
@@ -123,21 +116,7 @@ void ContiRadarMessageManager::Parse(const uint32_t message_id,
     }
   }
 
-  received_ids_.insert(message_id);
-  // check if need to check period
-  const auto it = check_ids_.find(message_id);
-  if (it != check_ids_.end()) {
-    const int64_t time = common::time::AsInt64<micros>(Clock::Now());
-    it->second.real_period = time - it->second.last_time;
-    // if period 1.5 large than base period, inc error_count
-    const double period_multiplier = 1.5;
-    if (it->second.real_period > (it->second.period * period_multiplier)) {
-      it->second.error_count += 1;
-    } else {
-      it->second.error_count = 0;
-    }
-    it->second.last_time = time;
-  }
+  return true;
 }
 
 }  // namespace conti_radar
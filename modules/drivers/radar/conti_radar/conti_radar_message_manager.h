@@ -52,9 +52,12 @@ class ContiRadarMessageManager : public MessageManager<ContiRadar> {
   void set_radar_conf(RadarConf radar_conf);
   ProtocolData<ContiRadar> *GetMutableProtocolDataById(
       const uint32_t message_id);
-  void Parse(const uint32_t message_id, const uint8_t *data, int32_t length);
   void set_can_client(std::shared_ptr<CanClient> can_client);
 
+ protected:
+  bool ParseLocked(const uint32_t message_id, const uint8_t *data,
+                   int32_t length) override;
+
  private:
   bool is_configured_ = false;
   RadarConfig200 radar_config_;
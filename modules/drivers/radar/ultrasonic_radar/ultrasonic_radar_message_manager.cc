@@ -39,8 +39,9 @@ void UltrasonicRadarMessageManager::set_can_client(
   can_client_ = can_client;
 }
 
-void UltrasonicRadarMessageManager::Parse(const uint32_t message_id,
-                                     const uint8_t *data, int32_t length) {
+bool UltrasonicRadarMessageManager::ParseLocked(const uint32_t message_id,
+                                                const uint8_t *data,
+                                                int32_t length) {
   if (message_id == 0x301) {
     sensor_data_.set_ranges(0, data[1]);
     sensor_data_.set_ranges(1, data[2]);
@@ -61,21 +62,7 @@ void UltrasonicRadarMessageManager::Parse(const uint32_t message_id,
     AdapterManager::PublishUltrasonic(sensor_data_);
   }
 
-  received_ids_.insert(message_id);
-  // check if need to check period
-  const auto it = check_ids_.find(message_id);
-  if (it != check_ids_.end()) {
-    const int64_t time = common::time::AsInt64<micros>(Clock::Now());
-    it->second.real_period = time - it->second.last_time;
-    // if period 1.5 large than base period, inc error_count
-    const double period_multiplier = 1.5;
-    if (it->second.real_period > (it->second.period * period_multiplier)) {
-      it->second.error_count += 1;
-    } else {
-      it->second.error_count = 0;
-    }
-    it->second.last_time = time;
-  }
+  return true;
 }
 
 }  // namespace ultrasonic_radar
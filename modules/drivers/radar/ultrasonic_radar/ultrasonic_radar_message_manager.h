@@ -47,9 +47,12 @@ class UltrasonicRadarMessageManager : public MessageManager<Ultrasonic> {
  public:
   explicit UltrasonicRadarMessageManager(int entrance_num);
   virtual ~UltrasonicRadarMessageManager() {}
-  void Parse(const uint32_t message_id, const uint8_t *data, int32_t length);
   void set_can_client(std::shared_ptr<CanClient> can_client);
 
+ protected:
+  bool ParseLocked(const uint32_t message_id, const uint8_t *data,
+                   int32_t length) override;
+
  private:
   std::shared_ptr<CanClient> can_client_;
   int entrance_num_;
@@ -15,6 +15,10 @@
  *****************************************************************************/
 
 #include "rslidar_pointcloud/compensator.h"
+
+#include <algorithm>
+#include <string>
+
 #include "ros/this_node.h"
 
 namespace apollo {
@@ -34,6 +38,21 @@ Compensator::Compensator(ros::NodeHandle node, ros::NodeHandle private_nh)
   private_nh.param("queue_size", queue_size_, 10);
   private_nh.param("tf_query_timeout", tf_timeout_, float(0.1));
 
+  // Also hand the compensated point clouds to the processes on this host
+  // through a ring in shared memory, if one is named.
+  private_nh.param("shm_name", shm_name_, std::string(""));
+  if (!shm_name_.empty()) {
+    int shm_slots = 4;
+    int shm_max_points = 400000;
+    private_nh.param("shm_slots", shm_slots, shm_slots);
+    private_nh.param("shm_max_points", shm_max_points, shm_max_points);
+    std::string error;
+    if (!shm_ring_.Create(shm_name_, std::max(shm_slots, 1),
+                          std::max(shm_max_points, 1), &error)) {
+      ROS_ERROR_STREAM("Failed to create point cloud ring: " << error);
+    }
+  }
+
   // advertise output point cloud (before subscribing to input data)
   compensation_pub_ = node.advertise<sensor_msgs::PointCloud2>(
       topic_compensated_pointcloud_, queue_size_);
@@ -65,10 +84,50 @@ void Compensator::pointcloud_callback(
     motion_compensation<float>(q_msg, timestamp_min, timestamp_max,
                                pose_min_time, pose_max_time);
     q_msg->header.stamp.fromSec(timestamp_max);
+    if (shm_ring_.IsOpen()) {
+      write_shm(*q_msg);
+    }
     compensation_pub_.publish(q_msg);
   }
 }
 
+void Compensator::write_shm(const sensor_msgs::PointCloud2& msg) {
+  PointCloudShmRing::PackedPointLayout layout;
+  layout.point_step = msg.point_step;
+  layout.x_offset = x_offset_;
+  layout.y_offset = y_offset_;
+  layout.z_offset = z_offset_;
+  layout.timestamp_offset = timestamp_offset_;
+  bool has_intensity = false;
+  for (size_t i = 0; i < msg.fields.size(); ++i) {
+    const sensor_msgs::PointField& f = msg.fields[i];
+    if (f.name == "intensity" && f.datatype == sensor_msgs::PointField::UINT8) {
+      layout.intensity_offset = f.offset;
+      has_intensity = true;
+    }
+  }
+  if (!has_intensity || timestamp_data_size_ != sizeof(double)) {
+    ROS_ERROR_THROTTLE(1, "point fields do not fit the point cloud ring");
+    return;
+  }
+
+  PointCloudShmRing::FrameInfo info;
+  info.timestamp = msg.header.stamp.toSec();
+  info.width = msg.width;
+  info.height = msg.height;
+  info.is_dense = msg.is_dense;
+  info.frame_id = msg.header.frame_id;
+  const uint32_t num_points = msg.width * msg.height;
+  if (!shm_ring_.Write(msg.data.data(), msg.data.size(), num_points, layout,
+                       info)) {
+    ROS_ERROR_STREAM_THROTTLE(1, "Failed to write " << num_points
+                                     << " points of " << msg.data.size()
+                                     << " bytes to point cloud ring "
+                                     << shm_name_ << " of "
+                                     << shm_ring_.max_points() << " points");
+  }
+}
+
 inline void Compensator::get_timestamp_interval(
     const sensor_msgs::PointCloud2ConstPtr& msg, double& timestamp_min,
     double& timestamp_max) {
@@ -27,6 +27,8 @@
 #include <tf2_ros/transform_listener.h>
 #include <Eigen/Eigen>
 
+#include "modules/drivers/point_cloud_shm/point_cloud_shm_ring.h"
+
 namespace apollo {
 namespace drivers {
 namespace velodyne {
@@ -72,6 +74,10 @@ class Compensator {
   * @brief get point field size by sensor_msgs::datatype
   */
   inline uint get_field_size(const int data_type);
+  /**
+  * @brief copy the compensated point cloud into the shared memory ring
+  */
+  void write_shm(const sensor_msgs::PointCloud2& msg);
 
   // subscribe velodyne pointcloud2 msg.
   ros::Subscriber pointcloud_sub_;
@@ -98,6 +104,10 @@ class Compensator {
   std::string topic_pointcloud_;
   // ros queue size for publisher and subscriber
   int queue_size_;
+
+  // name of the shared memory ring to also write point clouds to, if any
+  std::string shm_name_;
+  PointCloudShmRing shm_ring_;
 };
 
 }  // namespace velodyne
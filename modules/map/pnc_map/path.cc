@@ -680,28 +680,7 @@ bool Path::GetProjectionWithHueristicParams(const Vec2d& point,
     }
   }
   *min_distance = std::sqrt(*min_distance);
-  const auto& nearest_seg = segments_[min_index];
-  const auto prod = nearest_seg.ProductOntoUnit(point);
-  const auto proj = nearest_seg.ProjectOntoUnit(point);
-  if (min_index == 0) {
-    *accumulate_s = std::min(proj, nearest_seg.length());
-    if (proj < 0) {
-      *lateral = prod;
-    } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-    }
-  } else if (min_index == num_segments_ - 1) {
-    *accumulate_s = accumulated_s_[min_index] + std::max(0.0, proj);
-    if (proj > 0) {
-      *lateral = prod;
-    } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-    }
-  } else {
-    *accumulate_s = accumulated_s_[min_index] +
-                    std::max(0.0, std::min(proj, nearest_seg.length()));
-    *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-  }
+  ComputeProjection(point, min_index, *min_distance, accumulate_s, lateral);
   return true;
 }
 
@@ -729,6 +708,76 @@ bool Path::GetProjection(const Vec2d& point, double* accumulate_s,
     }
   }
   *min_distance = std::sqrt(*min_distance);
+  ComputeProjection(point, min_index, *min_distance, accumulate_s, lateral);
+  return true;
+}
+
+bool Path::GetProjections(const std::vector<Vec2d>& points,
+                          std::vector<double>* accumulate_s,
+                          std::vector<double>* lateral) const {
+  if (segments_.empty()) {
+    return false;
+  }
+  if (accumulate_s == nullptr || lateral == nullptr) {
+    return false;
+  }
+  accumulate_s->resize(points.size());
+  lateral->resize(points.size());
+  if (use_path_approximation_) {
+    double distance = 0.0;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      if (!approximation_.GetProjection(*this, points[i], &(*accumulate_s)[i],
+                                        &(*lateral)[i], &distance)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  CHECK_GE(num_points_, 2);
+  int hint_index = 0;
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    double min_distance = 0.0;
+    hint_index = FindNearestSegment(points[i], hint_index, &min_distance);
+    ComputeProjection(points[i], hint_index, min_distance, &(*accumulate_s)[i],
+                      &(*lateral)[i]);
+  }
+  return true;
+}
+
+int Path::FindNearestSegment(const Vec2d& point, const int hint_index,
+                             double* min_distance) const {
+  // Seed the search with the hinted segment, which is usually the nearest
+  // segment of a neighboring point, to get a tight bound early.
+  int min_index = hint_index;
+  double min_sqr_distance = segments_[hint_index].DistanceSquareTo(point);
+  double bound = std::sqrt(min_sqr_distance);
+  int i = 0;
+  while (i < num_segments_) {
+    const double sqr_distance = segments_[i].DistanceSquareTo(point);
+    // Ties are resolved to the smallest index, as in GetProjection().
+    if (sqr_distance < min_sqr_distance ||
+        (sqr_distance == min_sqr_distance && i < min_index)) {
+      min_index = i;
+      min_sqr_distance = sqr_distance;
+      bound = std::sqrt(min_sqr_distance);
+    }
+    // Any point on segment j > i is within accumulated_s_[j + 1] -
+    // accumulated_s_[i + 1] of segment i, so the segments ending before
+    // accumulated_s_[i + 1] + (distance - bound) are strictly farther away.
+    const double skip_s =
+        accumulated_s_[i + 1] + (std::sqrt(sqr_distance) - bound);
+    const auto next = std::lower_bound(accumulated_s_.begin() + i + 2,
+                                       accumulated_s_.end(), skip_s);
+    i = std::max(i + 1,
+                 static_cast<int>(next - accumulated_s_.begin()) - 1);
+  }
+  *min_distance = bound;
+  return min_index;
+}
+
+void Path::ComputeProjection(const Vec2d& point, const int min_index,
+                             const double min_distance, double* accumulate_s,
+                             double* lateral) const {
   const auto& nearest_seg = segments_[min_index];
   const auto prod = nearest_seg.ProductOntoUnit(point);
   const auto proj = nearest_seg.ProjectOntoUnit(point);
@@ -737,21 +786,20 @@ bool Path::GetProjection(const Vec2d& point, double* accumulate_s,
     if (proj < 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
     }
   } else if (min_index == num_segments_ - 1) {
     *accumulate_s = accumulated_s_[min_index] + std::max(0.0, proj);
     if (proj > 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
     }
   } else {
     *accumulate_s = accumulated_s_[min_index] +
                     std::max(0.0, std::min(proj, nearest_seg.length()));
-    *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+    *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
   }
-  return true;
 }
 
 bool Path::GetHeadingAlongPath(const Vec2d& point, double* heading) const {
@@ -254,6 +254,13 @@ class Path {
                      double* lateral) const;
   bool GetProjection(const common::math::Vec2d& point, double* accumulate_s,
                      double* lateral, double* distance) const;
+  // Project a whole point set (e.g. the corners of an obstacle polygon) in
+  // one pass. The nearest segment of each point is used as a hint for the
+  // next one, so that most segments are skipped by an arc-length bound.
+  // The result is identical to calling GetProjection() on each point.
+  bool GetProjections(const std::vector<common::math::Vec2d>& points,
+                      std::vector<double>* accumulate_s,
+                      std::vector<double>* lateral) const;
 
   bool GetHeadingAlongPath(const common::math::Vec2d& point,
                            double* heading) const;
@@ -332,6 +339,12 @@ class Path {
 
   double GetSample(const std::vector<double>& samples, const double s) const;
 
+  int FindNearestSegment(const common::math::Vec2d& point,
+                         const int hint_index, double* min_distance) const;
+  void ComputeProjection(const common::math::Vec2d& point, const int min_index,
+                         const double min_distance, double* accumulate_s,
+                         double* lateral) const;
+
   using GetOverlapFromLaneFunc =
       std::function<const std::vector<OverlapInfoConstPtr>&(const LaneInfo&)>;
   void GetAllOverlaps(GetOverlapFromLaneFunc GetOverlaps_from_lane,
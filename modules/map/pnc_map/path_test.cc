@@ -590,6 +590,56 @@ TEST(TestSuite, hdmap_jerky_path) {
   }
 }
 
+TEST(TestSuite, hdmap_path_get_projections) {
+  const int kNumPaths = 20;
+  const int kNumPoints = 200;
+  for (int path_id = 0; path_id < kNumPaths; ++path_id) {
+    const int num_segments = RandomInt(50, 500);
+    const double max_y = RandomDouble(0.5, 10.0);
+    std::vector<MapPathPoint> points;
+    double sum_x = 0;
+    for (int i = 0; i <= num_segments; ++i) {
+      points.push_back(MakeMapPathPoint(sum_x, RandomDouble(-max_y, max_y)));
+      sum_x += RandomDouble(0.1, 1.0);
+    }
+    const Path path(points, {});
+
+    // Randomly scattered points and the corners of boxes along the path.
+    std::vector<Vec2d> query_points;
+    for (int i = 0; i < kNumPoints; ++i) {
+      query_points.emplace_back(RandomDouble(-5.0, sum_x + 5.0),
+                                RandomDouble(-max_y - 5.0, max_y + 5.0));
+    }
+    for (int i = 0; i < kNumPoints / 4; ++i) {
+      const Box2d box({RandomDouble(0.0, sum_x), RandomDouble(-max_y, max_y)},
+                      RandomDouble(-M_PI, M_PI), 4.0, 2.0);
+      for (const auto& corner : box.GetAllCorners()) {
+        query_points.push_back(corner);
+      }
+    }
+
+    std::vector<double> accumulate_s;
+    std::vector<double> lateral;
+    EXPECT_TRUE(path.GetProjections(query_points, &accumulate_s, &lateral));
+    ASSERT_EQ(query_points.size(), accumulate_s.size());
+    ASSERT_EQ(query_points.size(), lateral.size());
+    for (size_t i = 0; i < query_points.size(); ++i) {
+      double expected_s = 0.0;
+      double expected_l = 0.0;
+      EXPECT_TRUE(
+          path.GetProjection(query_points[i], &expected_s, &expected_l));
+      EXPECT_DOUBLE_EQ(expected_s, accumulate_s[i]);
+      EXPECT_DOUBLE_EQ(expected_l, lateral[i]);
+    }
+  }
+
+  Path empty_path;
+  std::vector<double> accumulate_s;
+  std::vector<double> lateral;
+  EXPECT_FALSE(empty_path.GetProjections({{0.0, 0.0}}, &accumulate_s,
+                                         &lateral));
+}
+
 TEST(TestSuite, hdmap_s_path) {
   std::vector<MapPathPoint> points;
   const double kRadius = 50.0;
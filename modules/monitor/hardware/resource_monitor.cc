@@ -29,6 +29,9 @@ DEFINE_string(resource_monitor_name, "ResourceMonitor",
 DEFINE_double(resource_monitor_interval, 5,
               "Topic status checking interval (s).");
 
+DEFINE_double(resource_monitor_glob_interval, 60,
+              "Interval to glob the monitored directories again (s).");
+
 namespace apollo {
 namespace monitor {
 
@@ -39,11 +42,26 @@ ResourceMonitor::ResourceMonitor(const ResourceConf& config)
 }
 
 void ResourceMonitor::RunOnce(const double current_time) {
+  if (dir_space_paths_.empty() ||
+      current_time - last_glob_time_ >= FLAGS_resource_monitor_glob_interval) {
+    dir_space_paths_.clear();
+    for (const auto& dir_space : config_.dir_spaces()) {
+      dir_space_paths_.push_back(
+          apollo::common::util::Glob(dir_space.path()));
+    }
+    last_glob_time_ = current_time;
+  }
+
   // Monitor directory available size.
-  for (const auto& dir_space : config_.dir_spaces()) {
-    const int min_available_gb = dir_space.min_available_gb();
-    for (const auto& path : apollo::common::util::Glob(dir_space.path())) {
-      const auto space = boost::filesystem::space(path);
+  for (int i = 0; i < config_.dir_spaces_size(); ++i) {
+    const int min_available_gb = config_.dir_spaces(i).min_available_gb();
+    for (const auto& path : dir_space_paths_[i]) {
+      // The path may be gone since it was globbed.
+      boost::system::error_code error;
+      const auto space = boost::filesystem::space(path, error);
+      if (error) {
+        continue;
+      }
       const int available_gb = space.available >> 30;
       if (available_gb < min_available_gb) {
         MonitorManager::LogBuffer().ERROR() <<
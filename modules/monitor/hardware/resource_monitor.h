@@ -32,6 +32,11 @@ class ResourceMonitor : public RecurrentRunner {
 
  private:
   const ResourceConf& config_;
+
+  // Paths of each dir_spaces pattern, globbed again every
+  // --resource_monitor_glob_interval.
+  std::vector<std::vector<std::string>> dir_space_paths_;
+  double last_glob_time_ = 0.0;
 };
 
 }  // namespace monitor
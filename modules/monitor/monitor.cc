@@ -22,6 +22,7 @@
 #include "modules/monitor/hardware/resource_monitor.h"
 #include "modules/monitor/reporters/static_info_reporter.h"
 #include "modules/monitor/reporters/vehicle_state_reporter.h"
+#include "modules/monitor/software/latency_monitor.h"
 #include "modules/monitor/software/localization_monitor.h"
 #include "modules/monitor/software/process_monitor.h"
 #include "modules/monitor/software/summary_monitor.h"
@@ -68,6 +69,9 @@ Status Monitor::Init() {
   // Register resource monitor.
   monitor_thread_.RegisterRunner(make_unique<ResourceMonitor>(
       config.resource_conf()));
+  // Register latency monitor.
+  monitor_thread_.RegisterRunner(make_unique<LatencyMonitor>(
+      config.latency_conf()));
 
   // Register online reporters.
   if (MonitorManager::GetConfig().has_online_report_endpoint()) {
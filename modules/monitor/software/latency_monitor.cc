@@ -0,0 +1,74 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/monitor/software/latency_monitor.h"
+
+#include "modules/common/adapters/adapter_manager.h"
+#include "modules/common/log.h"
+#include "modules/monitor/common/monitor_manager.h"
+
+DEFINE_string(latency_monitor_name, "LatencyMonitor",
+              "Name of the latency monitor.");
+
+DEFINE_double(latency_monitor_interval, 2,
+              "Latency status checking interval (s).");
+
+namespace apollo {
+namespace monitor {
+
+using apollo::common::adapter::AdapterManager;
+
+LatencyMonitor::LatencyMonitor(const LatencyConf &config)
+    : RecurrentRunner(FLAGS_latency_monitor_name,
+                      FLAGS_latency_monitor_interval),
+      config_(config), tracker_(config.window_size()) {
+  AdapterManager::AddChassisCallback(&LatencyMonitor::OnChassis, this);
+}
+
+void LatencyMonitor::OnChassis(const canbus::Chassis &chassis) {
+  // Only the chassis messages after a control command carry the lineage.
+  if (chassis.header().lineage_size() > 0) {
+    std::lock_guard<std::mutex> lock(tracker_mutex_);
+    tracker_.AddLineage(chassis.header());
+  }
+}
+
+void LatencyMonitor::RunOnce(const double current_time) {
+  auto *latency = MonitorManager::GetStatus()->mutable_latency();
+  {
+    std::lock_guard<std::mutex> lock(tracker_mutex_);
+    tracker_.GetStatus(latency);
+  }
+
+  for (const auto &budget : config_.budgets()) {
+    auto iter = latency->find(budget.name());
+    if (iter == latency->end()) {
+      continue;
+    }
+    LatencyStatus &status = iter->second;
+    status.set_budget_exceeded(status.p99() > budget.max_p99());
+    if (!status.budget_exceeded()) {
+      exceeded_.erase(budget.name());
+    } else if (exceeded_.insert(budget.name()).second) {
+      MonitorManager::LogBuffer().WARN() <<
+          "Latency of " << budget.name() << " is over budget: p99 " <<
+          status.p99() * 1000 << "ms > " << budget.max_p99() * 1000 << "ms.";
+    }
+  }
+}
+
+}  // namespace monitor
+}  // namespace apollo
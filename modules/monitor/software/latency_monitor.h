@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#ifndef MODULES_MONITOR_SOFTWARE_LATENCY_MONITOR_H_
+#define MODULES_MONITOR_SOFTWARE_LATENCY_MONITOR_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "modules/canbus/proto/chassis.pb.h"
+#include "modules/monitor/common/recurrent_runner.h"
+#include "modules/monitor/proto/monitor_conf.pb.h"
+#include "modules/monitor/software/latency_tracker.h"
+
+namespace apollo {
+namespace monitor {
+
+// Follows the lineage of the chassis messages which canbus publishes after
+// applying a control command, from perception to the actuation, and reports
+// the latency percentiles of each hop to SystemStatus.
+class LatencyMonitor : public RecurrentRunner {
+ public:
+  explicit LatencyMonitor(const LatencyConf &config);
+  void RunOnce(const double current_time) override;
+
+ private:
+  void OnChassis(const canbus::Chassis &chassis);
+
+  const LatencyConf &config_;
+  std::mutex tracker_mutex_;
+  LatencyTracker tracker_;
+  // Hops over budget, to alert only when they become so.
+  std::unordered_set<std::string> exceeded_;
+};
+
+}  // namespace monitor
+}  // namespace apollo
+
+#endif  // MODULES_MONITOR_SOFTWARE_LATENCY_MONITOR_H_
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/monitor/software/latency_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace apollo {
+namespace monitor {
+namespace {
+
+constexpr char kEndToEnd[] = "end_to_end";
+
+// Nearest-rank percentile, which partially sorts the samples.
+double Percentile(const double percent, std::vector<double> *samples) {
+  const size_t rank = static_cast<size_t>(
+      std::ceil(percent / 100.0 * static_cast<double>(samples->size())));
+  const auto nth = samples->begin() + (rank > 0 ? rank - 1 : 0);
+  std::nth_element(samples->begin(), nth, samples->end());
+  return *nth;
+}
+
+}  // namespace
+
+LatencyTracker::LatencyTracker(const int window_size)
+    : window_size_(static_cast<size_t>(std::max(window_size, 1))) {}
+
+void LatencyTracker::AddLineage(const common::Header &header) {
+  if (header.lineage_size() == 0) {
+    return;
+  }
+  const auto &first = header.lineage(0);
+  double start_time = first.timestamp_sec();
+  if (first.has_lidar_timestamp()) {
+    start_time = static_cast<double>(first.lidar_timestamp()) * 1e-9;
+    AddSample("lidar->" + first.module_name(),
+              first.timestamp_sec() - start_time);
+  }
+  for (int i = 1; i < header.lineage_size(); ++i) {
+    const auto &from = header.lineage(i - 1);
+    const auto &to = header.lineage(i);
+    AddSample(from.module_name() + "->" + to.module_name(),
+              to.timestamp_sec() - from.timestamp_sec());
+  }
+  const auto &last = header.lineage(header.lineage_size() - 1);
+  AddSample(last.module_name() + "->" + header.module_name(),
+            header.timestamp_sec() - last.timestamp_sec());
+  AddSample(kEndToEnd, header.timestamp_sec() - start_time);
+}
+
+void LatencyTracker::GetStatus(
+    google::protobuf::Map<std::string, LatencyStatus> *status) const {
+  std::vector<double> samples;
+  for (const auto &window : windows_) {
+    samples = window.second.samples;
+    LatencyStatus &latency = (*status)[window.first];
+    latency.set_sample_count(static_cast<int>(samples.size()));
+    latency.set_max(*std::max_element(samples.begin(), samples.end()));
+    latency.set_p99(Percentile(99, &samples));
+    latency.set_p95(Percentile(95, &samples));
+    latency.set_p50(Percentile(50, &samples));
+  }
+}
+
+void LatencyTracker::AddSample(const std::string &name, const double latency) {
+  Window &window = windows_[name];
+  if (window.samples.size() < window_size_) {
+    window.samples.push_back(latency);
+  } else {
+    window.samples[window.next] = latency;
+    window.next = (window.next + 1) % window_size_;
+  }
+}
+
+}  // namespace monitor
+}  // namespace apollo
@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#ifndef MODULES_MONITOR_SOFTWARE_LATENCY_TRACKER_H_
+#define MODULES_MONITOR_SOFTWARE_LATENCY_TRACKER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/map.h"
+
+#include "modules/common/proto/header.pb.h"
+#include "modules/monitor/proto/monitor_conf.pb.h"
+
+namespace apollo {
+namespace monitor {
+
+// Keeps the latest latencies of each hop along the lineage of messages, such
+// as "planning->control", and of "end_to_end" from the first message, or the
+// lidar sensor if it has the timestamp, to the last.
+class LatencyTracker {
+ public:
+  explicit LatencyTracker(const int window_size);
+
+  // Adds the latencies along the lineage of a message, which ends at the
+  // message itself.
+  void AddLineage(const common::Header &header);
+
+  // Fills the percentiles of each hop. Hops without samples are left alone.
+  void GetStatus(
+      google::protobuf::Map<std::string, LatencyStatus> *status) const;
+
+ private:
+  // The latest samples, in a ring buffer.
+  struct Window {
+    std::vector<double> samples;
+    size_t next = 0;
+  };
+
+  void AddSample(const std::string &name, const double latency);
+
+  const size_t window_size_;
+  std::map<std::string, Window> windows_;
+};
+
+}  // namespace monitor
+}  // namespace apollo
+
+#endif  // MODULES_MONITOR_SOFTWARE_LATENCY_TRACKER_H_
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/monitor/software/latency_tracker.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace monitor {
+
+namespace {
+
+void AddRecord(const std::string &module_name, const double timestamp_sec,
+               common::Header *header) {
+  auto *record = header->add_lineage();
+  record->set_module_name(module_name);
+  record->set_timestamp_sec(timestamp_sec);
+}
+
+// A chassis message with the lineage of a control command.
+common::Header Chassis(const double start_time) {
+  common::Header header;
+  header.set_module_name("chassis");
+  AddRecord("perception_obstacle", start_time + 0.1, &header);
+  header.mutable_lineage(0)->set_lidar_timestamp(
+      static_cast<uint64_t>(start_time * 1e9));
+  AddRecord("prediction", start_time + 0.12, &header);
+  AddRecord("planning", start_time + 0.2, &header);
+  AddRecord("control", start_time + 0.21, &header);
+  header.set_timestamp_sec(start_time + 0.22);
+  return header;
+}
+
+}  // namespace
+
+TEST(LatencyTrackerTest, Hops) {
+  LatencyTracker tracker(10);
+  tracker.AddLineage(Chassis(1000.0));
+  common::Header no_lineage;
+  tracker.AddLineage(no_lineage);
+
+  google::protobuf::Map<std::string, LatencyStatus> status;
+  tracker.GetStatus(&status);
+  EXPECT_EQ(6, status.size());
+  EXPECT_NEAR(0.1, status["lidar->perception_obstacle"].p50(), 1e-6);
+  EXPECT_NEAR(0.02, status["perception_obstacle->prediction"].p50(), 1e-6);
+  EXPECT_NEAR(0.08, status["prediction->planning"].p50(), 1e-6);
+  EXPECT_NEAR(0.01, status["planning->control"].p50(), 1e-6);
+  EXPECT_NEAR(0.01, status["control->chassis"].p50(), 1e-6);
+  EXPECT_NEAR(0.22, status["end_to_end"].p99(), 1e-6);
+  EXPECT_EQ(1, status["end_to_end"].sample_count());
+}
+
+TEST(LatencyTrackerTest, Percentiles) {
+  LatencyTracker tracker(100);
+  // Latencies of 1 to 200 ms, of which only the latest 100 are kept.
+  for (int i = 1; i <= 200; ++i) {
+    common::Header header;
+    header.set_module_name("control");
+    AddRecord("planning", 10.0, &header);
+    header.set_timestamp_sec(10.0 + i * 1e-3);
+    tracker.AddLineage(header);
+  }
+
+  google::protobuf::Map<std::string, LatencyStatus> status;
+  tracker.GetStatus(&status);
+  const LatencyStatus &latency = status["planning->control"];
+  EXPECT_EQ(100, latency.sample_count());
+  EXPECT_NEAR(0.150, latency.p50(), 1e-6);
+  EXPECT_NEAR(0.195, latency.p95(), 1e-6);
+  EXPECT_NEAR(0.199, latency.p99(), 1e-6);
+  EXPECT_NEAR(0.200, latency.max(), 1e-6);
+}
+
+}  // namespace monitor
+}  // namespace apollo
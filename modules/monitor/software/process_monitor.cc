@@ -18,7 +18,6 @@
 
 #include "gflags/gflags.h"
 #include "modules/common/log.h"
-#include "modules/common/util/file.h"
 #include "modules/common/util/string_util.h"
 #include "modules/monitor/common/monitor_manager.h"
 
@@ -28,21 +27,12 @@ DEFINE_string(process_monitor_name, "ProcessMonitor",
 DEFINE_double(process_monitor_interval, 1.5,
               "Process status checking interval (s).");
 
+DEFINE_bool(process_monitor_resource_usage, true,
+            "Whether to report the CPU, memory, context switches and threads "
+            "of the module processes.");
+
 namespace apollo {
 namespace monitor {
-namespace {
-
-template <class Iterable>
-bool ContainsAll(const std::string &full, const Iterable &parts) {
-  for (const auto &part : parts) {
-    if (full.find(part) == std::string::npos) {
-      return false;
-    }
-  }
-  return true;
-}
-
-}  // namespace
 
 ProcessMonitor::ProcessMonitor()
     : RecurrentRunner(FLAGS_process_monitor_name,
@@ -51,35 +41,38 @@ ProcessMonitor::ProcessMonitor()
 
 void ProcessMonitor::RunOnce(const double current_time) {
   // Get running processes.
-  std::map<std::string, std::string> running_processes;
-  const auto procs = common::util::ListSubPaths("/proc");
-  for (const auto &proc : procs) {
-    // Get process command string.
-    std::string cmd_string;
-    const auto cmd_file = common::util::StrCat("/proc/", proc, "/cmdline");
-    if (common::util::GetContent(cmd_file, &cmd_string)) {
-      running_processes.emplace(proc, cmd_string);
-    }
-  }
+  sampler_.Update();
 
   for (const auto &module : MonitorManager::GetConfig().modules()) {
     if (module.has_process_conf()) {
-      UpdateModule(module.name(), module.process_conf(), running_processes);
+      UpdateModule(module.name(), module.process_conf(), current_time);
     }
   }
 }
 
-void ProcessMonitor::UpdateModule(
-    const std::string &module_name, const ProcessConf &config,
-    const std::map<std::string, std::string> &running_processes) {
+void ProcessMonitor::UpdateModule(const std::string &module_name,
+                                  const ProcessConf &config,
+                                  const double current_time) {
   auto *status = MonitorManager::GetModuleStatus(module_name);
-  for (const auto &proc : running_processes) {
-    if (ContainsAll(proc.second, config.process_cmd_keywords())) {
-      status->mutable_process_status()->set_running(true);
-      ADEBUG << "Module " << module_name
-             << " is running on process " << proc.first;
-      return;
+  const auto pids = sampler_.FindProcesses(config);
+  if (!pids.empty()) {
+    auto *process_status = status->mutable_process_status();
+    process_status->set_running(true);
+    ADEBUG << "Module " << module_name
+           << " is running on process " << pids.front();
+
+    ProcessSampler::Usage usage;
+    if (FLAGS_process_monitor_resource_usage &&
+        sampler_.Sample(pids, current_time, &usage)) {
+      process_status->set_cpu_usage(usage.cpu_usage);
+      process_status->set_memory_rss(usage.memory_rss);
+      process_status->set_voluntary_context_switches(
+          usage.voluntary_context_switches);
+      process_status->set_nonvoluntary_context_switches(
+          usage.nonvoluntary_context_switches);
+      process_status->set_threads(usage.threads);
     }
+    return;
   }
 
   if (status->process_status().running()) {
@@ -94,6 +87,7 @@ void ProcessMonitor::UpdateModule(
     }
   }
 
+  status->mutable_process_status()->Clear();
   status->mutable_process_status()->set_running(false);
 }
 
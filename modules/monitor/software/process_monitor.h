@@ -16,11 +16,11 @@
 #ifndef MODULES_MONITOR_SOFTWARE_PROCESS_MONITOR_H_
 #define MODULES_MONITOR_SOFTWARE_PROCESS_MONITOR_H_
 
-#include <map>
 #include <string>
 
 #include "modules/monitor/common/recurrent_runner.h"
 #include "modules/monitor/proto/monitor_conf.pb.h"
+#include "modules/monitor/software/process_sampler.h"
 
 namespace apollo {
 namespace monitor {
@@ -31,9 +31,11 @@ class ProcessMonitor : public RecurrentRunner {
   void RunOnce(const double current_time) override;
 
  private:
-  static void UpdateModule(
-      const std::string &module_name, const ProcessConf &process_conf,
-      const std::map<std::string, std::string> &running_processes);
+  void UpdateModule(const std::string &module_name,
+                    const ProcessConf &process_conf,
+                    const double current_time);
+
+  ProcessSampler sampler_;
 };
 
 }  // namespace monitor
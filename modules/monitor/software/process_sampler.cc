@@ -0,0 +1,234 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/monitor/software/process_sampler.h"
+
+#include <unistd.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <unordered_set>
+
+#include "modules/common/log.h"
+#include "modules/common/util/file.h"
+#include "modules/common/util/string_util.h"
+
+namespace apollo {
+namespace monitor {
+namespace {
+
+// Fields of <proc>/<pid>/stat after the command name, counted from the
+// state, which is field 3 in proc(5).
+constexpr int kUtimeField = 14 - 3;
+constexpr int kStimeField = 15 - 3;
+constexpr int kNumThreadsField = 20 - 3;
+constexpr int kStartTimeField = 22 - 3;
+
+bool IsPid(const std::string &name) {
+  for (const char c : name) {
+    if (!std::isdigit(c)) {
+      return false;
+    }
+  }
+  return !name.empty();
+}
+
+uint64_t ParseStatusValue(const std::string &status, const std::string &key) {
+  const auto pos = status.find(key);
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  return std::strtoull(status.c_str() + pos + key.size(), nullptr, 10);
+}
+
+}  // namespace
+
+ProcessSampler::ProcessSampler(const std::string &proc_root)
+    : proc_root_(proc_root),
+      ticks_per_second_(static_cast<double>(sysconf(_SC_CLK_TCK))),
+      page_size_(static_cast<uint64_t>(sysconf(_SC_PAGESIZE))) {}
+
+void ProcessSampler::Update() {
+  ++listings_;
+  std::unordered_set<int> running_pids;
+  for (const auto &path : common::util::ListSubPaths(proc_root_)) {
+    if (!IsPid(path)) {
+      continue;
+    }
+    const int pid = std::atoi(path.c_str());
+    auto iter = processes_.find(pid);
+    if (iter != processes_.end()) {
+      running_pids.insert(pid);
+      Process &process = iter->second;
+      if (process.cmdline_reads < 2) {
+        ReadCmdline(pid, &process);
+        ++process.cmdline_reads;
+      }
+      continue;
+    }
+
+    Stat stat;
+    if (!ReadStat(pid, &stat)) {
+      // Gone meanwhile.
+      continue;
+    }
+    running_pids.insert(pid);
+    Process &process = processes_[pid];
+    process.stat = stat;
+    process.stat_listing = listings_;
+    ReadCmdline(pid, &process);
+    process.cmdline_reads = 1;
+  }
+
+  for (auto iter = processes_.begin(); iter != processes_.end();) {
+    if (running_pids.count(iter->first) == 0) {
+      iter = processes_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+std::vector<int> ProcessSampler::FindProcesses(
+    const ProcessConf &config) const {
+  std::vector<int> pids;
+  for (const auto &process : processes_) {
+    bool contains_all = true;
+    for (const auto &keyword : config.process_cmd_keywords()) {
+      if (process.second.cmdline.find(keyword) == std::string::npos) {
+        contains_all = false;
+        break;
+      }
+    }
+    if (contains_all) {
+      pids.push_back(process.first);
+    }
+  }
+  return pids;
+}
+
+bool ProcessSampler::Sample(const std::vector<int> &pids,
+                            const double current_time, Usage *usage) {
+  *usage = Usage();
+  bool sampled = false;
+  for (const int pid : pids) {
+    auto iter = processes_.find(pid);
+    if (iter != processes_.end() &&
+        SampleProcess(pid, current_time, &iter->second, usage)) {
+      sampled = true;
+    }
+  }
+  return sampled;
+}
+
+bool ProcessSampler::ReadCmdline(const int pid, Process *process) const {
+  const std::string cmd_file =
+      common::util::StrCat(proc_root_, "/", pid, "/cmdline");
+  return common::util::GetContent(cmd_file, &process->cmdline);
+}
+
+bool ProcessSampler::ReadStat(const int pid, Stat *stat) const {
+  const std::string stat_file =
+      common::util::StrCat(proc_root_, "/", pid, "/stat");
+  std::string content;
+  if (!common::util::GetContent(stat_file, &content)) {
+    return false;
+  }
+  // The command name may contain spaces and parentheses.
+  const auto name_begin = content.find('(');
+  const auto name_end = content.rfind(')');
+  if (name_begin == std::string::npos || name_end == std::string::npos ||
+      name_end < name_begin) {
+    AERROR << "Cannot parse " << stat_file;
+    return false;
+  }
+  std::istringstream stat_stream(content.substr(name_end + 1));
+  std::vector<std::string> fields;
+  std::string field;
+  while (fields.size() <= kStartTimeField && stat_stream >> field) {
+    fields.push_back(field);
+  }
+  if (fields.size() <= kStartTimeField) {
+    AERROR << "Cannot parse " << stat_file;
+    return false;
+  }
+  stat->name.assign(content, name_begin + 1, name_end - name_begin - 1);
+  stat->start_time =
+      std::strtoull(fields[kStartTimeField].c_str(), nullptr, 10);
+  stat->cpu_ticks = std::strtoull(fields[kUtimeField].c_str(), nullptr, 10) +
+                    std::strtoull(fields[kStimeField].c_str(), nullptr, 10);
+  stat->threads = std::atoi(fields[kNumThreadsField].c_str());
+  return true;
+}
+
+bool ProcessSampler::SampleProcess(const int pid, const double current_time,
+                                   Process *process, Usage *usage) const {
+  if (process->stat_listing != listings_) {
+    // Known from an earlier listing, see whether it is still the same.
+    Stat stat;
+    if (!ReadStat(pid, &stat)) {
+      return false;
+    }
+    if (process->stat.start_time != stat.start_time ||
+        process->stat.name != stat.name) {
+      // The pid was reused or ran exec, match it again.
+      *process = Process();
+      process->stat = stat;
+      ReadCmdline(pid, process);
+      process->cmdline_reads = 1;
+      return false;
+    }
+    process->stat = stat;
+  }
+  // The next sample reads it anew.
+  process->stat_listing = 0;
+
+  const Stat &stat = process->stat;
+  if (process->sampled && current_time > process->sample_time &&
+      stat.cpu_ticks >= process->sample_cpu_ticks) {
+    usage->cpu_usage += 100.0 * (stat.cpu_ticks - process->sample_cpu_ticks) /
+                        ticks_per_second_ /
+                        (current_time - process->sample_time);
+  }
+  process->sampled = true;
+  process->sample_cpu_ticks = stat.cpu_ticks;
+  process->sample_time = current_time;
+  usage->threads += stat.threads;
+
+  const std::string dir = common::util::StrCat(proc_root_, "/", pid, "/");
+  std::string statm;
+  if (common::util::GetContent(dir + "statm", &statm)) {
+    std::istringstream statm_stream(statm);
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    if (statm_stream >> size >> resident) {
+      usage->memory_rss += resident * page_size_;
+    }
+  }
+
+  std::string status;
+  if (common::util::GetContent(dir + "status", &status)) {
+    usage->voluntary_context_switches +=
+        ParseStatusValue(status, "\nvoluntary_ctxt_switches:");
+    usage->nonvoluntary_context_switches +=
+        ParseStatusValue(status, "\nnonvoluntary_ctxt_switches:");
+  }
+  return true;
+}
+
+}  // namespace monitor
+}  // namespace apollo
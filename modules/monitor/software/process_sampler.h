@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#ifndef MODULES_MONITOR_SOFTWARE_PROCESS_SAMPLER_H_
+#define MODULES_MONITOR_SOFTWARE_PROCESS_SAMPLER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/monitor/proto/monitor_conf.pb.h"
+
+namespace apollo {
+namespace monitor {
+
+// Keeps the command lines of the running processes across cycles, so that
+// only new processes are read, and samples their resource usage from
+// <proc>/<pid>/stat, statm and status.
+class ProcessSampler {
+ public:
+  // Resource usage of a group of processes, summed up.
+  struct Usage {
+    // In percent of one core, since the previous sample.
+    double cpu_usage = 0.0;
+    uint64_t memory_rss = 0;  // In bytes.
+    uint64_t voluntary_context_switches = 0;
+    uint64_t nonvoluntary_context_switches = 0;
+    int threads = 0;
+  };
+
+  explicit ProcessSampler(const std::string &proc_root = "/proc");
+
+  // Lists the running processes. Only the processes not listed before are
+  // read: the command line of a new process is read on the two cycles after
+  // it shows up, in case it was caught between fork and exec, and then kept
+  // until the process is gone. A sampled process whose start time or command
+  // name changes in <proc>/<pid>/stat, because its pid was reused or it ran
+  // exec, counts as new.
+  void Update();
+
+  // Returns the pids of the processes whose command line contains all the
+  // keywords.
+  std::vector<int> FindProcesses(const ProcessConf &config) const;
+
+  // Samples the usage of the processes. Returns false if none of them could
+  // be read.
+  bool Sample(const std::vector<int> &pids, const double current_time,
+              Usage *usage);
+
+ private:
+  // The fields of <proc>/<pid>/stat in use.
+  struct Stat {
+    std::string name;
+    uint64_t start_time = 0;
+    uint64_t cpu_ticks = 0;
+    int threads = 0;
+  };
+
+  struct Process {
+    std::string cmdline;
+    int cmdline_reads = 0;
+    // The latest read, to tell a reused pid or an exec.
+    Stat stat;
+    // The listing in which the stat was read, which a sample in the same
+    // cycle reuses.
+    uint64_t stat_listing = 0;
+    bool sampled = false;
+    uint64_t sample_cpu_ticks = 0;
+    double sample_time = 0.0;
+  };
+
+  bool ReadCmdline(const int pid, Process *process) const;
+
+  bool ReadStat(const int pid, Stat *stat) const;
+
+  // Adds the usage of a process.
+  bool SampleProcess(const int pid, const double current_time,
+                     Process *process, Usage *usage) const;
+
+  const std::string proc_root_;
+  const double ticks_per_second_;
+  const uint64_t page_size_;
+  std::unordered_map<int, Process> processes_;
+  uint64_t listings_ = 0;
+};
+
+}  // namespace monitor
+}  // namespace apollo
+
+#endif  // MODULES_MONITOR_SOFTWARE_PROCESS_SAMPLER_H_
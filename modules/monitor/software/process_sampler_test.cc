@@ -0,0 +1,215 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/monitor/software/process_sampler.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace monitor {
+
+namespace {
+
+// A fake proc root with processes in it.
+class FakeProc {
+ public:
+  FakeProc() {
+    char root[] = "/tmp/process_sampler_test_XXXXXX";
+    root_ = mkdtemp(root);
+    mkdir((root_ + "/self").c_str(), 0755);
+  }
+
+  ~FakeProc() {
+    rmdir((root_ + "/self").c_str());
+    rmdir(root_.c_str());
+  }
+
+  const std::string &root() const { return root_; }
+
+  // The command name has spaces and parentheses by default, as it may.
+  void AddProcess(int pid, const std::string &cmdline, int start_time,
+                  const std::string &name = "my (proc)") {
+    names_[pid] = name;
+    const std::string dir = root_ + "/" + std::to_string(pid);
+    mkdir(dir.c_str(), 0755);
+    Write(dir + "/cmdline", cmdline);
+    Write(dir + "/statm", "5000 1200 300 10 0 900 0\n");
+    Write(dir + "/status",
+          "Name:\tplanning\nThreads:\t7\nvoluntary_ctxt_switches:\t40\n"
+          "nonvoluntary_ctxt_switches:\t3\n");
+    SetCpuTicks(pid, 0, 0, start_time);
+  }
+
+  void SetCpuTicks(int pid, int utime, int stime, int start_time) {
+    Write(root_ + "/" + std::to_string(pid) + "/stat",
+          std::to_string(pid) + " (" + names_[pid] + ") S 1 1 1 0 -1 4194560 100 0 0 0 " +
+              std::to_string(utime) + " " + std::to_string(stime) +
+              " 0 0 20 0 7 0 " + std::to_string(start_time) +
+              " 100000 1200 18446744073709551615\n");
+  }
+
+  void RemoveProcess(int pid) {
+    const std::string dir = root_ + "/" + std::to_string(pid);
+    for (const char *file : {"/cmdline", "/stat", "/statm", "/status"}) {
+      unlink((dir + file).c_str());
+    }
+    rmdir(dir.c_str());
+  }
+
+ private:
+  static void Write(const std::string &file, const std::string &content) {
+    std::ofstream fout(file);
+    fout << content;
+  }
+
+  std::string root_;
+  std::unordered_map<int, std::string> names_;
+};
+
+ProcessConf Keywords(const std::string &keyword) {
+  ProcessConf config;
+  config.add_process_cmd_keywords(keyword);
+  config.add_process_cmd_keywords("--flagfile");
+  return config;
+}
+
+}  // namespace
+
+TEST(ProcessSamplerTest, FindAndSample) {
+  FakeProc proc;
+  proc.AddProcess(100, std::string("planning\0--flagfile=a", 21), 5000);
+  proc.AddProcess(200, "bash", 6000);
+
+  ProcessSampler sampler(proc.root());
+  sampler.Update();
+  const auto pids = sampler.FindProcesses(Keywords("planning"));
+  ASSERT_EQ(1, pids.size());
+  EXPECT_EQ(100, pids[0]);
+  EXPECT_TRUE(sampler.FindProcesses(Keywords("control")).empty());
+
+  ProcessSampler::Usage usage;
+  EXPECT_TRUE(sampler.Sample(pids, 10.0, &usage));
+  EXPECT_EQ(0.0, usage.cpu_usage);
+  EXPECT_EQ(1200 * sysconf(_SC_PAGESIZE), usage.memory_rss);
+  EXPECT_EQ(40, usage.voluntary_context_switches);
+  EXPECT_EQ(3, usage.nonvoluntary_context_switches);
+  EXPECT_EQ(7, usage.threads);
+
+  // Half a core over two seconds.
+  const int ticks = sysconf(_SC_CLK_TCK);
+  proc.SetCpuTicks(100, ticks / 2, ticks / 2, 5000);
+  EXPECT_TRUE(sampler.Sample(pids, 12.0, &usage));
+  EXPECT_NEAR(50.0, usage.cpu_usage, 1e-6);
+
+  proc.RemoveProcess(100);
+  proc.RemoveProcess(200);
+}
+
+TEST(ProcessSamplerTest, ProcessesComeAndGo) {
+  FakeProc proc;
+  ProcessSampler sampler(proc.root());
+  // Caught between fork and exec.
+  proc.AddProcess(100, "supervisord", 5000);
+  sampler.Update();
+  EXPECT_TRUE(sampler.FindProcesses(Keywords("planning")).empty());
+  proc.AddProcess(100, std::string("planning\0--flagfile=a", 21), 5000);
+  sampler.Update();
+  EXPECT_EQ(1, sampler.FindProcesses(Keywords("planning")).size());
+
+  // Gone, and the pid reused by another process.
+  proc.RemoveProcess(100);
+  sampler.Update();
+  EXPECT_TRUE(sampler.FindProcesses(Keywords("planning")).empty());
+  proc.AddProcess(100, "bash", 7000);
+  sampler.Update();
+  EXPECT_TRUE(sampler.FindProcesses(Keywords("planning")).empty());
+
+  ProcessSampler::Usage usage;
+  EXPECT_FALSE(sampler.Sample({300}, 10.0, &usage));
+  proc.RemoveProcess(100);
+}
+
+TEST(ProcessSamplerTest, KnownProcessesNotReadAgain) {
+  FakeProc proc;
+  ProcessSampler sampler(proc.root());
+  proc.AddProcess(100, std::string("planning\0--flagfile=a", 21), 5000);
+  sampler.Update();
+  sampler.Update();
+  ASSERT_EQ(1, sampler.FindProcesses(Keywords("planning")).size());
+
+  // Still listed, so neither its stat nor its command line is read.
+  proc.AddProcess(100, "bash", 7000, "bash");
+  sampler.Update();
+  EXPECT_EQ(1, sampler.FindProcesses(Keywords("planning")).size());
+
+  // Until it is sampled.
+  ProcessSampler::Usage usage;
+  EXPECT_FALSE(sampler.Sample({100}, 10.0, &usage));
+  EXPECT_TRUE(sampler.FindProcesses(Keywords("planning")).empty());
+  proc.RemoveProcess(100);
+}
+
+TEST(ProcessSamplerTest, PidReusedOrExecWithinACycle) {
+  FakeProc proc;
+  ProcessSampler sampler(proc.root());
+  proc.AddProcess(100, std::string("planning\0--flagfile=a", 21), 5000,
+                  "planning");
+  proc.AddProcess(200, std::string("control\0--flagfile=b", 20), 6000,
+                  "control");
+  sampler.Update();
+  auto pids = sampler.FindProcesses(Keywords("planning"));
+  ASSERT_EQ(1, pids.size());
+  EXPECT_EQ(100, pids[0]);
+  pids = sampler.FindProcesses(Keywords("control"));
+  ASSERT_EQ(1, pids.size());
+  EXPECT_EQ(200, pids[0]);
+
+  // The samples in the cycle of the listing use the stat read by it, so
+  // the ticks since then count in the next sample.
+  ProcessSampler::Usage usage;
+  const int ticks = sysconf(_SC_CLK_TCK);
+  proc.SetCpuTicks(100, ticks / 2, 0, 5000);
+  EXPECT_TRUE(sampler.Sample({100}, 10.0, &usage));
+  EXPECT_TRUE(sampler.Sample({200}, 10.0, &usage));
+  proc.SetCpuTicks(100, ticks / 2, ticks / 2, 5000);
+  sampler.Update();
+  EXPECT_TRUE(sampler.Sample({100}, 11.0, &usage));
+  EXPECT_NEAR(100.0 * (ticks / 2 * 2) / ticks, usage.cpu_usage, 1e-6);
+
+  // Between two samples, pid 100 exits and is reused by another process,
+  // and pid 200 runs exec.
+  proc.AddProcess(100, "bash", 8000, "bash");
+  proc.AddProcess(200, "bash", 6000, "bash");
+  sampler.Update();
+  EXPECT_FALSE(sampler.Sample({100}, 12.0, &usage));
+  EXPECT_FALSE(sampler.Sample({200}, 12.0, &usage));
+  EXPECT_TRUE(sampler.FindProcesses(Keywords("planning")).empty());
+  EXPECT_TRUE(sampler.FindProcesses(Keywords("control")).empty());
+
+  proc.RemoveProcess(100);
+  proc.RemoveProcess(200);
+}
+
+}  // namespace monitor
+}  // namespace apollo
@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef MODULES_PERCEPTION_COMMON_PARALLEL_FOR_H_
+#define MODULES_PERCEPTION_COMMON_PARALLEL_FOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <vector>
+
+#include "ctpl/ctpl_stl.h"
+
+namespace apollo {
+namespace perception {
+
+// Splits the indices [0, n) into contiguous shares of at least min_per_share
+// indices, at most one more than the threads of the pool, and runs
+// fn(share, begin, end) for each of them. The calling thread runs the first
+// share, and the call returns once all of them are done. Without a pool,
+// fn(0, 0, n) runs on the calling thread.
+template <typename Function>
+void ParallelFor(ctpl::thread_pool* pool, const size_t n,
+                 const size_t min_per_share, const Function& fn) {
+  const size_t max_shares =
+      pool == nullptr ? 1 : static_cast<size_t>(pool->size()) + 1;
+  const size_t num_shares = std::max<size_t>(
+      1, std::min(max_shares, n / std::max<size_t>(1, min_per_share)));
+  std::vector<std::future<void>> futures;
+  for (size_t share = 1; share < num_shares; ++share) {
+    futures.push_back(pool->push([&fn, n, num_shares, share](int) {
+      fn(share, n * share / num_shares, n * (share + 1) / num_shares);
+    }));
+  }
+  fn(0, 0, n / num_shares);
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+}  // namespace perception
+}  // namespace apollo
+
+#endif  // MODULES_PERCEPTION_COMMON_PARALLEL_FOR_H_
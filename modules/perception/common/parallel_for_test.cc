@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/common/parallel_for.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+
+namespace {
+
+// The shares fn is called with, by share.
+std::vector<std::pair<size_t, size_t>> Shares(ctpl::thread_pool* pool,
+                                              size_t n, size_t min_per_share) {
+  std::mutex mutex;
+  std::vector<std::pair<size_t, size_t>> shares(n + 1);
+  size_t num_shares = 0;
+  ParallelFor(pool, n, min_per_share, [&](size_t share, size_t begin,
+                                           size_t end) {
+    std::lock_guard<std::mutex> lock(mutex);
+    shares[share] = {begin, end};
+    num_shares = std::max(num_shares, share + 1);
+  });
+  shares.resize(num_shares);
+  return shares;
+}
+
+}  // namespace
+
+TEST(ParallelForTest, Shares) {
+  ctpl::thread_pool pool(3);
+  // One per thread at most.
+  EXPECT_EQ((std::vector<std::pair<size_t, size_t>>{
+                {0, 25}, {25, 50}, {50, 75}, {75, 100}}),
+            Shares(&pool, 100, 16));
+  // Enough indices for two shares only.
+  EXPECT_EQ((std::vector<std::pair<size_t, size_t>>{{0, 17}, {17, 35}}),
+            Shares(&pool, 35, 16));
+  EXPECT_EQ((std::vector<std::pair<size_t, size_t>>{{0, 10}}),
+            Shares(&pool, 10, 16));
+  EXPECT_EQ((std::vector<std::pair<size_t, size_t>>{{0, 0}}),
+            Shares(&pool, 0, 16));
+  EXPECT_EQ((std::vector<std::pair<size_t, size_t>>{{0, 100}}),
+            Shares(nullptr, 100, 16));
+}
+
+TEST(ParallelForTest, EachIndexOnce) {
+  ctpl::thread_pool pool(2);
+  std::vector<int> counts(1000, 0);
+  ParallelFor(&pool, counts.size(), 1, [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      ++counts[i];
+    }
+  });
+  EXPECT_EQ(std::vector<int>(1000, 1), counts);
+}
+
+}  // namespace perception
+}  // namespace apollo
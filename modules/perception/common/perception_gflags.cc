@@ -50,6 +50,37 @@ DEFINE_string(camera_tf2_child_frame_id, "camera",
 DEFINE_string(obstacle_module_name, "perception_obstacle",
               "perception obstacle module name");
 DEFINE_bool(enable_visualization, false, "enable visualization for debug");
+DEFINE_bool(enable_lidar_pipeline, false,
+            "whether to segment and track a point cloud while the next one "
+            "is transformed and ROI filtered");
+DEFINE_int32(lidar_pipeline_queue_size, 1,
+             "the number of ROI filtered point clouds waiting for "
+             "segmentation, the oldest is dropped when full");
+
+/// obstacle/lidar/object_builder/min_box/min_box.cc
+DEFINE_int32(min_box_object_builder_num_threads, 4,
+             "the number of threads to build objects with, when there are "
+             "enough objects");
+
+/// common/sequence_type_fuser/object_sequence.cc
+DEFINE_int32(object_sequence_track_capacity, 128,
+             "the number of latest objects kept for each track, which should "
+             "cover the 5 seconds kept at the lidar frame rate");
+
+/// obstacle/lidar/tracker/hm_tracker/hungarian_matcher.cc
+DEFINE_int32(hm_tracker_match_num_threads, 4,
+             "the number of threads to compute track object distances with, "
+             "when there are enough tracks");
+
+/// obstacle/fusion/probabilistic_fusion/pbf_hm_track_object_matcher.cc
+DEFINE_int32(pbf_match_num_threads, 4,
+             "the number of threads to compute fusion track sensor object "
+             "distances with, when there are enough tracks");
+
+/// obstacle/fusion/probabilistic_fusion/probabilistic_fusion.cc
+DEFINE_int32(pbf_track_update_num_threads, 4,
+             "the number of threads to update fusion tracks with, when there "
+             "are enough tracks");
 
 /// obstacle/perception.cc
 /* dag streaming config for Apollo 2.0 */
@@ -203,6 +234,18 @@ DEFINE_string(traffic_light_subnode_config,
               "subnode_config.pb.txt",
               "traffic light subnode config filename.");
 DEFINE_double(light_height_adjust, 0, " adjust height without chaning code");
+DEFINE_double(traffic_light_projection_cache_translation, 0.0,
+              "max translation in meters between two poses for a cached "
+              "traffic light projection to be reused; 0 reuses only on the "
+              "same pose.");
+DEFINE_double(traffic_light_projection_cache_rotation, 0.0,
+              "max rotation in radians between two poses for a cached "
+              "traffic light projection to be reused; 0 reuses only on the "
+              "same pose.");
+DEFINE_bool(traffic_light_decode_roi_only, false,
+            "decode only the region of the image the rectifier crops, "
+            "instead of the whole image. The debug image is black outside "
+            "that region.");
 
 DEFINE_string(traffic_light_rectifier, "",
               "the rectifier enabled for traffic_light");
@@ -43,6 +43,23 @@ DECLARE_string(camera_tf2_frame_id);
 DECLARE_string(camera_tf2_child_frame_id);
 DECLARE_string(obstacle_module_name);
 DECLARE_bool(enable_visualization);
+DECLARE_bool(enable_lidar_pipeline);
+DECLARE_int32(lidar_pipeline_queue_size);
+
+/// obstacle/lidar/object_builder/min_box/min_box.cc
+DECLARE_int32(min_box_object_builder_num_threads);
+
+/// common/sequence_type_fuser/object_sequence.cc
+DECLARE_int32(object_sequence_track_capacity);
+
+/// obstacle/lidar/tracker/hm_tracker/hungarian_matcher.cc
+DECLARE_int32(hm_tracker_match_num_threads);
+
+/// obstacle/fusion/probabilistic_fusion/pbf_hm_track_object_matcher.cc
+DECLARE_int32(pbf_match_num_threads);
+
+/// obstacle/fusion/probabilistic_fusion/probabilistic_fusion.cc
+DECLARE_int32(pbf_track_update_num_threads);
 
 /// obstacle/onboard/radar_process_subnode.cc
 DECLARE_double(front_radar_forward_distance);
@@ -131,6 +148,9 @@ DECLARE_string(traffic_light_rectifier_config);
 DECLARE_string(traffic_light_reviser_config);
 DECLARE_string(traffic_light_subnode_config);
 DECLARE_double(light_height_adjust);
+DECLARE_double(traffic_light_projection_cache_translation);
+DECLARE_double(traffic_light_projection_cache_rotation);
+DECLARE_bool(traffic_light_decode_roi_only);
 DECLARE_string(traffic_light_rectifier);
 DECLARE_string(traffic_light_recognizer);
 DECLARE_string(traffic_light_reviser);
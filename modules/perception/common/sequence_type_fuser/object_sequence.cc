@@ -15,9 +15,12 @@
  *****************************************************************************/
 #include "modules/perception/common/sequence_type_fuser/object_sequence.h"
 
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 #include "modules/common/log.h"
+#include "modules/perception/common/perception_gflags.h"
 
 namespace apollo {
 namespace perception {
@@ -25,21 +28,23 @@ namespace perception {
 bool ObjectSequence::AddTrackedFrameObjects(
     const std::vector<std::shared_ptr<Object>>& objects, double timestamp) {
   std::lock_guard<std::mutex> lock(mutex_);
+  const int64_t key = DoubleToMapKey(timestamp);
   for (const auto& obj : objects) {
     int& track_id = obj->track_id;
     auto iter = sequence_.find(track_id);
     if (iter == sequence_.end()) {
-      auto res = sequence_.insert(std::make_pair(
-          track_id, std::map<int64_t, std::shared_ptr<Object>>()));
+      auto res = sequence_.insert(std::make_pair(track_id, Track()));
       if (!res.second) {
         AERROR << "Fail to insert track.";
         return false;
       }
       iter = res.first;
+      iter->second.ring.resize(
+          std::max(1, FLAGS_object_sequence_track_capacity));
+      iter->second.by_time =
+          tracks_by_time_.insert(tracks_by_time_.end(), track_id);
     }
-    auto res =
-        iter->second.insert(std::make_pair(DoubleToMapKey(timestamp), obj));
-    if (!res.second) {
+    if (!AddObject(&iter->second, key, obj)) {
       AERROR << "Fail to insert object.";
       return false;
     }
@@ -56,42 +61,116 @@ bool ObjectSequence::GetTrackInTemporalWindow(
     return false;
   }
   track->clear();
+  return VisitTrackInTemporalWindow(
+      track_id, window_time,
+      [track](const TimedObject& tobj) { track->insert(track->end(), tobj); });
+}
+
+bool ObjectSequence::GetTrackInTemporalWindow(
+    int track_id, std::vector<std::shared_ptr<Object>>* track,
+    double window_time) {
+  if (track == nullptr) {
+    return false;
+  }
+  track->clear();
+  return VisitTrackInTemporalWindow(
+      track_id, window_time,
+      [track](const TimedObject& tobj) { track->push_back(tobj.second); });
+}
+
+template <typename Visitor>
+bool ObjectSequence::VisitTrackInTemporalWindow(int track_id,
+                                                double window_time,
+                                                Visitor visit) {
   std::lock_guard<std::mutex> lock(mutex_);
   double start_time = current_ - window_time;
-  auto iter = sequence_.find(track_id);
-  if (iter == sequence_.end()) {
+  Track* track = FindTrack(track_id);
+  if (track == nullptr) {
     return false;
   }
-  for (auto& tobj : iter->second) {
+  for (std::size_t i = 0; i < track->size; ++i) {
+    const TimedObject& tobj = track->at(i);
     if (MapKeyToDouble(tobj.first) >= start_time) {
-      track->insert(tobj);
+      visit(tobj);
     }
   }
   return true;
 }
 
-void ObjectSequence::RemoveStaleTracks(double current_stamp) {
-  for (auto outer_iter = sequence_.begin(); outer_iter != sequence_.end();) {
-    CHECK(outer_iter->second.size() > 0) << "Find empty tracks.";
-    auto& track = outer_iter->second;
-    if (current_stamp - MapKeyToDouble(track.rbegin()->first) >
-        s_max_time_out_) {
-      sequence_.erase(outer_iter++);
-      continue;
+bool ObjectSequence::AddObject(Track* track, int64_t key,
+                               const std::shared_ptr<Object>& obj) {
+  // Objects mostly come in time order, and are appended to the ring.
+  std::size_t pos = track->size;
+  while (pos > 0 && track->at(pos - 1).first >= key) {
+    if (track->at(pos - 1).first == key) {
+      return false;
     }
-    for (auto inner_iter = track.begin(); inner_iter != track.end();) {
-      if (current_stamp - MapKeyToDouble(inner_iter->first) > s_max_time_out_) {
-        track.erase(inner_iter++);
-        continue;
-      } else {
-        break;
-      }
+    --pos;
+  }
+  if (track->size == track->ring.size()) {
+    // The ring is full, so the oldest object is dropped.
+    if (pos == 0) {
+      return true;
     }
-    if (track.size() == 0) {  // all element removed
-      sequence_.erase(outer_iter++);
-    } else {
-      ++outer_iter;
+    track->begin = (track->begin + 1) % track->ring.size();
+    --track->size;
+    --pos;
+  }
+  ++track->size;
+  for (std::size_t i = track->size - 1; i > pos; --i) {
+    track->at(i) = std::move(track->at(i - 1));
+  }
+  track->at(pos) = std::make_pair(key, obj);
+  if (pos + 1 < track->size) {
+    return true;
+  }
+
+  // The latest object of the track changed, so move the track behind the
+  // ones with older latest objects, which are usually all the others.
+  tracks_by_time_.splice(tracks_by_time_.end(), tracks_by_time_,
+                         track->by_time);
+  auto position = track->by_time;
+  while (position != tracks_by_time_.begin() &&
+         sequence_[*std::prev(position)].back().first > key) {
+    --position;
+  }
+  tracks_by_time_.splice(position, tracks_by_time_, track->by_time);
+  return true;
+}
+
+ObjectSequence::Track* ObjectSequence::FindTrack(int track_id) {
+  auto iter = sequence_.find(track_id);
+  if (iter == sequence_.end()) {
+    return nullptr;
+  }
+  Track& track = iter->second;
+  while (track.size > 0 &&
+         current_ - MapKeyToDouble(track.at(0).first) > s_max_time_out_) {
+    track.at(0).second.reset();
+    track.begin = (track.begin + 1) % track.ring.size();
+    --track.size;
+  }
+  if (track.size == 0) {  // all element removed
+    tracks_by_time_.erase(track.by_time);
+    sequence_.erase(iter);
+    return nullptr;
+  }
+  return &track;
+}
+
+void ObjectSequence::RemoveStaleTracks(double current_stamp) {
+  // Only tracks with all the objects too old are removed here, the too old
+  // objects of the others are when the tracks are found.
+  while (!tracks_by_time_.empty()) {
+    auto iter = sequence_.find(tracks_by_time_.front());
+    CHECK(iter != sequence_.end() && iter->second.size > 0)
+        << "Find empty tracks.";
+    if (current_stamp - MapKeyToDouble(iter->second.back().first) <=
+        s_max_time_out_) {
+      break;
     }
+    sequence_.erase(iter);
+    tracks_by_time_.pop_front();
   }
 }
 
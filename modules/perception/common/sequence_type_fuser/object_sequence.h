@@ -17,9 +17,12 @@
 #ifndef MODULES_PERCEPTION_COMMON_SEQUENCE_TYPE_FUSER_OBJECT_SEQUENCE_H_
 #define MODULES_PERCEPTION_COMMON_SEQUENCE_TYPE_FUSER_OBJECT_SEQUENCE_H_
 
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "modules/perception/obstacle/base/object.h"
@@ -59,6 +62,17 @@ class ObjectSequence {
       int track_id, std::map<int64_t, std::shared_ptr<Object>>* track,
       double window_time);
 
+  /**
+   * @brief Get tracked objects in a time window, in time order
+   * @param track_id The track id of object sequence
+   * @param track The output tracked objects, the oldest first
+   * @param window_time The time interval
+   * @return True if get track successfully, false otherwise
+   */
+  bool GetTrackInTemporalWindow(int track_id,
+                                std::vector<std::shared_ptr<Object>>* track,
+                                double window_time);
+
  protected:
   /**
    * @brief Remove too old tracks
@@ -67,6 +81,41 @@ class ObjectSequence {
   void RemoveStaleTracks(double current_stamp);
 
  private:
+  typedef std::pair<int64_t, std::shared_ptr<Object>> TimedObject;
+
+  // Latest objects of a track in a ring of fixed capacity, the oldest first.
+  struct Track {
+    std::vector<TimedObject> ring;
+    std::size_t begin = 0;
+    std::size_t size = 0;
+    // position in tracks_by_time_
+    std::list<int>::iterator by_time;
+
+    TimedObject& at(std::size_t i) {
+      return ring[(begin + i) % ring.size()];
+    }
+    TimedObject& back() { return at(size - 1); }
+  };
+
+  /**
+   * @brief Add an object to a track, in time order
+   * @return False if the track has an object with the same timestamp
+   */
+  bool AddObject(Track* track, int64_t key, const std::shared_ptr<Object>& obj);
+
+  /**
+   * @brief Find a track, with its objects too old to keep removed
+   * @return The track, or nullptr if there is none
+   */
+  Track* FindTrack(int track_id);
+
+  /**
+   * @brief Visit objects of a track in a time window, the oldest first
+   */
+  template <typename Visitor>
+  bool VisitTrackInTemporalWindow(int track_id, double window_time,
+                                  Visitor visit);
+
   const double kEps = 1e-9;
   int64_t DoubleToMapKey(const double d) {
     return static_cast<int64_t>(d / kEps);
@@ -74,7 +123,9 @@ class ObjectSequence {
   double MapKeyToDouble(const int64_t key) { return key * kEps; }
 
   double current_;
-  std::map<int, std::map<int64_t, std::shared_ptr<Object>>> sequence_;
+  std::unordered_map<int, Track> sequence_;
+  // track ids by the time of their latest objects, the oldest first
+  std::list<int> tracks_by_time_;
   std::mutex mutex_;
   static constexpr double s_max_time_out_ = 5.0;  // 5 seconds
 };
@@ -17,6 +17,8 @@
 
 #include "gtest/gtest.h"
 
+#include "modules/perception/common/perception_gflags.h"
+
 namespace apollo {
 namespace perception {
 
@@ -79,5 +81,42 @@ TEST_F(ObjectSequenceTest, TestAddAndGet) {
       sequence_.GetTrackInTemporalWindow(1, &tracked_objects, window_time));
 }
 
+TEST_F(ObjectSequenceTest, TestRingCapacity) {
+  const int capacity = FLAGS_object_sequence_track_capacity;
+  FLAGS_object_sequence_track_capacity = 4;
+  std::vector<std::shared_ptr<Object>> objects;
+  for (int i = 0; i < 6; ++i) {
+    std::shared_ptr<Object> object(new Object);
+    object->track_id = 0;
+    objects.push_back(object);
+    sequence_.AddTrackedFrameObjects({object}, static_cast<double>(i) * 0.1);
+  }
+  FLAGS_object_sequence_track_capacity = capacity;
+
+  std::vector<std::shared_ptr<Object>> tracked_objects;
+  EXPECT_TRUE(sequence_.GetTrackInTemporalWindow(0, &tracked_objects, 5.0));
+  ASSERT_EQ(tracked_objects.size(), 4);
+  for (std::size_t i = 0; i < tracked_objects.size(); ++i) {
+    EXPECT_EQ(tracked_objects[i], objects[i + 2]);
+  }
+}
+
+TEST_F(ObjectSequenceTest, TestDisorder) {
+  std::vector<std::shared_ptr<Object>> objects;
+  for (int i = 0; i < 3; ++i) {
+    std::shared_ptr<Object> object(new Object);
+    object->track_id = 0;
+    objects.push_back(object);
+  }
+  EXPECT_TRUE(sequence_.AddTrackedFrameObjects({objects[0]}, 0.0));
+  EXPECT_TRUE(sequence_.AddTrackedFrameObjects({objects[2]}, 0.2));
+  EXPECT_TRUE(sequence_.AddTrackedFrameObjects({objects[1]}, 0.1));
+  EXPECT_FALSE(sequence_.AddTrackedFrameObjects({objects[1]}, 0.1));
+
+  std::vector<std::shared_ptr<Object>> tracked_objects;
+  EXPECT_TRUE(sequence_.GetTrackInTemporalWindow(0, &tracked_objects, 5.0));
+  EXPECT_EQ(tracked_objects, objects);
+}
+
 }  // namespace perception
 }  // namespace apollo
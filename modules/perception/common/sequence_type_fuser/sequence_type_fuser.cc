@@ -16,6 +16,10 @@
 
 #include "modules/perception/common/sequence_type_fuser/sequence_type_fuser.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+
 #include "modules/common/log.h"
 #include "modules/common/util/file.h"
 #include "modules/perception/common/perception_gflags.h"
@@ -53,6 +57,11 @@ bool SequenceTypeFuser::Init() {
     }
   }
   ADEBUG << std::endl << transition_matrix_;
+  for (std::size_t i = 0; i < VALID_OBJECT_TYPE; ++i) {
+    for (std::size_t j = 0; j < VALID_OBJECT_TYPE; ++j) {
+      scaled_transition_matrix_(i, j) = transition_matrix_(i, j) * s_alpha_;
+    }
+  }
 
   // get classifier property
   const std::string& classifiers_property_file_path =
@@ -76,6 +85,10 @@ bool SequenceTypeFuser::Init() {
     smooth_matrices_.erase(iter);
   }
   ADEBUG << "Confidence: \n" << confidence_smooth_matrix_;
+  iter = smooth_matrices_.find("CNNSegClassifier");
+  if (iter != smooth_matrices_.end()) {
+    classifier_smooth_matrix_ = &iter->second;
+  }
   return true;
 }
 
@@ -87,7 +100,8 @@ bool SequenceTypeFuser::FuseType(
   }
   if (options.timestamp > 0.0) {
     sequence_.AddTrackedFrameObjects(*objects, options.timestamp);
-    std::map<int64_t, std::shared_ptr<Object>> tracked_objects;
+    std::vector<std::vector<std::shared_ptr<Object>>> tracks;
+    tracks.reserve(objects->size());
     for (auto& object : *objects) {
       if (object->is_background) {
         object->type_probs.assign(static_cast<int>(ObjectType::MAX_OBJECT_TYPE),
@@ -96,70 +110,100 @@ bool SequenceTypeFuser::FuseType(
         continue;
       }
       const int track_id = object->track_id;
+      tracks.emplace_back();
+      std::vector<std::shared_ptr<Object>>& tracked_objects = tracks.back();
       sequence_.GetTrackInTemporalWindow(track_id, &tracked_objects,
                                          config_.temporal_window());
       if (tracked_objects.size() == 0) {
         AERROR << "Find zero-length track, so skip.";
+        tracks.pop_back();
         continue;
       }
-      if (object != tracked_objects.rbegin()->second) {
+      if (object != tracked_objects.back()) {
         AERROR << "There must exist some timestamp in disorder, so skip.";
+        tracks.pop_back();
         continue;
       }
-      if (!FuseWithCCRF(&tracked_objects)) {
-        AERROR << "Failed to fuse types, so break.";
-        break;
-      }
+    }
+    if (!FuseWithCCRF(tracks)) {
+      AERROR << "Failed to fuse types.";
     }
   }
   return true;
 }
 
 bool SequenceTypeFuser::FuseWithCCRF(
-    std::map<int64_t, std::shared_ptr<Object>>* tracked_objects) {
-  if (tracked_objects == nullptr || tracked_objects->size() == 0) {
-    return false;
+    const std::vector<std::vector<std::shared_ptr<Object>>>& tracks) {
+  if (tracks.empty()) {
+    return true;
   }
 
   /// rectify object type with smooth matrices
-  fused_oneshot_probs_.resize(tracked_objects->size());
-  std::size_t i = 0;
-  for (auto& pair : *tracked_objects) {
-    std::shared_ptr<Object>& object = pair.second;
-    if (!RectifyObjectType(object, &fused_oneshot_probs_[i++])) {
-      AERROR << "Failed to fuse one shot probs in sequence.";
-      return false;
+  std::vector<std::size_t> offsets(tracks.size() + 1, 0);
+  for (std::size_t k = 0; k < tracks.size(); ++k) {
+    offsets[k + 1] = offsets[k] + tracks[k].size();
+  }
+  fused_oneshot_probs_.resize(offsets.back());
+  for (std::size_t k = 0; k < tracks.size(); ++k) {
+    for (std::size_t i = 0; i < tracks[k].size(); ++i) {
+      if (!RectifyObjectType(tracks[k][i],
+                             &fused_oneshot_probs_[offsets[k] + i])) {
+        AERROR << "Failed to fuse one shot probs in sequence.";
+        return false;
+      }
     }
   }
 
-  /// use Viterbi algorithm to infer the state
-  std::size_t length = tracked_objects->size();
-  fused_sequence_probs_.resize(length);
-  state_back_trace_.resize(length);
-  fused_sequence_probs_[0] = fused_oneshot_probs_[0];
-  /// add prior knowledge to suppress the sudden-appeared object types.
-  fused_sequence_probs_[0] += transition_matrix_.row(0).transpose();
-  for (std::size_t i = 1; i < length; ++i) {
+  /// use Viterbi algorithm to infer the state, one step for all the tracks
+  /// at a time. Longer tracks go first, so the ones still going at a step
+  /// are the first rows.
+  std::vector<std::size_t> order(tracks.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&tracks](const std::size_t a, const std::size_t b) {
+                     return tracks[a].size() > tracks[b].size();
+                   });
+  typedef Eigen::Matrix<double, Eigen::Dynamic, VALID_OBJECT_TYPE> Matrixnd;
+  Matrixnd fused_sequence_probs(tracks.size(), VALID_OBJECT_TYPE);
+  Matrixnd next_sequence_probs(tracks.size(), VALID_OBJECT_TYPE);
+  Matrixnd oneshot_probs(tracks.size(), VALID_OBJECT_TYPE);
+  for (std::size_t k = 0; k < tracks.size(); ++k) {
+    /// add prior knowledge to suppress the sudden-appeared object types.
+    Vectord probs = fused_oneshot_probs_[offsets[order[k]]];
+    probs += transition_matrix_.row(0).transpose();
+    fused_sequence_probs.row(k) = probs.transpose();
+  }
+  Eigen::ArrayXd prob(tracks.size());
+  std::size_t num_going = tracks.size();
+  for (std::size_t i = 1; i < tracks[order[0]].size(); ++i) {
+    while (tracks[order[num_going - 1]].size() <= i) {
+      --num_going;
+    }
+    for (std::size_t k = 0; k < num_going; ++k) {
+      oneshot_probs.row(k) =
+          fused_oneshot_probs_[offsets[order[k]] + i].transpose();
+    }
     for (std::size_t right = 0; right < VALID_OBJECT_TYPE; ++right) {
-      double max_prob = -DBL_MAX;
-      std::size_t id = 0;
+      auto max_prob = next_sequence_probs.col(right).head(num_going).array();
+      max_prob.setConstant(-DBL_MAX);
       for (std::size_t left = 0; left < VALID_OBJECT_TYPE; ++left) {
-        const double prob = fused_sequence_probs_[i - 1](left) +
-                            transition_matrix_(left, right) * s_alpha_ +
-                            fused_oneshot_probs_[i](right);
-        if (prob > max_prob) {
-          max_prob = prob;
-          id = left;
-        }
+        prob.head(num_going) =
+            fused_sequence_probs.col(left).head(num_going).array() +
+            scaled_transition_matrix_(left, right) +
+            oneshot_probs.col(right).head(num_going).array();
+        max_prob = (prob.head(num_going) > max_prob)
+                       .select(prob.head(num_going), max_prob);
       }
-      fused_sequence_probs_[i](right) = max_prob;
-      state_back_trace_[i](right) = id;
     }
+    fused_sequence_probs.topRows(num_going) =
+        next_sequence_probs.topRows(num_going);
   }
-  std::shared_ptr<Object> object = tracked_objects->rbegin()->second;
-  RecoverFromLogProb(&fused_sequence_probs_.back(), &object->type_probs,
-                     &object->type);
 
+  for (std::size_t k = 0; k < tracks.size(); ++k) {
+    Vectord probs = fused_sequence_probs.row(k).transpose();
+    std::shared_ptr<Object> object = tracks[order[k]].back();
+    RecoverFromLogProb(&probs, &object->type_probs, &object->type);
+  }
   return true;
 }
 
@@ -173,13 +217,12 @@ bool SequenceTypeFuser::RectifyObjectType(const std::shared_ptr<Object>& object,
 
   Vectord single_prob;
   fuser_util::FromStdVector(object->type_probs, &single_prob);
-  auto iter = smooth_matrices_.find("CNNSegClassifier");
-  if (iter == smooth_matrices_.end()) {
+  if (classifier_smooth_matrix_ == nullptr) {
     AERROR << "Failed to find CNNSegmentation classifier property.";
     return false;
   }
   static const Vectord epsilon = Vectord::Ones() * 1e-6;
-  single_prob = iter->second * single_prob + epsilon;
+  single_prob = *classifier_smooth_matrix_ * single_prob + epsilon;
   fuser_util::Normalize(&single_prob);
 
   double conf = object->score;
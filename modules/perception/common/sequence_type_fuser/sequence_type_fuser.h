@@ -66,19 +66,19 @@ class SequenceTypeFuser : public BaseTypeFuser {
 
  protected:
   /**
-   * @brief Fuse type over object sequence by a linear-chain CRF.
+   * @brief Fuse type over object sequences by a linear-chain CRF.
    * The fusion problem is modeled as inferring the discrete state
    * in a chain CRF. Note, log(P({X}|O)) = sigma_i{E_unary(X_i,O)} +
    * sigma_ij{E_pairwise(X_i,X_j)} - logZ,
    * E_unary(X_i,O) = sigma{logP(classifier)},
    * E_pairwise(X_i,X_j) = log{Transition(X_i,X_j)}.
    * Maximize the sequence probability P(X_t|{X}^opt,O) based on the
-   * Viterbi algorithm.
-   * @param tracked_objects The tracked objects as a sequence
+   * Viterbi algorithm, which runs step by step over all the sequences.
+   * @param tracks The tracked objects of each track as a sequence
    * @return True if fuse successfully, false otherwise
    */
   bool FuseWithCCRF(
-      std::map<int64_t, std::shared_ptr<Object>>* tracked_objects);
+      const std::vector<std::vector<std::shared_ptr<Object>>>& tracks);
 
   /**
    * @brief Rectify the initial object type based on smooth matrices
@@ -104,13 +104,14 @@ class SequenceTypeFuser : public BaseTypeFuser {
   ObjectSequence sequence_;
 
   Matrixd transition_matrix_;
+  // transition matrix scaled by s_alpha_, as the pairwise energies
+  Matrixd scaled_transition_matrix_;
   Matrixd confidence_smooth_matrix_;
   std::unordered_map<std::string, Matrixd> smooth_matrices_;
+  const Matrixd* classifier_smooth_matrix_ = nullptr;
 
   // Note all probabilities are in the log space
   std::vector<Vectord> fused_oneshot_probs_;
-  std::vector<Vectord> fused_sequence_probs_;
-  std::vector<Vectori> state_back_trace_;
 
   static constexpr double s_alpha_ = 1.8;
 
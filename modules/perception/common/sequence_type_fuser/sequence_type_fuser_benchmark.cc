@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of SequenceTypeFuser::FuseType on crowded scenes, with
+ * the sequences of all the tracks filled up.
+ **/
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/common/sequence_type_fuser/sequence_type_fuser.h"
+
+namespace apollo {
+namespace perception {
+namespace {
+
+constexpr double kFramePeriod = 0.1;
+// Frames in the 5 seconds kept for each track, and a few more.
+constexpr int kWarmUpFrames = 60;
+
+class CrowdedScene {
+ public:
+  explicit CrowdedScene(const int num_tracks) : num_tracks_(num_tracks) {}
+
+  std::vector<std::shared_ptr<Object>> NextFrame() {
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<std::shared_ptr<Object>> objects(num_tracks_);
+    for (int i = 0; i < num_tracks_; ++i) {
+      objects[i].reset(new Object);
+      objects[i]->track_id = i;
+      objects[i]->score = uniform(random_);
+      std::vector<float>& type_probs = objects[i]->type_probs;
+      type_probs.assign(static_cast<int>(ObjectType::MAX_OBJECT_TYPE), 0.0f);
+      float sum = 0.0f;
+      for (const ObjectType type :
+           {ObjectType::UNKNOWN, ObjectType::PEDESTRIAN, ObjectType::BICYCLE,
+            ObjectType::VEHICLE}) {
+        type_probs[type] = uniform(random_);
+        sum += type_probs[type];
+      }
+      for (float& prob : type_probs) {
+        prob /= sum;
+      }
+    }
+    return objects;
+  }
+
+  double NextTimestamp() {
+    timestamp_ += kFramePeriod;
+    return timestamp_;
+  }
+
+ private:
+  const int num_tracks_;
+  std::mt19937 random_{0};
+  double timestamp_ = 0.0;
+};
+
+void BM_FuseType(benchmark::State& state) {  // NOLINT
+  SequenceTypeFuser fuser;
+  if (!fuser.Init()) {
+    state.SkipWithError("Failed to init SequenceTypeFuser.");
+    return;
+  }
+  CrowdedScene scene(state.range(0));
+  TypeFuserOptions options;
+  for (int i = 0; i < kWarmUpFrames; ++i) {
+    std::vector<std::shared_ptr<Object>> objects = scene.NextFrame();
+    options.timestamp = scene.NextTimestamp();
+    fuser.FuseType(options, &objects);
+  }
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    std::vector<std::shared_ptr<Object>> objects = scene.NextFrame();
+    options.timestamp = scene.NextTimestamp();
+    state.ResumeTiming();
+    fuser.FuseType(options, &objects);
+  }
+}
+BENCHMARK(BM_FuseType)->Arg(20)->Arg(100)->Arg(300)->Arg(500);
+
+}  // namespace
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
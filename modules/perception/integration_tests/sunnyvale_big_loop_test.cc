@@ -14,14 +14,23 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
 #include <string>
 
+#include "geometry_msgs/TransformStamped.h"
 #include "gtest/gtest.h"
 
 #include "modules/common/configs/config_gflags.h"
 #include "modules/common/time/time.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/perception/integration_tests/perception_test_base.h"
+#include "modules/perception/obstacle/onboard/lidar_process_subnode.h"
+#include "modules/perception/onboard/dag_streaming.h"
+#include "modules/perception/proto/perception_obstacle.pb.h"
 
 namespace apollo {
 namespace perception {
@@ -43,6 +52,116 @@ class SunnyvaleBigLoopTest : public PerceptionTestBase {
   }
 };
 
+/**
+ * @class SunnyvaleBigLoopLatencyTest
+ * @brief Measures the latency of the lidar and fusion subnodes of the test
+ * DAG, with a thread per subnode.
+ */
+class SunnyvaleBigLoopLatencyTest : public SunnyvaleBigLoopTest {
+ public:
+  virtual void SetUp() {
+    SunnyvaleBigLoopTest::SetUp();
+    enable_dag_executor_ = FLAGS_enable_dag_executor;
+    FLAGS_enable_dag_executor = use_dag_executor_;
+    PerceptionTestBase::SetUp();
+    AdapterManager::AddPerceptionObstaclesCallback(
+        &SunnyvaleBigLoopLatencyTest::OnPerceptionObstacles, this);
+  }
+
+  virtual void TearDown() {
+    AdapterManager::GetPerceptionObstacles()->PopCallback();
+    FLAGS_enable_dag_executor = enable_dag_executor_;
+  }
+
+ protected:
+  // Feeds num_frames copies of the test point cloud to the lidar subnode,
+  // one at a time, and waits for the fused obstacles of each. Returns the
+  // average time from the point cloud to the fused obstacles, in ms, or a
+  // negative value if a frame is not fused.
+  double MeasureFrameLatency(const int num_frames) {
+    auto *lidar_subnode = dynamic_cast<LidarProcessSubnode *>(
+        DAGStreaming::GetSubnodeByName("Lidar64ProcessSubnode"));
+    if (lidar_subnode == nullptr) {
+      AERROR << "No Lidar64ProcessSubnode in " << FLAGS_dag_config_path;
+      return -1.0;
+    }
+    SetUpTransforms();
+    if (perception_->Start() != common::Status::OK()) {
+      AERROR << "Failed to start perception.";
+      return -1.0;
+    }
+
+    double total_latency_ms = 0.0;
+    bool all_fused = true;
+    for (int i = 0; i < num_frames && all_fused; ++i) {
+      cloud_blob_.header.stamp.fromSec(kFirstFrameTime + 0.1 * i);
+      const int64_t lidar_timestamp =
+          static_cast<int64_t>(cloud_blob_.header.stamp.toNSec());
+      const auto start = std::chrono::steady_clock::now();
+      lidar_subnode->OnPointCloud(cloud_blob_);
+      std::unique_lock<std::mutex> lock(mutex_);
+      all_fused = cv_.wait_for(lock, std::chrono::seconds(10), [&]() {
+        // Fusion stores the timestamp in seconds, up to rounding.
+        return std::llabs(fused_lidar_timestamp_ - lidar_timestamp) < 1000;
+      });
+      total_latency_ms += std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+    }
+    perception_->Stop();
+    return all_fused ? total_latency_ms / num_frames : -1.0;
+  }
+
+  bool use_dag_executor_ = false;
+
+ private:
+  void OnPerceptionObstacles(const PerceptionObstacles &obstacles) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fused_lidar_timestamp_ =
+        static_cast<int64_t>(obstacles.header().lidar_timestamp());
+    cv_.notify_all();
+  }
+
+  // Static transforms that put the lidar at the pose of the first frame of
+  // modules/planning/testdata/sunnyvale_big_loop_test, so that the HD map
+  // ROI of the test point cloud is on the road.
+  static void SetUpTransforms() {
+    geometry_msgs::TransformStamped lidar_to_novatel;
+    lidar_to_novatel.header.frame_id = FLAGS_lidar_tf2_frame_id;
+    lidar_to_novatel.child_frame_id = FLAGS_lidar_tf2_child_frame_id;
+    lidar_to_novatel.transform.rotation.w = 1.0;
+    geometry_msgs::TransformStamped novatel_to_world;
+    novatel_to_world.header.frame_id = FLAGS_localization_tf2_frame_id;
+    novatel_to_world.child_frame_id = FLAGS_localization_tf2_child_frame_id;
+    novatel_to_world.transform.translation.x = 586396.50656204869;
+    novatel_to_world.transform.translation.y = 4140180.6837947061;
+    novatel_to_world.transform.translation.z = -26.852361245559091;
+    novatel_to_world.transform.rotation.x = -0.0092481909057123071;
+    novatel_to_world.transform.rotation.y = -0.039521460395351093;
+    novatel_to_world.transform.rotation.z = 0.99913530890307178;
+    novatel_to_world.transform.rotation.w = 0.0090088643209680769;
+    auto &tf2_buffer = AdapterManager::Tf2Buffer();
+    tf2_buffer.setTransform(lidar_to_novatel, "sunnyvale_big_loop_test", true);
+    tf2_buffer.setTransform(novatel_to_world, "sunnyvale_big_loop_test", true);
+  }
+
+  static constexpr double kFirstFrameTime = 1500000000.0;
+
+  bool enable_dag_executor_ = false;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int64_t fused_lidar_timestamp_ = 0;
+};
+
+/**
+ * @class SunnyvaleBigLoopDagExecutorTest
+ * @brief Measures the same latency on the DAG executor.
+ */
+class SunnyvaleBigLoopDagExecutorTest : public SunnyvaleBigLoopLatencyTest {
+ public:
+  SunnyvaleBigLoopDagExecutorTest() { use_dag_executor_ = true; }
+};
+
 TEST_F(SunnyvaleBigLoopTest, test_01) {
   std::string seq_num = "1";
   FLAGS_test_localization_file = seq_num + "_localization.pb.txt";
@@ -53,6 +172,24 @@ TEST_F(SunnyvaleBigLoopTest, test_01) {
   AINFO << "test done.";
 }
 
+// Runs the lidar and fusion subnodes of the test DAG on the test point cloud
+// and reports their latency.
+TEST_F(SunnyvaleBigLoopLatencyTest, test_01_thread_per_subnode) {
+  constexpr int kNumFrames = 20;
+  const double latency_ms = MeasureFrameLatency(kNumFrames);
+  EXPECT_GT(latency_ms, 0.0);
+  AINFO << "point cloud to fused obstacles avg over " << kNumFrames
+        << " frames: " << latency_ms << " ms with a thread per subnode";
+}
+
+TEST_F(SunnyvaleBigLoopDagExecutorTest, test_01_dag_executor) {
+  constexpr int kNumFrames = 20;
+  const double latency_ms = MeasureFrameLatency(kNumFrames);
+  EXPECT_GT(latency_ms, 0.0);
+  AINFO << "point cloud to fused obstacles avg over " << kNumFrames
+        << " frames: " << latency_ms << " ms on the DAG executor";
+}
+
 }  // namespace perception
 }  // namespace apollo
 
@@ -111,6 +111,21 @@ class FixedSizeConQueue : public ConcurrentQueue<Data> {
     return true;
   }
 
+  // Pushes the data without waiting, dropping the oldest data if the queue
+  // is full. Returns true if data was dropped, and the dropped data.
+  virtual bool push_drop_oldest(const Data& data, Data* dropped) {
+    MutexLock lock(&this->mutex_);
+    bool is_dropped = false;
+    if (this->queue_.size() >= max_count_) {
+      *dropped = this->queue_.front();
+      this->queue_.pop();
+      is_dropped = true;
+    }
+    this->queue_.push(data);
+    this->condition_variable_.Signal();
+    return is_dropped;
+  }
+
   virtual void pop(Data* data) {
     MutexLock lock(&this->mutex_);
 
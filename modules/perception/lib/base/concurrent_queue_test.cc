@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/lib/base/concurrent_queue.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+
+TEST(FixedSizeConQueueTest, PushDropOldest) {
+  FixedSizeConQueue<int> queue(2);
+  int dropped = 0;
+  EXPECT_FALSE(queue.push_drop_oldest(1, &dropped));
+  EXPECT_FALSE(queue.push_drop_oldest(2, &dropped));
+  EXPECT_TRUE(queue.full());
+  EXPECT_FALSE(queue.try_push(3));
+
+  EXPECT_TRUE(queue.push_drop_oldest(3, &dropped));
+  EXPECT_EQ(1, dropped);
+  EXPECT_TRUE(queue.push_drop_oldest(4, &dropped));
+  EXPECT_EQ(2, dropped);
+  EXPECT_EQ(2, queue.size());
+
+  int data = 0;
+  queue.pop(&data);
+  EXPECT_EQ(3, data);
+  EXPECT_TRUE(queue.try_pop(&data));
+  EXPECT_EQ(4, data);
+  EXPECT_FALSE(queue.try_pop(&data));
+}
+
+// As the lidar pipeline: the producer keeps the latest frames, the consumer
+// runs them in order and stops at frame 0, which is pushed after the others
+// without dropping any.
+TEST(FixedSizeConQueueTest, FrameOrder) {
+  constexpr int kNumFrames = 10000;
+  FixedSizeConQueue<int> queue(1);
+  std::vector<int> consumed;
+  std::thread consumer([&queue, &consumed]() {
+    while (true) {
+      int frame = 0;
+      queue.pop(&frame);
+      if (frame == 0) {
+        return;
+      }
+      consumed.push_back(frame);
+      if (frame % 7 == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int num_dropped = 0;
+  int last_dropped = 0;
+  for (int frame = 1; frame <= kNumFrames; ++frame) {
+    int dropped = 0;
+    if (queue.push_drop_oldest(frame, &dropped)) {
+      EXPECT_GT(dropped, last_dropped);
+      last_dropped = dropped;
+      ++num_dropped;
+    }
+  }
+  queue.push(0);
+  consumer.join();
+
+  ASSERT_FALSE(consumed.empty());
+  for (size_t i = 1; i < consumed.size(); ++i) {
+    EXPECT_LT(consumed[i - 1], consumed[i]);
+  }
+  EXPECT_EQ(kNumFrames, consumed.back());
+  EXPECT_EQ(kNumFrames, static_cast<int>(consumed.size()) + num_dropped);
+}
+
+}  // namespace perception
+}  // namespace apollo
@@ -233,7 +233,7 @@ bool CCLanePostProcessor::Init() {
   cc_generator_.reset(
       new ConnectedComponentGeneratorGPU(image_width_, image_height_, roi_));
 #else
-  cc_generator_.reset(new ConnectedComponentGenerator(
+  cc_generator_.reset(new RunLengthComponentGenerator(
       lane_map_width, lane_map_height,
       cv::Rect(0, 0, lane_map_width, lane_map_height)));
 #endif
@@ -460,6 +460,8 @@ bool CCLanePostProcessor::GenerateLaneInstances(const cv::Mat &lane_map) {
     return false;
   }
 
+  vector<ConnectedComponentPtr> cc_list;
+#if CUDA_CC
   // 1. get binary lane label mask
   cv::Mat lane_mask;
   if (lane_map.type() == CV_32FC1) {
@@ -485,8 +487,16 @@ bool CCLanePostProcessor::GenerateLaneInstances(const cv::Mat &lane_map) {
   }
 
   // 2. find connected components from lane label mask
-  vector<ConnectedComponentPtr> cc_list;
   cc_generator_->FindConnectedComponents(lane_mask, &cc_list);
+#else
+  // 1-2. threshold the lane map and find connected components in one pass
+  if (lane_map.type() != CV_32FC1 && lane_map.type() != CV_8UC1) {
+    AERROR << "invalid input lane map type: " << lane_map.type();
+    return false;
+  }
+  cc_generator_->FindConnectedComponents(
+      lane_map, options_.lane_map_conf_thresh, &cc_list);
+#endif
 
   ADEBUG << "number of connected components = " << cc_list.size();
 
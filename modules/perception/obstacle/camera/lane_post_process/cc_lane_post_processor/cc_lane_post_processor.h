@@ -126,7 +126,7 @@ class CCLanePostProcessor : public BaseCameraLanePostProcessor {
 #if CUDA_CC
   std::shared_ptr<ConnectedComponentGeneratorGPU> cc_generator_;
 #else
-  std::shared_ptr<ConnectedComponentGenerator> cc_generator_;
+  std::shared_ptr<RunLengthComponentGenerator> cc_generator_;
 #endif
   std::shared_ptr<LaneFrame> cur_frame_;
   LaneInstancesPtr cur_lane_instances_;
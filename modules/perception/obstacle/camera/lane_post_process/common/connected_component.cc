@@ -107,6 +107,25 @@ void ConnectedComponent::AddPixel(int x, int y) {
   pixel_count_++;
 }
 
+void ConnectedComponent::AddPixelRun(int x_start, int x_end, int y) {
+  if (pixel_count_ == 0) {
+    bbox_.x_min = x_start;
+    bbox_.y_min = y;
+    bbox_.x_max = x_end;
+    bbox_.y_max = y;
+  } else {
+    bbox_.x_min = min(bbox_.x_min, x_start);
+    bbox_.x_max = max(bbox_.x_max, x_end);
+    bbox_.y_min = min(bbox_.y_min, y);
+    bbox_.y_max = max(bbox_.y_max, y);
+  }
+
+  for (int x = x_start; x <= x_end; ++x) {
+    pixels_->push_back(cv::Point(x, y));
+  }
+  pixel_count_ += x_end - x_start + 1;
+}
+
 void ConnectedComponent::FindBboxPixels() {
   bbox_.bbox_pixel_idx.reset(new vector<int>);
   for (int i = 0; i < pixel_count_; ++i) {
@@ -829,5 +848,160 @@ bool ConnectedComponentGenerator::FindConnectedComponents(
   return true;
 }
 
+/** RunLengthComponentGenerator **/
+RunLengthComponentGenerator::RunLengthComponentGenerator(int image_width,
+                                                         int image_height,
+                                                         cv::Rect roi)
+    : image_width_(image_width),
+      image_height_(image_height),
+      roi_x_min_(max(roi.x, 0)),
+      roi_y_min_(max(roi.y, 0)),
+      roi_x_max_(min(roi.x + roi.width, image_width) - 1),
+      roi_y_max_(min(roi.y + roi.height, image_height) - 1) {
+  if (roi_x_min_ != roi.x || roi_y_min_ != roi.y ||
+      roi_x_max_ != roi.x + roi.width - 1 ||
+      roi_y_max_ != roi.y + roi.height - 1) {
+    std::cerr << "roi is clipped to the image: (" << roi_x_min_ << ", "
+              << roi_y_min_ << ") - (" << roi_x_max_ << ", " << roi_y_max_
+              << ")" << std::endl;
+  }
+}
+
+template <typename T, typename IsForeground>
+void RunLengthComponentGenerator::EncodeRuns(const cv::Mat& lane_map,
+                                             IsForeground is_foreground) {
+  // runs of the previous row are [prev_begin, prev_end) of runs_
+  size_t prev_begin = 0;
+  size_t prev_end = 0;
+  for (int y = roi_y_min_; y <= roi_y_max_; ++y) {
+    const T* row = lane_map.ptr<T>(y);
+    const size_t cur_begin = runs_.size();
+    size_t prev = prev_begin;
+    int x = roi_x_min_;
+    while (x <= roi_x_max_) {
+      while (x <= roi_x_max_ && !is_foreground(row[x])) {
+        ++x;
+      }
+      if (x > roi_x_max_) {
+        break;
+      }
+      const int x_start = x;
+      while (x <= roi_x_max_ && is_foreground(row[x])) {
+        ++x;
+      }
+      const int x_end = x - 1;
+
+      // a run is 4-connected to the runs above which overlap its columns
+      int label = -1;
+      while (prev < prev_end && runs_[prev].x_end < x_start) {
+        ++prev;
+      }
+      for (size_t i = prev; i < prev_end && runs_[i].x_start <= x_end; ++i) {
+        if (label < 0) {
+          label = run_label_[i];
+        } else {
+          labels_.Unite(label, run_label_[i]);
+        }
+      }
+      if (label < 0) {
+        label = labels_.Add();
+      }
+      runs_.push_back({y, x_start, x_end});
+      run_label_.push_back(label);
+    }
+    prev_begin = cur_begin;
+    prev_end = runs_.size();
+  }
+}
+
+bool RunLengthComponentGenerator::FindComponents(const cv::Mat& lane_map,
+                                                 ScalarType conf_thresh) {
+  if (lane_map.empty()) {
+    std::cerr << "input lane map is empty" << std::endl;
+    return false;
+  }
+  if (lane_map.cols != image_width_ || lane_map.rows != image_height_) {
+    std::cerr << "The size of input lane map does not match" << std::endl;
+    return false;
+  }
+
+  runs_.clear();
+  run_label_.clear();
+  labels_.Reset();
+  if (lane_map.type() == CV_8UC1) {
+    EncodeRuns<uchar>(lane_map, [](const uchar v) { return v > 0; });
+  } else if (lane_map.type() == CV_32FC1) {
+    EncodeRuns<float>(
+        lane_map, [conf_thresh](const float v) { return v >= conf_thresh; });
+  } else {
+    std::cerr << "input lane map type is neither CV_8UC1 nor CV_32FC1"
+              << std::endl;
+    return false;
+  }
+
+  // number the components in the raster order of their first pixels
+  root_map_.assign(labels_.Num(), -1);
+  components_.clear();
+  vector<int> run_component(runs_.size());
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    const Run& run = runs_[i];
+    const int root = labels_.Find(run_label_[i]);
+    if (root_map_[root] < 0) {
+      root_map_[root] = static_cast<int>(components_.size());
+      components_.push_back({run.x_start, run.y, run.x_end, run.y, 0, 0, 0});
+    }
+    Component& component = components_[root_map_[root]];
+    component.x_min = min(component.x_min, run.x_start);
+    component.x_max = max(component.x_max, run.x_end);
+    component.y_max = run.y;
+    component.pixel_count += run.x_end - run.x_start + 1;
+    ++component.run_count;
+    run_component[i] = root_map_[root];
+  }
+
+  // group the runs by component, keeping the raster order in each
+  int first_run = 0;
+  for (auto& component : components_) {
+    component.first_run = first_run;
+    first_run += component.run_count;
+  }
+  vector<int> next_run(components_.size());
+  for (size_t k = 0; k < components_.size(); ++k) {
+    next_run[k] = components_[k].first_run;
+  }
+  component_runs_.resize(runs_.size());
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    component_runs_[next_run[run_component[i]]++] = runs_[i];
+  }
+  return true;
+}
+
+bool RunLengthComponentGenerator::FindConnectedComponents(
+    const cv::Mat& lane_map, ScalarType conf_thresh,
+    vector<shared_ptr<ConnectedComponent>>* cc) {
+  if (cc == NULL) {
+    std::cerr << "the pointer of output connected components is null."
+              << std::endl;
+    return false;
+  }
+  cc->clear();
+  if (!FindComponents(lane_map, conf_thresh)) {
+    return false;
+  }
+
+  cc->reserve(components_.size());
+  for (const auto& component : components_) {
+    cc->push_back(std::make_shared<ConnectedComponent>());
+    ConnectedComponent* cur_cc = cc->back().get();
+    cur_cc->ReservePixels(component.pixel_count);
+    for (int i = component.first_run;
+         i < component.first_run + component.run_count; ++i) {
+      const Run& run = component_runs_[i];
+      cur_cc->AddPixelRun(run.x_start, run.x_end, run.y);
+    }
+  }
+  return true;
+}
+
 }  // namespace perception
 }  // namespace apollo
@@ -213,6 +213,11 @@ class ConnectedComponent {
   }
   */
 
+  // add the pixels (x_start, y) to (x_end, y) of a horizontal run
+  void AddPixelRun(int x_start, int x_end, int y);
+
+  void ReservePixels(int pixel_count) { pixels_->reserve(pixel_count); }
+
   int GetPixelCount() const { return pixel_count_; }
   std::shared_ptr<const std::vector<cv::Point2i>> GetPixels() const {
     return pixels_;
@@ -353,6 +358,67 @@ class ConnectedComponentGenerator {
   std::vector<int> root_map_;
 };
 
+// Labels the 4-connected components of a lane map on its run-length encoding:
+// each row of the roi is scanned once into runs of foreground pixels, with the
+// confidence threshold applied in the same pass, and the union-find works on
+// runs instead of pixels. The components, their pixels and their order are
+// the same as those of ConnectedComponentGenerator.
+class RunLengthComponentGenerator {
+ public:
+  // a run of foreground pixels from (x_start, y) to (x_end, y)
+  struct Run {
+    int y;
+    int x_start;
+    int x_end;
+  };
+
+  // compact descriptor of a component, whose runs are
+  // runs()[first_run, first_run + run_count) in raster order
+  struct Component {
+    int x_min;
+    int y_min;
+    int x_max;
+    int y_max;
+    int pixel_count;
+    int first_run;
+    int run_count;
+  };
+
+  RunLengthComponentGenerator(int image_width, int image_height, cv::Rect roi);
+
+  // find the components of the pixels larger than zero in a CV_8UC1 lane
+  // mask, or not less than conf_thresh in a CV_32FC1 confidence map
+  bool FindComponents(const cv::Mat& lane_map, ScalarType conf_thresh);
+
+  const std::vector<Component>& components() const { return components_; }
+  const std::vector<Run>& runs() const { return component_runs_; }
+
+  // find the components and build a ConnectedComponent for each of them
+  bool FindConnectedComponents(
+      const cv::Mat& lane_map, ScalarType conf_thresh,
+      std::vector<std::shared_ptr<ConnectedComponent>>* cc);
+
+ private:
+  template <typename T, typename IsForeground>
+  void EncodeRuns(const cv::Mat& lane_map, IsForeground is_foreground);
+
+  int image_width_;
+  int image_height_;
+  int roi_x_min_;
+  int roi_y_min_;
+  int roi_x_max_;
+  int roi_y_max_;
+
+  // runs in raster order and their labels
+  std::vector<Run> runs_;
+  std::vector<int> run_label_;
+  DisjointSet labels_;
+  std::vector<int> root_map_;
+
+  std::vector<Component> components_;
+  std::vector<Run> component_runs_;
+};
+
 }  // namespace perception
 }  // namespace apollo
 
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of the connected components of a lane confidence map, on
+ * the lane map of cc_lane_post_processor_test: thresholding into a lane mask
+ * and ConnectedComponentGenerator against RunLengthComponentGenerator, with
+ * and without building the ConnectedComponent objects.
+ **/
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+
+#include "modules/perception/obstacle/camera/lane_post_process/common/connected_component.h"
+
+namespace apollo {
+namespace perception {
+namespace {
+
+const char kLaneMapFile[] =
+    "/apollo/modules/perception/data/cc_lane_post_processor_test/lane_map.jpg";
+const ScalarType kConfThresh = 0.97f;
+
+cv::Mat LoadLaneMap() {
+  const cv::Mat lane_map_ori =
+      cv::imread(kLaneMapFile, CV_LOAD_IMAGE_GRAYSCALE);
+  cv::Mat lane_map;
+  lane_map_ori.convertTo(lane_map, CV_32FC1, 1.0f / 255.0f, 0.0f);
+  return lane_map;
+}
+
+void BM_ConnectedComponentGenerator(benchmark::State &state) {  // NOLINT
+  const cv::Mat lane_map = LoadLaneMap();
+  const cv::Rect roi(0, 0, lane_map.cols, lane_map.rows);
+  ConnectedComponentGenerator generator(lane_map.cols, lane_map.rows, roi);
+  std::vector<ConnectedComponentPtr> cc_list;
+  while (state.KeepRunning()) {
+    cv::Mat lane_mask;
+    lane_mask.create(lane_map.rows, lane_map.cols, CV_8UC1);
+    lane_mask.setTo(cv::Scalar(0));
+    for (int h = 0; h < lane_mask.rows; ++h) {
+      for (int w = 0; w < lane_mask.cols; ++w) {
+        if (lane_map.at<float>(h, w) >= kConfThresh) {
+          lane_mask.at<unsigned char>(h, w) = 1;
+        }
+      }
+    }
+    generator.FindConnectedComponents(lane_mask, &cc_list);
+  }
+  state.SetLabel("components=" + std::to_string(cc_list.size()));
+}
+BENCHMARK(BM_ConnectedComponentGenerator);
+
+void BM_RunLengthConnectedComponents(benchmark::State &state) {  // NOLINT
+  const cv::Mat lane_map = LoadLaneMap();
+  const cv::Rect roi(0, 0, lane_map.cols, lane_map.rows);
+  RunLengthComponentGenerator generator(lane_map.cols, lane_map.rows, roi);
+  std::vector<ConnectedComponentPtr> cc_list;
+  while (state.KeepRunning()) {
+    generator.FindConnectedComponents(lane_map, kConfThresh, &cc_list);
+  }
+  state.SetLabel("components=" + std::to_string(cc_list.size()));
+}
+BENCHMARK(BM_RunLengthConnectedComponents);
+
+// The component descriptors only.
+void BM_RunLengthComponents(benchmark::State &state) {  // NOLINT
+  const cv::Mat lane_map = LoadLaneMap();
+  const cv::Rect roi(0, 0, lane_map.cols, lane_map.rows);
+  RunLengthComponentGenerator generator(lane_map.cols, lane_map.rows, roi);
+  while (state.KeepRunning()) {
+    generator.FindComponents(lane_map, kConfThresh);
+  }
+  state.SetLabel(
+      "components=" + std::to_string(generator.components().size()) +
+      " runs=" + std::to_string(generator.runs().size()));
+}
+BENCHMARK(BM_RunLengthComponents);
+
+}  // namespace
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/obstacle/camera/lane_post_process/common/connected_component.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "opencv2/core/core.hpp"
+
+namespace apollo {
+namespace perception {
+
+namespace {
+
+const int kWidth = 240;
+const int kHeight = 96;
+const float kConfThresh = 0.5f;
+
+// a confidence map with dashed and solid slanted lane markers over noise
+cv::Mat MakeLaneMap(const int seed) {
+  std::mt19937 random_engine(seed);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  cv::Mat lane_map(kHeight, kWidth, CV_32FC1, cv::Scalar(0.0f));
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      if (uniform(random_engine) < 0.1f) {
+        lane_map.at<float>(y, x) = uniform(random_engine);
+      }
+    }
+  }
+  for (int k = 0; k < 4; ++k) {
+    for (int y = kHeight / 3; y < kHeight; ++y) {
+      if (k % 2 == 1 && (y / 8) % 2 == 1) {
+        continue;
+      }
+      const int center =
+          kWidth / 2 + static_cast<int>((k - 1.5) * (y - kHeight / 3) * 1.2);
+      const int half_width = 1 + (y - kHeight / 3) / 20;
+      for (int x = std::max(center - half_width, 0);
+           x <= std::min(center + half_width, kWidth - 1); ++x) {
+        lane_map.at<float>(y, x) = 0.9f;
+      }
+    }
+  }
+  return lane_map;
+}
+
+cv::Mat MakeLaneMask(const cv::Mat &lane_map) {
+  cv::Mat lane_mask(lane_map.rows, lane_map.cols, CV_8UC1, cv::Scalar(0));
+  for (int y = 0; y < lane_map.rows; ++y) {
+    for (int x = 0; x < lane_map.cols; ++x) {
+      if (lane_map.at<float>(y, x) >= kConfThresh) {
+        lane_mask.at<unsigned char>(y, x) = 1;
+      }
+    }
+  }
+  return lane_mask;
+}
+
+void ExpectSameComponents(const std::vector<ConnectedComponentPtr> &expected,
+                          const std::vector<ConnectedComponentPtr> &actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i]->GetPixelCount(), actual[i]->GetPixelCount());
+    EXPECT_EQ(expected[i]->x_min(), actual[i]->x_min());
+    EXPECT_EQ(expected[i]->y_min(), actual[i]->y_min());
+    EXPECT_EQ(expected[i]->x_max(), actual[i]->x_max());
+    EXPECT_EQ(expected[i]->y_max(), actual[i]->y_max());
+    const auto expected_pixels = expected[i]->GetPixels();
+    const auto actual_pixels = actual[i]->GetPixels();
+    ASSERT_EQ(expected_pixels->size(), actual_pixels->size());
+    for (size_t j = 0; j < expected_pixels->size(); ++j) {
+      EXPECT_EQ(expected_pixels->at(j), actual_pixels->at(j));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(RunLengthComponentGeneratorTest, SameAsConnectedComponentGenerator) {
+  const cv::Rect roi(0, 0, kWidth, kHeight);
+  ConnectedComponentGenerator cc_generator(kWidth, kHeight, roi);
+  RunLengthComponentGenerator rle_generator(kWidth, kHeight, roi);
+  for (int seed = 0; seed < 5; ++seed) {
+    const cv::Mat lane_map = MakeLaneMap(seed);
+    const cv::Mat lane_mask = MakeLaneMask(lane_map);
+
+    std::vector<ConnectedComponentPtr> expected;
+    EXPECT_TRUE(cc_generator.FindConnectedComponents(lane_mask, &expected));
+
+    std::vector<ConnectedComponentPtr> from_confidence;
+    EXPECT_TRUE(rle_generator.FindConnectedComponents(lane_map, kConfThresh,
+                                                      &from_confidence));
+    ExpectSameComponents(expected, from_confidence);
+
+    std::vector<ConnectedComponentPtr> from_mask;
+    EXPECT_TRUE(rle_generator.FindConnectedComponents(lane_mask, kConfThresh,
+                                                      &from_mask));
+    ExpectSameComponents(expected, from_mask);
+  }
+}
+
+TEST(RunLengthComponentGeneratorTest, ComponentDescriptors) {
+  // two components: a U shape joined at the bottom row, and a single pixel
+  cv::Mat lane_mask(5, 6, CV_8UC1, cv::Scalar(0));
+  for (int y = 0; y < 4; ++y) {
+    lane_mask.at<unsigned char>(y, 0) = 1;
+    lane_mask.at<unsigned char>(y, 2) = 1;
+  }
+  lane_mask.at<unsigned char>(3, 1) = 1;
+  lane_mask.at<unsigned char>(0, 5) = 1;
+
+  RunLengthComponentGenerator generator(6, 5, cv::Rect(0, 0, 6, 5));
+  EXPECT_TRUE(generator.FindComponents(lane_mask, kConfThresh));
+  const auto &components = generator.components();
+  ASSERT_EQ(components.size(), 2);
+
+  EXPECT_EQ(components[0].x_min, 0);
+  EXPECT_EQ(components[0].y_min, 0);
+  EXPECT_EQ(components[0].x_max, 2);
+  EXPECT_EQ(components[0].y_max, 3);
+  EXPECT_EQ(components[0].pixel_count, 9);
+  EXPECT_EQ(components[0].first_run, 0);
+  EXPECT_EQ(components[0].run_count, 7);
+  const auto &last_run = generator.runs()[6];
+  EXPECT_EQ(last_run.y, 3);
+  EXPECT_EQ(last_run.x_start, 0);
+  EXPECT_EQ(last_run.x_end, 2);
+
+  EXPECT_EQ(components[1].x_min, 5);
+  EXPECT_EQ(components[1].y_min, 0);
+  EXPECT_EQ(components[1].pixel_count, 1);
+  EXPECT_EQ(components[1].first_run, 7);
+  EXPECT_EQ(components[1].run_count, 1);
+
+  cv::Mat lane_map(5, 6, CV_16UC1, cv::Scalar(0));
+  EXPECT_FALSE(generator.FindComponents(lane_map, kConfThresh));
+  EXPECT_FALSE(generator.FindComponents(cv::Mat(), kConfThresh));
+}
+
+}  // namespace perception
+}  // namespace apollo
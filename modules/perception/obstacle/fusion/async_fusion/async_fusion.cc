@@ -139,6 +139,9 @@ void AsyncFusion::CreateNewTracks(
   }
 }
 
+// Unlike in ProbabilisticFusion, the track updates here are not run in
+// parallel: tracks are fused with PbfIMFFusion, which sets the flags of
+// std::cerr and prints its state to it on every update.
 void AsyncFusion::UpdateAssignedTracks(
     const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
     const std::vector<std::pair<int, int>> &assignments,
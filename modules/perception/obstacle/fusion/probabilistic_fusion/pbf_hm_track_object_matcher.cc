@@ -14,16 +14,40 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <limits>
+#include <numeric>
 #include <sstream>
 
 #include "modules/common/log.h"
+#include "modules/perception/common/parallel_for.h"
+#include "modules/perception/common/perception_gflags.h"
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_hm_track_object_matcher.h"
-#include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_track_object_distance.h"
 
 namespace apollo {
 namespace perception {
 
+namespace {
+
+// Tracks below which computing association matrix in one more thread does
+// not pay off.
+const size_t kMinTracksPerThread = 16;
+
+// The distance of the pairs gated out and not computed yet.
+constexpr double kNotComputed = std::numeric_limits<double>::infinity();
+
+}  // namespace
+
+PbfHmTrackObjectMatcher::PbfHmTrackObjectMatcher() {
+  const int num_threads = std::max(1, FLAGS_pbf_match_num_threads);
+  if (num_threads > 1) {
+    // The calling thread computes a share too.
+    thread_pool_.reset(new ctpl::thread_pool(num_threads - 1));
+  }
+}
+
 bool PbfHmTrackObjectMatcher::Match(
     const std::vector<PbfTrackPtr> &fusion_tracks,
     const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
@@ -73,9 +97,48 @@ bool PbfHmTrackObjectMatcher::Match(
     return true;
   }
 
-  bool state = HmAssign(association_mat, assignments, unassigned_fusion_tracks,
+  bool state = HmAssign(&association_mat, assignments, unassigned_fusion_tracks,
                         unassigned_sensor_objects);
 
+  // The minimum distances of the unassigned tracks and objects are over all
+  // the pairs, including the gated out ones.
+  std::vector<int> all_objects(association_mat[0].size());
+  std::iota(all_objects.begin(), all_objects.end(), 0);
+  std::vector<int> unassigned_track_idxs;
+  for (const int track_ind : *unassigned_fusion_tracks) {
+    unassigned_track_idxs.push_back(track_ind_g2l[track_ind]);
+  }
+  std::vector<int> unassigned_object_idxs;
+  for (const int m_ind : *unassigned_sensor_objects) {
+    unassigned_object_idxs.push_back(measurement_ind_g2l[m_ind]);
+  }
+  // Whole rows for the unassigned tracks, then the columns of the unassigned
+  // objects in the other rows, each row by a single thread of the pool.
+  std::vector<bool> is_unassigned_track(association_mat.size(), false);
+  for (const int i : unassigned_track_idxs) {
+    is_unassigned_track[i] = true;
+  }
+  std::vector<int> other_tracks;
+  for (size_t i = 0; i < association_mat.size(); ++i) {
+    if (!is_unassigned_track[i]) {
+      other_tracks.push_back(i);
+    }
+  }
+  ParallelFor(thread_pool_.get(), unassigned_track_idxs.size(),
+              kMinTracksPerThread, [&](size_t, size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                  FillAssociationMat({unassigned_track_idxs[k]}, all_objects,
+                                     &association_mat);
+                }
+              });
+  ParallelFor(thread_pool_.get(), other_tracks.size(), kMinTracksPerThread,
+              [&](size_t, size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                  FillAssociationMat({other_tracks[k]}, unassigned_object_idxs,
+                                     &association_mat);
+                }
+              });
+
   for (const auto &track_measurement_pair : *assignments) {
     const int track_ind = track_measurement_pair.first;
     const int measurement_ind = track_measurement_pair.second;
@@ -129,37 +192,67 @@ void PbfHmTrackObjectMatcher::ComputeAssociationMat(
     std::vector<std::vector<double>> *association_mat) {
   CHECK_NOTNULL(association_mat);
 
-  PbfTrackObjectDistance pbf_distance;
-  Eigen::Vector3d local_ref_point = ref_point;
-  TrackObjectDistanceOptions options;
-  options.ref_point = &local_ref_point;
-  options.sensor_world_pose = &sensor_world_pose;
-  association_mat->resize(unassigned_fusion_tracks.size());
-  for (size_t i = 0; i < unassigned_fusion_tracks.size(); ++i) {
-    int fusion_idx = unassigned_fusion_tracks[i];
-    (*association_mat)[i].resize(unassigned_sensor_objects.size());
-    PbfTrackPtr fusion_track = fusion_tracks[fusion_idx];
-    for (size_t j = 0; j < unassigned_sensor_objects.size(); ++j) {
-      int sensor_idx = unassigned_sensor_objects[j];
-      const std::shared_ptr<PbfSensorObject> &sensor_object =
-          sensor_objects[sensor_idx];
-      double distance =
-          pbf_distance.Compute(fusion_track, sensor_object, options);
-      ADEBUG << "sensor distance:" << distance;
-      (*association_mat)[i][j] = distance;
+  mat_tracks_.clear();
+  for (const int fusion_idx : unassigned_fusion_tracks) {
+    mat_tracks_.push_back(fusion_tracks[fusion_idx]);
+  }
+  mat_objects_.clear();
+  for (const int sensor_idx : unassigned_sensor_objects) {
+    mat_objects_.push_back(sensor_objects[sensor_idx]);
+  }
+  mat_ref_point_ = ref_point;
+  mat_options_.ref_point = &mat_ref_point_;
+  mat_options_.sensor_world_pose = &sensor_world_pose;
+
+  // Only the pairs which may be connected are computed here. The others are
+  // computed once they are known to be needed, by the components they are in
+  // or by the minimum distances of the unassigned.
+  std::vector<std::vector<int>> candidates;
+  float gated_distance = 0.0f;
+  distance_.Prepare(mat_tracks_, mat_objects_, mat_options_,
+                    s_max_match_distance_, &candidates, &gated_distance);
+  association_mat->assign(
+      mat_tracks_.size(),
+      std::vector<double>(mat_objects_.size(),
+                          std::isinf(gated_distance) ? kNotComputed
+                                                     : gated_distance));
+
+  ParallelFor(thread_pool_.get(), mat_tracks_.size(), kMinTracksPerThread,
+              [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  for (const int j : candidates[i]) {
+                    double distance = distance_.Compute(
+                        mat_tracks_[i], mat_objects_[j], mat_options_);
+                    ADEBUG << "sensor distance:" << distance;
+                    (*association_mat)[i][j] = distance;
+                  }
+                }
+              });
+}
+
+void PbfHmTrackObjectMatcher::FillAssociationMat(
+    const std::vector<int> &track_idxs, const std::vector<int> &object_idxs,
+    std::vector<std::vector<double>> *association_mat) {
+  for (const int i : track_idxs) {
+    for (const int j : object_idxs) {
+      double &distance = (*association_mat)[i][j];
+      if (distance == kNotComputed) {
+        distance =
+            distance_.Compute(mat_tracks_[i], mat_objects_[j], mat_options_);
+      }
     }
   }
 }
 
 bool PbfHmTrackObjectMatcher::HmAssign(
-    const std::vector<std::vector<double>> &association_mat,
+    std::vector<std::vector<double>> *association_mat,
     std::vector<std::pair<int, int>> *assignments,
     std::vector<int> *unassigned_fusion_tracks,
     std::vector<int> *unassigned_sensor_objects) {
   double max_dist = s_max_match_distance_;
   std::vector<std::vector<int>> fusion_components;
   std::vector<std::vector<int>> sensor_components;
-  ComputeConnectedComponents(association_mat, max_dist, &fusion_components,
+  ComputeConnectedComponents(*association_mat, max_dist, &fusion_components,
                              &sensor_components);
 
   if (fusion_components.size() != sensor_components.size()) {
@@ -173,7 +266,7 @@ bool PbfHmTrackObjectMatcher::HmAssign(
                sensor_components[i].size() == 1) {
       int idx_f = fusion_components[i][0];
       int idx_s = sensor_components[i][0];
-      if (association_mat[idx_f][idx_s] < max_dist) {
+      if ((*association_mat)[idx_f][idx_s] < max_dist) {
         auto assignment = std::make_pair(unassigned_fusion_tracks->at(idx_f),
                                          unassigned_sensor_objects->at(idx_s));
         assignments->push_back(assignment);
@@ -183,6 +276,8 @@ bool PbfHmTrackObjectMatcher::HmAssign(
       continue;
     }
 
+    FillAssociationMat(fusion_components[i], sensor_components[i],
+                       association_mat);
     std::vector<std::vector<double>> loc_mat;
     std::vector<int> fusion_l2g;
     std::vector<int> sensor_l2g;
@@ -196,8 +291,8 @@ bool PbfHmTrackObjectMatcher::HmAssign(
         if (j == 0) {
           sensor_l2g[k] = sensor_components[i][k];
         }
-        loc_mat[j][k] =
-            association_mat[fusion_components[i][j]][sensor_components[i][k]];
+        loc_mat[j][k] = (*association_mat)[fusion_components[i][j]]
+                                          [sensor_components[i][k]];
       }
     }
 
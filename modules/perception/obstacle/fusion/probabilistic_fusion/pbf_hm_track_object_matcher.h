@@ -22,19 +22,22 @@
 #include <utility>
 #include <vector>
 
+#include "ctpl/ctpl_stl.h"
+
 #include "modules/common/macro.h"
 #include "modules/perception/common/graph_util.h"
 #include "modules/perception/obstacle/common/hungarian_bigraph_matcher.h"
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_base_track_object_matcher.h"
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_sensor_object.h"
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_track.h"
+#include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_track_object_distance.h"
 
 namespace apollo {
 namespace perception {
 
 class PbfHmTrackObjectMatcher : public PbfBaseTrackObjectMatcher {
  public:
-  PbfHmTrackObjectMatcher() = default;
+  PbfHmTrackObjectMatcher();
   virtual ~PbfHmTrackObjectMatcher() = default;
 
   bool Match(
@@ -60,7 +63,7 @@ class PbfHmTrackObjectMatcher : public PbfBaseTrackObjectMatcher {
       const Eigen::Vector3d &ref_point,
       const Eigen::Matrix4d &sensor_world_pose,
       std::vector<std::vector<double>> *association_mat);
-  bool HmAssign(const std::vector<std::vector<double>> &association_mat,
+  bool HmAssign(std::vector<std::vector<double>> *association_mat,
                 std::vector<std::pair<int, int>> *assignments,
                 std::vector<int> *unassigned_fusion_tracks,
                 std::vector<int> *unassigned_sensor_objects);
@@ -74,6 +77,21 @@ class PbfHmTrackObjectMatcher : public PbfBaseTrackObjectMatcher {
       std::vector<std::vector<int>> *obj_components);
 
  private:
+  // Computes the distances of the pairs of the given tracks and objects, by
+  // their indices in association_mat, which were gated out before.
+  void FillAssociationMat(const std::vector<int> &track_idxs,
+                          const std::vector<int> &object_idxs,
+                          std::vector<std::vector<double>> *association_mat);
+
+  PbfTrackObjectDistance distance_;
+  // What the association matrix of the latest Match() is of.
+  std::vector<PbfTrackPtr> mat_tracks_;
+  std::vector<std::shared_ptr<PbfSensorObject>> mat_objects_;
+  Eigen::Vector3d mat_ref_point_ = Eigen::Vector3d::Zero();
+  TrackObjectDistanceOptions mat_options_;
+
+  std::unique_ptr<ctpl::thread_pool> thread_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(PbfHmTrackObjectMatcher);
 };
 
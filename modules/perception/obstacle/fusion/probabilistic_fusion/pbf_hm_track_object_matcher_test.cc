@@ -0,0 +1,243 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/obstacle/fusion/probabilistic_fusion/dst_evidence_initiator.h"
+#include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_hm_track_object_matcher.h"
+#include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_track_object_distance.h"
+
+namespace apollo {
+namespace perception {
+
+class PbfHmTrackObjectMatcherForTest : public PbfHmTrackObjectMatcher {
+ public:
+  using PbfHmTrackObjectMatcher::HmAssign;
+};
+
+class PbfHmTrackObjectMatcherTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    DSTInitiator::instance().initialize_bba_manager();
+    PbfBaseTrackObjectMatcher::SetMaxMatchDistance(4.0);
+    FLAGS_pbf_match_num_threads = 4;
+  }
+
+  void TearDown() override {
+    FLAGS_use_distance_angle_fusion = use_distance_angle_fusion_;
+    FLAGS_pbf_match_num_threads = pbf_match_num_threads_;
+  }
+
+  std::shared_ptr<PbfSensorObject> MakeSensorObject(
+      const SensorType sensor_type, const double timestamp,
+      const Eigen::Vector3d &center, const int track_id) {
+    std::uniform_real_distribution<double> size(0.5, 3.0);
+    std::uniform_real_distribution<double> speed(-10.0, 10.0);
+    std::shared_ptr<PbfSensorObject> object(new PbfSensorObject());
+    object->sensor_type = sensor_type;
+    object->sensor_id = GetSensorType(sensor_type);
+    object->timestamp = timestamp;
+    object->object->track_id = track_id;
+    object->object->center = center;
+    object->object->anchor_point = center;
+    object->object->velocity =
+        Eigen::Vector3d(speed(random_), speed(random_), 0.0);
+    const double length = size(random_);
+    const double width = size(random_);
+    object->object->polygon.resize(4);
+    for (int k = 0; k < 4; ++k) {
+      auto &point = object->object->polygon.points[k];
+      point.x = center(0) + (k < 2 ? length : -length);
+      point.y = center(1) + (k % 3 == 0 ? width : -width);
+      point.z = 0.0;
+    }
+    return object;
+  }
+
+  // Tracks spread in front, and a frame of sensor objects mostly close to
+  // them, some of which keep the track ids of their sensor.
+  void MakeTracksAndObjects(const int num_tracks,
+                            const SensorType sensor_type) {
+    std::uniform_real_distribution<double> position(-60.0, 60.0);
+    std::uniform_real_distribution<double> noise(-2.0, 2.0);
+    for (int i = 0; i < num_tracks; ++i) {
+      const Eigen::Vector3d center(std::abs(position(random_)) + 1.0,
+                                   position(random_), 0.0);
+      // Every tenth track has seen the radar only.
+      const SensorType track_sensor_type = i % 10 == 9 ? RADAR : VELODYNE_64;
+      std::shared_ptr<PbfSensorObject> track_object =
+          MakeSensorObject(track_sensor_type, 0.0, center, i);
+      tracks_.emplace_back(new PbfTrack(track_object));
+      if (i % 4 == 3) {
+        continue;
+      }
+      const Eigen::Vector3d near_center =
+          center + Eigen::Vector3d(noise(random_), noise(random_), 0.0);
+      const int track_id = i % 7 == 0 ? i : 1000 + i;
+      std::shared_ptr<PbfSensorObject> near_object =
+          MakeSensorObject(sensor_type, 0.1, near_center, track_id);
+      near_object->object->velocity =
+          track_object->object->velocity +
+          Eigen::Vector3d(noise(random_), noise(random_), 0.0) / 4.0;
+      objects_.push_back(near_object);
+    }
+    for (int i = 0; i < num_tracks / 5; ++i) {
+      const Eigen::Vector3d center(position(random_), position(random_), 0.0);
+      objects_.push_back(MakeSensorObject(sensor_type, 0.1, center, 2000 + i));
+    }
+  }
+
+  // Matches as PbfHmTrackObjectMatcher::Match() does, but with all the pairs
+  // of the association matrix computed one by one.
+  void ExpectMatchedAsAllPairs() {
+    TrackObjectMatcherOptions options;
+    options.ref_point = &ref_point_;
+    options.sensor_world_pose = &sensor_world_pose_;
+    PbfHmTrackObjectMatcher matcher;
+    std::vector<std::pair<int, int>> assignments;
+    std::vector<int> unassigned_tracks;
+    std::vector<int> unassigned_objects;
+    std::vector<double> track_distances;
+    std::vector<double> object_distances;
+    ASSERT_TRUE(matcher.Match(tracks_, objects_, options, &assignments,
+                              &unassigned_tracks, &unassigned_objects,
+                              &track_distances, &object_distances));
+
+    PbfHmTrackObjectMatcherForTest expected_matcher;
+    std::vector<std::pair<int, int>> expected_assignments;
+    std::vector<int> expected_unassigned_tracks;
+    std::vector<int> expected_unassigned_objects;
+    expected_matcher.IdAssign(tracks_, objects_, &expected_assignments,
+                              &expected_unassigned_tracks,
+                              &expected_unassigned_objects);
+    const std::vector<int> mat_tracks = expected_unassigned_tracks;
+    const std::vector<int> mat_objects = expected_unassigned_objects;
+    PbfTrackObjectDistance distance;
+    TrackObjectDistanceOptions distance_options;
+    distance_options.ref_point = &ref_point_;
+    distance_options.sensor_world_pose = &sensor_world_pose_;
+    std::vector<std::vector<double>> association_mat(
+        mat_tracks.size(), std::vector<double>(mat_objects.size()));
+    for (size_t i = 0; i < mat_tracks.size(); ++i) {
+      for (size_t j = 0; j < mat_objects.size(); ++j) {
+        association_mat[i][j] = distance.Compute(
+            tracks_[mat_tracks[i]], objects_[mat_objects[j]], distance_options);
+      }
+    }
+    const std::vector<std::vector<double>> full_association_mat =
+        association_mat;
+    ASSERT_TRUE(expected_matcher.HmAssign(
+        &association_mat, &expected_assignments, &expected_unassigned_tracks,
+        &expected_unassigned_objects));
+
+    EXPECT_GT(assignments.size(), tracks_.size() / 3);
+    EXPECT_EQ(expected_assignments, assignments);
+    EXPECT_EQ(expected_unassigned_tracks, unassigned_tracks);
+    EXPECT_EQ(expected_unassigned_objects, unassigned_objects);
+    for (size_t i = 0; i < mat_tracks.size(); ++i) {
+      if (std::count(unassigned_tracks.begin(), unassigned_tracks.end(),
+                     mat_tracks[i]) > 0) {
+        EXPECT_EQ(*std::min_element(full_association_mat[i].begin(),
+                                    full_association_mat[i].end()),
+                  track_distances[mat_tracks[i]]);
+      }
+    }
+    for (size_t j = 0; j < mat_objects.size(); ++j) {
+      if (std::count(unassigned_objects.begin(), unassigned_objects.end(),
+                     mat_objects[j]) > 0) {
+        double min_distance = full_association_mat[0][j];
+        for (const auto &row : full_association_mat) {
+          min_distance = std::min(min_distance, row[j]);
+        }
+        EXPECT_EQ(min_distance, object_distances[mat_objects[j]]);
+      }
+    }
+  }
+
+  // Checks that the pairs gated out are no closer than the gate.
+  void ExpectGatedPairsFarApart() {
+    TrackObjectDistanceOptions options;
+    options.ref_point = &ref_point_;
+    options.sensor_world_pose = &sensor_world_pose_;
+    const double max_distance = PbfBaseTrackObjectMatcher::GetMaxMatchDistance();
+    PbfTrackObjectDistance gated_distance;
+    std::vector<std::vector<int>> candidates;
+    float distance_of_gated = 0.0f;
+    gated_distance.Prepare(tracks_, objects_, options, max_distance,
+                           &candidates, &distance_of_gated);
+    ASSERT_EQ(tracks_.size(), candidates.size());
+
+    PbfTrackObjectDistance distance;
+    size_t num_candidates = 0;
+    for (size_t i = 0; i < tracks_.size(); ++i) {
+      num_candidates += candidates[i].size();
+      for (size_t j = 0; j < objects_.size(); ++j) {
+        const float expected = distance.Compute(tracks_[i], objects_[j], options);
+        if (std::binary_search(candidates[i].begin(), candidates[i].end(), j)) {
+          EXPECT_EQ(expected,
+                    gated_distance.Compute(tracks_[i], objects_[j], options));
+        } else {
+          EXPECT_GE(expected, max_distance);
+          if (std::isfinite(distance_of_gated)) {
+            EXPECT_EQ(expected, distance_of_gated);
+          }
+        }
+      }
+    }
+    EXPECT_LT(num_candidates, tracks_.size() * objects_.size() / 2);
+  }
+
+  const bool use_distance_angle_fusion_ = FLAGS_use_distance_angle_fusion;
+  const int pbf_match_num_threads_ = FLAGS_pbf_match_num_threads;
+  std::mt19937 random_{0};
+  Eigen::Vector3d ref_point_ = Eigen::Vector3d(0.0, 0.0, 1.5);
+  Eigen::Matrix4d sensor_world_pose_ = Eigen::Matrix4d::Identity();
+  std::vector<PbfTrackPtr> tracks_;
+  std::vector<std::shared_ptr<PbfSensorObject>> objects_;
+};
+
+TEST_F(PbfHmTrackObjectMatcherTest, MatchLidarObjects) {
+  FLAGS_use_distance_angle_fusion = false;
+  MakeTracksAndObjects(100, VELODYNE_64);
+  ExpectGatedPairsFarApart();
+  ExpectMatchedAsAllPairs();
+}
+
+TEST_F(PbfHmTrackObjectMatcherTest, MatchRadarObjects) {
+  FLAGS_use_distance_angle_fusion = false;
+  MakeTracksAndObjects(100, RADAR);
+  ExpectGatedPairsFarApart();
+  ExpectMatchedAsAllPairs();
+}
+
+TEST_F(PbfHmTrackObjectMatcherTest, MatchInDistanceAngleMode) {
+  FLAGS_use_distance_angle_fusion = true;
+  MakeTracksAndObjects(100, VELODYNE_64);
+  ExpectGatedPairsFarApart();
+  ExpectMatchedAsAllPairs();
+}
+
+}  // namespace perception
+}  // namespace apollo
@@ -17,7 +17,10 @@
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_track_object_distance.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <numeric>
 #include <set>
 #include <utility>
 
@@ -37,6 +40,31 @@ DECLARE_bool(use_distance_angle_fusion);
 namespace apollo {
 namespace perception {
 
+namespace {
+
+// The range Compute() takes polygon centers with.
+constexpr int kComputeRange = 3;
+
+// Pairs further apart in angle than this, in degrees, never match in distance
+// angle mode.
+constexpr float kAngleTolerance = 5.0f;
+
+// Angles, in degrees, and grid cells, relatively, are gated with this much to
+// spare, which is far more than what rounding may take.
+constexpr float kAngleMargin = 0.01f;
+constexpr double kGridCellMargin = 0.01;
+
+// Cells further out are not indexed, which no sane position is in.
+constexpr double kMaxCellIndex = 1 << 30;
+
+int64_t CellKey(const int x, const int y) {
+  return static_cast<int64_t>(
+      (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+      static_cast<uint32_t>(y));
+}
+
+}  // namespace
+
 float PbfTrackObjectDistance::Compute(
     PbfTrackPtr fused_track,
     const std::shared_ptr<PbfSensorObject> &sensor_object,
@@ -181,7 +209,7 @@ float PbfTrackObjectDistance::ComputeDistanceAngleMatchProb(
   static float weight_y = 0.2f;
   static float speed_diff = 5.0f;
   static float epislon = 0.1f;
-  static float angle_tolerance = 5.0f;
+  static float angle_tolerance = kAngleTolerance;
   static float distance_tolerance_max = 5.0f;
   static float distance_tolerance_min = 2.0f;
 
@@ -193,13 +221,34 @@ float PbfTrackObjectDistance::ComputeDistanceAngleMatchProb(
     return std::numeric_limits<float>::max();
   }
 
-  const Eigen::Matrix4d &world_sensor_pose =
-      options.sensor_world_pose->inverse();
+  const CachedCenter *fcached = nullptr;
+  const CachedCenter *scached = nullptr;
+  if (cache_mode_ == CacheMode::SENSOR_CENTER &&
+      sensor_object->sensor_type == cached_sensor_type_ &&
+      *options.sensor_world_pose == cached_sensor_world_pose_) {
+    fcached = FindCachedCenter(fused_object);
+    scached = FindCachedCenter(sensor_object);
+  }
 
-  Eigen::Vector3d fcenter =
-      GetCenter(fused_object, world_sensor_pose, sensor_object->sensor_type);
-  Eigen::Vector3d scenter =
-      GetCenter(sensor_object, world_sensor_pose, sensor_object->sensor_type);
+  Eigen::Vector3d fcenter;
+  Eigen::Vector3d scenter;
+  float fangle = 0.0f;
+  float sangle = 0.0f;
+  if (fcached != nullptr && scached != nullptr) {
+    fcenter = fcached->center;
+    scenter = scached->center;
+    fangle = fcached->angle;
+    sangle = scached->angle;
+  } else {
+    const Eigen::Matrix4d &world_sensor_pose =
+        options.sensor_world_pose->inverse();
+    fcenter =
+        GetCenter(fused_object, world_sensor_pose, sensor_object->sensor_type);
+    scenter =
+        GetCenter(sensor_object, world_sensor_pose, sensor_object->sensor_type);
+    fangle = GetAngle(fcenter, sensor_object->sensor_type);
+    sangle = GetAngle(scenter, sensor_object->sensor_type);
+  }
 
   AINFO << "fcenter is " << fcenter;
   AINFO << "scenter is " << scenter;
@@ -244,8 +293,6 @@ float PbfTrackObjectDistance::ComputeDistanceAngleMatchProb(
   float distance = range_distance_ratio;
 
   // if (is_radar(sensor_object->sensor_type)) {
-  float sangle = GetAngle(scenter, sensor_object->sensor_type);
-  float fangle = GetAngle(fcenter, sensor_object->sensor_type);
   angle_distance_diff = (std::abs(sangle - fangle) * 180) / M_PI;
   float fobject_dist = static_cast<float>(fcenter.norm());
   double svelocity = sobj->velocity.norm();
@@ -288,13 +335,12 @@ float PbfTrackObjectDistance::ComputeDistance3D(
     AERROR << "Object is nullptr.";
     return std::numeric_limits<float>::max();
   }
-  const PolygonDType &fused_poly = obj->polygon;
   Eigen::Vector3d fused_poly_center(0, 0, 0);
   bool fused_state =
-      ComputePolygonCenter(fused_poly, ref_pos, range, &fused_poly_center);
+      GetPolygonCenter(fused_object, ref_pos, range, &fused_poly_center);
   if (!fused_state) {
     AERROR << "fail to compute polygon center! fused polygon size:"
-           << fused_poly.size();
+           << obj->polygon.size();
     return std::numeric_limits<float>::max();
   }
 
@@ -303,14 +349,13 @@ float PbfTrackObjectDistance::ComputeDistance3D(
     AERROR << "Object is nullptr.";
     return std::numeric_limits<float>::max();
   }
-  const PolygonDType &sensor_poly = obj2->polygon;
   Eigen::Vector3d sensor_poly_center(0, 0, 0);
   bool sensor_state =
-      ComputePolygonCenter(sensor_poly, ref_pos, range, &sensor_poly_center);
+      GetPolygonCenter(sensor_object, ref_pos, range, &sensor_poly_center);
 
   if (!sensor_state) {
     AERROR << "fail to compute sensor polygon center: polygon size:"
-           << sensor_poly.size();
+           << obj2->polygon.size();
     return std::numeric_limits<float>::max();
   }
 
@@ -366,5 +411,258 @@ bool PbfTrackObjectDistance::ComputePolygonCenter(
   return ComputePolygonCenter(polygon_part, center);
 }
 
+void PbfTrackObjectDistance::Prepare(
+    const std::vector<PbfTrackPtr> &fused_tracks,
+    const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+    const TrackObjectDistanceOptions &options, const double max_distance,
+    std::vector<std::vector<int>> *candidates, float *gated_distance) {
+  CHECK_NOTNULL(candidates);
+  CHECK_NOTNULL(gated_distance);
+  cache_mode_ = CacheMode::NONE;
+  cached_centers_.clear();
+  std::vector<int> all_objects(sensor_objects.size());
+  std::iota(all_objects.begin(), all_objects.end(), 0);
+  candidates->assign(fused_tracks.size(), all_objects);
+  *gated_distance = std::numeric_limits<float>::infinity();
+  if (sensor_objects.empty() || options.ref_point == nullptr) {
+    return;
+  }
+
+  // The sensor objects of a frame are of one sensor and one timestamp, which
+  // the cache and the gates rely on.
+  const SensorType sensor_type = sensor_objects[0]->sensor_type;
+  const double timestamp = sensor_objects[0]->timestamp;
+  for (const auto &sensor_object : sensor_objects) {
+    if (sensor_object->sensor_type != sensor_type ||
+        sensor_object->timestamp != timestamp) {
+      AWARN << "sensor objects are not of one frame, not gating pairs";
+      return;
+    }
+  }
+
+  if (FLAGS_use_distance_angle_fusion) {
+    if (options.sensor_world_pose == nullptr) {
+      return;
+    }
+    CacheSensorCenters(fused_tracks, sensor_objects,
+                       *options.sensor_world_pose);
+    GateOnAngles(fused_tracks, sensor_objects, candidates);
+    *gated_distance = std::numeric_limits<float>::max();
+  } else {
+    CachePolygonCenters(fused_tracks, sensor_objects, *options.ref_point);
+    GateOnPolygonCenters(fused_tracks, sensor_objects, max_distance,
+                         candidates);
+  }
+}
+
+void PbfTrackObjectDistance::CachePolygonCenters(
+    const std::vector<PbfTrackPtr> &fused_tracks,
+    const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+    const Eigen::Vector3d &ref_pos) {
+  cache_mode_ = CacheMode::POLYGON_CENTER;
+  cached_ref_pos_ = ref_pos;
+  auto cache = [this, &ref_pos](const std::shared_ptr<PbfSensorObject> &obj) {
+    if (obj == nullptr || obj->object == nullptr) {
+      return;
+    }
+    CachedCenter &cached = cached_centers_[obj.get()];
+    cached.valid = ComputePolygonCenter(obj->object->polygon, ref_pos,
+                                        kComputeRange, &cached.center);
+  };
+  for (const auto &fused_track : fused_tracks) {
+    cache(fused_track->GetFusedObject());
+  }
+  for (const auto &sensor_object : sensor_objects) {
+    cache(sensor_object);
+  }
+}
+
+void PbfTrackObjectDistance::CacheSensorCenters(
+    const std::vector<PbfTrackPtr> &fused_tracks,
+    const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+    const Eigen::Matrix4d &sensor_world_pose) {
+  cache_mode_ = CacheMode::SENSOR_CENTER;
+  cached_sensor_world_pose_ = sensor_world_pose;
+  cached_sensor_type_ = sensor_objects[0]->sensor_type;
+  const Eigen::Matrix4d &world_sensor_pose = sensor_world_pose.inverse();
+  auto cache = [this, &world_sensor_pose](
+                   const std::shared_ptr<PbfSensorObject> &obj) {
+    if (obj == nullptr || obj->object == nullptr) {
+      return;
+    }
+    CachedCenter &cached = cached_centers_[obj.get()];
+    cached.valid = true;
+    cached.center = GetCenter(obj, world_sensor_pose, cached_sensor_type_);
+    cached.angle = GetAngle(cached.center, cached_sensor_type_);
+  };
+  for (const auto &fused_track : fused_tracks) {
+    cache(fused_track->GetFusedObject());
+  }
+  for (const auto &sensor_object : sensor_objects) {
+    cache(sensor_object);
+  }
+}
+
+void PbfTrackObjectDistance::GateOnPolygonCenters(
+    const std::vector<PbfTrackPtr> &fused_tracks,
+    const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+    const double max_distance, std::vector<std::vector<int>> *candidates) {
+  const SensorType sensor_type = sensor_objects[0]->sensor_type;
+  if (!(max_distance > 0.0) ||
+      (!is_lidar(sensor_type) && !is_radar(sensor_type))) {
+    return;
+  }
+
+  // A track may be closer than max_distance only to the sensor objects in the
+  // 3 x 3 cells around it, as the cells are a bit larger than max_distance.
+  const double cell_size = max_distance * (1.0 + kGridCellMargin);
+  auto find_cell = [cell_size](const Eigen::Vector3d &pos, int *x, int *y) {
+    const double cell_x = std::floor(pos(0) / cell_size);
+    const double cell_y = std::floor(pos(1) / cell_size);
+    if (!(std::abs(cell_x) < kMaxCellIndex &&
+          std::abs(cell_y) < kMaxCellIndex)) {
+      return false;
+    }
+    *x = static_cast<int>(cell_x);
+    *y = static_cast<int>(cell_y);
+    return true;
+  };
+
+  std::unordered_map<int64_t, std::vector<int>> grid;
+  // Sensor objects out of the grid, which are candidates of all the tracks.
+  std::vector<int> ungated_objects;
+  for (size_t j = 0; j < sensor_objects.size(); ++j) {
+    const CachedCenter *cached = FindCachedCenter(sensor_objects[j]);
+    if (cached == nullptr || !cached->valid) {
+      // Compute() finds float max.
+      continue;
+    }
+    int x = 0;
+    int y = 0;
+    if (find_cell(cached->center, &x, &y)) {
+      grid[CellKey(x, y)].push_back(j);
+    } else {
+      ungated_objects.push_back(j);
+    }
+  }
+
+  const double timestamp = sensor_objects[0]->timestamp;
+  for (size_t i = 0; i < fused_tracks.size(); ++i) {
+    // Tracks without lidar objects are compared the other way round, from the
+    // sensor objects, and are not gated.
+    if (fused_tracks[i]->GetLatestLidarObject() == nullptr) {
+      continue;
+    }
+    const std::shared_ptr<PbfSensorObject> fused_object =
+        fused_tracks[i]->GetFusedObject();
+    if (fused_object == nullptr || fused_object->object == nullptr) {
+      continue;
+    }
+    const CachedCenter *cached = FindCachedCenter(fused_object);
+    if (cached == nullptr || !cached->valid) {
+      continue;
+    }
+    // Where ComputeDistance3D() predicts the track to be at the frame.
+    Eigen::Vector3d center = cached->center;
+    const double time_diff = timestamp - fused_object->timestamp;
+    center(0) += fused_object->object->velocity(0) * time_diff;
+    center(1) += fused_object->object->velocity(1) * time_diff;
+    int x = 0;
+    int y = 0;
+    if (!find_cell(center, &x, &y)) {
+      continue;
+    }
+
+    std::vector<int> &track_candidates = (*candidates)[i];
+    track_candidates = ungated_objects;
+    for (int dx = -1; dx <= 1; ++dx) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        const auto it = grid.find(CellKey(x + dx, y + dy));
+        if (it != grid.end()) {
+          track_candidates.insert(track_candidates.end(), it->second.begin(),
+                                  it->second.end());
+        }
+      }
+    }
+    std::sort(track_candidates.begin(), track_candidates.end());
+  }
+}
+
+void PbfTrackObjectDistance::GateOnAngles(
+    const std::vector<PbfTrackPtr> &fused_tracks,
+    const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+    std::vector<std::vector<int>> *candidates) {
+  std::vector<std::pair<float, int>> angle2idx;
+  // Sensor objects of no angle, which are candidates of all the tracks.
+  std::vector<int> ungated_objects;
+  for (size_t j = 0; j < sensor_objects.size(); ++j) {
+    const CachedCenter *cached = FindCachedCenter(sensor_objects[j]);
+    if (cached == nullptr) {
+      // Compute() finds float max.
+      continue;
+    }
+    if (std::isfinite(cached->angle)) {
+      angle2idx.emplace_back(cached->angle, j);
+    } else {
+      ungated_objects.push_back(j);
+    }
+  }
+  std::sort(angle2idx.begin(), angle2idx.end());
+
+  const float max_angle_diff =
+      static_cast<float>((kAngleTolerance + kAngleMargin) * M_PI / 180);
+  for (size_t i = 0; i < fused_tracks.size(); ++i) {
+    std::vector<int> &track_candidates = (*candidates)[i];
+    const std::shared_ptr<PbfSensorObject> fused_object =
+        fused_tracks[i]->GetFusedObject();
+    const CachedCenter *cached =
+        fused_object == nullptr ? nullptr : FindCachedCenter(fused_object);
+    if (cached == nullptr) {
+      // Compute() finds float max for all the sensor objects.
+      track_candidates.clear();
+      continue;
+    }
+    if (!std::isfinite(cached->angle)) {
+      continue;
+    }
+    track_candidates = ungated_objects;
+    const auto begin = std::lower_bound(
+        angle2idx.begin(), angle2idx.end(),
+        std::make_pair(cached->angle - max_angle_diff,
+                       std::numeric_limits<int>::min()));
+    const auto end = std::upper_bound(
+        begin, angle2idx.end(),
+        std::make_pair(cached->angle + max_angle_diff,
+                       std::numeric_limits<int>::max()));
+    for (auto it = begin; it != end; ++it) {
+      track_candidates.push_back(it->second);
+    }
+    std::sort(track_candidates.begin(), track_candidates.end());
+  }
+}
+
+const PbfTrackObjectDistance::CachedCenter *
+PbfTrackObjectDistance::FindCachedCenter(
+    const std::shared_ptr<PbfSensorObject> &object) const {
+  const auto it = cached_centers_.find(object.get());
+  return it == cached_centers_.end() ? nullptr : &it->second;
+}
+
+bool PbfTrackObjectDistance::GetPolygonCenter(
+    const std::shared_ptr<PbfSensorObject> &object,
+    const Eigen::Vector3d &ref_pos, int range, Eigen::Vector3d *center) {
+  if (cache_mode_ == CacheMode::POLYGON_CENTER && range == kComputeRange &&
+      ref_pos == cached_ref_pos_) {
+    const CachedCenter *cached = FindCachedCenter(object);
+    if (cached != nullptr) {
+      if (cached->valid) {
+        *center = cached->center;
+      }
+      return cached->valid;
+    }
+  }
+  return ComputePolygonCenter(object->object->polygon, ref_pos, range, center);
+}
+
 }  // namespace perception
 }  // namespace apollo
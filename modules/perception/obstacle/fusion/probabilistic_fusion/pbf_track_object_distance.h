@@ -18,6 +18,8 @@
 #define MODULES_PERCEPTION_OBSTACLE_FUSION_PBF_PBF_TRACK_OBJECT_DISTANCE_H_
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "modules/common/macro.h"
 #include "modules/perception/obstacle/base/types.h"
@@ -41,6 +43,19 @@ class PbfTrackObjectDistance {
                 const std::shared_ptr<PbfSensorObject> &sensor_object,
                 const TrackObjectDistanceOptions &options);
 
+  // Prepares to compute the distances between the tracks and the sensor
+  // objects of a frame. The centers of their objects, which Compute() would
+  // derive again for every pair otherwise, are cached, and the pairs are
+  // gated on them: (*candidates)[i] lists the sensor objects which track i
+  // may be closer than max_distance to. Compute() returns at least
+  // max_distance for all the other pairs, and exactly *gated_distance when it
+  // is finite. The objects must not change till the distances are computed.
+  void Prepare(
+      const std::vector<PbfTrackPtr> &fused_tracks,
+      const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+      const TrackObjectDistanceOptions &options, const double max_distance,
+      std::vector<std::vector<int>> *candidates, float *gated_distance);
+
  protected:
   float ComputeVelodyne64Velodyne64(
       const std::shared_ptr<PbfSensorObject> &fused_object,
@@ -75,6 +90,46 @@ class PbfTrackObjectDistance {
                             SensorType sensor_type);
 
  private:
+  struct CachedCenter {
+    bool valid = false;
+    Eigen::Vector3d center = Eigen::Vector3d::Zero();
+    // Of the center in the sensor frame, in distance angle mode.
+    float angle = 0.0f;
+  };
+
+  void CachePolygonCenters(
+      const std::vector<PbfTrackPtr> &fused_tracks,
+      const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+      const Eigen::Vector3d &ref_pos);
+  void CacheSensorCenters(
+      const std::vector<PbfTrackPtr> &fused_tracks,
+      const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+      const Eigen::Matrix4d &sensor_world_pose);
+  void GateOnPolygonCenters(
+      const std::vector<PbfTrackPtr> &fused_tracks,
+      const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+      const double max_distance, std::vector<std::vector<int>> *candidates);
+  void GateOnAngles(
+      const std::vector<PbfTrackPtr> &fused_tracks,
+      const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
+      std::vector<std::vector<int>> *candidates);
+  // Returns the cached center of the object, or nullptr if it is not cached.
+  const CachedCenter *FindCachedCenter(
+      const std::shared_ptr<PbfSensorObject> &object) const;
+  // Takes the polygon center of the object from the cache if it is there.
+  bool GetPolygonCenter(const std::shared_ptr<PbfSensorObject> &object,
+                        const Eigen::Vector3d &ref_pos, int range,
+                        Eigen::Vector3d *center);
+
+  enum class CacheMode { NONE, POLYGON_CENTER, SENSOR_CENTER };
+  CacheMode cache_mode_ = CacheMode::NONE;
+  // What the cached centers depend on besides the objects.
+  Eigen::Vector3d cached_ref_pos_ = Eigen::Vector3d::Zero();
+  Eigen::Matrix<double, 4, 4, Eigen::DontAlign> cached_sensor_world_pose_ =
+      Eigen::Matrix4d::Identity();
+  SensorType cached_sensor_type_ = UNKNOWN_SENSOR_TYPE;
+  std::unordered_map<const PbfSensorObject *, CachedCenter> cached_centers_;
+
   DISALLOW_COPY_AND_ASSIGN(PbfTrackObjectDistance);
 };
 }  // namespace perception
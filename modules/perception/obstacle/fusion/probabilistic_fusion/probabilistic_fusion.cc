@@ -16,10 +16,12 @@
 
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/probabilistic_fusion.h"
 
+#include <algorithm>
 #include <iomanip>
 
 #include "modules/common/macro.h"
 #include "modules/common/util/file.h"
+#include "modules/perception/common/parallel_for.h"
 #include "modules/perception/common/perception_gflags.h"
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/dst_evidence_initiator.h"
 #include "modules/perception/obstacle/fusion/probabilistic_fusion/pbf_hm_track_object_matcher.h"
@@ -28,6 +30,13 @@ namespace perception {
 
 using apollo::common::util::GetProtoFromFile;
 
+namespace {
+
+// Tracks below which updating in one more thread does not pay off.
+const size_t kMinTracksPerThread = 16;
+
+}  // namespace
+
 ProbabilisticFusion::~ProbabilisticFusion() {
   if (matcher_) {
     delete matcher_;
@@ -67,6 +76,12 @@ bool ProbabilisticFusion::Init() {
   PbfTrack::SetPublishIfHasLidar(config_.publish_if_has_lidar());
   PbfTrack::SetPublishIfHasRadar(config_.publish_if_has_radar());
 
+  const int num_threads = std::max(1, FLAGS_pbf_track_update_num_threads);
+  if (num_threads > 1) {
+    // The calling thread updates a share too.
+    thread_pool_.reset(new ctpl::thread_pool(num_threads - 1));
+  }
+
   // publish driven
   publish_sensor_id_ = FLAGS_fusion_publish_sensor_id;
   if (publish_sensor_id_ != "velodyne_64" && publish_sensor_id_ != "radar" &&
@@ -203,26 +218,47 @@ void ProbabilisticFusion::UpdateAssignedTracks(
     const std::vector<std::shared_ptr<PbfSensorObject>> &sensor_objects,
     const std::vector<std::pair<int, int>> &assignments,
     const std::vector<double> &track_object_dist) {
-  for (size_t i = 0; i < assignments.size(); i++) {
+  // Every track is assigned one sensor object at most, so the updates of the
+  // matched components share nothing.
+  RunUpdates(assignments.size(), [&](size_t i) {
     int local_track_index = assignments[i].first;
     int local_obj_index = assignments[i].second;
     (*tracks)[local_track_index]->UpdateWithSensorObject(
         sensor_objects[local_obj_index], track_object_dist[local_track_index]);
-  }
+  });
 }
 
 void ProbabilisticFusion::UpdateUnassignedTracks(
     std::vector<PbfTrackPtr> *tracks, const std::vector<int> &unassigned_tracks,
     const std::vector<double> &track_object_dist, const SensorType &sensor_type,
     const std::string &sensor_id, double timestamp) {
-  for (size_t i = 0; i < unassigned_tracks.size(); i++) {
+  auto update = [&](size_t i) {
     int local_track_index = unassigned_tracks[i];
     (*tracks)[local_track_index]->UpdateWithoutSensorObject(
         sensor_type, sensor_id, track_object_dist[local_track_index],
         timestamp);
+  };
+  // Without camera objects, tracks look up the camera calibration, which is
+  // shared.
+  if (is_camera(sensor_type)) {
+    for (size_t i = 0; i < unassigned_tracks.size(); i++) {
+      update(i);
+    }
+  } else {
+    RunUpdates(unassigned_tracks.size(), update);
   }
 }
 
+void ProbabilisticFusion::RunUpdates(
+    const size_t num_updates, const std::function<void(size_t)> &update) {
+  ParallelFor(thread_pool_.get(), num_updates, kMinTracksPerThread,
+              [&update](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  update(i);
+                }
+              });
+}
+
 void ProbabilisticFusion::CollectFusedObjects(
     double timestamp, std::vector<std::shared_ptr<Object>> *fused_objects) {
   if (fused_objects == nullptr) {
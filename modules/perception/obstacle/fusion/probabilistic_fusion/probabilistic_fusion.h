@@ -17,12 +17,15 @@
 #ifndef MODULES_PERCEPTION_OBSTACLE_FUSION_PROBABILISTIC_FUSION_PROBABILISTIC_FUSION_H_  // NOLINT
 #define MODULES_PERCEPTION_OBSTACLE_FUSION_PROBABILISTIC_FUSION_PROBABILISTIC_FUSION_H_  // NOLINT
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ctpl/ctpl_stl.h"
+
 #include "modules/perception/proto/probabilistic_fusion_config.pb.h"
 
 #include "modules/perception/obstacle/base/object.h"
@@ -89,6 +92,11 @@ class ProbabilisticFusion : public BaseFusion {
       const std::string &sensor_id, double timestamp,
       const Eigen::Matrix4d &sensor_world_pose);
 
+  /**@brief run update(i) for i in [0, num_updates), which must share no
+   * state, over the thread pool*/
+  void RunUpdates(const size_t num_updates,
+                  const std::function<void(size_t)> &update);
+
  protected:
   /**@brief produce fusion result for PNC only when fusing sensor with
    * publish_sensor_id_*/
@@ -101,6 +109,7 @@ class ProbabilisticFusion : public BaseFusion {
   std::mutex fusion_mutex_;
   bool use_camera_ = true;
   probabilistic_fusion_config::ModelConfigs config_;
+  std::unique_ptr<ctpl::thread_pool> thread_pool_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(ProbabilisticFusion);
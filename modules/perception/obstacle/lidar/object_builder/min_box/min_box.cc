@@ -16,11 +16,15 @@
 
 #include "modules/perception/obstacle/lidar/object_builder/min_box/min_box.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <utility>
 
-#include "modules/perception/common/convex_hullxy.h"
 #include "modules/perception/common/geometry_util.h"
+#include "modules/perception/common/parallel_for.h"
 #include "modules/perception/common/pcl_types.h"
+#include "modules/perception/common/perception_gflags.h"
 
 namespace apollo {
 namespace perception {
@@ -30,6 +34,232 @@ using pcl_util::PointCloudPtr;
 
 const float EPSILON = 1e-6;
 
+namespace {
+
+// Fewer objects than this are not worth another thread.
+const size_t kMinObjectsPerThread = 16;
+
+// Relative difference under which two values on a polygon are taken as a
+// tie, and compared again the way the edge by edge search did.
+const double kTieTolerance = 1e-9;
+
+// Rotating calipers over the edges of a convex polygon. For each edge it
+// finds the box with one side on the edge: the vertex farthest from the
+// edge gives the width, and the vertices with the least and the greatest
+// projection on the edge give the length. The edges are visited in the
+// order of the polygon, so each of these vertices only moves forward and a
+// round over all the edges takes linear time.
+class EdgeCalipers {
+ public:
+  explicit EdgeCalipers(const PolygonDType& polygon)
+      : polygon_(polygon), size_(polygon.points.size()) {}
+
+  // Edge from vertex edge % size to the next one. Edges must be visited in
+  // increasing order, at most one round from the first one.
+  double ComputeArea(size_t edge, Eigen::Vector3d* center, double* length,
+                     double* width, Eigen::Vector3d* dir) {
+    first_ = edge % size_;
+    second_ = (edge + 1) % size_;
+    const Eigen::Vector3d& a = Vertex(second_);
+    const Eigen::Vector3d& b = Vertex(first_);
+    ab_ = b - a;
+    ab_norm_ = std::sqrt(ab_[0] * ab_[0] + ab_[1] * ab_[1]);
+
+    // Vertices edge + 1 ... edge + size_ - 1 ascend to the farthest one and
+    // descend after it.
+    farthest_ = std::max(farthest_, edge + 1);
+    while (farthest_ + 1 < edge + size_ &&
+           Height(farthest_ + 1) >= Height(farthest_)) {
+      ++farthest_;
+    }
+    // Projections descend from vertex edge + 1 to the least one, ascend to
+    // the greatest one and descend to vertex edge + size_.
+    least_ = std::max(least_, edge + 1);
+    while (least_ + 1 <= edge + size_ &&
+           Projection(least_ + 1) <= Projection(least_)) {
+      ++least_;
+    }
+    greatest_ = std::max(greatest_, least_);
+    while (greatest_ + 1 <= edge + size_ &&
+           Projection(greatest_ + 1) >= Projection(greatest_)) {
+      ++greatest_;
+    }
+
+    // The vertex farthest from the edge, the first one on a tie.
+    double wid = 0.0;
+    Eigen::Vector3d v(0.0, 0.0, 0.0);
+    Eigen::Vector3d vn(0.0, 0.0, 0.0);
+    candidates_.clear();
+    AddTies(farthest_, edge + 2, edge + size_ - 1, &EdgeCalipers::Height,
+            ab_norm_);
+    std::sort(candidates_.begin(), candidates_.end());
+    for (const size_t i : candidates_) {
+      const double height = Height(i);
+      if (height > wid) {
+        wid = height;
+        v = Vertex(i);
+        vn = Pedal(i);
+      }
+    }
+
+    // The two pedals farthest apart, the first pair on a tie.
+    candidates_.clear();
+    AddTies(least_, edge + 1, edge + size_, &EdgeCalipers::Projection,
+            ab_norm_ * ab_norm_);
+    AddTies(greatest_, edge + 1, edge + size_, &EdgeCalipers::Projection,
+            ab_norm_ * ab_norm_);
+    std::sort(candidates_.begin(), candidates_.end());
+    candidates_.erase(std::unique(candidates_.begin(), candidates_.end()),
+                      candidates_.end());
+    pedals_.resize(candidates_.size());
+    for (size_t i = 0; i < candidates_.size(); ++i) {
+      pedals_[i] = Pedal(candidates_[i]);
+    }
+    double len = 0.0;
+    size_t point_num1 = 0;
+    size_t point_num2 = 0;
+    for (size_t i = 0; i + 1 < pedals_.size(); ++i) {
+      const Eigen::Vector3d& p1 = pedals_[i];
+      for (size_t j = i + 1; j < pedals_.size(); ++j) {
+        const Eigen::Vector3d& p2 = pedals_[j];
+        double dist = sqrt((p1[0] - p2[0]) * (p1[0] - p2[0]) +
+                           (p1[1] - p2[1]) * (p1[1] - p2[1]));
+        if (dist > len) {
+          len = dist;
+          point_num1 = i;
+          point_num2 = j;
+        }
+      }
+    }
+    const Eigen::Vector3d& ns1 = pedals_[point_num1];
+    const Eigen::Vector3d& ns2 = pedals_[point_num2];
+
+    Eigen::Vector3d vp1 = v + ns1 - vn;
+    Eigen::Vector3d vp2 = v + ns2 - vn;
+    (*center) = (vp1 + vp2 + ns1 + ns2) / 4;
+    (*center)[2] = polygon_.points[0].z;
+    if (len > wid) {
+      *dir = ns2 - ns1;
+    } else {
+      *dir = vp1 - ns1;
+    }
+    *length = len > wid ? len : wid;
+    *width = len > wid ? wid : len;
+    return (*length) * (*width);
+  }
+
+ private:
+  typedef double (EdgeCalipers::*Measure)(size_t) const;
+
+  Eigen::Vector3d Vertex(size_t i) const {
+    const pcl_util::PointD& p = polygon_.points[i % size_];
+    return Eigen::Vector3d(p.x, p.y, 0.0);
+  }
+
+  // Distance from the line of the edge.
+  double Height(size_t i) const {
+    const Eigen::Vector3d edge1 = Vertex(i) - Vertex(first_);
+    const Eigen::Vector3d edge2 = Vertex(second_) - Vertex(first_);
+    const double height = fabs(edge1[0] * edge2[1] - edge2[0] * edge1[1]);
+    return height / ab_norm_;
+  }
+
+  // Along the edge, from its second vertex to its first one, in units of
+  // its length.
+  double Projection(size_t i) const {
+    const Eigen::Vector3d ao = Vertex(i) - Vertex(second_);
+    return ao[0] * ab_[0] + ao[1] * ab_[1];
+  }
+
+  // Foot of the perpendicular from the vertex to the line of the edge.
+  Eigen::Vector3d Pedal(size_t i) const {
+    const size_t index = i % size_;
+    if (index == first_ || index == second_) {
+      return Vertex(index);
+    }
+    const Eigen::Vector3d o = Vertex(index);
+    const Eigen::Vector3d b = Vertex(first_);
+    const Eigen::Vector3d a = Vertex(second_);
+    double k = ((a[0] - o[0]) * (b[0] - a[0]) + (a[1] - o[1]) * (b[1] - a[1]));
+    k = k / ((b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]));
+    k = k * -1;
+    return Eigen::Vector3d((b[0] - a[0]) * k + a[0], (b[1] - a[1]) * k + a[1],
+                           0.0);
+  }
+
+  // Adds the vertex and its neighbors in [begin, end] with about the same
+  // measure, by their index in the polygon.
+  void AddTies(size_t i, size_t begin, size_t end, Measure measure,
+               double scale) {
+    if (i < begin || i > end) {
+      return;
+    }
+    const double value = (this->*measure)(i);
+    const double tolerance =
+        kTieTolerance * std::max(std::fabs(value), scale);
+    size_t low = i;
+    while (low > begin &&
+           std::fabs((this->*measure)(low - 1) - value) <= tolerance) {
+      --low;
+    }
+    size_t high = i;
+    while (high < end && high + 1 < low + size_ &&
+           std::fabs((this->*measure)(high + 1) - value) <= tolerance) {
+      ++high;
+    }
+    for (size_t j = low; j <= high; ++j) {
+      candidates_.push_back(j % size_);
+    }
+  }
+
+  const PolygonDType& polygon_;
+  const size_t size_;
+
+  size_t first_ = 0;
+  size_t second_ = 0;
+  Eigen::Vector3d ab_;
+  double ab_norm_ = 0.0;
+
+  // Vertices as edge + offset, so that they only increase.
+  size_t farthest_ = 0;
+  size_t least_ = 0;
+  size_t greatest_ = 0;
+
+  std::vector<size_t> candidates_;
+  std::vector<Eigen::Vector3d> pedals_;
+};
+
+// Whether the vertices turn the same way all around.
+bool IsConvex(const PolygonDType& polygon) {
+  const auto& points = polygon.points;
+  const size_t size = points.size();
+  int turn = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const pcl_util::PointD& o = points[i];
+    const pcl_util::PointD& a = points[(i + 1) % size];
+    const pcl_util::PointD& b = points[(i + 2) % size];
+    const double cross = (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    const int sign = cross > 0.0 ? 1 : (cross < 0.0 ? -1 : 0);
+    if (sign == 0 || sign == -turn) {
+      return false;
+    }
+    turn = sign;
+  }
+  return size >= 3;
+}
+
+}  // namespace
+
+bool MinBoxObjectBuilder::Init() {
+  const int num_threads = std::max(1, FLAGS_min_box_object_builder_num_threads);
+  buffers_.resize(num_threads);
+  if (num_threads > 1) {
+    // The calling thread builds a share too.
+    thread_pool_.reset(new ctpl::thread_pool(num_threads - 1));
+  }
+  return true;
+}
+
 bool MinBoxObjectBuilder::Build(const ObjectBuilderOptions& options,
                                 std::vector<std::shared_ptr<Object>>* objects) {
   if (objects == nullptr) {
@@ -39,10 +269,20 @@ bool MinBoxObjectBuilder::Build(const ObjectBuilderOptions& options,
   for (size_t i = 0; i < objects->size(); ++i) {
     if ((*objects)[i]) {
       (*objects)[i]->id = i;
-      BuildObject(options, (*objects)[i]);
     }
   }
 
+  // Each share of the objects is built with its own buffer.
+  ParallelFor(thread_pool_.get(), objects->size(), kMinObjectsPerThread,
+              [this, &options, objects](size_t share, size_t begin,
+                                        size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  if ((*objects)[i]) {
+                    BuildObject(options, (*objects)[i], &buffers_[share]);
+                  }
+                }
+              });
+
   return true;
 }
 
@@ -221,6 +461,19 @@ void MinBoxObjectBuilder::ReconstructPolygon(const Eigen::Vector3d& ref_ct,
       }
     }
   }
+  // The calipers need a convex polygon, which the angular order of the
+  // hull may not give for a sliver, and then each edge is searched alone.
+  EdgeCalipers calipers(obj->polygon);
+  const bool use_calipers = use_calipers_ && IsConvex(obj->polygon);
+  auto compute_area = [&](size_t i, size_t count, Eigen::Vector3d* center,
+                          double* length, double* width,
+                          Eigen::Vector3d* dir) {
+    if (use_calipers) {
+      return calipers.ComputeArea(min_point_index + count, center, length,
+                                  width, dir);
+    }
+    return ComputeAreaAlongOneEdge(obj, i, center, length, width, dir);
+  };
   size_t count = 0;
   double min_area = std::numeric_limits<double>::max();
   for (size_t i = min_point_index; count < obj->polygon.points.size();
@@ -251,7 +504,7 @@ void MinBoxObjectBuilder::ReconstructPolygon(const Eigen::Vector3d& ref_ct,
         double width = 0;
         Eigen::Vector3d dir;
         double area =
-            ComputeAreaAlongOneEdge(obj, i, &center, &length, &width, &dir);
+            compute_area(i, count, &center, &length, &width, &dir);
         if (area < min_area) {
           obj->center = center;
           obj->length = length;
@@ -271,8 +524,7 @@ void MinBoxObjectBuilder::ReconstructPolygon(const Eigen::Vector3d& ref_ct,
       double length = 0;
       double width = 0;
       Eigen::Vector3d dir;
-      double area =
-          ComputeAreaAlongOneEdge(obj, i, &center, &length, &width, &dir);
+      double area = compute_area(i, count, &center, &length, &width, &dir);
       if (area < min_area) {
         obj->center = center;
         obj->length = length;
@@ -292,7 +544,7 @@ void MinBoxObjectBuilder::ReconstructPolygon(const Eigen::Vector3d& ref_ct,
         double width = 0.0;
         Eigen::Vector3d dir;
         double area =
-            ComputeAreaAlongOneEdge(obj, i, &center, &length, &width, &dir);
+            compute_area(i, count, &center, &length, &width, &dir);
         if (area < min_area) {
           obj->center = center;
           obj->length = length;
@@ -308,7 +560,8 @@ void MinBoxObjectBuilder::ReconstructPolygon(const Eigen::Vector3d& ref_ct,
   obj->direction.normalize();
 }
 
-void MinBoxObjectBuilder::ComputePolygon2dxy(std::shared_ptr<Object> obj) {
+void MinBoxObjectBuilder::ComputePolygon2dxy(std::shared_ptr<Object> obj,
+                                             HullBuffer* buffer) {
   Eigen::Vector4f min_pt;
   Eigen::Vector4f max_pt;
   pcl_util::PointCloudPtr cloud = obj->cloud;
@@ -342,25 +595,7 @@ void MinBoxObjectBuilder::ComputePolygon2dxy(std::shared_ptr<Object> obj) {
     cloud->points[1].x -= min_eps;
   }
 
-  PointCloudPtr pcd_xy(new PointCloud);
-  for (size_t i = 0; i < cloud->points.size(); ++i) {
-    pcl_util::Point p = cloud->points[i];
-    p.z = min_pt[2];
-    pcd_xy->push_back(p);
-  }
-
-  ConvexHull2DXY<pcl_util::Point> hull;
-  hull.setInputCloud(pcd_xy);
-  hull.setDimension(2);
-  std::vector<pcl::Vertices> poly_vt;
-  PointCloudPtr plane_hull(new PointCloud);
-  hull.Reconstruct2dxy(plane_hull, &poly_vt);
-
-  if (poly_vt.size() == 1u) {
-    std::vector<int> ind(poly_vt[0].vertices.begin(),
-                         poly_vt[0].vertices.end());
-    TransformPointCloud(plane_hull, ind, &obj->polygon);
-  } else {
+  if (!ComputeConvexHull2dxy(cloud, min_pt[2], buffer, &obj->polygon)) {
     obj->polygon.points.resize(4);
     obj->polygon.points[0].x = static_cast<double>(min_pt[0]);
     obj->polygon.points[0].y = static_cast<double>(min_pt[1]);
@@ -380,15 +615,98 @@ void MinBoxObjectBuilder::ComputePolygon2dxy(std::shared_ptr<Object> obj) {
   }
 }
 
+bool MinBoxObjectBuilder::ComputeConvexHull2dxy(PointCloudPtr cloud,
+                                                float z, HullBuffer* buffer,
+                                                PolygonDType* polygon) {
+  const auto& points = cloud->points;
+  // Monotone chain, counterclockwise without collinear points.
+  std::vector<int>& sorted_points = buffer->sorted_points;
+  sorted_points.resize(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    sorted_points[i] = static_cast<int>(i);
+  }
+  std::sort(sorted_points.begin(), sorted_points.end(),
+            [&points](const int lhs, const int rhs) {
+              return points[lhs].x < points[rhs].x ||
+                     (points[lhs].x == points[rhs].x &&
+                      points[lhs].y < points[rhs].y);
+            });
+  auto cross = [&points](const int o, const int a, const int b) {
+    return (static_cast<double>(points[a].x) - points[o].x) *
+               (static_cast<double>(points[b].y) - points[o].y) -
+           (static_cast<double>(points[a].y) - points[o].y) *
+               (static_cast<double>(points[b].x) - points[o].x);
+  };
+  std::vector<int>& hull = buffer->hull;
+  hull.resize(2 * points.size());
+  size_t size = 0;
+  for (size_t i = 0; i < sorted_points.size(); ++i) {
+    while (size >= 2 &&
+           cross(hull[size - 2], hull[size - 1], sorted_points[i]) <= 0) {
+      --size;
+    }
+    hull[size++] = sorted_points[i];
+  }
+  const size_t lower_size = size + 1;
+  for (size_t i = sorted_points.size() - 1; i-- > 0;) {
+    while (size >= lower_size &&
+           cross(hull[size - 2], hull[size - 1], sorted_points[i]) <= 0) {
+      --size;
+    }
+    hull[size++] = sorted_points[i];
+  }
+  // The first point is at the end again.
+  --size;
+  if (size < 3) {
+    return false;
+  }
+
+  // Same order as ConvexHull2DXY: by decreasing angle around the
+  // centroid, which is clockwise from the one closest below -x.
+  float centroid_x = 0.0f;
+  float centroid_y = 0.0f;
+  for (size_t i = 0; i < size; ++i) {
+    centroid_x += points[hull[i]].x;
+    centroid_y += points[hull[i]].y;
+  }
+  centroid_x /= static_cast<float>(size);
+  centroid_y /= static_cast<float>(size);
+  std::vector<std::pair<double, int>>& angles = buffer->angles;
+  angles.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    const float dx = points[hull[i]].x - centroid_x;
+    const float dy = points[hull[i]].y - centroid_y;
+    angles[i] = std::make_pair(atan2(dy, dx), hull[i]);
+  }
+  std::sort(angles.begin(), angles.end(),
+            [](const std::pair<double, int>& lhs,
+               const std::pair<double, int>& rhs) {
+              return lhs.first > rhs.first;
+            });
+
+  polygon->resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    const pcl_util::Point& p = points[angles[i].second];
+    pcl_util::PointD& vertex = polygon->points[i];
+    vertex.x = p.x;
+    vertex.y = p.y;
+    vertex.z = z;
+    vertex.intensity = static_cast<uint8_t>(p.intensity);
+  }
+  return true;
+}
+
 void MinBoxObjectBuilder::ComputeGeometricFeature(const Eigen::Vector3d& ref_ct,
-                                                  std::shared_ptr<Object> obj) {
-  ComputePolygon2dxy(obj);
+                                                  std::shared_ptr<Object> obj,
+                                                  HullBuffer* buffer) {
+  ComputePolygon2dxy(obj, buffer);
   ReconstructPolygon(ref_ct, obj);
 }
 
 void MinBoxObjectBuilder::BuildObject(ObjectBuilderOptions options,
-                                      std::shared_ptr<Object> object) {
-  ComputeGeometricFeature(options.ref_center, object);
+                                      std::shared_ptr<Object> object,
+                                      HullBuffer* buffer) {
+  ComputeGeometricFeature(options.ref_center, object, buffer);
 }
 
 }  // namespace perception
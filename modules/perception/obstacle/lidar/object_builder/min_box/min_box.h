@@ -19,8 +19,11 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "ctpl/ctpl_stl.h"
+
 #include "modules/perception/obstacle/base/object.h"
 #include "modules/perception/obstacle/lidar/interface/base_object_builder.h"
 
@@ -29,33 +32,55 @@ namespace perception {
 
 class MinBoxObjectBuilder : public BaseObjectBuilder {
  public:
-  MinBoxObjectBuilder() : BaseObjectBuilder() {}
+  MinBoxObjectBuilder() : BaseObjectBuilder(), buffers_(1) {}
   virtual ~MinBoxObjectBuilder() {}
 
-  bool Init() override { return true; }
+  bool Init() override;
 
+  // Objects are built in parallel on min_box_object_builder_num_threads
+  // threads when there are enough of them.
   bool Build(const ObjectBuilderOptions& options,
              std::vector<std::shared_ptr<Object>>* objects) override;
   std::string name() const override { return "MinBoxObjectBuilder"; }
 
  protected:
+  // Buffers reused by one thread across the objects it builds.
+  struct HullBuffer {
+    std::vector<int> sorted_points;
+    std::vector<int> hull;
+    std::vector<std::pair<double, int>> angles;
+  };
+
   void BuildObject(ObjectBuilderOptions options,
-                   std::shared_ptr<Object> object);
+                   std::shared_ptr<Object> object, HullBuffer* buffer);
 
-  void ComputePolygon2dxy(std::shared_ptr<Object> obj);
+  void ComputePolygon2dxy(std::shared_ptr<Object> obj, HullBuffer* buffer);
 
   double ComputeAreaAlongOneEdge(std::shared_ptr<Object> obj,
                                  size_t first_in_point, Eigen::Vector3d* center,
                                  double* lenth, double* width,
                                  Eigen::Vector3d* dir);
 
+  // Computes the convex hull in xy, in the clockwise order of
+  // ConvexHull2DXY. Returns false if the points are collinear.
+  bool ComputeConvexHull2dxy(pcl_util::PointCloudPtr cloud, float z,
+                             HullBuffer* buffer, PolygonDType* polygon);
+
   void ReconstructPolygon(const Eigen::Vector3d& ref_ct,
                           std::shared_ptr<Object> obj);
 
   void ComputeGeometricFeature(const Eigen::Vector3d& ref_ct,
-                               std::shared_ptr<Object> obj);
+                               std::shared_ptr<Object> obj,
+                               HullBuffer* buffer);
+
+  // Whether the boxes of convex polygons are searched with rotating
+  // calipers rather than edge by edge, which gives the same boxes.
+  bool use_calipers_ = true;
 
  private:
+  std::vector<HullBuffer> buffers_;
+  std::unique_ptr<ctpl::thread_pool> thread_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(MinBoxObjectBuilder);
 };
 
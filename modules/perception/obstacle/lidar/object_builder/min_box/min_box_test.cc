@@ -17,9 +17,13 @@
 #include "modules/perception/obstacle/lidar/object_builder/min_box/min_box.h"
 
 #include <fstream>
+#include <random>
 
 #include "gtest/gtest.h"
 
+#include "modules/perception/common/convex_hullxy.h"
+#include "modules/perception/common/perception_gflags.h"
+
 namespace apollo {
 namespace perception {
 
@@ -27,16 +31,63 @@ class MinBoxObjectBuilderTest : public testing::Test {
  protected:
   MinBoxObjectBuilderTest() {}
   ~MinBoxObjectBuilderTest() {}
-  void SetUp() { min_box_object_builder_ = new MinBoxObjectBuilder(); }
+  void SetUp() {
+    num_threads_ = FLAGS_min_box_object_builder_num_threads;
+    min_box_object_builder_ = new MinBoxObjectBuilder();
+  }
   void TearDown() {
     delete min_box_object_builder_;
     min_box_object_builder_ = nullptr;
+    FLAGS_min_box_object_builder_num_threads = num_threads_;
   }
 
  protected:
   MinBoxObjectBuilder* min_box_object_builder_ = nullptr;
+  int num_threads_ = 1;
+};
+
+// Opens up the steps of building an object.
+class MinBoxObjectBuilderForTest : public MinBoxObjectBuilder {
+ public:
+  using MinBoxObjectBuilder::HullBuffer;
+  using MinBoxObjectBuilder::ComputeConvexHull2dxy;
+  using MinBoxObjectBuilder::ReconstructPolygon;
+  using MinBoxObjectBuilder::use_calipers_;
 };
 
+// Clouds of random points in a box, some on a grid so that there are
+// collinear and repeated points.
+std::vector<pcl_util::PointCloudPtr> ConstructRandomClouds(int num_clouds) {
+  std::mt19937 rng(20171101);
+  std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+  std::vector<pcl_util::PointCloudPtr> clouds;
+  for (int i = 0; i < num_clouds; ++i) {
+    const bool on_grid = i % 4 == 0;
+    const int num_points = 10 + static_cast<int>(rng() % 200);
+    const float center_x = uniform(rng) * 50.0f;
+    const float center_y = uniform(rng) * 50.0f;
+    const float length = 0.2f + 5.0f * std::fabs(uniform(rng));
+    const float width = 0.5f + 2.0f * std::fabs(uniform(rng));
+    pcl_util::PointCloudPtr cloud(new pcl_util::PointCloud);
+    for (int j = 0; j < num_points; ++j) {
+      pcl_util::Point p;
+      float x = uniform(rng) * length;
+      float y = uniform(rng) * width;
+      if (on_grid) {
+        x = std::round(x * 4.0f) * 0.25f;
+        y = std::round(y * 4.0f) * 0.25f;
+      }
+      p.x = center_x + x;
+      p.y = center_y + y;
+      p.z = uniform(rng);
+      p.intensity = static_cast<float>(rng() % 255);
+      cloud->points.push_back(p);
+    }
+    clouds.push_back(cloud);
+  }
+  return clouds;
+}
+
 bool ConstructPointCloud(std::vector<std::shared_ptr<Object>>* objects) {
   std::string pcd_data(
       "modules/perception/data/min_box_object_builder_test/"
@@ -120,5 +171,82 @@ TEST_F(MinBoxObjectBuilderTest, build) {
   EXPECT_NEAR(0.0, objects[4]->direction[2], EPSILON);
 }
 
+TEST_F(MinBoxObjectBuilderTest, build_in_parallel) {
+  std::vector<std::shared_ptr<Object>> objects;
+  std::vector<std::shared_ptr<Object>> expected_objects;
+  for (int i = 0; i < 20; ++i) {
+    ConstructPointCloud(&objects);
+    ConstructPointCloud(&expected_objects);
+  }
+  ObjectBuilderOptions options;
+  EXPECT_TRUE(min_box_object_builder_->Build(options, &expected_objects));
+
+  FLAGS_min_box_object_builder_num_threads = 4;
+  MinBoxObjectBuilder parallel_builder;
+  EXPECT_TRUE(parallel_builder.Init());
+  EXPECT_TRUE(parallel_builder.Build(options, &objects));
+  ASSERT_EQ(expected_objects.size(), objects.size());
+  for (size_t i = 0; i < objects.size(); ++i) {
+    EXPECT_EQ(i, objects[i]->id);
+    EXPECT_DOUBLE_EQ(expected_objects[i]->length, objects[i]->length);
+    EXPECT_DOUBLE_EQ(expected_objects[i]->width, objects[i]->width);
+    EXPECT_DOUBLE_EQ(expected_objects[i]->height, objects[i]->height);
+    EXPECT_DOUBLE_EQ(expected_objects[i]->direction[0],
+                     objects[i]->direction[0]);
+    EXPECT_DOUBLE_EQ(expected_objects[i]->direction[1],
+                     objects[i]->direction[1]);
+    EXPECT_DOUBLE_EQ(expected_objects[i]->center[0], objects[i]->center[0]);
+    EXPECT_DOUBLE_EQ(expected_objects[i]->center[1], objects[i]->center[1]);
+    EXPECT_EQ(expected_objects[i]->polygon.points.size(),
+              objects[i]->polygon.points.size());
+  }
+}
+
+TEST_F(MinBoxObjectBuilderTest, convex_hull_same_as_qhull) {
+  MinBoxObjectBuilderForTest builder;
+  MinBoxObjectBuilderForTest::HullBuffer buffer;
+  ConvexHull2DXY<pcl_util::Point> convex_hull;
+  for (const pcl_util::PointCloudPtr& cloud : ConstructRandomClouds(500)) {
+    PolygonDType polygon;
+    ASSERT_TRUE(builder.ComputeConvexHull2dxy(cloud, 0.0f, &buffer, &polygon));
+
+    pcl_util::PointCloudPtr hull(new pcl_util::PointCloud);
+    std::vector<pcl::Vertices> poly_vt;
+    convex_hull.setInputCloud(cloud);
+    convex_hull.setDimension(2);
+    convex_hull.Reconstruct2dxy(hull, &poly_vt);
+    ASSERT_EQ(1, poly_vt.size());
+    ASSERT_EQ(poly_vt[0].vertices.size(), polygon.points.size());
+    for (size_t i = 0; i < polygon.points.size(); ++i) {
+      const pcl_util::Point& expected = hull->points[poly_vt[0].vertices[i]];
+      EXPECT_EQ(expected.x, polygon.points[i].x);
+      EXPECT_EQ(expected.y, polygon.points[i].y);
+    }
+  }
+}
+
+TEST_F(MinBoxObjectBuilderTest, calipers_same_as_edge_by_edge) {
+  MinBoxObjectBuilderForTest builder;
+  MinBoxObjectBuilderForTest edge_by_edge_builder;
+  edge_by_edge_builder.use_calipers_ = false;
+  MinBoxObjectBuilderForTest::HullBuffer buffer;
+  const Eigen::Vector3d ref_ct(0.0, 0.0, 0.0);
+  for (const pcl_util::PointCloudPtr& cloud : ConstructRandomClouds(500)) {
+    std::shared_ptr<Object> object(new Object);
+    ASSERT_TRUE(builder.ComputeConvexHull2dxy(cloud, 0.0f, &buffer,
+                                              &object->polygon));
+    std::shared_ptr<Object> expected(new Object);
+    expected->polygon = object->polygon;
+    builder.ReconstructPolygon(ref_ct, object);
+    edge_by_edge_builder.ReconstructPolygon(ref_ct, expected);
+    EXPECT_DOUBLE_EQ(expected->length, object->length);
+    EXPECT_DOUBLE_EQ(expected->width, object->width);
+    EXPECT_DOUBLE_EQ(expected->center[0], object->center[0]);
+    EXPECT_DOUBLE_EQ(expected->center[1], object->center[1]);
+    EXPECT_DOUBLE_EQ(expected->direction[0], object->direction[0]);
+    EXPECT_DOUBLE_EQ(expected->direction[1], object->direction[1]);
+  }
+}
+
 }  // namespace perception
 }  // namespace apollo
@@ -16,17 +16,37 @@
 
 #include "modules/perception/obstacle/lidar/tracker/hm_tracker/hungarian_matcher.h"
 
+#include <algorithm>
+
 #include "modules/common/log.h"
 #include "modules/perception/common/geometry_util.h"
 #include "modules/perception/common/graph_util.h"
+#include "modules/perception/common/parallel_for.h"
+#include "modules/perception/common/perception_gflags.h"
 #include "modules/perception/obstacle/common/hungarian_bigraph_matcher.h"
 #include "modules/perception/obstacle/lidar/tracker/hm_tracker/track_object_distance.h"
 
 namespace apollo {
 namespace perception {
 
+namespace {
+
+// Tracks below which computing association matrix in one more thread does
+// not pay off.
+const size_t kMinTracksPerThread = 16;
+
+}  // namespace
+
 float HungarianMatcher::s_match_distance_maximum_ = 4.0f;
 
+HungarianMatcher::HungarianMatcher() {
+  const int num_threads = std::max(1, FLAGS_hm_tracker_match_num_threads);
+  if (num_threads > 1) {
+    // The calling thread computes a share too.
+    thread_pool_.reset(new ctpl::thread_pool(num_threads - 1));
+  }
+}
+
 bool HungarianMatcher::SetMatchDistanceMaximum(
     const float match_distance_maximum) {
   if (match_distance_maximum >= 0) {
@@ -169,12 +189,39 @@ void HungarianMatcher::ComputeAssociateMatrix(
     const std::vector<std::shared_ptr<TrackedObject>>& new_objects,
     Eigen::MatrixXf* association_mat) {
   // Compute matrix of association distance
-  for (size_t i = 0; i < tracks.size(); ++i) {
-    for (size_t j = 0; j < new_objects.size(); ++j) {
-      (*association_mat)(i, j) = TrackObjectDistance::ComputeDistance(
-          tracks[i], tracks_predict[i], new_objects[j]);
+  TrackObjectDistance::TrackFeatures track_features;
+  TrackObjectDistance::ObjectFeatures object_features;
+  if (!TrackObjectDistance::ExtractObjectFeatures(new_objects,
+                                                  &object_features)) {
+    AWARN << "histograms of objects differ in size, computing association "
+          << "matrix pair by pair";
+    for (size_t i = 0; i < tracks.size(); ++i) {
+      for (size_t j = 0; j < new_objects.size(); ++j) {
+        (*association_mat)(i, j) = TrackObjectDistance::ComputeDistance(
+            tracks[i], tracks_predict[i], new_objects[j]);
+      }
     }
+    return;
   }
+  TrackObjectDistance::ExtractTrackFeatures(tracks, tracks_predict,
+                                            &track_features);
+
+  // Pairs costing more than the unassigned objects do, which is 1.2 times the
+  // maximum, are neither connected nor in any optimal assignment. So their
+  // distances are only computed till they are known to be beyond the gate.
+  const float gate_distance = 2 * s_match_distance_maximum_;
+  ParallelFor(thread_pool_.get(), tracks.size(), kMinTracksPerThread,
+              [&](size_t, size_t begin, size_t end) {
+                std::vector<float> distances(new_objects.size());
+                for (size_t i = begin; i < end; ++i) {
+                  TrackObjectDistance::ComputeDistances(
+                      track_features, i, object_features, gate_distance,
+                      distances.data());
+                  for (size_t j = 0; j < new_objects.size(); ++j) {
+                    (*association_mat)(i, j) = distances[j];
+                  }
+                }
+              });
 }
 
 void HungarianMatcher::ComputeConnectedComponents(
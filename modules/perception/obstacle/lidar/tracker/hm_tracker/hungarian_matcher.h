@@ -22,6 +22,8 @@
 #include <utility>
 #include <vector>
 
+#include "ctpl/ctpl_stl.h"
+
 #include "modules/perception/obstacle/lidar/tracker/hm_tracker/base_matcher.h"
 
 namespace apollo {
@@ -29,7 +31,7 @@ namespace perception {
 
 class HungarianMatcher : public BaseMatcher {
  public:
-  HungarianMatcher() {}
+  HungarianMatcher();
   ~HungarianMatcher() {}
 
   // @brief set match distance maximum for matcher
@@ -110,6 +112,9 @@ class HungarianMatcher : public BaseMatcher {
   // threshold of matching
   static float s_match_distance_maximum_;
 
+  // threads computing association matrix besides the calling one, if any
+  std::unique_ptr<ctpl::thread_pool> thread_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(HungarianMatcher);
 };  // class HmMatcher
 
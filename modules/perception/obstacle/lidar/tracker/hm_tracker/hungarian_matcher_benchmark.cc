@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of HungarianMatcher::Match with hundreds of tracks, against
+ * computing the association matrix pair by pair.
+ **/
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/obstacle/lidar/tracker/hm_tracker/hungarian_matcher.h"
+#include "modules/perception/obstacle/lidar/tracker/hm_tracker/track_object_distance.h"
+
+namespace apollo {
+namespace perception {
+namespace {
+
+constexpr int kHistogramSize = 30;
+
+// Tracks spread over a scene, each with a detected object close by.
+class MatchScenario {
+ public:
+  explicit MatchScenario(const int num_tracks) {
+    std::mt19937 random(0);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> velocity(-8.0f, 8.0f);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    for (int i = 0; i < num_tracks; ++i) {
+      std::shared_ptr<TrackedObject> object = MakeObject(&random);
+      object->anchor_point =
+          Eigen::Vector3f(position(random), position(random), 0.0f);
+      const Eigen::Vector3f direction = object->direction;
+      tracks_.emplace_back(new ObjectTrack(object));
+      object->direction = direction;
+      object->velocity = Eigen::Vector3f(velocity(random), velocity(random), 0);
+      Eigen::VectorXf track_predict(6);
+      track_predict << object->anchor_point(0) + object->velocity(0) * 0.1f,
+          object->anchor_point(1) + object->velocity(1) * 0.1f, 0.0f,
+          object->velocity(0), object->velocity(1), 0.0f;
+      tracks_predict_.push_back(track_predict);
+      track_ptrs_.push_back(tracks_.back().get());
+
+      std::shared_ptr<TrackedObject> new_object = MakeObject(&random);
+      new_object->anchor_point =
+          Eigen::Vector3f(track_predict(0) + noise(random),
+                          track_predict(1) + noise(random), 0.0f);
+      objects_.push_back(new_object);
+    }
+  }
+
+  void Match(HungarianMatcher* matcher) {
+    matcher->Match(&objects_, track_ptrs_, tracks_predict_, &assignments_,
+                   &unassigned_tracks_, &unassigned_objects_);
+  }
+
+  void ComputeDistances() {
+    for (size_t i = 0; i < track_ptrs_.size(); ++i) {
+      for (size_t j = 0; j < objects_.size(); ++j) {
+        benchmark::DoNotOptimize(TrackObjectDistance::ComputeDistance(
+            track_ptrs_[i], tracks_predict_[i], objects_[j]));
+      }
+    }
+  }
+
+ private:
+  static std::shared_ptr<TrackedObject> MakeObject(std::mt19937* random) {
+    std::uniform_real_distribution<float> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<float> size(1.0f, 5.0f);
+    std::uniform_real_distribution<float> bin(0.0f, 0.1f);
+    std::uniform_int_distribution<int> num_points(10, 500);
+    std::shared_ptr<Object> object(new Object());
+    object->cloud.reset(new pcl_util::PointCloud());
+    object->cloud->resize(num_points(*random));
+    for (int i = 0; i < kHistogramSize; ++i) {
+      object->shape_features.push_back(bin(*random));
+    }
+    std::shared_ptr<TrackedObject> tracked_object(new TrackedObject());
+    tracked_object->object_ptr = object;
+    const float theta = angle(*random);
+    tracked_object->direction =
+        Eigen::Vector3f(std::cos(theta), std::sin(theta), 0.0f);
+    tracked_object->size =
+        Eigen::Vector3f(size(*random), size(*random), 1.5f);
+    tracked_object->velocity = Eigen::Vector3f::Zero();
+    return tracked_object;
+  }
+
+  std::vector<std::unique_ptr<ObjectTrack>> tracks_;
+  std::vector<ObjectTrackPtr> track_ptrs_;
+  std::vector<Eigen::VectorXf> tracks_predict_;
+  std::vector<std::shared_ptr<TrackedObject>> objects_;
+  std::vector<std::pair<int, int>> assignments_;
+  std::vector<int> unassigned_tracks_;
+  std::vector<int> unassigned_objects_;
+};
+
+void BM_ComputeDistancePairByPair(benchmark::State& state) {  // NOLINT
+  MatchScenario scenario(state.range(0));
+  while (state.KeepRunning()) {
+    scenario.ComputeDistances();
+  }
+}
+BENCHMARK(BM_ComputeDistancePairByPair)->Arg(100)->Arg(200)->Arg(300);
+
+void BM_Match(benchmark::State& state) {  // NOLINT
+  FLAGS_hm_tracker_match_num_threads = 1;
+  HungarianMatcher matcher;
+  MatchScenario scenario(state.range(0));
+  while (state.KeepRunning()) {
+    scenario.Match(&matcher);
+  }
+}
+BENCHMARK(BM_Match)->Arg(100)->Arg(200)->Arg(300);
+
+void BM_MatchMultiThread(benchmark::State& state) {  // NOLINT
+  FLAGS_hm_tracker_match_num_threads = 4;
+  HungarianMatcher matcher;
+  MatchScenario scenario(state.range(0));
+  while (state.KeepRunning()) {
+    scenario.Match(&matcher);
+  }
+}
+BENCHMARK(BM_MatchMultiThread)->Arg(100)->Arg(200)->Arg(300);
+
+}  // namespace
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,207 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/obstacle/lidar/tracker/hm_tracker/hungarian_matcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/common/perception_gflags.h"
+#include "modules/perception/obstacle/lidar/tracker/hm_tracker/track_object_distance.h"
+
+namespace apollo {
+namespace perception {
+
+namespace {
+
+constexpr float kMatchDistanceMaximum = 4.0f;
+
+// Match() with the association matrix computed pair by pair and no gate, as
+// it was before.
+class PairByPairMatcher : public HungarianMatcher {
+ public:
+  void Match(std::vector<std::shared_ptr<TrackedObject>>* objects,
+             const std::vector<ObjectTrackPtr>& tracks,
+             const std::vector<Eigen::VectorXf>& tracks_predict,
+             std::vector<std::pair<int, int>>* assignments,
+             std::vector<int>* unassigned_tracks,
+             std::vector<int>* unassigned_objects) {
+    Eigen::MatrixXf association_mat(tracks.size(), objects->size());
+    for (size_t i = 0; i < tracks.size(); ++i) {
+      for (size_t j = 0; j < objects->size(); ++j) {
+        association_mat(i, j) = TrackObjectDistance::ComputeDistance(
+            tracks[i], tracks_predict[i], (*objects)[j]);
+      }
+    }
+    std::vector<std::vector<int>> track_components;
+    std::vector<std::vector<int>> object_components;
+    ComputeConnectedComponents(association_mat, kMatchDistanceMaximum,
+                               &track_components, &object_components);
+    assignments->clear();
+    unassigned_tracks->clear();
+    unassigned_objects->clear();
+    for (size_t i = 0; i < track_components.size(); ++i) {
+      std::vector<std::pair<int, int>> sub_assignments;
+      std::vector<int> sub_unassigned_tracks;
+      std::vector<int> sub_unassigned_objects;
+      MatchInComponents(association_mat, track_components[i],
+                        object_components[i], &sub_assignments,
+                        &sub_unassigned_tracks, &sub_unassigned_objects);
+      for (const auto& assignment : sub_assignments) {
+        assignments->push_back(assignment);
+        (*objects)[assignment.second]->association_score =
+            association_mat(assignment.first, assignment.second);
+      }
+      unassigned_tracks->insert(unassigned_tracks->end(),
+                                sub_unassigned_tracks.begin(),
+                                sub_unassigned_tracks.end());
+      unassigned_objects->insert(unassigned_objects->end(),
+                                 sub_unassigned_objects.begin(),
+                                 sub_unassigned_objects.end());
+    }
+  }
+};
+
+}  // namespace
+
+class HungarianMatcherTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    num_threads_ = FLAGS_hm_tracker_match_num_threads;
+    ASSERT_TRUE(
+        HungarianMatcher::SetMatchDistanceMaximum(kMatchDistanceMaximum));
+  }
+
+  void TearDown() override {
+    FLAGS_hm_tracker_match_num_threads = num_threads_;
+  }
+
+  std::shared_ptr<TrackedObject> MakeObject() {
+    std::uniform_real_distribution<float> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<float> size(1.0f, 5.0f);
+    std::uniform_real_distribution<float> bin(0.0f, 0.1f);
+    std::uniform_int_distribution<int> num_points(10, 500);
+    std::shared_ptr<Object> object(new Object());
+    object->cloud.reset(new pcl_util::PointCloud());
+    object->cloud->resize(num_points(random_));
+    for (int i = 0; i < 30; ++i) {
+      object->shape_features.push_back(bin(random_));
+    }
+    std::shared_ptr<TrackedObject> tracked_object(new TrackedObject());
+    tracked_object->object_ptr = object;
+    const float theta = angle(random_);
+    tracked_object->direction =
+        Eigen::Vector3f(std::cos(theta), std::sin(theta), 0.0f);
+    tracked_object->size = Eigen::Vector3f(size(random_), size(random_), 1.5f);
+    tracked_object->velocity = Eigen::Vector3f::Zero();
+    return tracked_object;
+  }
+
+  // Tracks crowded enough for the components to hold several of them, most
+  // with an object close by, and some clutter.
+  void MakeScene(const int num_tracks) {
+    std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> velocity(-8.0f, 8.0f);
+    std::uniform_real_distribution<float> noise(-1.5f, 1.5f);
+    for (int i = 0; i < num_tracks; ++i) {
+      std::shared_ptr<TrackedObject> object = MakeObject();
+      object->anchor_point =
+          Eigen::Vector3f(position(random_), position(random_), 0.0f);
+      const Eigen::Vector3f direction = object->direction;
+      tracks_.emplace_back(new ObjectTrack(object));
+      object->direction = direction;
+      object->velocity = Eigen::Vector3f(velocity(random_), velocity(random_),
+                                         0.0f);
+      Eigen::VectorXf track_predict(6);
+      track_predict << object->anchor_point(0) + object->velocity(0) * 0.1f,
+          object->anchor_point(1) + object->velocity(1) * 0.1f, 0.0f,
+          object->velocity(0), object->velocity(1), 0.0f;
+      tracks_predict_.push_back(track_predict);
+      track_ptrs_.push_back(tracks_.back().get());
+
+      if (i % 5 != 0) {
+        std::shared_ptr<TrackedObject> new_object = MakeObject();
+        new_object->anchor_point =
+            Eigen::Vector3f(track_predict(0) + noise(random_),
+                            track_predict(1) + noise(random_), 0.0f);
+        objects_.push_back(new_object);
+      }
+      if (i % 7 == 0) {
+        std::shared_ptr<TrackedObject> clutter = MakeObject();
+        clutter->anchor_point =
+            Eigen::Vector3f(position(random_), position(random_), 0.0f);
+        objects_.push_back(clutter);
+      }
+    }
+  }
+
+  std::mt19937 random_{7};
+  std::vector<std::unique_ptr<ObjectTrack>> tracks_;
+  std::vector<ObjectTrackPtr> track_ptrs_;
+  std::vector<Eigen::VectorXf> tracks_predict_;
+  std::vector<std::shared_ptr<TrackedObject>> objects_;
+
+ private:
+  int num_threads_ = 1;
+};
+
+TEST_F(HungarianMatcherTest, SameAsPairByPair) {
+  MakeScene(200);
+  std::vector<std::pair<int, int>> expected_assignments;
+  std::vector<int> expected_unassigned_tracks;
+  std::vector<int> expected_unassigned_objects;
+  PairByPairMatcher pair_by_pair;
+  pair_by_pair.Match(&objects_, track_ptrs_, tracks_predict_,
+                     &expected_assignments, &expected_unassigned_tracks,
+                     &expected_unassigned_objects);
+  std::vector<float> expected_scores;
+  for (const auto& assignment : expected_assignments) {
+    expected_scores.push_back(objects_[assignment.second]->association_score);
+  }
+  // Crowded enough to assign within components of several tracks.
+  EXPECT_GT(expected_assignments.size(), 100);
+  EXPECT_LT(expected_assignments.size(), tracks_.size());
+
+  for (const int num_threads : {1, 4}) {
+    FLAGS_hm_tracker_match_num_threads = num_threads;
+    HungarianMatcher matcher;
+    std::vector<std::pair<int, int>> assignments;
+    std::vector<int> unassigned_tracks;
+    std::vector<int> unassigned_objects;
+    for (const auto& object : objects_) {
+      object->association_score = 0.0f;
+    }
+    matcher.Match(&objects_, track_ptrs_, tracks_predict_, &assignments,
+                  &unassigned_tracks, &unassigned_objects);
+    EXPECT_EQ(expected_assignments, assignments);
+    EXPECT_EQ(expected_unassigned_tracks, unassigned_tracks);
+    EXPECT_EQ(expected_unassigned_objects, unassigned_objects);
+    for (size_t i = 0; i < assignments.size() && i < expected_scores.size();
+         ++i) {
+      EXPECT_EQ(expected_scores[i],
+                objects_[assignments[i].second]->association_score);
+    }
+  }
+}
+
+}  // namespace perception
+}  // namespace apollo
@@ -17,6 +17,8 @@
 #include "modules/perception/obstacle/lidar/tracker/hm_tracker/track_object_distance.h"
 
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <vector>
 
 #include "modules/common/log.h"
@@ -111,6 +113,216 @@ float TrackObjectDistance::ComputeDistance(
   return result_distance;
 }
 
+void TrackObjectDistance::ExtractTrackFeatures(
+    const std::vector<ObjectTrackPtr>& tracks,
+    const std::vector<Eigen::VectorXf>& tracks_predict,
+    TrackFeatures* features) {
+  // Extract features of tracks field by field
+  *features = TrackFeatures();
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    const std::shared_ptr<TrackedObject>& last_object =
+        tracks[i]->current_object_;
+    const Eigen::VectorXf& track_predict = tracks_predict[i];
+    features->predicted_x.push_back(track_predict(0));
+    features->predicted_y.push_back(track_predict(1));
+    features->predicted_velocity_x.push_back(track_predict(3));
+    features->predicted_velocity_y.push_back(track_predict(4));
+    features->anchor_x.push_back(last_object->anchor_point(0));
+    features->anchor_y.push_back(last_object->anchor_point(1));
+    const Eigen::Vector2f velocity = last_object->velocity.head(2);
+    const float speed = velocity.norm();
+    features->speed.push_back(speed);
+    features->motion_direction_x.push_back(velocity(0) / speed);
+    features->motion_direction_y.push_back(velocity(1) / speed);
+    features->direction_x.push_back(last_object->direction(0));
+    features->direction_y.push_back(last_object->direction(1));
+    features->length.push_back(last_object->size(0));
+    features->width.push_back(last_object->size(1));
+    features->point_num.push_back(last_object->object_ptr->cloud->size());
+    const std::vector<float>& histogram =
+        last_object->object_ptr->shape_features;
+    features->histogram_offsets.push_back(features->histograms.size());
+    features->histogram_sizes.push_back(histogram.size());
+    features->histograms.insert(features->histograms.end(), histogram.begin(),
+                                histogram.end());
+  }
+}
+
+bool TrackObjectDistance::ExtractObjectFeatures(
+    const std::vector<std::shared_ptr<TrackedObject>>& new_objects,
+    ObjectFeatures* features) {
+  // Extract features of objects field by field
+  *features = ObjectFeatures();
+  const size_t num_objects = new_objects.size();
+  for (const auto& object : new_objects) {
+    features->anchor_x.push_back(object->anchor_point(0));
+    features->anchor_y.push_back(object->anchor_point(1));
+    features->direction_x.push_back(object->direction(0));
+    features->direction_y.push_back(object->direction(1));
+    features->length.push_back(object->size(0));
+    features->width.push_back(object->size(1));
+    features->point_num.push_back(object->object_ptr->cloud->size());
+  }
+  if (num_objects == 0) {
+    return true;
+  }
+  features->histogram_size = new_objects[0]->object_ptr->shape_features.size();
+  features->histograms.resize(features->histogram_size * num_objects);
+  for (size_t j = 0; j < num_objects; ++j) {
+    const std::vector<float>& histogram =
+        new_objects[j]->object_ptr->shape_features;
+    if (static_cast<int>(histogram.size()) != features->histogram_size) {
+      return false;
+    }
+    for (int i = 0; i < features->histogram_size; ++i) {
+      features->histograms[i * num_objects + j] = histogram[i];
+    }
+  }
+  return true;
+}
+
+void TrackObjectDistance::ComputeDistances(const TrackFeatures& tracks,
+                                           const size_t track,
+                                           const ObjectFeatures& objects,
+                                           const float gate_distance,
+                                           float* distances) {
+  // Compute distances of given track to all the objects, term by term as
+  // ComputeDistance does, in loops over the objects
+  const size_t num_objects = objects.anchor_x.size();
+  std::vector<float> location_distances(num_objects);
+  std::vector<float> direction_distances(num_objects);
+  std::vector<float> bbox_size_distances(num_objects);
+  std::vector<float> point_num_distances(num_objects);
+
+  // A. location distance
+  const float predicted_x = tracks.predicted_x[track];
+  const float predicted_y = tracks.predicted_y[track];
+  if (tracks.speed[track] > 2) {
+    const float motion_dir_x = tracks.motion_direction_x[track];
+    const float motion_dir_y = tracks.motion_direction_y[track];
+    const float orthogonal_dir_x = motion_dir_y;
+    const float orthogonal_dir_y = -motion_dir_x;
+    for (size_t j = 0; j < num_objects; ++j) {
+      const float diff_x = objects.anchor_x[j] - predicted_x;
+      const float diff_y = objects.anchor_y[j] - predicted_y;
+      const float motion_dir_distance =
+          motion_dir_x * diff_x + motion_dir_y * diff_y;
+      const float motion_orthogonal_dir_distance =
+          orthogonal_dir_x * diff_x + orthogonal_dir_y * diff_y;
+      location_distances[j] =
+          std::sqrt(motion_dir_distance * motion_dir_distance * 0.25 +
+                    motion_orthogonal_dir_distance *
+                        motion_orthogonal_dir_distance * 4);
+    }
+  } else {
+    for (size_t j = 0; j < num_objects; ++j) {
+      const float diff_x = objects.anchor_x[j] - predicted_x;
+      const float diff_y = objects.anchor_y[j] - predicted_y;
+      location_distances[j] = std::sqrt(diff_x * diff_x + diff_y * diff_y);
+    }
+  }
+
+  // B. direction distance
+  const float anchor_x = tracks.anchor_x[track];
+  const float anchor_y = tracks.anchor_y[track];
+  const float motion_x = tracks.predicted_velocity_x[track];
+  const float motion_y = tracks.predicted_velocity_y[track];
+  // the same as Eigen isZero() with its default precision
+  const float zero_precision = Eigen::NumTraits<float>::dummy_precision();
+  const bool has_motion = std::fabs(motion_x) > zero_precision ||
+                          std::fabs(motion_y) > zero_precision;
+  const double motion_length =
+      std::sqrt(static_cast<double>(motion_x * motion_x + motion_y * motion_y));
+  for (size_t j = 0; j < num_objects; ++j) {
+    const float shift_x = objects.anchor_x[j] - anchor_x;
+    const float shift_y = objects.anchor_y[j] - anchor_y;
+    const bool has_shift = std::fabs(shift_x) > zero_precision ||
+                           std::fabs(shift_y) > zero_precision;
+    const double shift_length =
+        std::sqrt(static_cast<double>(shift_x * shift_x + shift_y * shift_y));
+    const double cos_theta =
+        has_motion && has_shift
+            ? (motion_x * shift_x + motion_y * shift_y) /
+                  (motion_length * shift_length)
+            : 0.994;  // average cos
+    direction_distances[j] = -cos_theta + 1.0;
+  }
+
+  // C. bbox size distance
+  const float old_dir_x = tracks.direction_x[track];
+  const float old_dir_y = tracks.direction_y[track];
+  const float old_length = tracks.length[track];
+  const float old_width = tracks.width[track];
+  for (size_t j = 0; j < num_objects; ++j) {
+    const float new_dir_x = objects.direction_x[j];
+    const float new_dir_y = objects.direction_y[j];
+    const float new_length = objects.length[j];
+    const float new_width = objects.width[j];
+    const bool bbox_dir_close =
+        std::fabs(old_dir_x * new_dir_x + old_dir_y * new_dir_y) >
+        std::fabs(old_dir_x * new_dir_y - old_dir_y * new_dir_x);
+    const float size_0 = bbox_dir_close ? new_length : new_width;
+    const float size_1 = bbox_dir_close ? new_width : new_length;
+    const float diff_1 =
+        std::fabs(old_length - size_0) / std::max(old_length, size_0);
+    const float diff_2 =
+        std::fabs(old_width - size_1) / std::max(old_width, size_1);
+    bbox_size_distances[j] = std::min(diff_1, diff_2);
+  }
+
+  // D. point num distance
+  const int old_point_number = tracks.point_num[track];
+  for (size_t j = 0; j < num_objects; ++j) {
+    const int new_point_number = objects.point_num[j];
+    point_num_distances[j] = std::abs(old_point_number - new_point_number) *
+                             1.0f /
+                             std::max(old_point_number, new_point_number);
+  }
+
+  // E. sum up, and gate the pairs already too far apart
+  std::vector<double> partial_distances(num_objects);
+  std::vector<size_t> gated_objects;
+  gated_objects.reserve(num_objects);
+  for (size_t j = 0; j < num_objects; ++j) {
+    partial_distances[j] =
+        s_location_distance_weight_ * location_distances[j] +
+        s_direction_distance_weight_ * direction_distances[j] +
+        s_bbox_size_distance_weight_ * bbox_size_distances[j] +
+        s_point_num_distance_weight_ * point_num_distances[j];
+    if (partial_distances[j] > gate_distance) {
+      distances[j] = partial_distances[j];
+    } else {
+      gated_objects.push_back(j);
+    }
+  }
+
+  // F. histogram distance of the gated pairs
+  const int histogram_size = tracks.histogram_sizes[track];
+  if (histogram_size != objects.histogram_size) {
+    AERROR << "sizes of compared features not matched. TrackObjectDistance";
+    for (const size_t j : gated_objects) {
+      distances[j] =
+          partial_distances[j] + s_histogram_distance_weight_ * FLT_MAX;
+    }
+    return;
+  }
+  const float* track_histogram =
+      tracks.histograms.data() + tracks.histogram_offsets[track];
+  std::vector<float> histogram_distances(gated_objects.size(), 0.0f);
+  for (int i = 0; i < histogram_size; ++i) {
+    const float* object_bins = objects.histograms.data() + i * num_objects;
+    for (size_t k = 0; k < gated_objects.size(); ++k) {
+      histogram_distances[k] +=
+          std::fabs(track_histogram[i] - object_bins[gated_objects[k]]);
+    }
+  }
+  for (size_t k = 0; k < gated_objects.size(); ++k) {
+    const size_t j = gated_objects[k];
+    distances[j] = partial_distances[j] +
+                   s_histogram_distance_weight_ * histogram_distances[k];
+  }
+}
+
 float TrackObjectDistance::ComputeLocationDistance(
     ObjectTrackPtr track, const Eigen::VectorXf& track_predict,
     const std::shared_ptr<TrackedObject>& new_object) {
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Eigen/Core"
 
@@ -31,6 +32,44 @@ namespace perception {
 
 class TrackObjectDistance {
  public:
+  // features of tracks, with their predicted states, stored field by field so
+  // that the distances of a track to many objects are computed in
+  // vectorizable loops
+  struct TrackFeatures {
+    std::vector<float> predicted_x;
+    std::vector<float> predicted_y;
+    std::vector<float> predicted_velocity_x;
+    std::vector<float> predicted_velocity_y;
+    std::vector<float> anchor_x;
+    std::vector<float> anchor_y;
+    std::vector<float> speed;
+    std::vector<float> motion_direction_x;
+    std::vector<float> motion_direction_y;
+    std::vector<float> direction_x;
+    std::vector<float> direction_y;
+    std::vector<float> length;
+    std::vector<float> width;
+    std::vector<int> point_num;
+    // histograms of the tracks, one after another
+    std::vector<float> histograms;
+    std::vector<int> histogram_offsets;
+    std::vector<int> histogram_sizes;
+  };
+
+  // features of detected objects, stored field by field
+  struct ObjectFeatures {
+    std::vector<float> anchor_x;
+    std::vector<float> anchor_y;
+    std::vector<float> direction_x;
+    std::vector<float> direction_y;
+    std::vector<float> length;
+    std::vector<float> width;
+    std::vector<int> point_num;
+    // bin i of object j is histograms[i * objects number + j]
+    std::vector<float> histograms;
+    int histogram_size = 0;
+  };
+
   // @brief set weight of location dist for all the track object distance
   // objects
   // @param[IN] location_distance_weight: weight of location dist
@@ -70,6 +109,38 @@ class TrackObjectDistance {
       ObjectTrackPtr track, const Eigen::VectorXf& track_predict,
       const std::shared_ptr<TrackedObject>& new_object);
 
+  // @brief extract features of tracks for computing distances in batch
+  // @param[IN] tracks: tracks for <track, object> distance computing
+  // @param[IN] tracks_predict: predicted states of given tracks
+  // @param[OUT] features: features of given tracks
+  // @return nothing
+  static void ExtractTrackFeatures(
+      const std::vector<ObjectTrackPtr>& tracks,
+      const std::vector<Eigen::VectorXf>& tracks_predict,
+      TrackFeatures* features);
+
+  // @brief extract features of objects for computing distances in batch
+  // @param[IN] new_objects: recently detected objects
+  // @param[OUT] features: features of given objects
+  // @return false if histograms of objects differ in size, otherwise true
+  static bool ExtractObjectFeatures(
+      const std::vector<std::shared_ptr<TrackedObject>>& new_objects,
+      ObjectFeatures* features);
+
+  // @brief compute distances of a track to all the objects, which are equal
+  // to the ones of ComputeDistance. The histogram distance is skipped for the
+  // objects whose other distances already sum up to more than gate distance,
+  // and their distances are only known to be more than it.
+  // @param[IN] tracks: features of tracks
+  // @param[IN] track: index of the track in tracks
+  // @param[IN] objects: features of objects
+  // @param[IN] gate_distance: distance beyond which pairs are not needed
+  // @param[OUT] distances: distances of the track to each object
+  // @return nothing
+  static void ComputeDistances(const TrackFeatures& tracks, const size_t track,
+                               const ObjectFeatures& objects,
+                               const float gate_distance, float* distances);
+
   std::string Name() const { return "TrackObjectDistance"; }
 
  private:
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/obstacle/lidar/tracker/hm_tracker/track_object_distance.h"
+
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+
+class TrackObjectDistanceTest : public testing::Test {
+ protected:
+  std::shared_ptr<TrackedObject> MakeObject(const int histogram_size) {
+    std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::uniform_real_distribution<float> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<float> bin(0.0f, 0.1f);
+    std::uniform_int_distribution<int> num_points(1, 200);
+
+    std::shared_ptr<Object> object(new Object());
+    object->cloud.reset(new pcl_util::PointCloud());
+    object->cloud->resize(num_points(random_));
+    for (int i = 0; i < histogram_size; ++i) {
+      object->shape_features.push_back(bin(random_));
+    }
+    std::shared_ptr<TrackedObject> tracked_object(new TrackedObject());
+    tracked_object->object_ptr = object;
+    tracked_object->anchor_point =
+        Eigen::Vector3f(position(random_), position(random_), 0.0f);
+    const float theta = angle(random_);
+    tracked_object->direction =
+        Eigen::Vector3f(std::cos(theta), std::sin(theta), 0.0f);
+    tracked_object->size = Eigen::Vector3f(size(random_), size(random_), 1.5f);
+    tracked_object->velocity = Eigen::Vector3f::Zero();
+    return tracked_object;
+  }
+
+  void MakeTracksAndObjects(const int num_tracks, const int num_objects,
+                            const int histogram_size) {
+    std::uniform_real_distribution<float> velocity(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    for (int i = 0; i < num_tracks; ++i) {
+      std::shared_ptr<TrackedObject> object = MakeObject(histogram_size);
+      const Eigen::Vector3f anchor_point = object->anchor_point;
+      const Eigen::Vector3f direction = object->direction;
+      tracks_.emplace_back(new ObjectTrack(object));
+      object->direction = direction;
+      // Static, slow and fast tracks.
+      if (i % 3 != 0) {
+        object->velocity = Eigen::Vector3f(velocity(random_) / (i % 3),
+                                           velocity(random_) / (i % 3), 0.0f);
+      }
+      Eigen::VectorXf track_predict(6);
+      track_predict << anchor_point(0) + object->velocity(0) * 0.1f,
+          anchor_point(1) + object->velocity(1) * 0.1f, 0.0f,
+          object->velocity(0), object->velocity(1), 0.0f;
+      tracks_predict_.push_back(track_predict);
+      track_ptrs_.push_back(tracks_.back().get());
+
+      // An object near every other track.
+      if (i % 2 == 0 && static_cast<int>(objects_.size()) < num_objects) {
+        std::shared_ptr<TrackedObject> near_object =
+            MakeObject(histogram_size);
+        near_object->anchor_point =
+            anchor_point + Eigen::Vector3f(noise(random_), noise(random_), 0);
+        objects_.push_back(near_object);
+      }
+    }
+    // One object right at the last anchor point of a track.
+    if (!objects_.empty()) {
+      objects_.back()->anchor_point = tracks_[0]->current_object_->anchor_point;
+    }
+    while (static_cast<int>(objects_.size()) < num_objects) {
+      objects_.push_back(MakeObject(histogram_size));
+    }
+  }
+
+  std::mt19937 random_{42};
+  std::vector<std::unique_ptr<ObjectTrack>> tracks_;
+  std::vector<ObjectTrackPtr> track_ptrs_;
+  std::vector<Eigen::VectorXf> tracks_predict_;
+  std::vector<std::shared_ptr<TrackedObject>> objects_;
+};
+
+TEST_F(TrackObjectDistanceTest, ComputeDistances) {
+  MakeTracksAndObjects(60, 50, 30);
+  TrackObjectDistance::TrackFeatures track_features;
+  TrackObjectDistance::ObjectFeatures object_features;
+  TrackObjectDistance::ExtractTrackFeatures(track_ptrs_, tracks_predict_,
+                                            &track_features);
+  ASSERT_TRUE(
+      TrackObjectDistance::ExtractObjectFeatures(objects_, &object_features));
+
+  std::vector<float> distances(objects_.size());
+  for (size_t i = 0; i < track_ptrs_.size(); ++i) {
+    TrackObjectDistance::ComputeDistances(track_features, i, object_features,
+                                          FLT_MAX, distances.data());
+    for (size_t j = 0; j < objects_.size(); ++j) {
+      EXPECT_EQ(TrackObjectDistance::ComputeDistance(
+                    track_ptrs_[i], tracks_predict_[i], objects_[j]),
+                distances[j]);
+    }
+  }
+}
+
+TEST_F(TrackObjectDistanceTest, ComputeDistancesWithinGate) {
+  MakeTracksAndObjects(60, 50, 30);
+  TrackObjectDistance::TrackFeatures track_features;
+  TrackObjectDistance::ObjectFeatures object_features;
+  TrackObjectDistance::ExtractTrackFeatures(track_ptrs_, tracks_predict_,
+                                            &track_features);
+  ASSERT_TRUE(
+      TrackObjectDistance::ExtractObjectFeatures(objects_, &object_features));
+
+  const float gate_distance = 8.0f;
+  int num_within_gate = 0;
+  std::vector<float> distances(objects_.size());
+  for (size_t i = 0; i < track_ptrs_.size(); ++i) {
+    TrackObjectDistance::ComputeDistances(track_features, i, object_features,
+                                          gate_distance, distances.data());
+    for (size_t j = 0; j < objects_.size(); ++j) {
+      const float distance = TrackObjectDistance::ComputeDistance(
+          track_ptrs_[i], tracks_predict_[i], objects_[j]);
+      if (distances[j] > gate_distance) {
+        EXPECT_GT(distance, gate_distance);
+      } else {
+        EXPECT_EQ(distance, distances[j]);
+        ++num_within_gate;
+      }
+    }
+  }
+  EXPECT_GT(num_within_gate, 0);
+}
+
+TEST_F(TrackObjectDistanceTest, HistogramSizesNotMatched) {
+  MakeTracksAndObjects(4, 3, 30);
+  objects_.push_back(MakeObject(20));
+  TrackObjectDistance::ObjectFeatures object_features;
+  EXPECT_FALSE(
+      TrackObjectDistance::ExtractObjectFeatures(objects_, &object_features));
+
+  objects_.pop_back();
+  tracks_[1]->current_object_->object_ptr->shape_features.resize(20);
+  TrackObjectDistance::TrackFeatures track_features;
+  TrackObjectDistance::ExtractTrackFeatures(track_ptrs_, tracks_predict_,
+                                            &track_features);
+  ASSERT_TRUE(
+      TrackObjectDistance::ExtractObjectFeatures(objects_, &object_features));
+  std::vector<float> distances(objects_.size());
+  TrackObjectDistance::ComputeDistances(track_features, 1, object_features,
+                                        FLT_MAX, distances.data());
+  for (size_t j = 0; j < objects_.size(); ++j) {
+    EXPECT_EQ(TrackObjectDistance::ComputeDistance(
+                  track_ptrs_[1], tracks_predict_[1], objects_[j]),
+              distances[j]);
+  }
+}
+
+}  // namespace perception
+}  // namespace apollo
@@ -322,12 +322,7 @@ bool AsyncFusionSubnode::GetSharedData(const Event &event,
                                        std::shared_ptr<SensorObjects> *objs) {
   double timestamp = event.timestamp;
   const std::string &device_id = event.reserve;
-  std::string data_key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id, &data_key)) {
-    AERROR << "Failed to produce shared data key. EventID:" << event.event_id
-           << " timestamp:" << timestamp << " device_id:" << device_id;
-    return false;
-  }
+  const CommonSharedDataKey data_key(timestamp, device_id);
   bool get_data_succ = false;
 
   if (event.event_id == radar_event_id_ && radar_object_data_ != nullptr) {
@@ -340,7 +335,8 @@ bool AsyncFusionSubnode::GetSharedData(const Event &event,
     if (event_manager_->Subscribe(lane_event_id_, &lane_event, false)) {
       get_data_succ =
           lane_shared_data_->Get(data_key, &((*objs)->lane_objects));
-      AINFO << "getting lane data successfully for data key " << data_key;
+      AINFO << "getting lane data successfully for data key "
+            << data_key.ToString();
     }
   } else {
     AERROR << "Event id is not supported. event:" << event.to_string();
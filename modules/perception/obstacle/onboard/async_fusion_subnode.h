@@ -48,6 +48,9 @@ class AsyncFusionSubnode : public Subnode {
   AsyncFusionSubnode() = default;
   virtual ~AsyncFusionSubnode() {}
   apollo::common::Status ProcEvents() override;
+
+  // Waits for the lane event in ProcEvents(), so keeps its own thread.
+  std::vector<EventID> TriggerEvents() const override { return {}; }
   bool GeneratePbMsg(PerceptionObstacles *obstacles);
 
  protected:
@@ -171,12 +171,7 @@ bool CIPVSubnode::GetSharedData(const Event &event,
                                 std::shared_ptr<SensorObjects> *objs) {
   double timestamp = event.timestamp;
   device_id_ = event.reserve;
-  string data_key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id_, &data_key)) {
-    AERROR << "Failed to produce shared data key. EventID:" << event.event_id
-           << " timestamp:" << timestamp << " device_id_:" << device_id_;
-    return false;
-  }
+  const CommonSharedDataKey data_key(timestamp, device_id_);
   camera_object_data_->Get(data_key, objs);
   std::shared_ptr<LaneObjects> lane_objects;
 
@@ -193,9 +188,7 @@ bool CIPVSubnode::GetSharedData(const Event &event,
 void CIPVSubnode::PublishDataAndEvent(
     const float timestamp, const SharedDataPtr<SensorObjects> &sensor_objects,
     CIPVObjectData *cipv_object_data) {
-  std::string key = "";
-  SubnodeHelper::ProduceSharedDataKey(timestamp, device_id_, &key);
-
+  const CommonSharedDataKey key(timestamp, device_id_);
   cipv_object_data->Add(key, sensor_objects);
 
   for (size_t idx = 0; idx < pub_meta_events_.size(); ++idx) {
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "modules/perception/proto/perception_obstacle.pb.h"
 
@@ -39,6 +40,9 @@ class CIPVSubnode : public Subnode {
   virtual ~CIPVSubnode() {}
   apollo::common::Status ProcEvents() override;
 
+  // Waits for the lane event in ProcEvents(), so keeps its own thread.
+  std::vector<EventID> TriggerEvents() const override { return {}; }
+
  protected:
   bool InitInternal() override;
 
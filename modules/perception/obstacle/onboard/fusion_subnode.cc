@@ -185,7 +185,9 @@ Status FusionSubnode::ProcEvents() {
       return Status(ErrorCode::PERCEPTION_ERROR, "Subscribe event fail.");
     }
     if (events.empty()) {
-      usleep(500);
+      if (!executor_driven_) {
+        usleep(500);
+      }
       continue;
     }
     Process(event_meta, events);
@@ -208,6 +210,17 @@ Status FusionSubnode::ProcEvents() {
   return Status::OK();
 }
 
+std::vector<EventID> FusionSubnode::TriggerEvents() const {
+  std::vector<EventID> event_ids;
+  if (lane_event_id_ != -1) {
+    return event_ids;
+  }
+  for (const auto &event_meta : sub_meta_events_) {
+    event_ids.push_back(event_meta.event_id);
+  }
+  return event_ids;
+}
+
 Status FusionSubnode::Process(const EventMeta &event_meta,
                               const std::vector<Event> &events) {
   CipvOptions cipv_options;
@@ -399,12 +412,7 @@ bool FusionSubnode::GetSharedData(const Event &event,
                                   std::shared_ptr<SensorObjects> *objs) {
   double timestamp = event.timestamp;
   const std::string &device_id = event.reserve;
-  std::string data_key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id, &data_key)) {
-    AERROR << "Failed to produce shared data key. EventID:" << event.event_id
-           << " timestamp:" << timestamp << " device_id:" << device_id;
-    return false;
-  }
+  const CommonSharedDataKey data_key(timestamp, device_id);
   bool get_data_succ = false;
   if (event.event_id == lidar_event_id_ && lidar_object_data_ != nullptr) {
     get_data_succ = lidar_object_data_->Get(data_key, objs);
@@ -419,7 +427,8 @@ bool FusionSubnode::GetSharedData(const Event &event,
       Event lane_event;
       if (event_manager_->Subscribe(lane_event_id_, &lane_event, false)) {
         get_data_succ = lane_shared_data_->Get(data_key, &lane_objects_);
-        ADEBUG << "getting lane data successfully for data key " << data_key;
+        ADEBUG << "getting lane data successfully for data key "
+               << data_key.ToString();
       }
     }
   } else {
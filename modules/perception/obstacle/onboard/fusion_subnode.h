@@ -49,6 +49,9 @@ class FusionSubnode : public Subnode {
   FusionSubnode() = default;
   virtual ~FusionSubnode() {}
   apollo::common::Status ProcEvents() override;
+  // The camera event waits for the lane event, so the subnode keeps its own
+  // thread when lanes are fused.
+  std::vector<EventID> TriggerEvents() const override;
   bool GeneratePbMsg(PerceptionObstacles *obstacles);
 
  protected:
@@ -143,13 +143,7 @@ bool LanePostProcessingSubnode::GetSharedData(const Event &event,
   double timestamp = event.timestamp;
   string device_id = event.reserve;
   device_id_ = device_id;
-  string data_key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id, &data_key)) {
-    AERROR << "failed to produce shared data key. EventID:" << event.event_id
-           << " timestamp:" << timestamp << " device_id:" << device_id;
-    return false;
-  }
-
+  const CommonSharedDataKey data_key(timestamp, device_id);
   if (!camera_object_data_->Get(data_key, objs)) {
     AERROR << "failed to get shared data. event:" << event.to_string();
     return false;
@@ -159,15 +153,9 @@ bool LanePostProcessingSubnode::GetSharedData(const Event &event,
 
 void LanePostProcessingSubnode::PublishDataAndEvent(
     const double timestamp, const SharedDataPtr<LaneObjects> &lane_objects) {
-  string key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id_, &key)) {
-    AERROR << "failed to produce shared key. time: "
-           << GLOG_TIMESTAMP(timestamp) << ", device_id: " << device_id_;
-    return;
-  }
-
+  const CommonSharedDataKey key(timestamp, device_id_);
   if (!lane_shared_data_->Add(key, lane_objects)) {
-    AWARN << "failed to add LaneSharedData. key: " << key
+    AWARN << "failed to add LaneSharedData. key: " << key.ToString()
           << " num_detected_objects: " << lane_objects->size();
     return;
   }
@@ -189,7 +177,10 @@ Status LanePostProcessingSubnode::ProcEvents() {
   CHECK_EQ(sub_meta_events_.size(), 1u) << "only subcribe one event.";
   const EventMeta &event_meta = sub_meta_events_[0];
   Event event;
-  event_manager_->Subscribe(event_meta.event_id, &event);
+  if (!event_manager_->Subscribe(event_meta.event_id, &event,
+                                 executor_driven_)) {
+    return Status(ErrorCode::PERCEPTION_ERROR, "Failed to subscribe event.");
+  }
   ++seq_num_;
   shared_ptr<SensorObjects> objs;
   if (!GetSharedData(event, &objs)) {
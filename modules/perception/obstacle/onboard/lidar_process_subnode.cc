@@ -16,6 +16,11 @@
 
 #include "modules/perception/obstacle/onboard/lidar_process_subnode.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <thread>
 #include <unordered_map>
 
 #include "eigen_conversions/eigen_msg.h"
@@ -38,6 +43,14 @@
 
 namespace apollo {
 namespace perception {
+namespace {
+
+// How long the shared memory reader waits for a frame, and how long without
+// any before it opens the ring again, as a restarted driver makes a new one.
+constexpr int kShmWaitTimeoutMs = 100;
+constexpr int kShmReopenTimeoutMs = 1000;
+
+}  // namespace
 
 using apollo::common::adapter::AdapterManager;
 using Eigen::Affine3d;
@@ -49,6 +62,8 @@ using pcl_util::PointD;
 using pcl_util::PointIndices;
 using pcl_util::PointIndicesPtr;
 
+LidarProcessSubnode::~LidarProcessSubnode() { StopThreads(); }
+
 bool LidarProcessSubnode::InitInternal() {
   if (inited_) {
     return true;
@@ -77,97 +92,171 @@ bool LidarProcessSubnode::InitInternal() {
     return false;
   }
   device_id_ = reserve_field_map["device_id"];
-  AddMessageCallback();
+  if (reserve_field_map.find("point_cloud_shm") != reserve_field_map.end()) {
+    point_cloud_shm_name_ = reserve_field_map["point_cloud_shm"];
+  }
+
+  if (FLAGS_enable_lidar_pipeline) {
+    frame_queue_.reset(new FixedSizeConQueue<std::shared_ptr<LidarFrame>>(
+        std::max(1, FLAGS_lidar_pipeline_queue_size)));
+    pipeline_worker_.reset(new PipelineWorker(this));
+    pipeline_worker_->Start();
+    AINFO << "lidar process runs in a pipeline of two stages.";
+  }
+  if (point_cloud_shm_name_.empty()) {
+    AddMessageCallback();
+  } else {
+    shm_reader_.reset(new ShmReader(this));
+    shm_reader_->Start();
+    AINFO << "lidar process reads point clouds from shared memory: "
+          << point_cloud_shm_name_;
+  }
 
   inited_ = true;
 
   return true;
 }
 
+void LidarProcessSubnode::StopThreads() {
+  threads_stopped_ = true;
+  if (shm_reader_ != nullptr) {
+    shm_reader_->Join();
+    shm_reader_.reset();
+  }
+  if (pipeline_worker_ != nullptr) {
+    // A null frame stops the worker once the frames before it are done.
+    {
+      std::lock_guard<std::mutex> lock(frame_queue_mutex_);
+      frame_queue_->push(nullptr);
+    }
+    pipeline_worker_->Join();
+    pipeline_worker_.reset();
+  }
+}
+
 void LidarProcessSubnode::OnPointCloud(
     const sensor_msgs::PointCloud2& message) {
   AINFO << "process OnPointCloud.";
-  PERF_FUNCTION("LidarProcessSubnode");
   if (!inited_) {
     AERROR << "the LidarProcessSubnode has not been Init";
     return;
   }
-  const double kTimeStamp = message.header.stamp.toSec();
-  timestamp_ = kTimeStamp;
-  ++seq_num_;
+  if (threads_stopped_) {
+    return;
+  }
 
-  std::shared_ptr<SensorObjects> out_sensor_objects(new SensorObjects);
-  out_sensor_objects->timestamp = timestamp_;
-  out_sensor_objects->sensor_type = GetSensorType();
-  out_sensor_objects->sensor_id = device_id_;
-  out_sensor_objects->seq_num = seq_num_;
+  std::shared_ptr<LidarFrame> frame(new LidarFrame);
+  frame->timestamp = message.header.stamp.toSec();
+  frame->receive_time = TimeUtil::GetCurrentTime();
+  PERF_BLOCK_START();
+  frame->point_cloud.reset(new PointCloud);
+  TransPointCloudToPCL(message, &frame->point_cloud);
+  frame->input_time = TimeUtil::GetCurrentTime() - frame->receive_time;
+  ADEBUG << "transform pointcloud success. points num is: "
+         << frame->point_cloud->points.size();
+  PERF_BLOCK_END("lidar_transform_poindcloud");
+  OnFrame(frame);
+}
+
+void LidarProcessSubnode::OnFrame(const std::shared_ptr<LidarFrame>& frame) {
+  PERF_FUNCTION("LidarProcessSubnode");
+  if (!PreprocessFrame(frame.get())) {
+    return;
+  }
+  if (frame_queue_ == nullptr) {
+    ProcessFrame(*frame);
+    return;
+  }
+
+  // Keep the latest frames when the back stage falls behind.
+  std::lock_guard<std::mutex> lock(frame_queue_mutex_);
+  if (threads_stopped_) {
+    return;
+  }
+  std::shared_ptr<LidarFrame> dropped_frame;
+  if (frame_queue_->push_drop_oldest(frame, &dropped_frame)) {
+    ++dropped_frames_;
+    AWARN << "lidar pipeline is full, drop frame: "
+          << GLOG_TIMESTAMP(dropped_frame->timestamp)
+          << " dropped_frames: " << dropped_frames_.load();
+  }
+}
+
+bool LidarProcessSubnode::PreprocessFrame(LidarFrame* frame) {
+  frame->seq_num = ++seq_num_;
 
   PERF_BLOCK_START();
   /// get velodyne2world transfrom
-  std::shared_ptr<Matrix4d> velodyne_trans = std::make_shared<Matrix4d>();
-  if (!GetVelodyneTrans(kTimeStamp, velodyne_trans.get())) {
+  frame->velodyne_trans = std::make_shared<Matrix4d>();
+  if (!GetVelodyneTrans(frame->timestamp, frame->velodyne_trans.get())) {
     AERROR << "failed to get trans at timestamp: "
-           << GLOG_TIMESTAMP(kTimeStamp);
-    return;
+           << GLOG_TIMESTAMP(frame->timestamp);
+    return false;
   }
-  out_sensor_objects->sensor2world_pose = *velodyne_trans;
-  AINFO << "get lidar trans pose succ. pose: \n" << *velodyne_trans;
+  AINFO << "get lidar trans pose succ. pose: \n" << *frame->velodyne_trans;
   PERF_BLOCK_END("lidar_get_velodyne2world_transfrom");
 
-  PointCloudPtr point_cloud(new PointCloud);
-  TransPointCloudToPCL(message, &point_cloud);
-  ADEBUG << "transform pointcloud success. points num is: "
-         << point_cloud->points.size();
-  PERF_BLOCK_END("lidar_transform_poindcloud");
-
-  // error_code_ = common::OK;
-
   /// call hdmap to get ROI
   if (FLAGS_use_navigation_mode) {
     AdapterManager::Observe();
   }
-  HdmapStructPtr hdmap = nullptr;
   if (hdmap_input_) {
     PointD velodyne_pose = {0.0, 0.0, 0.0, 0};  // (0,0,0)
-    Affine3d temp_trans(*velodyne_trans);
+    Affine3d temp_trans(*frame->velodyne_trans);
     PointD velodyne_pose_world = pcl::transformPoint(velodyne_pose, temp_trans);
-    hdmap.reset(new HdmapStruct);
-    hdmap_input_->GetROI(velodyne_pose_world, FLAGS_map_radius, &hdmap);
+    frame->hdmap.reset(new HdmapStruct);
+    hdmap_input_->GetROI(velodyne_pose_world, FLAGS_map_radius, &frame->hdmap);
     PERF_BLOCK_END("lidar_get_roi_from_hdmap");
   }
 
   /// call roi_filter
-  PointCloudPtr roi_cloud(new PointCloud);
+  frame->roi_cloud.reset(new PointCloud);
   if (roi_filter_ != nullptr) {
     PointIndicesPtr roi_indices(new PointIndices);
     ROIFilterOptions roi_filter_options;
-    roi_filter_options.velodyne_trans = velodyne_trans;
-    roi_filter_options.hdmap = hdmap;
-    if (roi_filter_->Filter(point_cloud, roi_filter_options,
+    roi_filter_options.velodyne_trans = frame->velodyne_trans;
+    roi_filter_options.hdmap = frame->hdmap;
+    if (roi_filter_->Filter(frame->point_cloud, roi_filter_options,
                             roi_indices.get())) {
-      pcl::copyPointCloud(*point_cloud, *roi_indices, *roi_cloud);
+      pcl::copyPointCloud(*frame->point_cloud, *roi_indices,
+                          *frame->roi_cloud);
       roi_indices_ = roi_indices;
     } else {
       AERROR << "failed to call roi filter.";
-      return;
+      return false;
     }
   }
   ADEBUG << "call roi_filter succ. The num of roi_cloud is: "
-         << roi_cloud->points.size();
+         << frame->roi_cloud->points.size();
   PERF_BLOCK_END("lidar_roi_filter");
+  return true;
+}
+
+void LidarProcessSubnode::ProcessFrame(const LidarFrame& frame) {
+  timestamp_ = frame.timestamp;
+  PointCloudPtr point_cloud = frame.point_cloud;
+  const std::shared_ptr<Matrix4d>& velodyne_trans = frame.velodyne_trans;
+
+  std::shared_ptr<SensorObjects> out_sensor_objects(new SensorObjects);
+  out_sensor_objects->timestamp = timestamp_;
+  out_sensor_objects->sensor_type = GetSensorType();
+  out_sensor_objects->sensor_id = device_id_;
+  out_sensor_objects->seq_num = frame.seq_num;
+  out_sensor_objects->sensor2world_pose = *velodyne_trans;
 
+  PERF_BLOCK_START();
   /// call segmentor
   std::vector<std::shared_ptr<Object>> objects;
   if (segmentor_ != nullptr) {
     SegmentationOptions segmentation_options;
     segmentation_options.origin_cloud = point_cloud;
     PointIndices non_ground_indices;
-    non_ground_indices.indices.resize(roi_cloud->points.size());
+    non_ground_indices.indices.resize(frame.roi_cloud->points.size());
     // non_ground_indices.indices.resize(point_cloud->points.size());
 
     std::iota(non_ground_indices.indices.begin(),
               non_ground_indices.indices.end(), 0);
-    if (!segmentor_->Segment(roi_cloud, non_ground_indices,
+    if (!segmentor_->Segment(frame.roi_cloud, non_ground_indices,
                              segmentation_options, &objects)) {
       AERROR << "failed to call segmention.";
       return;
@@ -207,7 +296,7 @@ void LidarProcessSubnode::OnPointCloud(
   if (tracker_ != nullptr) {
     TrackerOptions tracker_options;
     tracker_options.velodyne_trans = velodyne_trans;
-    tracker_options.hdmap = hdmap;
+    tracker_options.hdmap = frame.hdmap;
     tracker_options.hdmap_input = hdmap_input_;
     if (!tracker_->Track(objects, timestamp_, tracker_options,
                          &(out_sensor_objects->objects))) {
@@ -233,7 +322,136 @@ void LidarProcessSubnode::OnPointCloud(
 
   // if visualization mode, add the point cloud outside
   PublishDataAndEvent(timestamp_, out_sensor_objects, &point_cloud);
-  return;
+  ReportLatency(frame);
+}
+
+void LidarProcessSubnode::RunPipeline() {
+  while (true) {
+    std::shared_ptr<LidarFrame> frame;
+    frame_queue_->pop(&frame);
+    if (frame == nullptr) {
+      return;
+    }
+    ProcessFrame(*frame);
+  }
+}
+
+void LidarProcessSubnode::RunShmReader() {
+  uint64_t last_shm_frame = 0;
+  int idle_time_ms = 0;
+  while (!threads_stopped_) {
+    if (!point_cloud_shm_.IsOpen()) {
+      std::string error;
+      if (!point_cloud_shm_.Open(point_cloud_shm_name_, &error)) {
+        AWARN_EVERY(100) << "failed to open point cloud ring: " << error;
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kShmWaitTimeoutMs));
+        continue;
+      }
+      AINFO << "opened point cloud ring " << point_cloud_shm_name_ << " of "
+            << point_cloud_shm_.num_slots() << " slots of "
+            << point_cloud_shm_.max_points() << " points.";
+      last_shm_frame = 0;
+      idle_time_ms = 0;
+    }
+
+    const uint64_t shm_frame =
+        point_cloud_shm_.WaitForFrame(last_shm_frame, kShmWaitTimeoutMs);
+    if (shm_frame == last_shm_frame) {
+      idle_time_ms += kShmWaitTimeoutMs;
+      if (idle_time_ms >= kShmReopenTimeoutMs) {
+        point_cloud_shm_.Close();
+      }
+      continue;
+    }
+    idle_time_ms = 0;
+    // Only the latest frame is read, as the pipeline keeps the latest too.
+    if (last_shm_frame != 0 && shm_frame > last_shm_frame + 1) {
+      dropped_frames_ += shm_frame - last_shm_frame - 1;
+      AWARN << "lidar process fell behind the point cloud ring, skip "
+            << shm_frame - last_shm_frame - 1
+            << " frames. dropped_frames: " << dropped_frames_.load();
+    }
+    last_shm_frame = shm_frame;
+
+    std::shared_ptr<LidarFrame> frame(new LidarFrame);
+    if (!ReadShmPointCloud(shm_frame, frame.get())) {
+      ++dropped_frames_;
+      AWARN << "point cloud was overwritten while read, drop frame: "
+            << shm_frame << " dropped_frames: " << dropped_frames_.load();
+      continue;
+    }
+    OnFrame(frame);
+  }
+}
+
+bool LidarProcessSubnode::ReadShmPointCloud(const uint64_t shm_frame,
+                                            LidarFrame* frame) {
+  frame->receive_time = TimeUtil::GetCurrentTime();
+  PERF_BLOCK_START();
+  PointCloudPtr cloud(new PointCloud);
+  drivers::PointCloudShmRing::FrameInfo info;
+  // From the arrays in shared memory right into the cloud, without the NaN
+  // points as in TransPointCloudToPCL().
+  const bool read = point_cloud_shm_.Read(
+      shm_frame, &info,
+      [&cloud](const drivers::PointCloudShmRing::FrameView& view) {
+        cloud->points.resize(view.num_points);
+        size_t points_num = 0;
+        for (uint32_t i = 0; i < view.num_points; ++i) {
+          if (!std::isnan(view.x[i]) && !std::isnan(view.y[i]) &&
+              !std::isnan(view.z[i])) {
+            Point& point = cloud->points[points_num];
+            point.x = view.x[i];
+            point.y = view.y[i];
+            point.z = view.z[i];
+            point.intensity = view.intensity[i];
+            ++points_num;
+          }
+        }
+        cloud->points.resize(points_num);
+      });
+  if (!read) {
+    return false;
+  }
+  // As pcl_conversions stamps the cloud, in microseconds.
+  cloud->header.stamp = static_cast<uint64_t>(info.timestamp * 1e6);
+  cloud->header.frame_id = info.frame_id;
+  cloud->width = info.width;
+  cloud->height = info.height;
+  cloud->is_dense = info.is_dense;
+  frame->timestamp = info.timestamp;
+  frame->point_cloud = cloud;
+  frame->input_time = TimeUtil::GetCurrentTime() - frame->receive_time;
+  ADEBUG << "read pointcloud from shared memory. points num is: "
+         << cloud->points.size();
+  PERF_BLOCK_END("lidar_read_pointcloud_shm");
+  return true;
+}
+
+void LidarProcessSubnode::ReportLatency(const LidarFrame& frame) {
+  const double now = TimeUtil::GetCurrentTime();
+  const double latency = now - frame.receive_time;
+  latency_sum_ += latency;
+  input_time_sum_ += frame.input_time;
+  max_latency_ = std::max(max_latency_, latency);
+  if (++published_frames_ == 1) {
+    first_publish_time_ = now;
+  }
+  if (published_frames_ % kLatencyReportFrames != 0) {
+    return;
+  }
+  AINFO << "lidar process published_frames: " << published_frames_
+        << " dropped_frames: " << dropped_frames_.load() << " latency avg: "
+        << latency_sum_ / kLatencyReportFrames * 1e3
+        << " ms max: " << max_latency_ * 1e3 << " ms throughput: "
+        << (published_frames_ - 1) / (now - first_publish_time_)
+        << " Hz point cloud input avg: "
+        << input_time_sum_ / kLatencyReportFrames * 1e3 << " ms from "
+        << (point_cloud_shm_name_.empty() ? "ROS" : point_cloud_shm_name_);
+  latency_sum_ = 0.0;
+  max_latency_ = 0.0;
+  input_time_sum_ = 0.0;
 }
 
 void LidarProcessSubnode::RegistAllAlgorithm() {
@@ -408,13 +626,7 @@ void LidarProcessSubnode::PublishDataAndEvent(
     double timestamp, const SharedDataPtr<SensorObjects>& data,
     PointCloudPtr* cloud) {
   // set shared data
-  std::string key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id_, &key)) {
-    AERROR << "Failed to produce shared key. time: "
-           << GLOG_TIMESTAMP(timestamp) << ", device_id: " << device_id_;
-    return;
-  }
-
+  const CommonSharedDataKey key(timestamp, device_id_);
   AINFO << "lidar object size is " << data->objects.size();
 
   processing_data_->Add(key, data);
@@ -17,7 +17,9 @@
 #ifndef MODULES_PERCEPTION_OBSTACLE_ONBORAD_LIDAR_PROCESS_SUBNODE_H_
 #define MODULES_PERCEPTION_OBSTACLE_ONBORAD_LIDAR_PROCESS_SUBNODE_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -28,8 +30,11 @@
 #include "modules/perception/proto/perception_obstacle.pb.h"
 
 #include "modules/common/adapters/adapter_manager.h"
+#include "modules/drivers/point_cloud_shm/point_cloud_shm_ring.h"
 #include "modules/perception/common/pcl_types.h"
 #include "modules/perception/common/sequence_type_fuser/base_type_fuser.h"
+#include "modules/perception/lib/base/concurrent_queue.h"
+#include "modules/perception/lib/base/thread.h"
 #include "modules/perception/obstacle/base/object.h"
 #include "modules/perception/obstacle/lidar/interface/base_object_builder.h"
 #include "modules/perception/obstacle/lidar/interface/base_object_filter.h"
@@ -49,7 +54,7 @@ namespace perception {
 class LidarProcessSubnode : public Subnode {
  public:
   LidarProcessSubnode() = default;
-  ~LidarProcessSubnode() = default;
+  ~LidarProcessSubnode();
 
   apollo::common::Status ProcEvents() override {
     return apollo::common::Status::OK();
@@ -62,8 +67,64 @@ class LidarProcessSubnode : public Subnode {
   virtual void AddMessageCallback() = 0;
 
  private:
+  // A point cloud between the two stages of lidar process.
+  struct LidarFrame {
+    double timestamp = 0.0;
+    SeqId seq_num = 0;
+    double receive_time = 0.0;
+    // Taken to get the point cloud from the driver into PCL.
+    double input_time = 0.0;
+    std::shared_ptr<Eigen::Matrix4d> velodyne_trans;
+    pcl_util::PointCloudPtr point_cloud;
+    pcl_util::PointCloudPtr roi_cloud;
+    HdmapStructPtr hdmap;
+  };
+
+  // Runs the second stage of the frames, while the message callback runs
+  // the first stage of the next frame.
+  class PipelineWorker : public Thread {
+   public:
+    explicit PipelineWorker(LidarProcessSubnode* subnode)
+        : Thread(true, "LidarPipelineWorker"), subnode_(subnode) {}
+
+   protected:
+    void Run() override { subnode_->RunPipeline(); }
+
+   private:
+    LidarProcessSubnode* subnode_;
+  };
+
+  // Reads the point clouds the driver writes to shared memory, in place of
+  // the message callback.
+  class ShmReader : public Thread {
+   public:
+    explicit ShmReader(LidarProcessSubnode* subnode)
+        : Thread(true, "LidarShmReader"), subnode_(subnode) {}
+
+   protected:
+    void Run() override { subnode_->RunShmReader(); }
+
+   private:
+    LidarProcessSubnode* subnode_;
+  };
+
   bool InitInternal() override;
 
+  // Stops and joins the pipeline worker and the shared memory reader.
+  void StopThreads();
+
+  // Runs the frame through the pipeline, or right away without it.
+  void OnFrame(const std::shared_ptr<LidarFrame>& frame);
+  // Transform and ROI filter.
+  bool PreprocessFrame(LidarFrame* frame);
+  // Segmentation, object filter, object builder, tracker and type fuser,
+  // then publish.
+  void ProcessFrame(const LidarFrame& frame);
+  void RunPipeline();
+  void RunShmReader();
+  bool ReadShmPointCloud(const uint64_t shm_frame, LidarFrame* frame);
+  void ReportLatency(const LidarFrame& frame);
+
   pcl_util::PointIndicesPtr GetROIIndices() { return roi_indices_; }
 
   void RegistAllAlgorithm();
@@ -93,6 +154,26 @@ class LidarProcessSubnode : public Subnode {
   std::unique_ptr<BaseTracker> tracker_;
   std::unique_ptr<BaseTypeFuser> type_fuser_;
   pcl_util::PointIndicesPtr roi_indices_;
+
+  std::unique_ptr<FixedSizeConQueue<std::shared_ptr<LidarFrame>>> frame_queue_;
+  std::unique_ptr<PipelineWorker> pipeline_worker_;
+  std::atomic<uint64_t> dropped_frames_{0};
+  std::atomic<bool> threads_stopped_{false};
+  // So that no frame is queued after the null frame that stops the worker.
+  std::mutex frame_queue_mutex_;
+
+  // Name of the ring the driver writes the point clouds to, if any.
+  std::string point_cloud_shm_name_;
+  drivers::PointCloudShmRing point_cloud_shm_;
+  std::unique_ptr<ShmReader> shm_reader_;
+
+  // From receiving the point cloud to publishing the objects.
+  static constexpr uint64_t kLatencyReportFrames = 100;
+  uint64_t published_frames_ = 0;
+  double first_publish_time_ = 0.0;
+  double latency_sum_ = 0.0;
+  double max_latency_ = 0.0;
+  double input_time_sum_ = 0.0;
 };
 
 class Lidar64ProcessSubnode : public LidarProcessSubnode {
@@ -107,6 +188,10 @@ class Lidar16ProcessSubnode : public LidarProcessSubnode {
   void AddMessageCallback() override;
 };
 
+// To get the point clouds through shared memory instead of ROS, when the
+// driver runs on the same host, name the ring of the driver compensator
+// (param shm_name) in the reserve field of the subnode:
+//      reserve: "device_id:velodyne64;point_cloud_shm:/apollo_velodyne64;"
 REGISTER_SUBNODE(Lidar64ProcessSubnode);
 
 // To use 16-beam Lidar, you need to
@@ -339,12 +339,7 @@ bool RadarProcessSubnode::InitAlgorithmPlugin() {
 void RadarProcessSubnode::PublishDataAndEvent(
     double timestamp, const SharedDataPtr<SensorObjects> &data) {
   // set shared data
-  std::string key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id_, &key)) {
-    AERROR << "Failed to produce shared key. time: "
-           << GLOG_TIMESTAMP(timestamp) << ", device_id: " << device_id_;
-    return;
-  }
+  const CommonSharedDataKey key(timestamp, device_id_);
 
   radar_data_->Add(key, data);
   // pub events
@@ -100,13 +100,7 @@ bool UltrasonicObstacleSubnode::InitAlgorithmPlugin() {
 
 bool UltrasonicObstacleSubnode::PublishDataAndEvent(
     const double timestamp, const SharedDataPtr<SensorObjects>& data) {
-  std::string key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id_, &key)) {
-    AERROR << "Failed to produce shared key. time: "
-           << GLOG_TIMESTAMP(timestamp) << ", device_id: " << device_id_;
-    return false;
-  }
-
+  const CommonSharedDataKey key(timestamp, device_id_);
   processing_data_->Add(key, data);
 
   for (size_t idx = 0; idx < pub_meta_events_.size(); ++idx) {
@@ -232,7 +232,12 @@ bool VisualizationSubnode::SubscribeEvents(const EventMeta& event_meta,
                                            std::vector<Event>* events) const {
   Event event;
   if (event_meta.event_id == vis_driven_event_id_) {
-    event_manager_->Subscribe(event_meta.event_id, &event);
+    if (!event_manager_->Subscribe(event_meta.event_id, &event,
+                                   executor_driven_)) {
+      // Nothing to render, e.g. the event was dropped by a Reset() before a
+      // driven run, so skip the frame.
+      return true;
+    }
     events->insert(events->begin(), event);
   } else {
     // no blocking
@@ -244,9 +249,9 @@ bool VisualizationSubnode::SubscribeEvents(const EventMeta& event_meta,
   return true;
 }
 
-void VisualizationSubnode::SetRadarContent(const std::string& data_key,
-                                           FrameContent* content,
-                                           double timestamp) {
+void VisualizationSubnode::SetRadarContent(
+    const CommonSharedDataKey& data_key, FrameContent* content,
+    double timestamp) {
   if (radar_object_data_) {
     std::shared_ptr<SensorObjects> objs;
 
@@ -258,9 +263,9 @@ void VisualizationSubnode::SetRadarContent(const std::string& data_key,
   }
 }
 
-void VisualizationSubnode::SetLidarContent(const std::string& data_key,
-                                           FrameContent* content,
-                                           double timestamp) {
+void VisualizationSubnode::SetLidarContent(
+    const CommonSharedDataKey& data_key, FrameContent* content,
+    double timestamp) {
   if (lidar_object_data_) {
     std::shared_ptr<SensorObjects> objs;
 
@@ -284,9 +289,9 @@ void VisualizationSubnode::SetLidarContent(const std::string& data_key,
   }
 }
 
-void VisualizationSubnode::SetCameraContent(const std::string& data_key,
-                                            FrameContent* content,
-                                            double timestamp) {
+void VisualizationSubnode::SetCameraContent(
+    const CommonSharedDataKey& data_key, FrameContent* content,
+    double timestamp) {
   std::shared_ptr<CameraItem> camera_item;
   if (!camera_shared_data_->Get(data_key, &camera_item) ||
       camera_item == nullptr) {
@@ -311,9 +316,9 @@ void VisualizationSubnode::SetCameraContent(const std::string& data_key,
                               (*(objs->camera_frame_supplement)));
 }
 
-void VisualizationSubnode::SetFusionContent(const std::string& data_key,
-                                            FrameContent* content,
-                                            double timestamp) {
+void VisualizationSubnode::SetFusionContent(
+    const CommonSharedDataKey& data_key, FrameContent* content,
+    double timestamp) {
   SharedDataPtr<FusionItem> fusion_item;
   if (!fusion_data_->Get(data_key, &fusion_item) || fusion_item == nullptr) {
     AERROR << "Failed to get shared data: " << fusion_data_->name();
@@ -323,19 +328,13 @@ void VisualizationSubnode::SetFusionContent(const std::string& data_key,
   if (FLAGS_use_navigation_mode) {
     std::string trigger_device_id = fusion_item->fused_sensor_device_id;
     double trigger_ts = fusion_item->fused_sensor_ts;
-    std::string data_key_sensor;
+    const CommonSharedDataKey data_key_sensor(trigger_ts, trigger_device_id);
     if (trigger_device_id == "velodyne64") {
-      SubnodeHelper::ProduceSharedDataKey(trigger_ts, trigger_device_id,
-                                          &data_key_sensor);
       SetLidarContent(data_key_sensor, content, timestamp);
     } else if (trigger_device_id == "camera") {
-      SubnodeHelper::ProduceSharedDataKey(trigger_ts, trigger_device_id,
-                                          &data_key_sensor);
       SetCameraContent(data_key_sensor, content, timestamp);
       SetLaneContent(data_key, content, timestamp);
     } else if (trigger_device_id == "radar_front") {
-      SubnodeHelper::ProduceSharedDataKey(trigger_ts, trigger_device_id,
-                                          &data_key_sensor);
       SetRadarContent(data_key_sensor, content, timestamp);
     }
   } else {
@@ -345,25 +344,19 @@ void VisualizationSubnode::SetFusionContent(const std::string& data_key,
     for (int i = 0; i < ts.size(); ++i) {
       double trigger_ts = ts[i];
       std::string trigger_device_id = device_id[i];
-      std::string data_key_sensor;
+      const CommonSharedDataKey data_key_sensor(trigger_ts, trigger_device_id);
       AINFO << "trigger device id " << trigger_device_id;
-      AINFO << "data key sensor " << data_key_sensor;
+      AINFO << "data key sensor " << data_key_sensor.ToString();
 
       if (trigger_device_id == "velodyne_64") {
         AINFO << "set lidar content";
-        SubnodeHelper::ProduceSharedDataKey(trigger_ts, trigger_device_id,
-                                            &data_key_sensor);
         SetLidarContent(data_key_sensor, content, timestamp);
       } else if (trigger_device_id == "camera") {
         AINFO << "set camera content";
-        SubnodeHelper::ProduceSharedDataKey(trigger_ts, trigger_device_id,
-                                            &data_key_sensor);
         SetCameraContent(data_key_sensor, content, timestamp);
         // SetLaneContent(data_key, content, timestamp);
       } else if (trigger_device_id == "radar_front") {
         AINFO << "set radar front content";
-        SubnodeHelper::ProduceSharedDataKey(trigger_ts, trigger_device_id,
-                                            &data_key_sensor);
         SetRadarContent(data_key_sensor, content, timestamp);
       }
     }
@@ -373,9 +366,9 @@ void VisualizationSubnode::SetFusionContent(const std::string& data_key,
   AINFO << "Set fused objects : " << fusion_item->obstacles.size();
 }
 
-void VisualizationSubnode::SetLaneContent(const std::string& data_key,
-                                          FrameContent* content,
-                                          double timestamp) {
+void VisualizationSubnode::SetLaneContent(
+    const CommonSharedDataKey& data_key, FrameContent* content,
+    double timestamp) {
   if (lane_shared_data_) {
     LaneObjectsPtr lane_objs;
     if (!lane_shared_data_->Get(data_key, &lane_objs) || lane_objs == nullptr) {
@@ -388,7 +381,7 @@ void VisualizationSubnode::SetLaneContent(const std::string& data_key,
 
 void VisualizationSubnode::SetFrameContent(const Event& event,
                                            const std::string& device_id,
-                                           const std::string& data_key,
+                                           const CommonSharedDataKey& data_key,
                                            const double timestamp,
                                            FrameContent* content) {
   if (event.event_id == camera_event_id_) {
@@ -409,7 +402,7 @@ void VisualizationSubnode::SetFrameContent(const Event& event,
   } else if (event.event_id == fusion_event_id_) {
     bool show_fused_objects = true;
     if (show_fused_objects) {
-      AINFO << "vis_driven_event data_key = " << data_key;
+      AINFO << "vis_driven_event data_key = " << data_key.ToString();
       SetFusionContent(data_key, content, timestamp);
     }
   } else if (event.event_id == cipv_event_id_) {
@@ -466,14 +459,7 @@ apollo::common::Status VisualizationSubnode::ProcEvents() {
     for (size_t j = 0; j < events.size(); j++) {
       double timestamp = events[j].timestamp;
       const std::string& device_id = events[j].reserve;
-      std::string data_key;
-
-      if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id,
-                                               &data_key)) {
-        AERROR << "Failed to produce shared data key. timestamp:" << timestamp
-               << " device_id:" << device_id;
-        return Status(ErrorCode::PERCEPTION_ERROR, "Failed to proc events.");
-      }
+      const CommonSharedDataKey data_key(timestamp, device_id);
       AINFO << "event: " << events[j].event_id << " device_id:" << device_id
             << " timestamp: ";
       AINFO << std::fixed << std::setprecision(64) << timestamp;
@@ -48,6 +48,10 @@ class VisualizationSubnode : public Subnode {
 
   apollo::common::Status ProcEvents() override;
 
+  std::vector<EventID> TriggerEvents() const override {
+    return {vis_driven_event_id_};
+  }
+
  private:
   bool InitStream();
 
@@ -55,18 +59,18 @@ class VisualizationSubnode : public Subnode {
                        std::vector<Event>* events) const;
 
   void SetFrameContent(const Event& event, const std::string& device_id,
-                       const std::string& data_key, const double timestamp,
-                       FrameContent* content);
-  void SetFusionContent(const std::string& data_key, FrameContent* content,
-                        double timestamp);
-  void SetCameraContent(const std::string& data_key, FrameContent* content,
-                        double timestamp);
-  void SetRadarContent(const std::string& data_key, FrameContent* content,
-                       double timestamp);
-  void SetLaneContent(const std::string& data_key, FrameContent* content,
-                      double timestamp);
-  void SetLidarContent(const std::string& data_key, FrameContent* content,
-                       double timestamp);
+                       const CommonSharedDataKey& data_key,
+                       const double timestamp, FrameContent* content);
+  void SetFusionContent(const CommonSharedDataKey& data_key,
+                        FrameContent* content, double timestamp);
+  void SetCameraContent(const CommonSharedDataKey& data_key,
+                        FrameContent* content, double timestamp);
+  void SetRadarContent(const CommonSharedDataKey& data_key,
+                       FrameContent* content, double timestamp);
+  void SetLaneContent(const CommonSharedDataKey& data_key,
+                      FrameContent* content, double timestamp);
+  void SetLidarContent(const CommonSharedDataKey& data_key,
+                       FrameContent* content, double timestamp);
 
   RadarObjectData* radar_object_data_ = nullptr;
   CameraObjectData* camera_object_data_ = nullptr;
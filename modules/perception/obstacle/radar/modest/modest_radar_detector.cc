@@ -138,13 +138,14 @@ bool ModestRadarDetector::CollectRadarResult(
     AERROR << "objects is nullptr";
     return false;
   }
+  objects->reserve(objects->size() + obs_track.size());
   for (size_t i = 0; i < obs_track.size(); ++i) {
-    std::shared_ptr<Object> object_ptr = std::shared_ptr<Object>(new Object());
     const std::shared_ptr<Object> &object_radar_ptr =
         obs_track[i].GetObsRadar();
     if (config_.use_fp_filter() && object_radar_ptr->is_background) {
       continue;
     }
+    std::shared_ptr<Object> object_ptr = result_pool_.Get();
     object_ptr->clone(*object_radar_ptr);
     object_ptr->tracking_time = obs_track[i].GetTrackingTime();
     object_ptr->track_id = obs_track[i].GetObsId();
@@ -25,6 +25,7 @@
 
 #include "modules/perception/obstacle/radar/interface/base_radar_detector.h"
 #include "modules/perception/obstacle/radar/modest/object_builder.h"
+#include "modules/perception/obstacle/radar/modest/radar_object_pool.h"
 #include "modules/perception/obstacle/radar/modest/radar_track_manager.h"
 
 namespace apollo {
@@ -66,6 +67,8 @@ class ModestRadarDetector : public BaseRadarDetector {
   ContiParams conti_params_;
   ObjectBuilder object_builder_;
   boost::shared_ptr<RadarTrackManager> radar_tracker_;
+  // The collected objects are reused once the consumers release them.
+  RadarObjectPool result_pool_;
 
   modest_radar_detector_config::ModelConfigs config_;
 
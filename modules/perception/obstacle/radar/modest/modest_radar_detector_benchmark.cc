@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Throughput of the modest radar detector over ContiRadar messages:
+//
+//   modest_radar_detector_benchmark [--conti_radar_bag=<recorded bag>]
+//
+// The messages on FLAGS_conti_radar_topic of the bag are replayed through
+// one detector. Without a bag, one minute of a 14 Hz radar seeing 100
+// moving obstacles is generated for each radar of the benchmark.
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "rosbag/bag.h"
+#include "rosbag/view.h"
+
+#include "modules/common/adapters/adapter_gflags.h"
+#include "modules/perception/obstacle/radar/modest/modest_radar_detector.h"
+
+namespace apollo {
+namespace perception {
+namespace {
+
+const char kBagFlag[] = "--conti_radar_bag=";
+constexpr double kRadarPeriod = 1.0 / 14.0;
+constexpr int kObstacles = 100;
+
+std::string bag_file;  // NOLINT
+
+std::vector<ContiRadar> ReadBag() {
+  std::vector<ContiRadar> messages;
+  rosbag::Bag bag;
+  try {
+    bag.open(bag_file, rosbag::bagmode::Read);
+  } catch (const rosbag::BagIOException &e) {
+    AERROR << "Failed to open " << bag_file << ": " << e.what();
+    return messages;
+  }
+  rosbag::View view(bag, rosbag::TopicQuery({FLAGS_conti_radar_topic}));
+  for (auto it = view.begin(); it != view.end(); ++it) {
+    messages.push_back(*(it->instantiate<ContiRadar>()));
+  }
+  bag.close();
+  return messages;
+}
+
+std::vector<ContiRadar> Generate() {
+  std::vector<ContiRadar> messages(static_cast<size_t>(60.0 / kRadarPeriod));
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const double t = i * kRadarPeriod;
+    messages[i].mutable_header()->set_timestamp_sec(1500000000.0 + t);
+    for (int id = 0; id < kObstacles; ++id) {
+      auto *obs = messages[i].add_contiobs();
+      obs->set_obstacle_id(id);
+      obs->set_longitude_dist(5.0 + id * 2.0 + t * (id % 7 - 3));
+      obs->set_lateral_dist((id % 10 - 5) * 3.5);
+      obs->set_longitude_vel(id % 7 - 3);
+      obs->set_lateral_vel(0.0);
+      obs->set_longitude_dist_rms(0.1);
+      obs->set_lateral_dist_rms(0.1);
+      obs->set_longitude_vel_rms(0.1);
+      obs->set_lateral_vel_rms(0.1);
+      obs->set_probexist(0.99);
+      obs->set_meas_state(static_cast<int>(ContiMeasState::CONTI_MEASURED));
+    }
+  }
+  return messages;
+}
+
+const std::vector<ContiRadar> &Messages() {
+  static const std::vector<ContiRadar> messages =
+      bag_file.empty() ? Generate() : ReadBag();
+  return messages;
+}
+
+void BM_ModestRadarDetector(benchmark::State &state) {  // NOLINT
+  const std::vector<ContiRadar> &messages = Messages();
+  const int num_radars = state.range(0);
+  Eigen::Matrix4d radar2world_pose = Eigen::Matrix4d::Identity();
+  RadarDetectorOptions options;
+  options.radar2world_pose = &radar2world_pose;
+  options.car_linear_speed = Eigen::Vector3f(5.0, 0.0, 0.0);
+  const std::vector<PolygonDType> map_polygons;
+  std::vector<std::shared_ptr<Object>> objects;
+  size_t num_objects = 0;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    std::vector<std::unique_ptr<ModestRadarDetector>> detectors;
+    for (int i = 0; i < num_radars; ++i) {
+      detectors.emplace_back(new ModestRadarDetector());
+      CHECK(detectors.back()->Init());
+    }
+    state.ResumeTiming();
+    num_objects = 0;
+    for (const auto &message : messages) {
+      for (auto &detector : detectors) {
+        objects.clear();
+        detector->Detect(message, map_polygons, options, &objects);
+        num_objects += objects.size();
+      }
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          messages.size() * num_radars);
+  state.SetLabel("objects=" + std::to_string(num_objects));
+}
+BENCHMARK(BM_ModestRadarDetector)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace perception
+}  // namespace apollo
+
+int main(int argc, char **argv) {
+  // Takes out the bag flag before the benchmark flags are parsed.
+  int benchmark_argc = 0;
+  for (int i = 0; i < argc; ++i) {
+    if (std::strncmp(argv[i], apollo::perception::kBagFlag,
+                     sizeof(apollo::perception::kBagFlag) - 1) == 0) {
+      apollo::perception::bag_file =
+          argv[i] + sizeof(apollo::perception::kBagFlag) - 1;
+    } else {
+      argv[benchmark_argc++] = argv[i];
+    }
+  }
+  benchmark::Initialize(&benchmark_argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
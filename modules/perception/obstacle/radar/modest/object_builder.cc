@@ -31,21 +31,24 @@ bool ObjectBuilder::Build(const ContiRadar &raw_obstacles,
     AERROR << "radar objects is nullptr.";
     return false;
   }
-  std::unordered_map<int, int> current_con_ids;
+  current_con_ids_.clear();
   auto objects = &(radar_objects->objects);
+  objects->reserve(objects->size() + raw_obstacles.contiobs_size());
   for (int i = 0; i < raw_obstacles.contiobs_size(); ++i) {
-    std::shared_ptr<Object> object_ptr = std::shared_ptr<Object>(new Object());
+    std::shared_ptr<Object> object_ptr = object_pool_.Get();
+    // All the other fields are set below.
+    object_ptr->is_background = false;
     const int obstacle_id = raw_obstacles.contiobs(i).obstacle_id();
     auto continuous_id_it = continuous_ids_.find(obstacle_id);
     if (continuous_id_it != continuous_ids_.end()) {
-      current_con_ids[obstacle_id] = continuous_id_it->second + 1;
+      current_con_ids_[obstacle_id] = continuous_id_it->second + 1;
     } else {
-      current_con_ids[obstacle_id] = 1;
+      current_con_ids_[obstacle_id] = 1;
     }
-    if (current_con_ids[obstacle_id] <= delay_frames_) {
+    if (current_con_ids_[obstacle_id] <= delay_frames_) {
       object_ptr->is_background = true;
     }
-    int tracking_times = current_con_ids[obstacle_id];
+    int tracking_times = current_con_ids_[obstacle_id];
     if (use_fp_filter_ &&
         ContiRadarUtil::IsFp(raw_obstacles.contiobs(i), conti_params_,
                              delay_frames_, tracking_times)) {
@@ -108,7 +111,7 @@ bool ObjectBuilder::Build(const ContiRadar &raw_obstacles,
     direction = radar_pose.topLeftCorner(3, 3).cast<float>() * direction;
     object_ptr->direction = direction.cast<double>();
     //  the avg time diff is from manual
-    object_ptr->tracking_time = current_con_ids[obstacle_id] * 0.074;
+    object_ptr->tracking_time = current_con_ids_[obstacle_id] * 0.074;
     double theta = std::atan2(direction(1), direction(0));
     object_ptr->theta = theta;
     //  For radar obstacle , the polygon is supposed to have
@@ -124,7 +127,7 @@ bool ObjectBuilder::Build(const ContiRadar &raw_obstacles,
     object_ptr->radar_supplement->angle = 0;
     objects->push_back(object_ptr);
   }
-  continuous_ids_ = current_con_ids;
+  continuous_ids_.swap(current_con_ids_);
   return true;
 }
 
@@ -27,6 +27,7 @@
 #include "modules/perception/obstacle/base/types.h"
 #include "modules/perception/obstacle/radar/interface/base_radar_detector.h"
 #include "modules/perception/obstacle/radar/modest/radar_define.h"
+#include "modules/perception/obstacle/radar/modest/radar_object_pool.h"
 
 namespace apollo {
 namespace perception {
@@ -56,6 +57,9 @@ class ObjectBuilder {
 
  private:
   std::unordered_map<int, int> continuous_ids_;
+  // Continuous ids of the frame being built, kept to reuse its buckets.
+  std::unordered_map<int, int> current_con_ids_;
+  RadarObjectPool object_pool_;
   int delay_frames_ = 4;
   bool use_fp_filter_ = true;
   ContiParams conti_params_;
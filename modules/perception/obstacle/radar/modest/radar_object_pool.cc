@@ -0,0 +1,41 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/obstacle/radar/modest/radar_object_pool.h"
+
+#include <atomic>
+
+namespace apollo {
+namespace perception {
+
+std::shared_ptr<Object> RadarObjectPool::Get() {
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    const size_t index = (next_ + i) % objects_.size();
+    if (objects_[index].use_count() == 1) {
+      // Pairs with the release of the last other holder, which may be on
+      // another thread.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      next_ = index + 1;
+      return objects_[index];
+    }
+  }
+  objects_.emplace_back(new Object());
+  next_ = 0;
+  return objects_.back();
+}
+
+}  // namespace perception
+}  // namespace apollo
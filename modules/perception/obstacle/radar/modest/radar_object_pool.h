@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef MODULES_PERCEPTION_OBSTACLE_RADAR_MODEST_RADAR_OBJECT_POOL_H_
+#define MODULES_PERCEPTION_OBSTACLE_RADAR_MODEST_RADAR_OBJECT_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "modules/perception/obstacle/base/object.h"
+
+namespace apollo {
+namespace perception {
+
+// Recycles the objects of previous radar frames once nothing else holds
+// them, so that a steady stream of radar frames does not allocate objects.
+class RadarObjectPool {
+ public:
+  RadarObjectPool() = default;
+  ~RadarObjectPool() = default;
+
+  // @brief: get an object which is held by nobody else. Its fields are left
+  //         as the previous user set them.
+  // @return the object
+  std::shared_ptr<Object> Get();
+
+  // @brief: number of objects in the pool, in use or not.
+  size_t size() const { return objects_.size(); }
+
+ private:
+  std::vector<std::shared_ptr<Object>> objects_;
+  // Where to look for a free object next. Objects are mostly released in the
+  // order they are taken, so the scan rarely goes far.
+  size_t next_ = 0;
+};
+
+}  // namespace perception
+}  // namespace apollo
+
+#endif  // MODULES_PERCEPTION_OBSTACLE_RADAR_MODEST_RADAR_OBJECT_POOL_H_
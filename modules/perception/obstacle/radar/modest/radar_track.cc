@@ -16,6 +16,8 @@
 
 #include "modules/perception/obstacle/radar/modest/radar_track.h"
 
+#include <utility>
+
 namespace apollo {
 namespace perception {
 
@@ -42,23 +44,15 @@ RadarTrack::RadarTrack(const Object &obs, const double timestamp) {
   id_tracked_ = false;
 }
 
-RadarTrack::RadarTrack(const RadarTrack &track) {
-  obs_id_ = track.obs_id_;
-  obs_radar_ = track.obs_radar_;
-  tracked_times_ = track.tracked_times_;
-  tracking_time_ = track.tracking_time_;
-  timestamp_ = track.timestamp_;
-  id_tracked_ = track.id_tracked_;
-}
-
-RadarTrack &RadarTrack::operator=(const RadarTrack &track) {
-  obs_id_ = track.obs_id_;
-  obs_radar_ = track.obs_radar_;
-  tracked_times_ = track.tracked_times_;
-  tracking_time_ = track.tracking_time_;
-  timestamp_ = track.timestamp_;
-  id_tracked_ = track.id_tracked_;
-  return *this;
+RadarTrack::RadarTrack(std::shared_ptr<Object> obs_radar,
+                       const double timestamp) {
+  s_current_idx_ %= MAX_RADAR_IDX;
+  obs_id_ = s_current_idx_++;
+  obs_radar_ = std::move(obs_radar);
+  timestamp_ = timestamp;
+  tracked_times_ = 1;
+  tracking_time_ = 0.0;
+  id_tracked_ = false;
 }
 
 void RadarTrack::UpdataObsRadar(std::shared_ptr<Object> obs_radar,
@@ -76,11 +70,13 @@ void RadarTrack::IncreaseTrackedTimes() { tracked_times_++; }
 
 int RadarTrack::GetObsId() const { return obs_id_; }
 
-std::shared_ptr<Object> RadarTrack::GetObsRadar() { return obs_radar_; }
+const std::shared_ptr<Object> &RadarTrack::GetObsRadar() const {
+  return obs_radar_;
+}
 
-double RadarTrack::GetTimestamp() { return timestamp_; }
+double RadarTrack::GetTimestamp() const { return timestamp_; }
 
-double RadarTrack::GetTrackingTime() { return tracking_time_; }
+double RadarTrack::GetTrackingTime() const { return tracking_time_; }
 
 }  // namespace perception
 }  // namespace apollo
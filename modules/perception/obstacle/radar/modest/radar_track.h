@@ -35,9 +35,14 @@ class RadarTrack {
 
   RadarTrack(const Object &obs, const double timestamp);
 
-  RadarTrack(const RadarTrack &track);
+  // track an observation without copying it
+  RadarTrack(std::shared_ptr<Object> obs_radar, const double timestamp);
 
-  RadarTrack &operator=(const RadarTrack &track);
+  RadarTrack(const RadarTrack &track) = default;
+  RadarTrack(RadarTrack &&track) = default;
+
+  RadarTrack &operator=(const RadarTrack &track) = default;
+  RadarTrack &operator=(RadarTrack &&track) = default;
 
   ~RadarTrack() {}
 
@@ -51,11 +56,11 @@ class RadarTrack {
 
   int GetObsId() const;
 
-  std::shared_ptr<Object> GetObsRadar();
+  const std::shared_ptr<Object> &GetObsRadar() const;
 
-  double GetTimestamp();
+  double GetTimestamp() const;
 
-  double GetTrackingTime();
+  double GetTrackingTime() const;
 
   static void SetTrackedTimesThreshold(const int threshold) {
     s_tracked_times_threshold_ = threshold;
@@ -16,6 +16,7 @@
 
 #include "modules/perception/obstacle/radar/modest/radar_track_manager.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -28,64 +29,60 @@ void RadarTrackManager::Process(const SensorObjects &radar_obs) {
 }
 
 void RadarTrackManager::Update(SensorObjects *radar_obs) {
-  std::vector<std::pair<int, int>> assignment;
-  std::vector<int> unassigned_track;
-  std::vector<int> unassigned_obs;
-  AssignTrackObsIdMatch(*radar_obs, &assignment, &unassigned_track,
-                        &unassigned_obs);
-  UpdateAssignedTrack(*radar_obs, assignment);
-  UpdateUnassignedTrack((*radar_obs).timestamp, unassigned_track);
+  AssignTrackObsIdMatch(*radar_obs, &assignment_, &unassigned_track_,
+                        &unassigned_obs_);
+  UpdateAssignedTrack(*radar_obs, assignment_);
+  UpdateUnassignedTrack((*radar_obs).timestamp, unassigned_track_);
   DeleteLostTrack();
-  CreateNewTrack(*radar_obs, unassigned_obs);
+  CreateNewTrack(*radar_obs, unassigned_obs_);
 }
 
 void RadarTrackManager::AssignTrackObsIdMatch(
     const SensorObjects &radar_obs,
     std::vector<std::pair<int, int>> *assignment,
     std::vector<int> *unassigned_track, std::vector<int> *unassigned_obs) {
-  assignment->resize(obs_tracks_.size() * 2);
-  int assignment_num = 0;
-  std::vector<bool> track_used(obs_tracks_.size(), false);
-  std::vector<bool> obs_used(radar_obs.objects.size(), false);
+  assignment->clear();
+  unassigned_track->clear();
+  unassigned_obs->clear();
+  obs_id_index_.clear();
+  for (size_t j = 0; j < radar_obs.objects.size(); j++) {
+    obs_id_index_.emplace_back(radar_obs.objects[j]->track_id, j);
+  }
+  std::sort(obs_id_index_.begin(), obs_id_index_.end());
+  obs_used_.assign(radar_obs.objects.size(), false);
+
+  double timestamp_obs = radar_obs.timestamp;
   for (size_t i = 0; i < obs_tracks_.size(); i++) {
-    std::shared_ptr<Object> obs;
-    obs = obs_tracks_[i].GetObsRadar();
-    if (obs == nullptr) {
-      continue;
-    }
-    double timestamp_track = obs_tracks_[i].GetTimestamp();
-    double timestamp_obs = radar_obs.timestamp;
-    for (size_t j = 0; j < radar_obs.objects.size(); j++) {
-      double distance = DistanceBetweenObs(
-          *obs, timestamp_track, *(radar_obs.objects[j]), timestamp_obs);
-      if (obs->track_id == radar_obs.objects[j]->track_id &&
-          distance < RADAR_TRACK_THRES) {
-        assignment->at(assignment_num++) = std::make_pair(i, j);
-        track_used[i] = true;
-        obs_used[j] = true;
-        obs_tracks_[i].IncreaseTrackedTimes();
+    const std::shared_ptr<Object> &obs = obs_tracks_[i].GetObsRadar();
+    bool track_used = false;
+    if (obs != nullptr) {
+      double timestamp_track = obs_tracks_[i].GetTimestamp();
+      // Only the observations with the same id are candidates.
+      for (auto it = std::lower_bound(obs_id_index_.begin(),
+                                      obs_id_index_.end(),
+                                      std::make_pair(obs->track_id, 0));
+           it != obs_id_index_.end() && it->first == obs->track_id; ++it) {
+        const int j = it->second;
+        double distance = DistanceBetweenObs(
+            *obs, timestamp_track, *(radar_obs.objects[j]), timestamp_obs);
+        if (distance < RADAR_TRACK_THRES) {
+          assignment->emplace_back(i, j);
+          track_used = true;
+          obs_used_[j] = true;
+          obs_tracks_[i].IncreaseTrackedTimes();
+        }
       }
     }
-  }
-
-  assignment->resize(assignment_num);
-  unassigned_track->resize(obs_tracks_.size());
-  int unassigned_track_num = 0;
-  for (size_t i = 0; i < track_used.size(); i++) {
-    if (track_used[i] == false) {
-      unassigned_track->at(unassigned_track_num++) = i;
+    if (!track_used) {
+      unassigned_track->push_back(i);
     }
   }
-  unassigned_track->resize(unassigned_track_num);
 
-  unassigned_obs->resize(radar_obs.objects.size());
-  int unassigned_obs_num = 0;
-  for (size_t i = 0; i < obs_used.size(); i++) {
-    if (obs_used[i] == false) {
-      unassigned_obs->at(unassigned_obs_num++) = i;
+  for (size_t j = 0; j < obs_used_.size(); j++) {
+    if (!obs_used_[j]) {
+      unassigned_obs->push_back(j);
     }
   }
-  unassigned_obs->resize(unassigned_obs_num);
 }
 
 void RadarTrackManager::UpdateAssignedTrack(
@@ -112,20 +109,24 @@ void RadarTrackManager::UpdateUnassignedTrack(
 }
 
 void RadarTrackManager::DeleteLostTrack() {
-  int track_num = 0;
+  size_t track_num = 0;
   for (size_t i = 0; i < obs_tracks_.size(); i++) {
     if (obs_tracks_[i].GetObsRadar() != nullptr) {
-      obs_tracks_[track_num++] = obs_tracks_[i];
+      if (track_num != i) {
+        obs_tracks_[track_num] = std::move(obs_tracks_[i]);
+      }
+      track_num++;
     }
   }
-  obs_tracks_.resize(track_num);
+  obs_tracks_.erase(obs_tracks_.begin() + track_num, obs_tracks_.end());
 }
 
 void RadarTrackManager::CreateNewTrack(const SensorObjects &radar_obs,
                                        const std::vector<int> &unassigned_obs) {
+  obs_tracks_.reserve(obs_tracks_.size() + unassigned_obs.size());
   for (size_t i = 0; i < unassigned_obs.size(); i++) {
-    obs_tracks_.push_back(RadarTrack(*(radar_obs.objects[unassigned_obs[i]]),
-                                     radar_obs.timestamp));
+    obs_tracks_.emplace_back(radar_obs.objects[unassigned_obs[i]],
+                             radar_obs.timestamp);
   }
 }
 
@@ -45,7 +45,8 @@ class RadarTrackManager {
   void Update(SensorObjects *radar_obs);
 
   // @brief match observation obstacles to existed tracking states by
-  //            tracking id
+  //            tracking id, within RADAR_TRACK_THRES of the predicted
+  //            position
   // @param [out]: assigement index pairs of observations and tracking states
   // @param [out]: indexs of unassigend tracking state
   // @param [out]: indexs of unassigned observation obstacles
@@ -90,6 +91,15 @@ class RadarTrackManager {
                             const Object &obs2, double timestamp2);
   SensorObjects radar_obs_;
   std::vector<RadarTrack> obs_tracks_;
+
+  // Per frame buffers, kept to reuse their memory.
+  // (track id, index) of the observations, sorted to look up the
+  // observations with the id of a track.
+  std::vector<std::pair<int, int>> obs_id_index_;
+  std::vector<bool> obs_used_;
+  std::vector<std::pair<int, int>> assignment_;
+  std::vector<int> unassigned_track_;
+  std::vector<int> unassigned_obs_;
 };
 
 }  // namespace perception
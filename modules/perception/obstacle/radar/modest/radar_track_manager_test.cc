@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Copyright 2017 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/obstacle/radar/modest/radar_track_manager.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/obstacle/radar/modest/radar_object_pool.h"
+
+namespace apollo {
+namespace perception {
+
+namespace {
+
+std::shared_ptr<Object> MakeObject(const int track_id, const double x,
+                                   const double vx) {
+  std::shared_ptr<Object> object(new Object());
+  object->track_id = track_id;
+  object->center = Eigen::Vector3d(x, 0.0, 0.0);
+  object->velocity = Eigen::Vector3d(vx, 0.0, 0.0);
+  return object;
+}
+
+}  // namespace
+
+TEST(RadarTrackManagerTest, AssociateByIdAndDistance) {
+  RadarTrackManager manager;
+  SensorObjects frame;
+  frame.timestamp = 1.0;
+  frame.objects = {MakeObject(1, 0.0, 10.0), MakeObject(2, 20.0, 0.0),
+                   MakeObject(3, 40.0, 0.0)};
+  manager.Process(frame);
+  ASSERT_EQ(3, manager.GetTracks().size());
+  const int track_1 = manager.GetTracks()[0].GetObsId();
+  const int track_2 = manager.GetTracks()[1].GetObsId();
+
+  // Object 1 moved as predicted, object 2 jumped away under the same id and
+  // object 3 disappeared.
+  frame.timestamp = 1.05;
+  frame.objects = {MakeObject(2, 30.0, 0.0), MakeObject(1, 0.5, 10.0)};
+  manager.Process(frame);
+  const auto &tracks = manager.GetTracks();
+  ASSERT_EQ(4, tracks.size());
+  EXPECT_EQ(track_1, tracks[0].GetObsId());
+  EXPECT_EQ(frame.objects[1], tracks[0].GetObsRadar());
+  EXPECT_NEAR(0.05, tracks[0].GetTrackingTime(), 1e-9);
+  // Track 2 and 3 are kept within RADAR_TRACK_TIME_WIN.
+  EXPECT_EQ(track_2, tracks[1].GetObsId());
+  EXPECT_EQ(20.0, tracks[1].GetObsRadar()->center(0));
+  EXPECT_EQ(frame.objects[0], tracks[3].GetObsRadar());
+
+  // Lost tracks are deleted after RADAR_TRACK_TIME_WIN.
+  frame.timestamp = 1.15;
+  frame.objects = {MakeObject(1, 1.5, 10.0)};
+  manager.Process(frame);
+  ASSERT_EQ(1, manager.GetTracks().size());
+  EXPECT_EQ(track_1, manager.GetTracks()[0].GetObsId());
+}
+
+TEST(RadarObjectPoolTest, ReuseReleased) {
+  RadarObjectPool pool;
+  std::shared_ptr<Object> first = pool.Get();
+  std::shared_ptr<Object> second = pool.Get();
+  EXPECT_NE(first, second);
+  Object *released = second.get();
+  second.reset();
+  EXPECT_EQ(released, pool.Get().get());
+  EXPECT_EQ(2, pool.size());
+}
+
+}  // namespace perception
+}  // namespace apollo
@@ -27,5 +27,8 @@ DEFINE_int32(
 
 DEFINE_int32(stamp_enlarge_factor, 100, "timestamp enlarge factor");
 
+DEFINE_int32(shared_data_ring_size, 64,
+             "the number of latest frames kept per device in shared data");
+
 }  // namespace perception
 }  // namespace apollo
@@ -18,11 +18,12 @@
 #define MODULES_PERCEPTION_ONBOARD_COMMON_SHARED_DATA_H_
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <sstream>
 #include <string>
-#include <unordered_map>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -44,16 +45,19 @@ using SharedDataConstPtr = std::shared_ptr<const T>;
 
 DECLARE_int32(shared_data_stale_time);
 DECLARE_int32(stamp_enlarge_factor);
+DECLARE_int32(shared_data_ring_size);
 
 struct CommonSharedDataKey {
   CommonSharedDataKey() = default;
   CommonSharedDataKey(const double ts, const std::string &id)
       : timestamp(ts), device_id(id) {}
   virtual std::string ToString() const {
-    return device_id +
-           (boost::format("%ld") %
-            static_cast<int64_t>(timestamp * FLAGS_stamp_enlarge_factor))
-               .str();
+    return device_id + (boost::format("%ld") % Ticks()).str();
+  }
+  // The timestamp in 1 / stamp_enlarge_factor seconds. The frames of a
+  // device with the same ticks share one key.
+  int64_t Ticks() const {
+    return static_cast<int64_t>(timestamp * FLAGS_stamp_enlarge_factor);
   }
   double timestamp = 0.0;
   std::string device_id = "";
@@ -73,11 +77,20 @@ struct CommonSharedDataStat {
 };
 
 // define shared data template for common usage
+//
+// The frames of each device are kept in a ring of the latest
+// shared_data_ring_size frames, which is looked up by the ticks of the key,
+// newest first. Add(), Get() and the others take no lock, but the one to
+// add the first frame of a device.
 template <class M>
 class CommonSharedData : public SharedData {
  public:
   CommonSharedData() {}
-  virtual ~CommonSharedData() {}
+  virtual ~CommonSharedData() {
+    for (DeviceRing *device : devices_) {
+      delete device;
+    }
+  }
 
   bool Init() override {
     latest_timestamp_ = std::numeric_limits<double>::min();
@@ -92,197 +105,354 @@ class CommonSharedData : public SharedData {
 
   void RemoveStaleData() override;
 
-  // @brief: add new key shared data
+  // @brief: add new key shared data, which replaces the oldest frame of the
+  //         device when its ring is full
   // @param [in]: key
   // @param [in]: value
   // @return : true or false
-  bool Add(const std::string &key, const SharedDataPtr<M> &data);
-
   bool Add(const CommonSharedDataKey &key, const SharedDataPtr<M> &data);
 
   // @brief: get shared data for the given key
   // @param [in]: key
   // @param [out]: value with the key
   // @return : true or false
-  bool Get(const std::string &key, SharedDataPtr<M> *data);
-
   bool Get(const CommonSharedDataKey &key, SharedDataPtr<M> *data);
 
   double GetLatestTimestamp() const;
   // @brief: remove shared data with the given key
   // @param [in]: key
   // @return : true or false
-  bool Remove(const std::string &key);
-
   bool Remove(const CommonSharedDataKey &key);
 
   // @brief: get the data then remove it
   // @param [in]: key
   // @param [out]: value with the key
   // @return : true or false
-  bool Pop(const std::string &key, SharedDataPtr<M> *data);
-
   bool Pop(const CommonSharedDataKey &key, SharedDataPtr<M> *data);
 
   // @brief: num of data stored in shared data
   // @return: num of data
-  unsigned Size() const { return data_map_.size(); }
-
-  CommonSharedDataStat GetStat() const { return stat_; }
+  unsigned Size() const;
+
+  CommonSharedDataStat GetStat() const {
+    CommonSharedDataStat stat;
+    stat.add_cnt = add_cnt_.load(std::memory_order_relaxed);
+    stat.remove_cnt = remove_cnt_.load(std::memory_order_relaxed);
+    stat.get_cnt = get_cnt_.load(std::memory_order_relaxed);
+    return stat;
+  }
 
  private:
-  typedef std::unordered_map<std::string, SharedDataPtr<M>> SharedDataMap;
-  typedef std::pair<std::string, SharedDataPtr<M>> SharedDataPair;
-  typedef std::unordered_map<std::string, uint64_t>
-      DataAddedTimeMap;  // precision in second
-  typedef std::pair<std::string, uint64_t> DataKeyTimestampPair;
-
-  SharedDataMap data_map_;
+  static constexpr int64_t kEmptyTicks = std::numeric_limits<int64_t>::min();
+  static constexpr int kMaxNumDevices = 16;
+
+  // The version of a slot is odd while a frame is written to or cleared
+  // from it, and goes up by two with each change. A writer makes it odd with
+  // a CAS, so writers of a slot exclude each other, and a clear CASes from
+  // the version it saw the frame at, so it never lands on a newer frame. A
+  // reader takes a frame if the version is the same even value before and
+  // after reading it.
+  struct Slot {
+    std::atomic<uint64_t> version{0};
+    std::atomic<int64_t> ticks{kEmptyTicks};
+    SharedDataPtr<M> data;
+    std::atomic<uint64_t> added_time{0};  // precision in second
+  };
+
+  struct DeviceRing {
+    DeviceRing(const std::string &id, const int size)
+        : device_id(id), slots(new Slot[size]), num_slots(size) {}
+
+    // Returns the slot index of the ticks, or -1.
+    int Find(const int64_t ticks) const;
+
+    const std::string device_id;
+    std::unique_ptr<Slot[]> slots;
+    const int num_slots;
+    std::atomic<uint64_t> next_slot{0};
+  };
+
+  DeviceRing *FindDevice(const std::string &device_id) const;
+  DeviceRing *FindOrAddDevice(const std::string &device_id);
+
+  // Reads the frame of the slot if it has the ticks, with the version it
+  // was read at.
+  bool ReadSlot(const int64_t ticks, Slot *slot, uint64_t *version,
+                SharedDataPtr<M> *data) const;
+  // Waits for the writers of the slot and makes its version odd. Returns
+  // the even version it was at.
+  uint64_t LockSlot(Slot *slot) const;
+  // Empties the slot if it is still at the version.
+  bool ClearSlot(const uint64_t version, Slot *slot);
+
+  DeviceRing *devices_[kMaxNumDevices] = {};
+  std::atomic<int> num_devices_{0};
+  // Only for adding devices.
   Mutex mutex_;
-  CommonSharedDataStat stat_;
-  DataAddedTimeMap data_added_time_map_;
-  double latest_timestamp_ = std::numeric_limits<double>::min();
+  std::atomic<uint64_t> add_cnt_{0};
+  std::atomic<uint64_t> remove_cnt_{0};
+  std::atomic<uint64_t> get_cnt_{0};
+  std::atomic<double> latest_timestamp_{std::numeric_limits<double>::min()};
 
   DISALLOW_COPY_AND_ASSIGN(CommonSharedData);
 };
 
 template <class M>
-void CommonSharedData<M>::Reset() {
-  MutexLock lock(&mutex_);
-  AINFO << "Reset " << name() << ", map size: " << data_map_.size();
-  data_map_.clear();
-  data_added_time_map_.clear();
-  latest_timestamp_ = std::numeric_limits<double>::min();
-}
+constexpr int64_t CommonSharedData<M>::kEmptyTicks;
 
 template <class M>
-void CommonSharedData<M>::RemoveStaleData() {
-  MutexLock lock(&mutex_);
-  const uint64_t now = ::time(NULL);
-  bool has_change = false;
-  for (auto iter = data_added_time_map_.begin();
-       iter != data_added_time_map_.end();) {
-    if (now - iter->second >
-        static_cast<uint64_t>(FLAGS_shared_data_stale_time)) {
-      const size_t erase_cnt = data_map_.erase(iter->first);
-      if (erase_cnt != 1u) {
-        AWARN << "data_map_ erase cnt:" << erase_cnt << " key:" << iter->first;
-        return;
-      }
-      iter = data_added_time_map_.erase(iter);
-      ++stat_.remove_cnt;
-      has_change = true;
-    } else {
-      ++iter;
+int CommonSharedData<M>::DeviceRing::Find(const int64_t ticks) const {
+  const uint64_t next = next_slot.load(std::memory_order_acquire);
+  const uint64_t count =
+      std::min<uint64_t>(next, static_cast<uint64_t>(num_slots));
+  for (uint64_t i = 1; i <= count; ++i) {
+    const int index = static_cast<int>((next - i) % num_slots);
+    if (slots[index].ticks.load(std::memory_order_acquire) == ticks) {
+      return index;
     }
   }
-  if (has_change) {
-    AINFO << "SharedData remove_stale_data name:" << name() << " stat:["
-          << stat_.ToString() << "]";
+  return -1;
+}
+
+template <class M>
+typename CommonSharedData<M>::DeviceRing *CommonSharedData<M>::FindDevice(
+    const std::string &device_id) const {
+  const int num_devices = num_devices_.load(std::memory_order_acquire);
+  for (int i = 0; i < num_devices; ++i) {
+    if (devices_[i]->device_id == device_id) {
+      return devices_[i];
+    }
   }
+  return nullptr;
 }
 
 template <class M>
-bool CommonSharedData<M>::Add(const std::string &key,
-                              const SharedDataPtr<M> &data) {
+typename CommonSharedData<M>::DeviceRing *CommonSharedData<M>::FindOrAddDevice(
+    const std::string &device_id) {
+  DeviceRing *device = FindDevice(device_id);
+  if (device != nullptr) {
+    return device;
+  }
   MutexLock lock(&mutex_);
-  auto ret = data_map_.emplace(SharedDataPair(key, data));
-  if (!ret.second) {
-    AWARN << "Duplicate key: " << key;
-    return false;
+  device = FindDevice(device_id);
+  if (device != nullptr) {
+    return device;
+  }
+  const int num_devices = num_devices_.load(std::memory_order_relaxed);
+  if (num_devices == kMaxNumDevices) {
+    AERROR << name() << " has too many devices, failed to add: " << device_id;
+    return nullptr;
   }
+  device = new DeviceRing(device_id, std::max(1, FLAGS_shared_data_ring_size));
+  devices_[num_devices] = device;
+  num_devices_.store(num_devices + 1, std::memory_order_release);
+  return device;
+}
 
-  const uint64_t timestamp = ::time(NULL);
-  data_added_time_map_.emplace(DataKeyTimestampPair(key, timestamp));
-  ++stat_.add_cnt;
-  return true;
+template <class M>
+bool CommonSharedData<M>::ReadSlot(const int64_t ticks, Slot *slot,
+                                   uint64_t *version,
+                                   SharedDataPtr<M> *data) const {
+  while (true) {
+    const uint64_t begin = slot->version.load(std::memory_order_acquire);
+    if (begin % 2 == 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (slot->ticks.load(std::memory_order_relaxed) != ticks) {
+      return false;
+    }
+    SharedDataPtr<M> slot_data = std::atomic_load(&slot->data);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->version.load(std::memory_order_relaxed) == begin) {
+      *version = begin;
+      *data = std::move(slot_data);
+      return true;
+    }
+  }
 }
 
 template <class M>
-bool CommonSharedData<M>::Add(const CommonSharedDataKey &key,
-                              const SharedDataPtr<M> &data) {
-  // update latest_timestamp for SharedData
-  latest_timestamp_ = key.timestamp;
-  return Add(key.ToString(), data);
+uint64_t CommonSharedData<M>::LockSlot(Slot *slot) const {
+  uint64_t version = slot->version.load(std::memory_order_relaxed);
+  while (version % 2 == 1 ||
+         !slot->version.compare_exchange_weak(version, version + 1,
+                                              std::memory_order_acq_rel)) {
+    if (version % 2 == 1) {
+      std::this_thread::yield();
+      version = slot->version.load(std::memory_order_relaxed);
+    }
+  }
+  return version;
 }
 
 template <class M>
-bool CommonSharedData<M>::Get(const std::string &key, SharedDataPtr<M> *data) {
-  MutexLock lock(&mutex_);
-  auto citer = data_map_.find(key);
-  if (citer == data_map_.end()) {
-    AWARN << "Failed to get shared data. key: " << key;
+bool CommonSharedData<M>::ClearSlot(const uint64_t version, Slot *slot) {
+  uint64_t expected = version;
+  if (version % 2 == 1 ||
+      !slot->version.compare_exchange_strong(expected, version + 1,
+                                             std::memory_order_acq_rel)) {
     return false;
   }
-  *data = citer->second;
-  ++stat_.get_cnt;
+  slot->ticks.store(kEmptyTicks, std::memory_order_relaxed);
+  SharedDataPtr<M> data =
+      std::atomic_exchange(&slot->data, SharedDataPtr<M>());
+  slot->version.store(version + 2, std::memory_order_release);
+  remove_cnt_.fetch_add(1, std::memory_order_relaxed);
   return true;
 }
 
 template <class M>
-bool CommonSharedData<M>::Get(const CommonSharedDataKey &key,
-                              SharedDataPtr<M> *data) {
-  return Get(key.ToString(), data);
+void CommonSharedData<M>::Reset() {
+  const int num_devices = num_devices_.load(std::memory_order_acquire);
+  AINFO << "Reset " << name() << ", size: " << Size();
+  for (int i = 0; i < num_devices; ++i) {
+    DeviceRing *device = devices_[i];
+    for (int j = 0; j < device->num_slots; ++j) {
+      Slot *slot = &device->slots[j];
+      const uint64_t version = LockSlot(slot);
+      slot->ticks.store(kEmptyTicks, std::memory_order_relaxed);
+      SharedDataPtr<M> data =
+          std::atomic_exchange(&slot->data, SharedDataPtr<M>());
+      slot->version.store(version + 2, std::memory_order_release);
+    }
+  }
+  latest_timestamp_ = std::numeric_limits<double>::min();
 }
 
 template <class M>
-double CommonSharedData<M>::GetLatestTimestamp() const {
-  return latest_timestamp_;
+void CommonSharedData<M>::RemoveStaleData() {
+  const uint64_t now = ::time(NULL);
+  bool has_change = false;
+  const int num_devices = num_devices_.load(std::memory_order_acquire);
+  for (int i = 0; i < num_devices; ++i) {
+    DeviceRing *device = devices_[i];
+    for (int j = 0; j < device->num_slots; ++j) {
+      Slot *slot = &device->slots[j];
+      const uint64_t version = slot->version.load(std::memory_order_acquire);
+      const int64_t ticks = slot->ticks.load(std::memory_order_relaxed);
+      const uint64_t added_time =
+          slot->added_time.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot->version.load(std::memory_order_relaxed) != version ||
+          ticks == kEmptyTicks) {
+        continue;
+      }
+      if (now - added_time >
+              static_cast<uint64_t>(FLAGS_shared_data_stale_time) &&
+          ClearSlot(version, slot)) {
+        has_change = true;
+      }
+    }
+  }
+  if (has_change) {
+    AINFO << "SharedData remove_stale_data name:" << name() << " stat:["
+          << GetStat().ToString() << "]";
+  }
 }
 
 template <class M>
-bool CommonSharedData<M>::Remove(const std::string &key) {
-  MutexLock lock(&mutex_);
-  const size_t num = data_map_.erase(key);
-  if (num != 1u) {
-    AWARN << "Only one element should be deleted with key: " << key
-          << ", but num: " << num;
+bool CommonSharedData<M>::Add(const CommonSharedDataKey &key,
+                              const SharedDataPtr<M> &data) {
+  DeviceRing *device = FindOrAddDevice(key.device_id);
+  if (device == nullptr) {
     return false;
   }
-
-  const size_t erase_cnt = data_added_time_map_.erase(key);
-  if (erase_cnt != 1u) {
-    AWARN << "data_added_time_map_ erase cnt:" << erase_cnt << " key:" << key;
+  const int64_t ticks = key.Ticks();
+  if (device->Find(ticks) >= 0) {
+    AWARN << "Duplicate key: " << key.ToString();
     return false;
   }
-  ++stat_.remove_cnt;
+
+  const uint64_t next =
+      device->next_slot.fetch_add(1, std::memory_order_acq_rel);
+  Slot *slot = &device->slots[next % device->num_slots];
+  const uint64_t version = LockSlot(slot);
+  if (slot->ticks.load(std::memory_order_relaxed) != kEmptyTicks) {
+    // The oldest frame of the device.
+    remove_cnt_.fetch_add(1, std::memory_order_relaxed);
+  }
+  slot->ticks.store(ticks, std::memory_order_relaxed);
+  // The oldest frame is released after the slot is unlocked.
+  SharedDataPtr<M> oldest_data = std::atomic_exchange(&slot->data, data);
+  slot->added_time.store(::time(NULL), std::memory_order_relaxed);
+  slot->version.store(version + 2, std::memory_order_release);
+
+  // update latest_timestamp for SharedData
+  latest_timestamp_ = key.timestamp;
+  add_cnt_.fetch_add(1, std::memory_order_relaxed);
   return true;
 }
 
 template <class M>
-bool CommonSharedData<M>::Remove(const CommonSharedDataKey &key) {
-  return Remove(key.ToString());
+bool CommonSharedData<M>::Get(const CommonSharedDataKey &key,
+                              SharedDataPtr<M> *data) {
+  DeviceRing *device = FindDevice(key.device_id);
+  const int64_t ticks = key.Ticks();
+  const int index = device == nullptr ? -1 : device->Find(ticks);
+  uint64_t version = 0;
+  if (index >= 0 && ReadSlot(ticks, &device->slots[index], &version, data)) {
+    get_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  AWARN << "Failed to get shared data. key: " << key.ToString();
+  return false;
 }
 
 template <class M>
-bool CommonSharedData<M>::Pop(const std::string &key, SharedDataPtr<M> *data) {
-  MutexLock lock(&mutex_);
-  auto citer = data_map_.find(key);
-  if (citer == data_map_.end()) {
-    AWARN << "Failed to get shared data. key: " << key;
-    return false;
-  }
-  *data = citer->second;
-  const size_t num = data_map_.erase(key);
-  if (num != 1u) {
-    AWARN << "Only one element should be deleted with key: " << key
-          << ", but num: " << num;
-    return false;
-  }
-  const size_t erase_cnt = data_added_time_map_.erase(key);
-  if (erase_cnt != 1u) {
-    AWARN << "data_added_time_map_ erase cnt:" << erase_cnt << " key:" << key;
+double CommonSharedData<M>::GetLatestTimestamp() const {
+  return latest_timestamp_;
+}
+
+template <class M>
+bool CommonSharedData<M>::Remove(const CommonSharedDataKey &key) {
+  DeviceRing *device = FindDevice(key.device_id);
+  const int64_t ticks = key.Ticks();
+  const int index = device == nullptr ? -1 : device->Find(ticks);
+  uint64_t version = 0;
+  SharedDataPtr<M> data;
+  if (index < 0 ||
+      !ReadSlot(ticks, &device->slots[index], &version, &data) ||
+      !ClearSlot(version, &device->slots[index])) {
+    AWARN << "Only one element should be deleted with key: "
+          << key.ToString() << ", but num: 0";
     return false;
   }
-  ++stat_.get_cnt;
-  ++stat_.remove_cnt;
   return true;
 }
 
 template <class M>
 bool CommonSharedData<M>::Pop(const CommonSharedDataKey &key,
                               SharedDataPtr<M> *data) {
-  return Pop(key.ToString(), data);
+  DeviceRing *device = FindDevice(key.device_id);
+  const int64_t ticks = key.Ticks();
+  const int index = device == nullptr ? -1 : device->Find(ticks);
+  uint64_t version = 0;
+  SharedDataPtr<M> slot_data;
+  if (index >= 0 &&
+      ReadSlot(ticks, &device->slots[index], &version, &slot_data) &&
+      ClearSlot(version, &device->slots[index])) {
+    *data = std::move(slot_data);
+    get_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  AWARN << "Failed to get shared data. key: " << key.ToString();
+  return false;
+}
+
+template <class M>
+unsigned CommonSharedData<M>::Size() const {
+  unsigned size = 0;
+  const int num_devices = num_devices_.load(std::memory_order_acquire);
+  for (int i = 0; i < num_devices; ++i) {
+    for (int j = 0; j < devices_[i]->num_slots; ++j) {
+      if (devices_[i]->slots[j].ticks.load(std::memory_order_relaxed) !=
+          kEmptyTicks) {
+        ++size;
+      }
+    }
+  }
+  return size;
 }
 
 }  // namespace perception
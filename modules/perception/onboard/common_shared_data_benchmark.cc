@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Cost of the shared data between subnodes: a frame added by the producer
+// and read by two consumers, for three devices, as in the obstacle DAG.
+// Each benchmark thread runs a DAG of its own devices on the shared data.
+//
+//   common_shared_data_benchmark [--benchmark_filter=<regex>]
+//
+// The string keyed map with one mutex, which the shared data used, is kept
+// here to compare with.
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/perception/onboard/common_shared_data.h"
+
+namespace apollo {
+namespace perception {
+namespace {
+
+std::vector<std::string> Devices(int thread_index) {
+  std::vector<std::string> devices;
+  for (const char *device : {"velodyne64_", "radar_", "camera_"}) {
+    devices.push_back(device + std::to_string(thread_index));
+  }
+  return devices;
+}
+
+class IntSharedData : public CommonSharedData<int> {
+ public:
+  std::string name() const override { return "IntSharedData"; }
+};
+
+// The string keyed shared data.
+class StringKeyedSharedData {
+ public:
+  bool Add(const CommonSharedDataKey &key, const SharedDataPtr<int> &data) {
+    const std::string key_str = key.ToString();
+    MutexLock lock(&mutex_);
+    if (!data_map_.emplace(key_str, data).second) {
+      return false;
+    }
+    data_added_time_map_.emplace(key_str, ::time(NULL));
+    ++stat_.add_cnt;
+    return true;
+  }
+
+  bool Get(const CommonSharedDataKey &key, SharedDataPtr<int> *data) {
+    const std::string key_str = key.ToString();
+    MutexLock lock(&mutex_);
+    auto iter = data_map_.find(key_str);
+    if (iter == data_map_.end()) {
+      return false;
+    }
+    *data = iter->second;
+    ++stat_.get_cnt;
+    return true;
+  }
+
+  bool Remove(const CommonSharedDataKey &key) {
+    const std::string key_str = key.ToString();
+    MutexLock lock(&mutex_);
+    data_added_time_map_.erase(key_str);
+    ++stat_.remove_cnt;
+    return data_map_.erase(key_str) == 1u;
+  }
+
+ private:
+  std::unordered_map<std::string, SharedDataPtr<int>> data_map_;
+  std::unordered_map<std::string, uint64_t> data_added_time_map_;
+  Mutex mutex_;
+  CommonSharedDataStat stat_;
+};
+
+// The shared data is kept across the runs of a benchmark, so that each run
+// starts after the frames of the previous ones.
+int64_t NextRunFrame() {
+  static std::atomic<int64_t> run(0);
+  return run.fetch_add(1) << 32;
+}
+
+// Adds a frame per device, reads each twice, and drops the frame of
+// shared_data_ring_size frames ago.
+template <class SharedDataType>
+void AddGetFrames(const std::vector<std::string> &devices, int64_t frame,
+                  SharedDataType *shared_data) {
+  const SharedDataPtr<int> value(new int(static_cast<int>(frame)));
+  SharedDataPtr<int> data;
+  for (const std::string &device_id : devices) {
+    const CommonSharedDataKey key(0.1 * frame, device_id);
+    shared_data->Add(key, value);
+    shared_data->Get(key, &data);
+    shared_data->Get(key, &data);
+  }
+  benchmark::DoNotOptimize(data);
+}
+
+void BM_StringKeyedSharedData(benchmark::State &state) {  // NOLINT
+  static StringKeyedSharedData shared_data;
+  const std::vector<std::string> devices = Devices(state.thread_index);
+  int64_t frame = NextRunFrame();
+  while (state.KeepRunning()) {
+    AddGetFrames(devices, frame, &shared_data);
+    if (frame >= FLAGS_shared_data_ring_size) {
+      for (const std::string &device_id : devices) {
+        shared_data.Remove(CommonSharedDataKey(
+            0.1 * (frame - FLAGS_shared_data_ring_size), device_id));
+      }
+    }
+    ++frame;
+  }
+  state.SetItemsProcessed(state.iterations() * devices.size());
+}
+BENCHMARK(BM_StringKeyedSharedData)->Threads(1)->Threads(4);
+
+void BM_CommonSharedData(benchmark::State &state) {  // NOLINT
+  static IntSharedData shared_data;
+  const std::vector<std::string> devices = Devices(state.thread_index);
+  int64_t frame = NextRunFrame();
+  while (state.KeepRunning()) {
+    AddGetFrames(devices, frame, &shared_data);
+    ++frame;
+  }
+  state.SetItemsProcessed(state.iterations() * devices.size());
+}
+BENCHMARK(BM_CommonSharedData)->Threads(1)->Threads(4);
+
+}  // namespace
+}  // namespace perception
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/onboard/common_shared_data.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+
+namespace {
+
+class IntSharedData : public CommonSharedData<int> {
+ public:
+  std::string name() const override { return "IntSharedData"; }
+};
+
+SharedDataPtr<int> MakeData(int value) {
+  return SharedDataPtr<int>(new int(value));
+}
+
+}  // namespace
+
+TEST(CommonSharedDataTest, AddGetRemove) {
+  IntSharedData shared_data;
+  ASSERT_TRUE(shared_data.Init());
+  EXPECT_TRUE(shared_data.Add(CommonSharedDataKey(1.0, "velodyne64"),
+                              MakeData(1)));
+  EXPECT_TRUE(shared_data.Add(CommonSharedDataKey(1.0, "radar"), MakeData(2)));
+  EXPECT_TRUE(shared_data.Add(CommonSharedDataKey(1.1, "radar"), MakeData(3)));
+  // The same ticks.
+  EXPECT_FALSE(shared_data.Add(CommonSharedDataKey(1.001, "radar"),
+                               MakeData(4)));
+  EXPECT_EQ(3, shared_data.Size());
+  EXPECT_DOUBLE_EQ(1.1, shared_data.GetLatestTimestamp());
+
+  SharedDataPtr<int> data;
+  EXPECT_TRUE(shared_data.Get(CommonSharedDataKey(1.0, "velodyne64"), &data));
+  EXPECT_EQ(1, *data);
+  EXPECT_TRUE(shared_data.Get(CommonSharedDataKey(1.0, "radar"), &data));
+  EXPECT_EQ(2, *data);
+  EXPECT_FALSE(shared_data.Get(CommonSharedDataKey(1.2, "radar"), &data));
+  EXPECT_FALSE(shared_data.Get(CommonSharedDataKey(1.0, "camera"), &data));
+
+  EXPECT_TRUE(shared_data.Pop(CommonSharedDataKey(1.1, "radar"), &data));
+  EXPECT_EQ(3, *data);
+  EXPECT_FALSE(shared_data.Get(CommonSharedDataKey(1.1, "radar"), &data));
+  EXPECT_TRUE(shared_data.Remove(CommonSharedDataKey(1.0, "radar")));
+  EXPECT_FALSE(shared_data.Remove(CommonSharedDataKey(1.0, "radar")));
+  EXPECT_EQ(1, shared_data.Size());
+
+  const CommonSharedDataStat stat = shared_data.GetStat();
+  EXPECT_EQ(3, stat.add_cnt);
+  EXPECT_EQ(3, stat.get_cnt);
+  EXPECT_EQ(2, stat.remove_cnt);
+
+  shared_data.Reset();
+  EXPECT_EQ(0, shared_data.Size());
+  EXPECT_FALSE(shared_data.Get(CommonSharedDataKey(1.0, "velodyne64"), &data));
+}
+
+TEST(CommonSharedDataTest, KeepsLatestFrames) {
+  IntSharedData shared_data;
+  ASSERT_TRUE(shared_data.Init());
+  const int num_frames = FLAGS_shared_data_ring_size + 10;
+  for (int i = 0; i < num_frames; ++i) {
+    EXPECT_TRUE(
+        shared_data.Add(CommonSharedDataKey(0.1 * i, "camera"), MakeData(i)));
+  }
+  EXPECT_EQ(FLAGS_shared_data_ring_size, shared_data.Size());
+  SharedDataPtr<int> data;
+  EXPECT_FALSE(shared_data.Get(CommonSharedDataKey(0.0, "camera"), &data));
+  EXPECT_TRUE(shared_data.Get(CommonSharedDataKey(0.1 * 10, "camera"), &data));
+  EXPECT_EQ(10, *data);
+  EXPECT_EQ(10, shared_data.GetStat().remove_cnt);
+}
+
+TEST(CommonSharedDataTest, ConcurrentDevices) {
+  IntSharedData shared_data;
+  ASSERT_TRUE(shared_data.Init());
+  const int kNumFrames = 2000;
+  std::atomic<int> misses(0);
+  std::vector<std::thread> threads;
+  for (const std::string device_id : {"velodyne64", "radar", "camera"}) {
+    threads.emplace_back([&, device_id] {
+      for (int i = 0; i < kNumFrames; ++i) {
+        shared_data.Add(CommonSharedDataKey(0.1 * i, device_id), MakeData(i));
+      }
+    });
+    threads.emplace_back([&, device_id] {
+      SharedDataPtr<int> data;
+      for (int i = 0; i < kNumFrames; ++i) {
+        if (shared_data.Get(CommonSharedDataKey(0.1 * i, device_id), &data)) {
+          EXPECT_EQ(i, *data);
+        } else {
+          ++misses;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(3 * kNumFrames, shared_data.GetStat().add_cnt);
+  EXPECT_EQ(3 * kNumFrames, shared_data.GetStat().get_cnt + misses);
+}
+
+// Adds wrap onto slots being cleared by RemoveStaleData and Remove, while
+// frames are read; a frame found must never be empty or another one.
+TEST(CommonSharedDataTest, ConcurrentAddClearGet) {
+  const int ring_size = FLAGS_shared_data_ring_size;
+  const int stale_time = FLAGS_shared_data_stale_time;
+  FLAGS_shared_data_ring_size = 4;
+  FLAGS_shared_data_stale_time = 0;
+  IntSharedData shared_data;
+  EXPECT_TRUE(shared_data.Init());
+
+  const auto end_time =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(1200);
+  std::atomic<int> next_frame(0);
+  std::atomic<bool> done(false);
+  std::atomic<int> num_found(0);
+  std::atomic<int> num_bad(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([&] {
+      while (std::chrono::steady_clock::now() < end_time) {
+        const int frame = next_frame.fetch_add(1);
+        shared_data.Add(CommonSharedDataKey(0.1 * frame, "velodyne64"),
+                        MakeData(frame));
+      }
+    });
+  }
+  threads.emplace_back([&] {
+    while (!done) {
+      shared_data.RemoveStaleData();
+    }
+  });
+  threads.emplace_back([&] {
+    while (!done) {
+      const int frame = next_frame.load() - 2;
+      shared_data.Remove(CommonSharedDataKey(0.1 * frame, "velodyne64"));
+    }
+  });
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([&] {
+      SharedDataPtr<int> data;
+      while (!done) {
+        const int frame = next_frame.load() - 1;
+        if (shared_data.Get(CommonSharedDataKey(0.1 * frame, "velodyne64"),
+                            &data)) {
+          ++num_found;
+          if (data == nullptr || *data != frame) {
+            ++num_bad;
+          }
+        }
+      }
+    });
+  }
+  threads[0].join();
+  threads[1].join();
+  done = true;
+  for (size_t i = 2; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+
+  EXPECT_GT(num_found, 0);
+  EXPECT_EQ(0, num_bad);
+  EXPECT_LE(shared_data.Size(), 4);
+  FLAGS_shared_data_ring_size = ring_size;
+  FLAGS_shared_data_stale_time = stale_time;
+}
+
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,225 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/onboard/dag_executor.h"
+
+#include <algorithm>
+#include <map>
+
+#include "modules/common/log.h"
+#include "modules/perception/onboard/subnode.h"
+
+namespace apollo {
+namespace perception {
+
+using apollo::common::ErrorCode;
+using apollo::common::Status;
+using std::map;
+using std::vector;
+
+namespace {
+
+// The longest path from the subnode to the end of the DAG. A cycle is cut
+// at the number of subnodes.
+int Rank(SubnodeID subnode_id, const map<SubnodeID, vector<SubnodeID>> &edges,
+         int depth, map<SubnodeID, int> *ranks) {
+  const auto rank_iter = ranks->find(subnode_id);
+  if (rank_iter != ranks->end()) {
+    return rank_iter->second;
+  }
+  int rank = 0;
+  const auto edge_iter = edges.find(subnode_id);
+  if (edge_iter != edges.end() && depth < static_cast<int>(edges.size())) {
+    for (const SubnodeID to_node : edge_iter->second) {
+      rank = std::max(rank, Rank(to_node, edges, depth + 1, ranks) + 1);
+    }
+  }
+  (*ranks)[subnode_id] = rank;
+  return rank;
+}
+
+}  // namespace
+
+DAGExecutor::~DAGExecutor() {
+  Stop();
+  Join();
+}
+
+bool DAGExecutor::Init(const DAGConfig &dag_config,
+                       const vector<Subnode *> &subnodes,
+                       EventManager *event_manager) {
+  CHECK(event_manager != nullptr) << "event_manager == nullptr";
+  event_manager_ = event_manager;
+
+  map<SubnodeID, int> priorities;
+  for (const auto &subnode_proto : dag_config.subnode_config().subnodes()) {
+    priorities[subnode_proto.id()] = subnode_proto.priority();
+  }
+  map<SubnodeID, vector<SubnodeID>> edges;
+  for (const auto &edge_proto : dag_config.edge_config().edges()) {
+    edges[edge_proto.from_node()].push_back(edge_proto.to_node());
+  }
+
+  map<SubnodeID, int> ranks;
+  for (Subnode *subnode : subnodes) {
+    vector<EventID> trigger_events = subnode->TriggerEvents();
+    if (trigger_events.empty()) {
+      continue;
+    }
+    std::unique_ptr<Node> node(new Node);
+    node->subnode = subnode;
+    node->priority = priorities[subnode->id()];
+    node->rank = Rank(subnode->id(), edges, 0, &ranks);
+    node->trigger_events = std::move(trigger_events);
+    for (const EventID event_id : node->trigger_events) {
+      if (!event_node_map_.emplace(event_id, node.get()).second) {
+        AERROR << "event triggers two subnodes. event_id: " << event_id;
+        return false;
+      }
+    }
+    subnode->SetExecutorDriven();
+    AINFO << "DAGExecutor drives subnode: " << subnode->name()
+          << " priority: " << node->priority << " rank: " << node->rank;
+    nodes_.push_back(std::move(node));
+  }
+  return true;
+}
+
+bool DAGExecutor::IsDriven(SubnodeID subnode_id) const {
+  for (const auto &node : nodes_) {
+    if (node->subnode->id() == subnode_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DAGExecutor::Start(int num_workers) {
+  for (int i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(new Worker(this));
+    workers_.back()->Start();
+  }
+  AINFO << "DAGExecutor start " << num_workers << " workers for "
+        << nodes_.size() << " subnodes.";
+}
+
+void DAGExecutor::Stop() {
+  MutexLock lock(&mutex_);
+  stop_ = true;
+  cond_.Signalall();
+}
+
+void DAGExecutor::CancelBlockedWorkers() {
+  for (auto &worker : workers_) {
+    if (worker->IsAlive()) {
+      AINFO << "pthread_cancel to thread " << worker->Tid();
+      pthread_cancel(worker->Tid());
+    }
+  }
+}
+
+void DAGExecutor::Join() {
+  for (auto &worker : workers_) {
+    worker->Join();
+  }
+  workers_.clear();
+}
+
+void DAGExecutor::Schedule(EventID event_id) {
+  const auto iter = event_node_map_.find(event_id);
+  if (iter == event_node_map_.end()) {
+    return;
+  }
+  Node *node = iter->second;
+  MutexLock lock(&mutex_);
+  if (stop_ || node->stopped) {
+    return;
+  }
+  if (node->state == NodeState::IDLE) {
+    Enqueue(node);
+  } else if (node->state == NodeState::RUNNING) {
+    node->rerun = true;
+  }
+}
+
+void DAGExecutor::WorkLoop() {
+  while (true) {
+    Node *node = nullptr;
+    {
+      MutexLock lock(&mutex_);
+      while (!stop_ && ready_.empty()) {
+        cond_.Wait(&mutex_);
+      }
+      if (stop_) {
+        return;
+      }
+      node = ready_.top().node;
+      ready_.pop();
+      node->state = NodeState::RUNNING;
+      node->rerun = false;
+    }
+
+    RunNode(node);
+
+    MutexLock lock(&mutex_);
+    if (!stop_ && !node->stopped && (node->rerun || HasPendingEvents(*node))) {
+      Enqueue(node);
+    } else {
+      node->state = NodeState::IDLE;
+    }
+  }
+}
+
+void DAGExecutor::RunNode(Node *node) {
+  Status status = node->subnode->ProcEvents();
+  ++node->total_count;
+  if (status.code() == ErrorCode::PERCEPTION_ERROR) {
+    ++node->failed_count;
+    AWARN << "Subnode: " << node->subnode->name() << " proc event failed. "
+          << " total_count: " << node->total_count
+          << " failed_count: " << node->failed_count;
+  } else if (status.code() == ErrorCode::PERCEPTION_FATAL) {
+    AERROR << "Subnode: " << node->subnode->name()
+           << " proc event FATAL error, EXIT. "
+           << " total_count: " << node->total_count
+           << " failed_count: " << node->failed_count;
+    MutexLock lock(&mutex_);
+    node->stopped = true;
+  }
+}
+
+void DAGExecutor::Enqueue(Node *node) {
+  Task task;
+  task.priority = node->priority;
+  task.rank = node->rank;
+  task.seq = seq_++;
+  task.node = node;
+  ready_.push(task);
+  node->state = NodeState::QUEUED;
+  cond_.Signal();
+}
+
+bool DAGExecutor::HasPendingEvents(const Node &node) const {
+  for (const EventID event_id : node.trigger_events) {
+    if (event_manager_->EventQueueLength(event_id) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace perception
+}  // namespace apollo
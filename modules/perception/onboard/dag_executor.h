@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef MODULES_PERCEPTION_ONBOARD_DAG_EXECUTOR_H_
+#define MODULES_PERCEPTION_ONBOARD_DAG_EXECUTOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/perception/onboard/proto/dag_config.pb.h"
+
+#include "modules/common/macro.h"
+#include "modules/perception/lib/base/mutex.h"
+#include "modules/perception/lib/base/thread.h"
+#include "modules/perception/onboard/event_manager.h"
+#include "modules/perception/onboard/types.h"
+
+namespace apollo {
+namespace perception {
+
+class Subnode;
+
+// Runs the ProcEvents() of the subnodes on a pool of workers, once per
+// published trigger event, instead of one thread looping per subnode.
+// A subnode runs on one worker at a time, in the order of its events. The
+// ready subnodes are run by the priority in DAGConfig first, then those
+// nearer the end of the DAG, so that a frame in flight is finished before
+// the next one is started.
+class DAGExecutor {
+ public:
+  DAGExecutor() = default;
+  ~DAGExecutor();
+
+  // Takes the subnodes with trigger events, which are then driven by the
+  // executor. Not thread-safe, call before publishing.
+  bool Init(const DAGConfig &dag_config, const std::vector<Subnode *> &subnodes,
+            EventManager *event_manager);
+
+  bool IsDriven(SubnodeID subnode_id) const;
+
+  size_t NumDrivenSubnodes() const { return nodes_.size(); }
+
+  void Start(int num_workers);
+
+  // Stops taking subnodes to run. The workers exit after their current run.
+  void Stop();
+
+  // Cancels the workers which are still blocked in a subnode after Stop().
+  void CancelBlockedWorkers();
+
+  void Join();
+
+  // Called after an event is published. thread-safe.
+  void Schedule(EventID event_id);
+
+ private:
+  enum class NodeState { IDLE, QUEUED, RUNNING };
+
+  struct Node {
+    Subnode *subnode = nullptr;
+    int priority = 0;
+    // The longest path in subnodes to the end of the DAG.
+    int rank = 0;
+    std::vector<EventID> trigger_events;
+    NodeState state = NodeState::IDLE;
+    // An event came while running.
+    bool rerun = false;
+    // Exited on a FATAL error.
+    bool stopped = false;
+    int total_count = 0;
+    int failed_count = 0;
+  };
+
+  struct Task {
+    int priority = 0;
+    int rank = 0;
+    uint64_t seq = 0;
+    Node *node = nullptr;
+
+    bool operator<(const Task &other) const {
+      if (priority != other.priority) {
+        return priority < other.priority;
+      }
+      if (rank != other.rank) {
+        return rank > other.rank;
+      }
+      return seq > other.seq;
+    }
+  };
+
+  class Worker : public Thread {
+   public:
+    explicit Worker(DAGExecutor *executor)
+        : Thread(true, "DAGExecutorWorker"), executor_(executor) {}
+
+   protected:
+    void Run() override { executor_->WorkLoop(); }
+
+   private:
+    DAGExecutor *executor_;
+  };
+
+  void WorkLoop();
+
+  // Runs ProcEvents() once, as Subnode::Run() does in its loop.
+  void RunNode(Node *node);
+
+  // Must hold mutex_.
+  void Enqueue(Node *node);
+  bool HasPendingEvents(const Node &node) const;
+
+  EventManager *event_manager_ = nullptr;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  // Read only after Init().
+  std::unordered_map<EventID, Node *> event_node_map_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  Mutex mutex_;
+  CondVar cond_;
+  std::priority_queue<Task> ready_;
+  uint64_t seq_ = 0;
+  bool stop_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(DAGExecutor);
+};
+
+}  // namespace perception
+}  // namespace apollo
+
+#endif  // MODULES_PERCEPTION_ONBOARD_DAG_EXECUTOR_H_
@@ -0,0 +1,216 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/onboard/dag_executor.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/text_format.h"
+#include "gtest/gtest.h"
+
+#include "modules/perception/onboard/proto/dag_config.pb.h"
+
+#include "modules/perception/onboard/event_manager.h"
+#include "modules/perception/onboard/shared_data_manager.h"
+#include "modules/perception/onboard/subnode.h"
+
+namespace apollo {
+namespace perception {
+
+using apollo::common::Status;
+using google::protobuf::TextFormat;
+
+namespace {
+
+// 1 -> 2 -> 3, and 4 -> 5 with a higher priority.
+const char kDAGConfig[] = R"(
+  subnode_config {
+    subnodes { id: 1 name: "Source" type: SUBNODE_IN }
+    subnodes { id: 2 name: "Middle" }
+    subnodes { id: 3 name: "Sink" type: SUBNODE_OUT }
+    subnodes { id: 4 name: "FastSource" type: SUBNODE_IN }
+    subnodes { id: 5 name: "FastSink" type: SUBNODE_OUT priority: 1 }
+  }
+  edge_config {
+    edges { id: 101 from_node: 1 to_node: 2 events { id: 1001 name: "a" } }
+    edges { id: 102 from_node: 2 to_node: 3 events { id: 1002 name: "b" } }
+    edges { id: 103 from_node: 4 to_node: 5 events { id: 1003 name: "c" } }
+  }
+  data_config {}
+)";
+
+// Records the events it runs on, and forwards them if it publishes.
+class RecordSubnode : public Subnode {
+ public:
+  RecordSubnode(std::mutex *mutex, std::vector<std::string> *records)
+      : mutex_(mutex), records_(records) {}
+
+  Status ProcEvents() override {
+    EXPECT_FALSE(running_.exchange(true)) << name_ << " runs twice at once.";
+    Event event;
+    if (!event_manager_->Subscribe(sub_meta_events_[0].event_id, &event,
+                                   executor_driven_)) {
+      running_ = false;
+      return Status(common::ErrorCode::PERCEPTION_ERROR, "no event");
+    }
+    {
+      std::lock_guard<std::mutex> lock(*mutex_);
+      records_->push_back(name_ + ":" + std::to_string(event.timestamp));
+    }
+    usleep(100);
+    if (!pub_meta_events_.empty()) {
+      event.event_id = pub_meta_events_[0].event_id;
+      event_manager_->Publish(event);
+    }
+    running_ = false;
+    return Status::OK();
+  }
+
+ private:
+  std::atomic<bool> running_{false};
+  std::mutex *mutex_;
+  std::vector<std::string> *records_;
+};
+
+class SourceSubnode : public Subnode {
+ public:
+  Status ProcEvents() override { return Status::OK(); }
+};
+
+class DAGExecutorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(TextFormat::ParseFromString(kDAGConfig, &dag_config_));
+    ASSERT_TRUE(event_manager_.Init(dag_config_.edge_config()));
+    for (const auto &subnode_proto : dag_config_.subnode_config().subnodes()) {
+      Subnode *subnode = nullptr;
+      if (subnode_proto.type() == DAGConfig::SUBNODE_IN) {
+        subnode = new SourceSubnode;
+      } else {
+        subnode = new RecordSubnode(&mutex_, &records_);
+      }
+      std::vector<EventID> sub_events;
+      std::vector<EventID> pub_events;
+      for (const auto &edge : dag_config_.edge_config().edges()) {
+        if (edge.to_node() == subnode_proto.id()) {
+          sub_events.push_back(edge.events(0).id());
+        }
+        if (edge.from_node() == subnode_proto.id()) {
+          pub_events.push_back(edge.events(0).id());
+        }
+      }
+      ASSERT_TRUE(subnode->Init(subnode_proto, sub_events, pub_events,
+                                &event_manager_, &shared_data_manager_));
+      subnodes_.emplace_back(subnode);
+    }
+    std::vector<Subnode *> subnodes;
+    for (const auto &subnode : subnodes_) {
+      subnodes.push_back(subnode.get());
+    }
+    ASSERT_TRUE(executor_.Init(dag_config_, subnodes, &event_manager_));
+    event_manager_.SetPublishCallback(
+        [this](EventID event_id) { executor_.Schedule(event_id); });
+  }
+
+  void Publish(EventID event_id, double timestamp) {
+    Event event;
+    event.event_id = event_id;
+    event.timestamp = timestamp;
+    event_manager_.Publish(event);
+  }
+
+  std::vector<std::string> WaitForRecords(size_t size) {
+    for (int i = 0; i < 1000; ++i) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (records_.size() >= size) {
+          return records_;
+        }
+      }
+      usleep(1000);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+  }
+
+  DAGConfig dag_config_;
+  EventManager event_manager_;
+  SharedDataManager shared_data_manager_;
+  std::vector<std::unique_ptr<Subnode>> subnodes_;
+  DAGExecutor executor_;
+  std::mutex mutex_;
+  std::vector<std::string> records_;
+};
+
+}  // namespace
+
+TEST_F(DAGExecutorTest, DrivesSubnodesWithTriggerEvents) {
+  EXPECT_EQ(3, executor_.NumDrivenSubnodes());
+  EXPECT_FALSE(executor_.IsDriven(1));
+  EXPECT_TRUE(executor_.IsDriven(2));
+  EXPECT_TRUE(executor_.IsDriven(3));
+  EXPECT_FALSE(executor_.IsDriven(4));
+  EXPECT_TRUE(executor_.IsDriven(5));
+}
+
+TEST_F(DAGExecutorTest, RunsEventsInOrder) {
+  executor_.Start(4);
+  const int kNumFrames = 50;
+  for (int i = 0; i < kNumFrames; ++i) {
+    Publish(1001, i);
+  }
+  const std::vector<std::string> records = WaitForRecords(2 * kNumFrames);
+  executor_.Stop();
+  executor_.Join();
+
+  ASSERT_EQ(2 * kNumFrames, records.size());
+  int middle = 0;
+  int sink = 0;
+  for (const auto &record : records) {
+    if (record.find("Middle:") == 0) {
+      EXPECT_EQ("Middle:" + std::to_string(double(middle++)), record);
+    } else {
+      EXPECT_EQ("Sink:" + std::to_string(double(sink++)), record);
+    }
+  }
+  EXPECT_EQ(kNumFrames, middle);
+  EXPECT_EQ(kNumFrames, sink);
+}
+
+TEST_F(DAGExecutorTest, RunsByPriorityThenRank) {
+  // Queued before the single worker starts.
+  Publish(1001, 0);
+  Publish(1002, 0);
+  Publish(1003, 0);
+  executor_.Start(1);
+  const std::vector<std::string> records = WaitForRecords(4);
+  executor_.Stop();
+  executor_.Join();
+
+  // The priority subnode first, then the frame in flight is finished.
+  const std::vector<std::string> expected = {
+      "FastSink:" + std::to_string(0.0), "Sink:" + std::to_string(0.0),
+      "Middle:" + std::to_string(0.0), "Sink:" + std::to_string(0.0)};
+  EXPECT_EQ(expected, records);
+}
+
+}  // namespace perception
+}  // namespace apollo
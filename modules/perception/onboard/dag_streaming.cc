@@ -31,6 +31,12 @@ using std::string;
 using std::map;
 using std::vector;
 
+DEFINE_int32(num_threads_in_dag, 4,
+             "The number of workers running the subnodes with the DAG "
+             "executor.");
+DEFINE_bool(enable_dag_executor, false,
+            "whether to run the event driven subnodes on a pool of workers, "
+            "instead of one thread per subnode.");
 DEFINE_int32(max_allowed_congestion_value, 0,
              "When DAGStreaming event_queues max length greater than "
              "max_allowed_congestion_value, reset DAGStreaming."
@@ -67,6 +73,19 @@ bool DAGStreaming::Init(const string& dag_config_path) {
     return false;
   }
 
+  if (FLAGS_enable_dag_executor) {
+    vector<Subnode*> subnodes;
+    for (auto& pair : subnode_map_) {
+      subnodes.push_back(pair.second.get());
+    }
+    if (!executor_.Init(dag_config, subnodes, &event_manager_)) {
+      AERROR << "failed to Init DAGExecutor. file: " << dag_config_path;
+      return false;
+    }
+    event_manager_.SetPublishCallback(
+        [this](EventID event_id) { executor_.Schedule(event_id); });
+  }
+
   inited_ = true;
   AINFO << "DAGStreaming Init success.";
   return true;
@@ -74,16 +93,24 @@ bool DAGStreaming::Init(const string& dag_config_path) {
 
 void DAGStreaming::Schedule() {
   monitor_->Start();
-  // start all subnodes.
+  if (executor_.NumDrivenSubnodes() > 0) {
+    executor_.Start(FLAGS_num_threads_in_dag);
+  }
+  // start all subnodes, but the ones driven by the executor.
   for (auto& pair : subnode_map_) {
-    pair.second->Start();
+    if (!executor_.IsDriven(pair.first)) {
+      pair.second->Start();
+    }
   }
 
   AINFO << "DAGStreaming start to schedule...";
 
   for (auto& pair : subnode_map_) {
-    pair.second->Join();
+    if (!executor_.IsDriven(pair.first)) {
+      pair.second->Join();
+    }
   }
+  executor_.Join();
 
   monitor_->Join();
   AINFO << "DAGStreaming schedule exit.";
@@ -95,6 +122,7 @@ void DAGStreaming::Stop() {
   for (auto& pair : subnode_map_) {
     pair.second->Stop();
   }
+  executor_.Stop();
 
   // sleep 100 ms
   usleep(100000);
@@ -105,6 +133,7 @@ void DAGStreaming::Stop() {
       pthread_cancel(pair.second->Tid());
     }
   }
+  executor_.CancelBlockedWorkers();
 
   AINFO << "DAGStreaming is stoped.";
 }
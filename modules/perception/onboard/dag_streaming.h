@@ -28,6 +28,7 @@
 
 #include "modules/common/macro.h"
 #include "modules/perception/lib/base/thread.h"
+#include "modules/perception/onboard/dag_executor.h"
 #include "modules/perception/onboard/event_manager.h"
 #include "modules/perception/onboard/shared_data_manager.h"
 
@@ -35,6 +36,7 @@ namespace apollo {
 namespace perception {
 
 DECLARE_int32(num_threads_in_dag);
+DECLARE_bool(enable_dag_executor);
 DECLARE_int32(max_allowed_congestion_value);
 DECLARE_bool(enable_timing_remove_stale_data);
 
@@ -75,6 +77,7 @@ class DAGStreaming : public Thread {
 
   EventManager event_manager_;
   SharedDataManager shared_data_manager_;
+  DAGExecutor executor_;
   bool inited_ = false;
   std::unique_ptr<DAGStreamingMonitor> monitor_;
   // NOTE(Yangguang Li): Guarantee Sunode should be firstly called destructor.
@@ -77,6 +77,9 @@ bool EventManager::Publish(const Event &event) {
     // try second time.
     queue->try_push(event);
   }
+  if (publish_callback_) {
+    publish_callback_(event.event_id);
+  }
   return true;
 }
 
@@ -167,6 +170,14 @@ int EventManager::AvgLenOfEventQueues() const {
   return total_length / event_queue_map_.size();
 }
 
+int EventManager::EventQueueLength(EventID event_id) const {
+  EventQueueMapConstIterator citer = event_queue_map_.find(event_id);
+  if (citer == event_queue_map_.end()) {
+    return 0;
+  }
+  return citer->second->size();
+}
+
 int EventManager::MaxLenOfEventQueues() const {
   int max_length = 0;
   for (const auto &event : event_queue_map_) {
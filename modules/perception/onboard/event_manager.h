@@ -17,10 +17,12 @@
 #ifndef MODULES_PERCEPTION_ONBOARD_EVENT_MANAGER_H_
 #define MODULES_PERCEPTION_ONBOARD_EVENT_MANAGER_H_
 
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "modules/perception/onboard/proto/dag_config.pb.h"
@@ -51,6 +53,15 @@ class EventManager {
   // clear all the event queues.
   void Reset();
 
+  // called after an event is published, with its id.
+  // not thread-safe, set before publishing.
+  void SetPublishCallback(std::function<void(EventID)> callback) {
+    publish_callback_ = std::move(callback);
+  }
+
+  // thread-safe.
+  int EventQueueLength(EventID event_id) const;
+
   int AvgLenOfEventQueues() const;
 
   int MaxLenOfEventQueues() const;
@@ -83,6 +94,7 @@ class EventManager {
   // for debug.
   EventMetaMap event_meta_map_;
   bool inited_ = false;
+  std::function<void(EventID)> publish_callback_;
 
   DISALLOW_COPY_AND_ASSIGN(EventManager);
 };
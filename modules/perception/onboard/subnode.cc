@@ -101,6 +101,14 @@ void Subnode::Run() {
   }
 }
 
+vector<EventID> Subnode::TriggerEvents() const {
+  vector<EventID> event_ids;
+  if (type_ != DAGConfig::SUBNODE_IN && sub_meta_events_.size() == 1u) {
+    event_ids.push_back(sub_meta_events_[0].event_id);
+  }
+  return event_ids;
+}
+
 string Subnode::DebugString() const {
   ostringstream oss;
   oss << "{id: " << id_ << ", name: " << name_ << ", reserve: " << reserve_
@@ -125,7 +133,8 @@ Status CommonSubnode::ProcEvents() {
   CHECK(pub_meta_events_.size() == 1u) << "CommonSubnode pub_meta_events == 1";
 
   Event sub_event;
-  if (!event_manager_->Subscribe(sub_meta_events_[0].event_id, &sub_event)) {
+  if (!event_manager_->Subscribe(sub_meta_events_[0].event_id, &sub_event,
+                                 executor_driven_)) {
     AERROR << "failed to subscribe. meta_event: <"
            << sub_meta_events_[0].to_string() << ">";
     return Status(ErrorCode::PERCEPTION_ERROR, "Failed to subscribe event.");
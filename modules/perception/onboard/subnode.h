@@ -70,6 +70,15 @@ class Subnode : public Thread {
 
   virtual std::string DebugString() const;
 
+  // @brief The events on which the DAG executor runs ProcEvents() once. As
+  //        it holds a worker, ProcEvents() must not wait for other events
+  //        then. Subnodes without trigger events keep their own thread.
+  //        By default, the only event a subnode subscribes, if so.
+  // @return event ids
+  virtual std::vector<EventID> TriggerEvents() const;
+
+  void SetExecutorDriven() { executor_driven_ = true; }
+
  protected:
   // @brief init the inner members ( default do nothing )
   // @return true/false
@@ -92,6 +101,10 @@ class Subnode : public Thread {
   std::vector<EventMeta> sub_meta_events_;
   std::vector<EventMeta> pub_meta_events_;
 
+  // Whether ProcEvents() is run by the DAG executor on trigger events,
+  // instead of in a loop by the own thread.
+  bool executor_driven_ = false;
+
  private:
   volatile bool stop_ = false;
   bool inited_ = false;
@@ -16,6 +16,10 @@
 
 #include "modules/perception/traffic_light/base/image.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "cv_bridge/cv_bridge.h"
 
 #include "modules/common/log.h"
@@ -75,6 +79,45 @@ bool Image::GenerateMat() {
   }
   return true;
 }
+bool Image::GenerateMat(const cv::Rect &roi) {
+  if (contain_mat_) {
+    return true;
+  }
+  if (image_data_->encoding.compare("yuyv") != 0) {
+    return GenerateMat();
+  }
+  const int width = image_data_->width;
+  const int height = image_data_->height;
+  // Yuyv2rgb converts the pixels in blocks, widen the roi to whole blocks so
+  // that the pixels in it are decoded as in the whole image.
+  const int kBlockPixels = 64;
+  const cv::Rect region = roi & cv::Rect(0, 0, width, height);
+  const int x_begin = region.x / kBlockPixels * kBlockPixels;
+  const int x_end =
+      std::min(width, (region.x + region.width + kBlockPixels - 1) /
+                          kBlockPixels * kBlockPixels);
+  const int row_pixels = x_end - x_begin;
+  const int block_pixels =
+      (row_pixels + kBlockPixels - 1) / kBlockPixels * kBlockPixels;
+
+  mat_ = cv::Mat::zeros(height, width, CV_8UC3);
+  std::vector<unsigned char> yuv(block_pixels * 2, 0);
+  std::vector<unsigned char> rgb(block_pixels * 3);
+  cv::Mat rgb_row(1, row_pixels, CV_8UC3, rgb.data());
+  for (int y = region.y; y < region.y + region.height; ++y) {
+    std::memcpy(yuv.data(),
+                &image_data_->data[y * image_data_->step + x_begin * 2],
+                row_pixels * 2);
+    Yuyv2rgb(yuv.data(), rgb.data(), block_pixels);
+    cv::Mat bgr_row = mat_(cv::Rect(x_begin, y, row_pixels, 1));
+    cv::cvtColor(rgb_row, bgr_row, CV_RGB2BGR);
+  }
+
+  contain_mat_ = true;
+  AINFO << "Generate done " << region << " of " << mat_.size();
+  return true;
+}
+
 const cv::Mat &Image::mat() const { return mat_; }
 
 cv::Size Image::size() const {
@@ -118,6 +118,12 @@ class Image {
    */
   bool GenerateMat();
 
+  /**
+   * @brief generate cv::Mat from the image data inside roi only, the rest of
+   *        the image is left black
+   */
+  bool GenerateMat(const cv::Rect &roi);
+
  private:
   bool contain_image_ = false;
   bool contain_mat_ = false;
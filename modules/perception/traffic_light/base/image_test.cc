@@ -60,6 +60,33 @@ TEST_F(ImageTest, test_all) {
   ASSERT_TRUE(image_->Init(timestamp, cam_id, img));
   EXPECT_EQ("unkown camera", image_->camera_id_str());
 }
+
+TEST_F(ImageTest, generate_mat_roi) {
+  const int width = 256;
+  const int height = 16;
+  boost::shared_ptr<sensor_msgs::Image> msg(new sensor_msgs::Image);
+  msg->encoding = "yuyv";
+  msg->width = width;
+  msg->height = height;
+  msg->step = width * 2;
+  msg->data.resize(msg->step * height);
+  for (size_t i = 0; i < msg->data.size(); ++i) {
+    msg->data[i] = static_cast<uint8_t>(i * 37 % 251);
+  }
+
+  Image whole;
+  ASSERT_TRUE(whole.Init(0.0, CameraId::LONG_FOCUS, msg));
+  ASSERT_TRUE(whole.GenerateMat());
+
+  const cv::Rect roi(70, 3, 50, 9);
+  ASSERT_TRUE(image_->Init(0.0, CameraId::LONG_FOCUS, msg));
+  ASSERT_TRUE(image_->GenerateMat(roi));
+  ASSERT_TRUE(image_->contain_mat());
+  ASSERT_EQ(whole.mat().size(), image_->mat().size());
+  EXPECT_EQ(0, cv::norm(whole.mat()(roi), image_->mat()(roi), cv::NORM_INF));
+  EXPECT_EQ(0, cv::countNonZero(image_->mat()(cv::Rect(0, 0, width, 3))
+                                    .reshape(1)));
+}
 }  // namespace traffic_light
 }  // namespace perception
 }  // namespace apollo
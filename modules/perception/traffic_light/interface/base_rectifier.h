@@ -57,6 +57,19 @@ class BaseRectifier {
   virtual bool Rectify(const Image &image, const RectifyOption &option,
                        std::vector<LightPtr> *lights) = 0;
 
+  /**
+   * @brief: region of the image Rectify() and the recognizer read for the
+   *         given lights, the whole image by default.
+   * @param  const cv::Size&: image size
+   * @param  Lights from projection
+   * @param  region
+   */
+  virtual void GetImageRegion(const cv::Size &size,
+                              const std::vector<LightPtr> &lights,
+                              cv::Rect *region) {
+    *region = cv::Rect(0, 0, size.width, size.height);
+  }
+
   /**
    * @brief name
    */
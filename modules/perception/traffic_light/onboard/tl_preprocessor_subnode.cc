@@ -107,13 +107,7 @@ bool TLPreprocessorSubnode::AddDataAndPublishEvent(
     double timestamp) {
   // add data down-stream
   std::string device_str = kCameraIdToStr.at(camera_id);
-  std::string key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_str, &key)) {
-    AERROR << "TLPreprocessorSubnode gen share data key failed. ts:"
-           << GLOG_TIMESTAMP(timestamp);
-    return false;
-  }
-
+  const CommonSharedDataKey key(timestamp, device_str);
   if (!preprocessing_data_->Add(key, data)) {
     AERROR << "TLPreprocessorSubnode push data into shared_data failed.";
     data->image.reset();
@@ -192,13 +192,7 @@ bool TLProcSubnode::ProcEvent(const Event &event) {
   const std::string device_id = event.reserve;
 
   AINFO << "Detect Start ts:" << GLOG_TIMESTAMP(timestamp);
-  std::string key;
-  if (!SubnodeHelper::ProduceSharedDataKey(timestamp, device_id, &key)) {
-    AERROR << "TLProcSubnode produce_shared_data_key failed."
-           << " ts:" << timestamp << " device_id:" << device_id;
-    return false;
-  }
-
+  const CommonSharedDataKey key(timestamp, device_id);
   SharedDataPtr<ImageLights> image_lights;
   if (!preprocessing_data_->Get(key, &image_lights)) {
     AERROR << "TLProcSubnode failed to get shared data,"
@@ -228,10 +222,22 @@ bool TLProcSubnode::ProcEvent(const Event &event) {
     return false;
   }
 
-  if (!image_lights->image->GenerateMat()) {
+  // decode the image, or only the region the rectifier crops
+  const double before_decode_ts = TimeUtil::GetCurrentTime();
+  bool decoded = false;
+  if (FLAGS_traffic_light_decode_roi_only) {
+    cv::Rect region;
+    rectifier_->GetImageRegion(image_lights->image->size(),
+                               *(image_lights->lights), &region);
+    decoded = image_lights->image->GenerateMat(region);
+  } else {
+    decoded = image_lights->image->GenerateMat();
+  }
+  if (!decoded) {
     AERROR << "TLProcSubnode failed to generate mat";
     return false;
   }
+  const double decode_latency = TimeUtil::GetCurrentTime() - before_decode_ts;
   // using rectifier to rectify the region.
   const double before_rectify_ts = TimeUtil::GetCurrentTime();
   if (!rectifier_->Rectify(*(image_lights->image), rectify_option,
@@ -281,6 +287,7 @@ bool TLProcSubnode::ProcEvent(const Event &event) {
         << " msg_ts: " << GLOG_TIMESTAMP(timestamp)
         << " from device_id: " << device_id << " get "
         << image_lights->lights->size() << " lights."
+        << " decode_latency: " << decode_latency * 1000 << " ms."
         << " detection_latency: " << detection_latency * 1000 << " ms."
         << " recognization_latency: " << recognization_latency * 1000 << " ms."
         << " revise_latency: " << revise_latency * 1000 << " ms."
@@ -590,7 +597,8 @@ bool TLProcSubnode::PublishMessage(
 Status TLProcSubnode::ProcEvents() {
   Event event;
   const EventMeta &event_meta = sub_meta_events_[0];
-  if (!event_manager_->Subscribe(event_meta.event_id, &event)) {
+  if (!event_manager_->Subscribe(event_meta.event_id, &event,
+                                 executor_driven_)) {
     AERROR << "Failed to subscribe event: " << event_meta.event_id;
     return Status(ErrorCode::PERCEPTION_ERROR, "Failed to subscribe event.");
   }
@@ -84,6 +84,9 @@ bool TLPreprocessor::CacheLightsProjections(const CarPose &pose,
     light_ptrs.reset(new LightPtrs);
   }
   if (signals.size() > 0) {
+    const double before_projection_ts = TimeUtil::GetCurrentTime();
+    const size_t cache_hits = projection_.cache_hits();
+    const size_t cache_misses = projection_.cache_misses();
     // project light region on each camera's image plane
     for (int cam_id = 0; cam_id < kCountCameraId; ++cam_id) {
       if (!ProjectLights(pose, signals, static_cast<CameraId>(cam_id),
@@ -99,6 +102,12 @@ bool TLPreprocessor::CacheLightsProjections(const CarPose &pose,
       }
     }
 
+    AINFO << "projection_latency: "
+          << (TimeUtil::GetCurrentTime() - before_projection_ts) * 1000
+          << " ms. projection cache hits: "
+          << projection_.cache_hits() - cache_hits
+          << " misses: " << projection_.cache_misses() - cache_misses;
+
     // select which image to be used
     SelectImage(pose, lights_on_image, lights_outside_image,
                 &(image_lights->camera_id));
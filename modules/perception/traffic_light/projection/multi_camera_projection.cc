@@ -15,12 +15,16 @@
  *****************************************************************************/
 #include "modules/perception/traffic_light/projection/multi_camera_projection.h"
 
+#include <algorithm>
+#include <cmath>
 #include <unordered_map>
+#include <utility>
 
 #include "Eigen/Core"
 #include "Eigen/Dense"
 
 #include "modules/common/util/file.h"
+#include "modules/perception/common/perception_gflags.h"
 #include "modules/perception/traffic_light/base/tl_shared_data.h"
 
 namespace apollo {
@@ -29,6 +33,23 @@ namespace traffic_light {
 
 using apollo::common::util::GetProtoFromFile;
 
+namespace {
+
+// Projections of the signals passed by long ago are dropped past this size.
+const size_t kMaxCachedProjections = 256;
+
+void SignalBoundary(const apollo::hdmap::Signal &signal,
+                    std::vector<double> *boundary) {
+  boundary->clear();
+  for (const auto &point : signal.boundary().point()) {
+    boundary->push_back(point.x());
+    boundary->push_back(point.y());
+    boundary->push_back(point.z());
+  }
+}
+
+}  // namespace
+
 bool MultiCamerasProjection::Init() {
   if (!GetProtoFromFile(FLAGS_traffic_light_multi_camera_projection_config,
                         &config_)) {
@@ -81,6 +102,10 @@ bool MultiCamerasProjection::Init() {
       camera_coeffient_[kShortFocusIdx].camera_extrinsic;
   AINFO << "Lidar to long(25mm): ";
   AINFO << camera_coeffient_[kLongFocusIdx].camera_extrinsic;
+
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  projection_cache_.clear();
+  projection_cache_.resize(kCountCameraId);
   return true;
 }
 
@@ -97,14 +122,70 @@ bool MultiCamerasProjection::Project(const CarPose &pose,
     return false;
   }
   AINFO << "Begin project camera: " << option.camera_id;
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto &cache = projection_cache_[camera_id];
+  std::vector<double> boundary;
+  SignalBoundary(tl_info, &boundary);
+  auto cached = cache.find(tl_info.id().id());
+  if (cached != cache.end() && cached->second.boundary == boundary &&
+      IsPoseClose(mpose, cached->second.pose)) {
+    ++cache_hits_;
+    if (cached->second.on_image) {
+      light->region.projection_roi = cached->second.projection_roi;
+    }
+    return cached->second.on_image;
+  }
+  ++cache_misses_;
+
   bool ret =
       projection_->Project(camera_coeffient_[camera_id], mpose, tl_info, light);
   if (!ret) {
     AWARN << "Projection failed projection the traffic light. "
           << "camera_id: " << camera_id;
   }
+
+  if (cached == cache.end() && cache.size() >= kMaxCachedProjections) {
+    cache.clear();
+  }
+  CachedProjection &entry = cache[tl_info.id().id()];
+  entry.pose = mpose;
+  entry.boundary = std::move(boundary);
+  entry.projection_roi = light->region.projection_roi;
+  entry.on_image = ret;
   return ret;
 }
+
+size_t MultiCamerasProjection::cache_hits() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_hits_;
+}
+
+size_t MultiCamerasProjection::cache_misses() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_misses_;
+}
+
+bool MultiCamerasProjection::IsPoseClose(
+    const Eigen::Matrix4d &pose, const Eigen::Matrix4d &cached_pose) const {
+  const double max_translation =
+      FLAGS_traffic_light_projection_cache_translation;
+  const double max_rotation = FLAGS_traffic_light_projection_cache_rotation;
+  if (max_translation <= 0.0 && max_rotation <= 0.0) {
+    return pose == cached_pose;
+  }
+  const double translation =
+      (pose.block<3, 1>(0, 3) - cached_pose.block<3, 1>(0, 3)).norm();
+  if (translation > max_translation) {
+    return false;
+  }
+  // angle of the relative rotation
+  const double cos_angle =
+      ((pose.block<3, 3>(0, 0).transpose() * cached_pose.block<3, 3>(0, 0))
+           .trace() -
+       1.0) /
+      2.0;
+  return std::acos(std::max(-1.0, std::min(1.0, cos_angle))) <= max_rotation;
+}
 }  // namespace traffic_light
 }  // namespace perception
 }  // namespace apollo
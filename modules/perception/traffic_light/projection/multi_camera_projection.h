@@ -18,9 +18,13 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "Eigen/Core"
+
 #include "modules/perception/proto/traffic_light/multi_camera_projection_config.pb.h"
 
 #include "modules/perception/traffic_light/interface/base_projection.h"
@@ -29,6 +33,10 @@ namespace apollo {
 namespace perception {
 namespace traffic_light {
 // @brief 2 Camera Projection project the Light into the image.
+//        The projection of each signal on each camera is cached with the
+//        pose it was computed at, and reused while the car stays within
+//        FLAGS_traffic_light_projection_cache_translation and
+//        FLAGS_traffic_light_projection_cache_rotation of that pose.
 class MultiCamerasProjection {
  public:
   MultiCamerasProjection() = default;
@@ -39,11 +47,32 @@ class MultiCamerasProjection {
                        Light *light) const;
   std::string name() const { return "TLPreprocessor"; }
 
+  // @brief number of projections served from / missed in the cache
+  size_t cache_hits() const;
+  size_t cache_misses() const;
+
  private:
+  struct CachedProjection {
+    Eigen::Matrix4d pose;
+    std::vector<double> boundary;
+    cv::Rect projection_roi;
+    bool on_image = false;
+  };
+
+  bool IsPoseClose(const Eigen::Matrix4d &pose,
+                   const Eigen::Matrix4d &cached_pose) const;
+
   std::vector<CameraCoeffient> camera_coeffient_;
   std::vector<std::string> camera_names_;
   std::unique_ptr<BaseProjection> projection_;
 
+  // signal id -> cached projection, for each camera
+  mutable std::vector<std::unordered_map<std::string, CachedProjection>>
+      projection_cache_;
+  mutable size_t cache_hits_ = 0;
+  mutable size_t cache_misses_ = 0;
+  mutable std::mutex cache_mutex_;
+
   traffic_light::multi_camera_projection_config::ModelConfigs config_;
 };
 
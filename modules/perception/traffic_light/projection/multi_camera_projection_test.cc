@@ -15,6 +15,8 @@
  *****************************************************************************/
 #include "modules/perception/traffic_light/projection/multi_camera_projection.h"
 
+#include <utility>
+
 #include "gtest/gtest.h"
 
 #include "modules/perception/traffic_light/projection/projection.h"
@@ -29,6 +31,51 @@ TEST(MultiCameraProjectionTest, load_proto) {
   EXPECT_TRUE(mc_projection.Init());
 }
 
+TEST(MultiCameraProjectionTest, cache_projection) {
+  RegisterFactoryBoundaryProjection();
+  MultiCamerasProjection mc_projection;
+  ASSERT_TRUE(mc_projection.Init());
+
+  Light light;
+  light.info.mutable_id()->set_id("signal_0");
+  for (const auto &xy : {std::make_pair(-0.3, 0.0), std::make_pair(0.3, 0.0),
+                         std::make_pair(0.3, 1.0), std::make_pair(-0.3, 1.0)}) {
+    auto *point = light.info.mutable_boundary()->add_point();
+    point->set_x(xy.first);
+    point->set_y(50.0);
+    point->set_z(5.0 + xy.second);
+  }
+  CarPose pose;
+  pose.set_pose(Eigen::Matrix4d::Identity());
+  const ProjectOption option(CameraId::SHORT_FOCUS);
+
+  const bool on_image = mc_projection.Project(pose, option, &light);
+  const cv::Rect projection_roi = light.region.projection_roi;
+  EXPECT_EQ(0u, mc_projection.cache_hits());
+  EXPECT_EQ(1u, mc_projection.cache_misses());
+
+  // the same signal on the same pose
+  Light cached_light;
+  cached_light.info = light.info;
+  EXPECT_EQ(on_image, mc_projection.Project(pose, option, &cached_light));
+  EXPECT_EQ(projection_roi, cached_light.region.projection_roi);
+  EXPECT_EQ(1u, mc_projection.cache_hits());
+
+  // the car moved
+  Eigen::Matrix4d moved = Eigen::Matrix4d::Identity();
+  moved(1, 3) = 1.0;
+  pose.set_pose(moved);
+  mc_projection.Project(pose, option, &cached_light);
+  EXPECT_EQ(1u, mc_projection.cache_hits());
+  EXPECT_EQ(2u, mc_projection.cache_misses());
+
+  // the signal changed in the map
+  light.info.mutable_boundary()->mutable_point(0)->set_z(4.0);
+  mc_projection.Project(pose, option, &light);
+  EXPECT_EQ(1u, mc_projection.cache_hits());
+  EXPECT_EQ(3u, mc_projection.cache_misses());
+}
+
 }  // namespace traffic_light
 }  // namespace perception
 }  // namespace apollo
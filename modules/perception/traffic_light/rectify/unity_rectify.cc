@@ -125,6 +125,12 @@ bool UnityRectify::Rectify(const Image &image, const RectifyOption &option,
   return true;
 }
 
+void UnityRectify::GetImageRegion(const cv::Size &size,
+                                  const std::vector<LightPtr> &lights,
+                                  cv::Rect *region) {
+  crop_->GetCropBox(size, lights, region);
+}
+
 std::string UnityRectify::name() const { return "UnityRectify"; }
 
 }  // namespace traffic_light
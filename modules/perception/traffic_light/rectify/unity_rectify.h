@@ -52,6 +52,13 @@ class UnityRectify : public BaseRectifier {
   bool Rectify(const Image &image, const RectifyOption &option,
                std::vector<LightPtr> *lights) override;
 
+  /**
+   * @brief: the crop box of the lights, detection and recognition stay
+   *         inside it
+   */
+  void GetImageRegion(const cv::Size &size, const std::vector<LightPtr> &lights,
+                      cv::Rect *region) override;
+
   std::string name() const override;
 
  private:
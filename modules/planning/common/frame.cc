@@ -22,11 +22,14 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <string>
 #include <utility>
 
+#include "boost/make_shared.hpp"
+
 #include "modules/routing/proto/routing.pb.h"
 
 #include "modules/common/adapters/adapter_manager.h"
@@ -186,7 +189,8 @@ bool Frame::CreateReferenceLineInfo() {
       is_near_destination_ = true;
     }
     reference_line_info_.emplace_back(vehicle_state_, planning_start_point_,
-                                      *ref_line_iter, *segments_iter);
+                                      std::move(*ref_line_iter),
+                                      std::move(*segments_iter));
     ++ref_line_iter;
     ++segments_iter;
   }
@@ -362,17 +366,9 @@ Status Frame::Init() {
   // prediction
   if (AdapterManager::GetPrediction() &&
       !AdapterManager::GetPrediction()->Empty()) {
-    if (FLAGS_enable_lag_prediction && lag_predictor_) {
-      lag_predictor_->GetLaggedPrediction(&prediction_);
-    } else {
-      prediction_.CopyFrom(
-          AdapterManager::GetPrediction()->GetLatestObserved());
-    }
-    if (FLAGS_align_prediction_time) {
-      AlignPredictionTime(vehicle_state_.timestamp(), &prediction_);
-    }
-    for (auto &ptr : Obstacle::CreateObstacles(prediction_)) {
-      AddObstacle(*ptr);
+    prediction_ = CreatePrediction();
+    for (auto &ptr : Obstacle::CreateObstacles(*prediction_)) {
+      AddObstacle(std::move(*ptr));
     }
   }
   if (FLAGS_enable_collision_detection) {
@@ -394,6 +390,44 @@ Status Frame::Init() {
   return Status::OK();
 }
 
+boost::shared_ptr<const PredictionObstacles> Frame::CreatePrediction() {
+  const auto &prediction = *AdapterManager::GetPrediction();
+  const bool use_lag_prediction = FLAGS_enable_lag_prediction && lag_predictor_;
+  if (!use_lag_prediction && !FLAGS_align_prediction_time) {
+    // observed messages are immutable, no need to copy
+    return prediction.GetLatestObservedPtr();
+  }
+
+  if (use_lag_prediction && !FLAGS_align_prediction_time) {
+    prediction_source_.latest = prediction.GetLatestObservedPtr();
+    prediction_source_.history_size =
+        std::distance(prediction.begin(), prediction.end());
+    prediction_source_.has_localization =
+        AdapterManager::GetLocalization() &&
+        !AdapterManager::GetLocalization()->Empty();
+    prediction_source_.protected_ids = lag_predictor_->ProtectedObstacleIds();
+    const auto *last_frame = FrameHistory::instance()->Latest();
+    if (last_frame && last_frame->prediction_ &&
+        last_frame->prediction_source_ == prediction_source_) {
+      ADEBUG << "Share lagged prediction with frame "
+             << last_frame->SequenceNum();
+      return last_frame->prediction_;
+    }
+  }
+
+  auto result = boost::make_shared<PredictionObstacles>();
+  if (use_lag_prediction) {
+    lag_predictor_->GetLaggedPrediction(result.get());
+  } else {
+    result->CopyFrom(prediction.GetLatestObserved());
+  }
+  if (FLAGS_align_prediction_time) {
+    // aligned relative time depends on the start time of this frame
+    AlignPredictionTime(vehicle_state_.timestamp(), result.get());
+  }
+  return result;
+}
+
 const Obstacle *Frame::FindCollisionObstacle() const {
   if (obstacles_.Items().empty()) {
     return nullptr;
@@ -470,7 +504,10 @@ void Frame::RecordInputDebug(planning_internal::Debug *debug) {
         AdapterManager::GetRoutingResponse()->GetLatestObserved());
   }
 
-  planning_data->mutable_prediction_header()->CopyFrom(prediction_.header());
+  auto *prediction_header = planning_data->mutable_prediction_header();
+  if (prediction_) {
+    prediction_header->CopyFrom(prediction_->header());
+  }
 
   auto relative_map = AdapterManager::GetRelativeMap();
   if (!relative_map->Empty()) {
@@ -513,6 +550,11 @@ void Frame::AddObstacle(const Obstacle &obstacle) {
   obstacles_.Add(obstacle.Id(), obstacle);
 }
 
+void Frame::AddObstacle(Obstacle &&obstacle) {
+  const std::string id = obstacle.Id();
+  obstacles_.Add(id, std::move(obstacle));
+}
+
 const ReferenceLineInfo *Frame::FindDriveReferenceLineInfo() {
   double min_cost = std::numeric_limits<double>::infinity();
   drive_reference_line_info_ = nullptr;
@@ -28,6 +28,8 @@
 #include <string>
 #include <vector>
 
+#include "boost/shared_ptr.hpp"
+
 #include "modules/common/proto/geometry.pb.h"
 #include "modules/common/vehicle_state/proto/vehicle_state.pb.h"
 #include "modules/localization/proto/pose.pb.h"
@@ -137,6 +139,32 @@ class Frame {
                                               const common::math::Box2d &box);
 
   void AddObstacle(const Obstacle &obstacle);
+  void AddObstacle(Obstacle &&obstacle);
+
+  /**
+   * @brief build the prediction of this frame. The latest prediction message
+   * is shared as is when no post processing is enabled, and a lagged
+   * prediction is shared with the previous frame when its inputs are
+   * unchanged.
+   */
+  boost::shared_ptr<const prediction::PredictionObstacles> CreatePrediction();
+
+  /**
+   * @brief the inputs a lagged prediction is built from.
+   */
+  struct PredictionSource {
+    boost::shared_ptr<const prediction::PredictionObstacles> latest;
+    std::size_t history_size = 0;
+    bool has_localization = false;
+    std::vector<int> protected_ids;
+
+    bool operator==(const PredictionSource &other) const {
+      return latest && latest == other.latest &&
+             history_size == other.history_size &&
+             has_localization == other.has_localization &&
+             protected_ids == other.protected_ids;
+    }
+  };
 
  private:
   uint32_t sequence_num_ = 0;
@@ -152,7 +180,8 @@ class Frame {
    **/
   const ReferenceLineInfo *drive_reference_line_info_ = nullptr;
 
-  prediction::PredictionObstacles prediction_;
+  boost::shared_ptr<const prediction::PredictionObstacles> prediction_;
+  PredictionSource prediction_source_;
   ThreadSafeIndexedObstacles obstacles_;
   ChangeLaneDecider change_lane_decider_;
   ADCTrajectory trajectory_;  // last published trajectory
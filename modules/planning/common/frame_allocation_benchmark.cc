@@ -0,0 +1,221 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of the per-cycle heap allocations of Frame::Init: the
+ * prediction and obstacle table, and the reference line infos. The label of
+ * each run reports the allocation count and bytes per cycle.
+ **/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <list>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "boost/make_shared.hpp"
+#include "boost/shared_ptr.hpp"
+
+#include "modules/planning/common/obstacle.h"
+#include "modules/planning/common/reference_line_info.h"
+#include "modules/planning/reference_line/reference_line.h"
+
+namespace {
+
+std::atomic<std::size_t> num_allocations(0);
+std::atomic<std::size_t> num_allocated_bytes(0);
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++num_allocations;
+  num_allocated_bytes += size;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+namespace apollo {
+namespace planning {
+namespace {
+
+using apollo::prediction::PredictionObstacles;
+
+constexpr int kNumTrajectoryPoints = 80;
+constexpr double kReferenceLineLength = 250.0;
+constexpr double kReferenceLineResolution = 0.5;
+
+class AllocationCounter {
+ public:
+  AllocationCounter()
+      : allocations_(num_allocations), bytes_(num_allocated_bytes) {}
+
+  void Report(benchmark::State* state) const {
+    const std::size_t cycles =
+        std::max<std::size_t>(1, static_cast<std::size_t>(state->iterations()));
+    state->SetLabel(
+        "allocs/cycle=" +
+        std::to_string((num_allocations - allocations_) / cycles) +
+        " bytes/cycle=" +
+        std::to_string((num_allocated_bytes - bytes_) / cycles));
+  }
+
+ private:
+  const std::size_t allocations_;
+  const std::size_t bytes_;
+};
+
+boost::shared_ptr<const PredictionObstacles> MakePrediction(
+    const int num_obstacles) {
+  auto prediction = boost::make_shared<PredictionObstacles>();
+  prediction->mutable_header()->set_timestamp_sec(1.0);
+  for (int i = 0; i < num_obstacles; ++i) {
+    auto* obstacle = prediction->add_prediction_obstacle();
+    auto* perception = obstacle->mutable_perception_obstacle();
+    perception->set_id(i);
+    perception->mutable_position()->set_x(5.0 * i);
+    perception->mutable_position()->set_y(3.5 * (i % 3));
+    perception->set_theta(0.0);
+    perception->set_length(4.5);
+    perception->set_width(2.0);
+    perception->mutable_velocity()->set_x(5.0);
+    for (const auto& corner : {std::make_pair(-2.25, -1.0),
+                               std::make_pair(2.25, -1.0),
+                               std::make_pair(2.25, 1.0),
+                               std::make_pair(-2.25, 1.0)}) {
+      auto* point = perception->add_polygon_point();
+      point->set_x(perception->position().x() + corner.first);
+      point->set_y(perception->position().y() + corner.second);
+    }
+    auto* trajectory = obstacle->add_trajectory();
+    trajectory->set_probability(1.0);
+    for (int j = 0; j < kNumTrajectoryPoints; ++j) {
+      auto* point = trajectory->add_trajectory_point();
+      point->mutable_path_point()->set_x(perception->position().x() + 0.5 * j);
+      point->mutable_path_point()->set_y(perception->position().y());
+      point->mutable_path_point()->set_s(0.5 * j);
+      point->set_v(5.0);
+      point->set_relative_time(0.1 * j);
+    }
+  }
+  return prediction;
+}
+
+ReferenceLine MakeReferenceLine(const double offset) {
+  std::vector<ReferencePoint> points;
+  for (double s = 0.0; s <= kReferenceLineLength;
+       s += kReferenceLineResolution) {
+    points.emplace_back(hdmap::MapPathPoint({s, offset}, 0.0), 0.0, 0.0);
+  }
+  return ReferenceLine(points);
+}
+
+// Frame::Init before sharing: the latest prediction copied into the frame and
+// each obstacle copied into the obstacle table.
+void BM_FrameObstaclesCopied(benchmark::State& state) {  // NOLINT
+  const auto latest = MakePrediction(state.range(0));
+  AllocationCounter counter;
+  while (state.KeepRunning()) {
+    PredictionObstacles prediction;
+    prediction.CopyFrom(*latest);
+    ThreadSafeIndexedObstacles obstacles;
+    for (auto& ptr : Obstacle::CreateObstacles(prediction)) {
+      obstacles.Add(ptr->Id(), *ptr);
+    }
+    benchmark::DoNotOptimize(obstacles);
+  }
+  counter.Report(&state);
+}
+BENCHMARK(BM_FrameObstaclesCopied)->Arg(10)->Arg(50)->Arg(100);
+
+void BM_FrameObstaclesShared(benchmark::State& state) {  // NOLINT
+  const auto latest = MakePrediction(state.range(0));
+  AllocationCounter counter;
+  while (state.KeepRunning()) {
+    boost::shared_ptr<const PredictionObstacles> prediction = latest;
+    ThreadSafeIndexedObstacles obstacles;
+    for (auto& ptr : Obstacle::CreateObstacles(*prediction)) {
+      const std::string id = ptr->Id();
+      obstacles.Add(id, std::move(*ptr));
+    }
+    benchmark::DoNotOptimize(obstacles);
+  }
+  counter.Report(&state);
+}
+BENCHMARK(BM_FrameObstaclesShared)->Arg(10)->Arg(50)->Arg(100);
+
+// The reference lines handed out by ReferenceLineProvider, copied into the
+// reference line infos.
+void BM_ReferenceLineInfoCopied(benchmark::State& state) {  // NOLINT
+  const std::list<ReferenceLine> provided = {MakeReferenceLine(0.0),
+                                             MakeReferenceLine(3.5)};
+  const common::VehicleState vehicle_state;
+  const common::TrajectoryPoint planning_start_point;
+  AllocationCounter counter;
+  while (state.KeepRunning()) {
+    std::list<ReferenceLine> reference_lines(provided.begin(), provided.end());
+    std::list<hdmap::RouteSegments> segments(reference_lines.size());
+    std::list<ReferenceLineInfo> reference_line_info;
+    auto segments_iter = segments.begin();
+    for (const auto& reference_line : reference_lines) {
+      reference_line_info.emplace_back(vehicle_state, planning_start_point,
+                                       reference_line, *segments_iter);
+      ++segments_iter;
+    }
+    benchmark::DoNotOptimize(reference_line_info);
+  }
+  counter.Report(&state);
+}
+BENCHMARK(BM_ReferenceLineInfoCopied);
+
+void BM_ReferenceLineInfoMoved(benchmark::State& state) {  // NOLINT
+  const std::list<ReferenceLine> provided = {MakeReferenceLine(0.0),
+                                             MakeReferenceLine(3.5)};
+  const common::VehicleState vehicle_state;
+  const common::TrajectoryPoint planning_start_point;
+  AllocationCounter counter;
+  while (state.KeepRunning()) {
+    std::list<ReferenceLine> reference_lines(provided.begin(), provided.end());
+    std::list<hdmap::RouteSegments> segments(reference_lines.size());
+    std::list<ReferenceLineInfo> reference_line_info;
+    auto segments_iter = segments.begin();
+    for (auto& reference_line : reference_lines) {
+      reference_line_info.emplace_back(vehicle_state, planning_start_point,
+                                       std::move(reference_line),
+                                       std::move(*segments_iter));
+      ++segments_iter;
+    }
+    benchmark::DoNotOptimize(reference_line_info);
+  }
+  counter.Report(&state);
+}
+BENCHMARK(BM_ReferenceLineInfoMoved);
+
+}  // namespace
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -19,7 +19,9 @@
  **/
 
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -54,6 +56,19 @@ TEST(IndexedList, Add_ConstRef) {
   }
 }
 
+TEST(IndexedList, Add_Move) {
+  StringIndexedList object;
+  std::string one(64, '1');
+  const auto* data = one.data();
+  auto* ptr = object.Add(1, std::move(one));
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_EQ(data, ptr->data());
+  std::string one_again(64, 'a');
+  ASSERT_EQ(ptr, object.Add(1, std::move(one_again)));
+  EXPECT_EQ(std::string(64, 'a'), *object.Find(1));
+  ASSERT_EQ(1, object.Items().size());
+}
+
 TEST(IndexedList, Find) {
   StringIndexedList object;
   object.Add(1, "one");
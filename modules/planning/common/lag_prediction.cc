@@ -65,14 +65,7 @@ void LagPrediction::GetLaggedPrediction(PredictionObstacles* obstacles) const {
 
   std::unordered_set<int> protected_obstacles;
   for (const auto& obstacle : latest_prediction->prediction_obstacle()) {
-    const auto& perception = obstacle.perception_obstacle();
-    if (perception.confidence() < FLAGS_perception_confidence_threshold &&
-        perception.type() != PerceptionObstacle::VEHICLE) {
-      continue;
-    }
-    double distance =
-        common::util::DistanceXY(perception.position(), adc_position);
-    if (distance < FLAGS_lag_prediction_protection_distance) {
+    if (IsProtected(obstacle, adc_position)) {
       protected_obstacles.insert(obstacle.perception_obstacle().id());
       // add protected obstacle
       AddObstacleToPrediction(0.0, obstacle, obstacles);
@@ -124,6 +117,38 @@ void LagPrediction::GetLaggedPrediction(PredictionObstacles* obstacles) const {
   }
 }
 
+std::vector<int> LagPrediction::ProtectedObstacleIds() const {
+  std::vector<int> ids;
+  if (!AdapterManager::GetPrediction() ||
+      AdapterManager::GetPrediction()->Empty() ||
+      !AdapterManager::GetLocalization() ||
+      AdapterManager::GetLocalization()->Empty()) {
+    return ids;
+  }
+  const auto& adc_position =
+      AdapterManager::GetLocalization()->GetLatestObserved().pose().position();
+  const auto& latest_prediction =
+      AdapterManager::GetPrediction()->GetLatestObserved();
+  for (const auto& obstacle : latest_prediction.prediction_obstacle()) {
+    if (IsProtected(obstacle, adc_position)) {
+      ids.push_back(obstacle.perception_obstacle().id());
+    }
+  }
+  return ids;
+}
+
+bool LagPrediction::IsProtected(const PredictionObstacle& obstacle,
+                                const common::PointENU& adc_position) const {
+  const auto& perception = obstacle.perception_obstacle();
+  if (perception.confidence() < FLAGS_perception_confidence_threshold &&
+      perception.type() != PerceptionObstacle::VEHICLE) {
+    return false;
+  }
+  double distance =
+      common::util::DistanceXY(perception.position(), adc_position);
+  return distance < FLAGS_lag_prediction_protection_distance;
+}
+
 void LagPrediction::AddObstacleToPrediction(
     double delay_sec, const prediction::PredictionObstacle& history_obstacle,
     prediction::PredictionObstacles* obstacles) const {
@@ -23,7 +23,9 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "modules/common/proto/geometry.pb.h"
 #include "modules/prediction/proto/prediction_obstacle.pb.h"
 
 namespace apollo {
@@ -34,6 +36,13 @@ class LagPrediction {
   LagPrediction(uint32_t min_appear_num, uint32_t max_disappear_num);
   void GetLaggedPrediction(prediction::PredictionObstacles* obstacles) const;
 
+  /**
+   * @brief the ids of the obstacles in the latest prediction that are close
+   * enough to ADC to skip the lag filter. Together with the prediction
+   * history they fully determine the output of GetLaggedPrediction().
+   */
+  std::vector<int> ProtectedObstacleIds() const;
+
   struct LagInfo {
     uint32_t last_observed_seq = 0;
     double last_observed_time = 0.0;
@@ -42,6 +51,9 @@ class LagPrediction {
   };
 
  private:
+  bool IsProtected(const prediction::PredictionObstacle& obstacle,
+                   const common::PointENU& adc_position) const;
+
   void AddObstacleToPrediction(
       double delay_sec, const prediction::PredictionObstacle& obstacle,
       prediction::PredictionObstacles* obstacles) const;
@@ -279,6 +279,8 @@ DEFINE_bool(
     "Enable multiple thread to calculation curve cost in dp_poly_path.");
 DEFINE_bool(enable_multi_thread_in_dp_st_graph, false,
             "Enable multiple thread to calculation curve cost in dp_st_graph.");
+DEFINE_bool(enable_multi_thread_in_st_boundary_mapper, false,
+            "Enable multiple thread to map obstacles to st boundaries.");
 
 /// Lattice Planner
 DEFINE_double(lattice_epsilon, 1e-6, "Epsilon in lattice planner.");
@@ -59,6 +59,15 @@ ReferenceLineInfo::ReferenceLineInfo(const common::VehicleState& vehicle_state,
       reference_line_(reference_line),
       lanes_(segments) {}
 
+ReferenceLineInfo::ReferenceLineInfo(const common::VehicleState& vehicle_state,
+                                     const TrajectoryPoint& adc_planning_point,
+                                     ReferenceLine&& reference_line,
+                                     hdmap::RouteSegments&& segments)
+    : vehicle_state_(vehicle_state),
+      adc_planning_point_(adc_planning_point),
+      reference_line_(std::move(reference_line)),
+      lanes_(std::move(segments)) {}
+
 bool ReferenceLineInfo::Init(const std::vector<const Obstacle*>& obstacles) {
   const auto& param = VehicleConfigHelper::GetConfig().vehicle_param();
   // stitching point
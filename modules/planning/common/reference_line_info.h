@@ -55,6 +55,10 @@ class ReferenceLineInfo {
                              const common::TrajectoryPoint& adc_planning_point,
                              const ReferenceLine& reference_line,
                              const hdmap::RouteSegments& segments);
+  explicit ReferenceLineInfo(const common::VehicleState& vehicle_state,
+                             const common::TrajectoryPoint& adc_planning_point,
+                             ReferenceLine&& reference_line,
+                             hdmap::RouteSegments&& segments);
 
   bool Init(const std::vector<const Obstacle*>& obstacles);
 
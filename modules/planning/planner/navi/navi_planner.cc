@@ -30,7 +30,7 @@
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/log.h"
 #include "modules/common/math/math_utils.h"
-#include "modules/common/time/time.h"
+#include "modules/common/time/tracer.h"
 #include "modules/common/util/string_tokenizer.h"
 #include "modules/common/util/string_util.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
@@ -58,7 +58,7 @@ using common::Status;
 using common::TrajectoryPoint;
 using common::adapter::AdapterManager;
 using common::math::Vec2d;
-using common::time::Clock;
+using common::time::Tracer;
 
 namespace {
 constexpr uint32_t KDestLanePriority = 0;
@@ -163,15 +163,20 @@ Status NaviPlanner::PlanOnReferenceLine(
   auto ret = Status::OK();
 
   for (auto& task : tasks_) {
-    const double start_timestamp = Clock::NowInSeconds();
+    // On the steady clock, so that the tasks are timed in replays on the mock
+    // clock too.
+    const int64_t start_ns = Tracer::NowNanos();
     ret = task->Execute(frame, reference_line_info);
+    const int64_t end_ns = Tracer::NowNanos();
+    if (Tracer::enabled()) {
+      Tracer::instance()->AddSpan(task->Name(), start_ns, end_ns);
+    }
     if (!ret.ok()) {
       AERROR << "Failed to run tasks[" << task->Name()
              << "], Error message: " << ret.error_message();
       break;
     }
-    const double end_timestamp = Clock::NowInSeconds();
-    const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+    const double time_diff_ms = (end_ns - start_ns) * 1e-6;
 
     ADEBUG << "after task " << task->Name() << ":"
            << reference_line_info->PathSpeedDebugString() << std::endl;
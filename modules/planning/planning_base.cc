@@ -25,6 +25,7 @@
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/math/quaternion.h"
 #include "modules/common/time/time.h"
+#include "modules/common/util/lineage.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/planning_context.h"
@@ -75,6 +76,8 @@ void PlanningBase::PublishPlanningPb(ADCTrajectory* trajectory_pb,
         prediction.header().camera_timestamp());
     trajectory_pb->mutable_header()->set_radar_timestamp(
         prediction.header().radar_timestamp());
+    common::util::AppendLineage(prediction.header(),
+                                trajectory_pb->mutable_header());
   }
 
   // TODO(all): integrate reverse gear
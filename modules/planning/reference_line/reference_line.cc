@@ -346,6 +346,23 @@ bool ReferenceLine::XYToSL(const common::math::Vec2d& xy_point,
   return true;
 }
 
+bool ReferenceLine::XYToSL(const std::vector<common::math::Vec2d>& xy_points,
+                           std::vector<SLPoint>* const sl_points) const {
+  DCHECK_NOTNULL(sl_points);
+  std::vector<double> s;
+  std::vector<double> l;
+  if (!map_path_.GetProjections(xy_points, &s, &l)) {
+    AERROR << "Can't get nearest points from path.";
+    return false;
+  }
+  sl_points->resize(xy_points.size());
+  for (std::size_t i = 0; i < xy_points.size(); ++i) {
+    (*sl_points)[i].set_s(s[i]);
+    (*sl_points)[i].set_l(l[i]);
+  }
+  return true;
+}
+
 ReferencePoint ReferenceLine::InterpolateWithMatchedIndex(
     const ReferencePoint& p0, const double s0, const ReferencePoint& p1,
     const double s1, const InterpolatedIndex& index) const {
@@ -552,19 +569,25 @@ bool ReferenceLine::GetApproximateSLBoundary(
 
 bool ReferenceLine::GetSLBoundary(const common::math::Box2d& box,
                                   SLBoundary* const sl_boundary) const {
+  std::vector<common::math::Vec2d> corners;
+  box.GetAllCorners(&corners);
+  return GetSLBoundary(corners, sl_boundary);
+}
+
+bool ReferenceLine::GetSLBoundary(
+    const std::vector<common::math::Vec2d>& points,
+    SLBoundary* const sl_boundary) const {
   double start_s(std::numeric_limits<double>::max());
   double end_s(std::numeric_limits<double>::lowest());
   double start_l(std::numeric_limits<double>::max());
   double end_l(std::numeric_limits<double>::lowest());
-  std::vector<common::math::Vec2d> corners;
-  box.GetAllCorners(&corners);
-  for (const auto& point : corners) {
-    SLPoint sl_point;
-    if (!XYToSL(point, &sl_point)) {
-      AERROR << "failed to get projection for point: " << point.DebugString()
-             << " on reference line.";
-      return false;
-    }
+  std::vector<SLPoint> sl_points;
+  if (!XYToSL(points, &sl_points)) {
+    AERROR << "failed to get projection for " << points.size()
+           << " points on reference line.";
+    return false;
+  }
+  for (const auto& sl_point : sl_points) {
     start_s = std::fmin(start_s, sl_point.s());
     end_s = std::fmax(end_s, sl_point.s());
     start_l = std::fmin(start_l, sl_point.l());
@@ -584,27 +607,12 @@ std::vector<hdmap::LaneSegment> ReferenceLine::GetLaneSegments(
 
 bool ReferenceLine::GetSLBoundary(const hdmap::Polygon& polygon,
                                   SLBoundary* const sl_boundary) const {
-  double start_s(std::numeric_limits<double>::max());
-  double end_s(std::numeric_limits<double>::lowest());
-  double start_l(std::numeric_limits<double>::max());
-  double end_l(std::numeric_limits<double>::lowest());
+  std::vector<common::math::Vec2d> points;
+  points.reserve(polygon.point_size());
   for (const auto& point : polygon.point()) {
-    SLPoint sl_point;
-    if (!XYToSL(point, &sl_point)) {
-      AERROR << "failed to get projection for point: " << point.DebugString()
-             << " on reference line.";
-      return false;
-    }
-    start_s = std::fmin(start_s, sl_point.s());
-    end_s = std::fmax(end_s, sl_point.s());
-    start_l = std::fmin(start_l, sl_point.l());
-    end_l = std::fmax(end_l, sl_point.l());
+    points.emplace_back(point.x(), point.y());
   }
-  sl_boundary->set_start_s(start_s);
-  sl_boundary->set_end_s(end_s);
-  sl_boundary->set_start_l(start_l);
-  sl_boundary->set_end_l(end_l);
-  return true;
+  return GetSLBoundary(points, sl_boundary);
 }
 
 bool ReferenceLine::HasOverlap(const common::math::Box2d& box) const {
@@ -41,6 +41,9 @@ class ReferenceLine {
  public:
   ReferenceLine() = default;
   explicit ReferenceLine(const ReferenceLine& reference_line) = default;
+  ReferenceLine(ReferenceLine&& reference_line) = default;
+  ReferenceLine& operator=(const ReferenceLine& reference_line) = default;
+  ReferenceLine& operator=(ReferenceLine&& reference_line) = default;
   template <typename Iterator>
   explicit ReferenceLine(const Iterator begin, const Iterator end)
       : reference_points_(begin, end),
@@ -100,6 +103,8 @@ class ReferenceLine {
                      SLBoundary* const sl_boundary) const;
   bool GetSLBoundary(const hdmap::Polygon& polygon,
                      SLBoundary* const sl_boundary) const;
+  bool GetSLBoundary(const std::vector<common::math::Vec2d>& points,
+                     SLBoundary* const sl_boundary) const;
 
   bool SLToXY(const common::SLPoint& sl_point,
               common::math::Vec2d* const xy_point) const;
@@ -109,6 +114,12 @@ class ReferenceLine {
   bool XYToSL(const XYPoint& xy, common::SLPoint* const sl_point) const {
     return XYToSL(common::math::Vec2d(xy.x(), xy.y()), sl_point);
   }
+  /**
+   * @brief project a set of points in one pass, see
+   * hdmap::Path::GetProjections().
+   */
+  bool XYToSL(const std::vector<common::math::Vec2d>& xy_points,
+              std::vector<common::SLPoint>* const sl_points) const;
 
   bool GetLaneWidth(const double s, double* const lane_left_width,
                     double* const lane_right_width) const;
@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of obstacle SL boundary projection: 100 obstacle boxes on
+ * a 250 m curved reference line, projected corner by corner versus in one
+ * batch.
+ **/
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/box2d.h"
+#include "modules/planning/reference_line/reference_line.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+using apollo::common::SLPoint;
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+
+constexpr double kLength = 250.0;
+constexpr double kResolution = 0.5;
+constexpr int kNumObstacles = 100;
+
+ReferenceLine MakeReferenceLine() {
+  std::vector<ReferencePoint> points;
+  for (double s = 0.0; s <= kLength; s += kResolution) {
+    const double x = s;
+    const double y = 10.0 * std::sin(s / 40.0);
+    const double heading = std::atan(0.25 * std::cos(s / 40.0));
+    points.emplace_back(hdmap::MapPathPoint({x, y}, heading), 0.0, 0.0);
+  }
+  return ReferenceLine(points);
+}
+
+std::vector<Box2d> MakeObstacles(const ReferenceLine& reference_line) {
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < kNumObstacles; ++i) {
+    const double s = kLength * (i + 0.5) / kNumObstacles;
+    const auto ref_point = reference_line.GetReferencePoint(s);
+    const double l = (i % 5 - 2) * 1.8;
+    const Vec2d center(ref_point.x() - std::sin(ref_point.heading()) * l,
+                       ref_point.y() + std::cos(ref_point.heading()) * l);
+    boxes.emplace_back(center, ref_point.heading() + 0.1 * (i % 3), 4.5, 2.0);
+  }
+  return boxes;
+}
+
+// The SL boundary computation as it was done before the batched projection.
+bool GetSLBoundaryPerCorner(const ReferenceLine& reference_line,
+                            const Box2d& box, SLBoundary* sl_boundary) {
+  double start_s(std::numeric_limits<double>::max());
+  double end_s(std::numeric_limits<double>::lowest());
+  double start_l(std::numeric_limits<double>::max());
+  double end_l(std::numeric_limits<double>::lowest());
+  std::vector<Vec2d> corners;
+  box.GetAllCorners(&corners);
+  for (const auto& point : corners) {
+    SLPoint sl_point;
+    if (!reference_line.XYToSL(point, &sl_point)) {
+      return false;
+    }
+    start_s = std::fmin(start_s, sl_point.s());
+    end_s = std::fmax(end_s, sl_point.s());
+    start_l = std::fmin(start_l, sl_point.l());
+    end_l = std::fmax(end_l, sl_point.l());
+  }
+  sl_boundary->set_start_s(start_s);
+  sl_boundary->set_end_s(end_s);
+  sl_boundary->set_start_l(start_l);
+  sl_boundary->set_end_l(end_l);
+  return true;
+}
+
+void BM_SLBoundaryPerCorner(benchmark::State& state) {  // NOLINT
+  const auto reference_line = MakeReferenceLine();
+  const auto boxes = MakeObstacles(reference_line);
+  SLBoundary sl_boundary;
+  while (state.KeepRunning()) {
+    for (const auto& box : boxes) {
+      GetSLBoundaryPerCorner(reference_line, box, &sl_boundary);
+    }
+    benchmark::DoNotOptimize(sl_boundary);
+  }
+}
+BENCHMARK(BM_SLBoundaryPerCorner);
+
+void BM_SLBoundaryBatched(benchmark::State& state) {  // NOLINT
+  const auto reference_line = MakeReferenceLine();
+  const auto boxes = MakeObstacles(reference_line);
+  SLBoundary sl_boundary;
+  while (state.KeepRunning()) {
+    for (const auto& box : boxes) {
+      reference_line.GetSLBoundary(box, &sl_boundary);
+    }
+    benchmark::DoNotOptimize(sl_boundary);
+  }
+}
+BENCHMARK(BM_SLBoundaryBatched);
+
+}  // namespace
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
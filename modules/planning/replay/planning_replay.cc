@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/replay/planning_replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "google/protobuf/util/message_differencer.h"
+
+#include "modules/common/adapters/adapter_manager.h"
+#include "modules/common/log.h"
+#include "modules/common/time/time.h"
+#include "modules/common/util/file.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::ErrorCode;
+using apollo::common::Status;
+using apollo::common::adapter::AdapterManager;
+using apollo::common::time::Clock;
+using apollo::localization::LocalizationEstimate;
+
+namespace {
+
+struct Input {
+  const char* name;
+  bool (*feed)(const std::string& file);
+};
+
+const Input kInputs[] = {
+    {"routing", &AdapterManager::FeedRoutingResponseFile},
+    {"chassis", &AdapterManager::FeedChassisFile},
+    {"prediction", &AdapterManager::FeedPredictionFile},
+    {"traffic_light", &AdapterManager::FeedTrafficLightDetectionFile},
+};
+
+constexpr char kGoldenFile[] = "golden.pb.txt";
+
+// Returns the file of an input in a frame, or empty if there is none.
+std::string FindInput(const std::string& frame_dir, const std::string& name) {
+  for (const char* extension : {".pb.txt", ".bin"}) {
+    const std::string file = frame_dir + "/" + name + extension;
+    if (common::util::PathExists(file)) {
+      return file;
+    }
+  }
+  return "";
+}
+
+// Clears what changes from run to run.
+void TrimTrajectory(ADCTrajectory* trajectory) {
+  trajectory->clear_latency_stats();
+  trajectory->clear_debug();
+  auto* header = trajectory->mutable_header();
+  header->clear_timestamp_sec();
+  header->clear_lidar_timestamp();
+  header->clear_camera_timestamp();
+  header->clear_radar_timestamp();
+  header->clear_sequence_num();
+}
+
+}  // namespace
+
+Status PlanningReplay::Init() {
+  Clock::SetMode(Clock::MOCK);
+  FLAGS_use_multi_thread_to_add_obstacles = false;
+  FLAGS_enable_multi_thread_in_dp_poly_path = false;
+  FLAGS_enable_multi_thread_in_dp_st_graph = false;
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = false;
+  FLAGS_enable_reference_line_provider_thread = false;
+  FLAGS_align_prediction_time = false;
+  FLAGS_estimate_current_vehicle_state = false;
+  FLAGS_enable_lag_prediction = false;
+  FLAGS_use_planning_fallback = false;
+  // Keeps the relative times of the trajectory points from the mock clock.
+  FLAGS_planning_test_mode = true;
+
+  planning_.reset(new StdPlanning());
+  return planning_->Init();
+}
+
+bool PlanningReplay::Replay(const std::string& replay_dir,
+                            const bool update_golden, Summary* summary) {
+  std::vector<std::string> frames = common::util::ListSubPaths(replay_dir);
+  if (frames.empty()) {
+    AERROR << "No frames in " << replay_dir;
+    return false;
+  }
+  std::sort(frames.begin(), frames.end());
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (const auto& frame : frames) {
+    if (!RunFrame(replay_dir + "/" + frame, update_golden, summary)) {
+      return false;
+    }
+  }
+  summary->seconds += std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start_time)
+                          .count();
+  return true;
+}
+
+bool PlanningReplay::FeedInputs(const std::string& frame_dir) {
+  const std::string localization_file = FindInput(frame_dir, "localization");
+  LocalizationEstimate localization;
+  if (localization_file.empty() ||
+      !common::util::GetProtoFromFile(localization_file, &localization)) {
+    AERROR << "Failed to load the localization of " << frame_dir;
+    return false;
+  }
+  Clock::SetNowInSeconds(localization.header().timestamp_sec());
+  AdapterManager::FeedLocalizationData(localization);
+
+  for (const auto& input : kInputs) {
+    const std::string file = FindInput(frame_dir, input.name);
+    if (!file.empty() && !input.feed(file)) {
+      AERROR << "Failed to feed " << file;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PlanningReplay::RunFrame(const std::string& frame_dir,
+                              const bool update_golden, Summary* summary) {
+  if (!FeedInputs(frame_dir)) {
+    return false;
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  planning_->RunOnce();
+  const double time_ms = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+  timing_stats_.Add("StdPlanning::RunOnce", time_ms);
+
+  const ADCTrajectory* published =
+      AdapterManager::GetPlanning()->GetLatestPublished();
+  if (published == nullptr) {
+    AERROR << "No trajectory was published for " << frame_dir;
+    return false;
+  }
+  ++summary->frames;
+  for (const auto& task : published->latency_stats().task_stats()) {
+    timing_stats_.Add(task.name(), task.time_ms());
+  }
+  if (published->header().status().error_code() != ErrorCode::OK) {
+    ++summary->failures;
+  }
+
+  ADCTrajectory trajectory = *published;
+  TrimTrajectory(&trajectory);
+  const std::string golden_file = frame_dir + "/" + kGoldenFile;
+  if (update_golden) {
+    if (!common::util::SetProtoToASCIIFile(trajectory, golden_file)) {
+      AERROR << "Failed to write " << golden_file;
+      return false;
+    }
+    return true;
+  }
+
+  ADCTrajectory golden;
+  if (!common::util::GetProtoFromASCIIFile(golden_file, &golden)) {
+    AERROR << "Failed to load " << golden_file;
+    ++summary->golden_diffs;
+    return true;
+  }
+  TrimTrajectory(&golden);
+  google::protobuf::util::MessageDifferencer differencer;
+  std::string diff;
+  differencer.ReportDifferencesToString(&diff);
+  if (!differencer.Compare(golden, trajectory)) {
+    AERROR << frame_dir << " differs from the golden run:\n" << diff;
+    ++summary->golden_diffs;
+  }
+  return true;
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#ifndef MODULES_PLANNING_REPLAY_PLANNING_REPLAY_H_
+#define MODULES_PLANNING_REPLAY_PLANNING_REPLAY_H_
+
+#include <memory>
+#include <string>
+
+#include "modules/planning/proto/planning.pb.h"
+
+#include "modules/common/status/status.h"
+#include "modules/planning/replay/timing_stats.h"
+#include "modules/planning/std_planning.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class PlanningReplay
+ * @brief Runs StdPlanning on recorded inputs, one frame after another on the
+ * mock clock, as fast as it can, timing each task and comparing the
+ * trajectories to the ones of a golden run.
+ *
+ * A replay directory has a sub-directory per frame, replayed in name order.
+ * A frame has any of localization, chassis, prediction, routing and
+ * traffic_light, each as <name>.pb.txt or <name>.bin, and golden.pb.txt. An
+ * input missing from a frame is left as it was in the previous one, so the
+ * routing is usually only in the first frame. Every frame needs a
+ * localization, whose timestamp is the time of the frame.
+ */
+class PlanningReplay {
+ public:
+  struct Summary {
+    int frames = 0;
+    // Frames planned with an error status.
+    int failures = 0;
+    // Frames whose trajectory differs from the golden one.
+    int golden_diffs = 0;
+    double seconds = 0.0;
+  };
+
+  /**
+   * @brief Initializes the planning. The flags which make planning
+   * nondeterministic, such as those of its threads, are reset.
+   */
+  common::Status Init();
+
+  /**
+   * @brief Replays all the frames of a directory, and saves their
+   * trajectories as golden ones if update_golden, or else compares them.
+   * @return false if a frame could not be replayed.
+   */
+  bool Replay(const std::string& replay_dir, const bool update_golden,
+              Summary* summary);
+
+  const TimingStats& timing_stats() const { return timing_stats_; }
+
+ private:
+  bool FeedInputs(const std::string& frame_dir);
+  bool RunFrame(const std::string& frame_dir, const bool update_golden,
+                Summary* summary);
+
+  std::unique_ptr<StdPlanning> planning_;
+  TimingStats timing_stats_;
+};
+
+}  // namespace planning
+}  // namespace apollo
+
+#endif  // MODULES_PLANNING_REPLAY_PLANNING_REPLAY_H_
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Replays recorded planning frames and prints the timings of the
+ * planning tasks, e.g.
+ *   planning_replay --replay_dir=/apollo/data/replay/sunnyvale \
+ *     --map_dir=modules/map/data/sunnyvale_loop
+ **/
+
+#include <algorithm>
+#include <iostream>
+
+#include "gflags/gflags.h"
+
+#include "modules/common/log.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/replay/planning_replay.h"
+
+DEFINE_string(replay_dir, "",
+              "The directory of the frames to replay, one sub-directory per "
+              "frame.");
+DEFINE_bool(replay_update_golden, false,
+            "True to save the trajectories as the golden ones, instead of "
+            "comparing them.");
+DEFINE_string(replay_adapter_config_filename,
+              "modules/planning/testdata/conf/adapter.conf",
+              "The adapter config of the replay, without ROS.");
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_replay_dir.empty()) {
+    AERROR << "need to provide --replay_dir";
+    return 1;
+  }
+  FLAGS_planning_adapter_config_filename =
+      FLAGS_replay_adapter_config_filename;
+
+  apollo::planning::PlanningReplay replay;
+  const auto status = replay.Init();
+  if (!status.ok()) {
+    AERROR << "Failed to init planning: " << status.ToString();
+    return 1;
+  }
+  apollo::planning::PlanningReplay::Summary summary;
+  if (!replay.Replay(FLAGS_replay_dir, FLAGS_replay_update_golden,
+                     &summary)) {
+    return 1;
+  }
+
+  std::cout << replay.timing_stats().Report() << std::endl
+            << summary.frames << " frames in " << summary.seconds << " s ("
+            << summary.frames / std::max(summary.seconds, 1e-9)
+            << " frames/s), " << summary.failures << " failed";
+  if (!FLAGS_replay_update_golden) {
+    std::cout << ", " << summary.golden_diffs << " differ from the golden run";
+  }
+  std::cout << std::endl;
+  return summary.golden_diffs == 0 ? 0 : 1;
+}
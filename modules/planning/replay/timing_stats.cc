@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/replay/timing_stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+// Nearest rank of a percentile in sorted timings.
+double Percentile(const std::vector<double>& sorted_ms, const int percent) {
+  const size_t rank = (sorted_ms.size() * percent + 99) / 100;
+  return sorted_ms[std::max<size_t>(rank, 1) - 1];
+}
+
+}  // namespace
+
+void TimingStats::Add(const std::string& name, const double time_ms) {
+  times_ms_[name].push_back(time_ms);
+}
+
+TimingStats::Distribution TimingStats::GetDistribution(
+    const std::string& name) const {
+  Distribution distribution;
+  auto iter = times_ms_.find(name);
+  if (iter == times_ms_.end() || iter->second.empty()) {
+    return distribution;
+  }
+  std::vector<double> sorted_ms = iter->second;
+  std::sort(sorted_ms.begin(), sorted_ms.end());
+  distribution.count = static_cast<int>(sorted_ms.size());
+  distribution.mean_ms =
+      std::accumulate(sorted_ms.begin(), sorted_ms.end(), 0.0) /
+      sorted_ms.size();
+  distribution.p50_ms = Percentile(sorted_ms, 50);
+  distribution.p90_ms = Percentile(sorted_ms, 90);
+  distribution.p99_ms = Percentile(sorted_ms, 99);
+  distribution.max_ms = sorted_ms.back();
+  return distribution;
+}
+
+std::string TimingStats::Report() const {
+  std::string report;
+  char line[256];
+  snprintf(line, sizeof(line), "%-40s %8s %10s %10s %10s %10s %10s\n", "task",
+           "count", "mean(ms)", "p50(ms)", "p90(ms)", "p99(ms)", "max(ms)");
+  report += line;
+  for (const auto& times : times_ms_) {
+    const Distribution distribution = GetDistribution(times.first);
+    snprintf(line, sizeof(line),
+             "%-40s %8d %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+             times.first.c_str(), distribution.count, distribution.mean_ms,
+             distribution.p50_ms, distribution.p90_ms, distribution.p99_ms,
+             distribution.max_ms);
+    report += line;
+  }
+  return report;
+}
+
+}  // namespace planning
+}  // namespace apollo
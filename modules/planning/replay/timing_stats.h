@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#ifndef MODULES_PLANNING_REPLAY_TIMING_STATS_H_
+#define MODULES_PLANNING_REPLAY_TIMING_STATS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class TimingStats
+ * @brief Keeps all the timings of each planning task over a replay, to
+ * report their distributions.
+ */
+class TimingStats {
+ public:
+  struct Distribution {
+    int count = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p90_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+  };
+
+  void Add(const std::string& name, const double time_ms);
+
+  /**
+   * @brief Returns the distribution of the timings of a task, with a count of
+   * 0 if it has none.
+   */
+  Distribution GetDistribution(const std::string& name) const;
+
+  /**
+   * @brief Returns a table of the distributions of all the tasks, by name.
+   */
+  std::string Report() const;
+
+ private:
+  std::map<std::string, std::vector<double>> times_ms_;
+};
+
+}  // namespace planning
+}  // namespace apollo
+
+#endif  // MODULES_PLANNING_REPLAY_TIMING_STATS_H_
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/replay/timing_stats.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+TEST(TimingStatsTest, Distribution) {
+  TimingStats stats;
+  for (int i = 100; i >= 1; --i) {
+    stats.Add("DpPolyPathOptimizer", i);
+  }
+  stats.Add("SpeedDecider", 0.5);
+
+  const auto distribution = stats.GetDistribution("DpPolyPathOptimizer");
+  EXPECT_EQ(100, distribution.count);
+  EXPECT_DOUBLE_EQ(50.5, distribution.mean_ms);
+  EXPECT_DOUBLE_EQ(50.0, distribution.p50_ms);
+  EXPECT_DOUBLE_EQ(90.0, distribution.p90_ms);
+  EXPECT_DOUBLE_EQ(99.0, distribution.p99_ms);
+  EXPECT_DOUBLE_EQ(100.0, distribution.max_ms);
+
+  const auto single = stats.GetDistribution("SpeedDecider");
+  EXPECT_EQ(1, single.count);
+  EXPECT_DOUBLE_EQ(0.5, single.p50_ms);
+  EXPECT_DOUBLE_EQ(0.5, single.p99_ms);
+
+  EXPECT_EQ(0, stats.GetDistribution("PathDecider").count);
+}
+
+TEST(TimingStatsTest, Report) {
+  TimingStats stats;
+  stats.Add("SpeedDecider", 1.0);
+  stats.Add("DpPolyPathOptimizer", 2.0);
+  const std::string report = stats.Report();
+  const auto dp_pos = report.find("DpPolyPathOptimizer");
+  const auto speed_pos = report.find("SpeedDecider");
+  ASSERT_NE(std::string::npos, dp_pos);
+  ASSERT_NE(std::string::npos, speed_pos);
+  EXPECT_LT(dp_pos, speed_pos);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -27,7 +27,7 @@
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/log.h"
 #include "modules/common/math/math_utils.h"
-#include "modules/common/time/time.h"
+#include "modules/common/time/tracer.h"
 #include "modules/common/util/file.h"
 #include "modules/common/util/string_tokenizer.h"
 #include "modules/common/util/string_util.h"
@@ -56,7 +56,7 @@ using common::Status;
 using common::TrajectoryPoint;
 using common::adapter::AdapterManager;
 using common::math::Vec2d;
-using common::time::Clock;
+using common::time::Tracer;
 
 namespace {
 constexpr double kPathOptimizationFallbackCost = 2e4;
@@ -200,15 +200,20 @@ Status LaneFollowScenario::PlanOnReferenceLine(
   auto ret = Status::OK();
 
   for (auto& optimizer : tasks_) {
-    const double start_timestamp = Clock::NowInSeconds();
+    // On the steady clock, so that the tasks are timed in replays on the mock
+    // clock too.
+    const int64_t start_ns = Tracer::NowNanos();
     ret = optimizer->Execute(frame, reference_line_info);
+    const int64_t end_ns = Tracer::NowNanos();
+    if (Tracer::enabled()) {
+      Tracer::instance()->AddSpan(optimizer->Name(), start_ns, end_ns);
+    }
     if (!ret.ok()) {
       AERROR << "Failed to run tasks[" << optimizer->Name()
              << "], Error message: " << ret.error_message();
       break;
     }
-    const double end_timestamp = Clock::NowInSeconds();
-    const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+    const double time_diff_ms = (end_ns - start_ns) * 1e-6;
 
     ADEBUG << "after optimizer " << optimizer->Name() << ":"
            << reference_line_info->PathSpeedDebugString() << std::endl;
@@ -29,6 +29,7 @@
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/math/quaternion.h"
 #include "modules/common/time/time.h"
+#include "modules/common/time/tracer.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/ego_info.h"
@@ -50,6 +51,7 @@ using apollo::common::VehicleState;
 using apollo::common::VehicleStateProvider;
 using apollo::common::adapter::AdapterManager;
 using apollo::common::time::Clock;
+using apollo::common::time::Tracer;
 using apollo::hdmap::HDMapUtil;
 using apollo::routing::RoutingResponse;
 
@@ -152,6 +154,7 @@ Status StdPlanning::Start() {
 }
 
 void StdPlanning::RunOnce() {
+  TRACE_SCOPE("StdPlanning::RunOnce");
   // snapshot all coming data
   AdapterManager::Observe();
 
@@ -316,6 +319,7 @@ void StdPlanning::RunOnce() {
   if (!status.ok()) {
     status.Save(trajectory_pb->mutable_header()->mutable_status());
     AERROR << "Planning failed:" << status.ToString();
+    Tracer::instance()->DumpOnAnomaly("planning_failure");
     if (FLAGS_publish_estop) {
       AERROR << "Planning failed and set estop";
       // Because the function "Control::ProduceControlCommand()" checks the
@@ -356,6 +360,7 @@ Status StdPlanning::Plan(
     const double current_time_stamp,
     const std::vector<TrajectoryPoint>& stitching_trajectory,
     ADCTrajectory* trajectory_pb) {
+  TRACE_SCOPE("StdPlanning::Plan");
   auto* ptr_debug = trajectory_pb->mutable_debug();
   if (FLAGS_enable_record_debug) {
     ptr_debug->mutable_planning_data()->mutable_init_point()->CopyFrom(
@@ -21,6 +21,8 @@
 #include "modules/planning/toolkits/optimizers/st_graph/st_boundary_mapper.h"
 
 #include <algorithm>
+#include <functional>
+#include <future>
 #include <limits>
 #include <unordered_map>
 #include <utility>
@@ -34,6 +36,7 @@
 #include "modules/common/math/vec2d.h"
 #include "modules/common/util/file.h"
 #include "modules/common/util/string_util.h"
+#include "modules/common/util/thread_pool.h"
 #include "modules/common/util/util.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/planning/common/frame.h"
@@ -51,12 +54,54 @@ using apollo::common::VehicleParam;
 using apollo::common::math::Box2d;
 using apollo::common::math::Vec2d;
 using apollo::common::util::StrCat;
+using apollo::common::util::ThreadPool;
 
 namespace {
 constexpr double boundary_t_buffer = 0.1;
 constexpr double boundary_s_buffer = 1.0;
+constexpr int default_num_point = 50;
 }  // namespace
 
+constexpr std::size_t StBoundaryMapper::PathSweep::kChunkSize;
+
+void StBoundaryMapper::PathSweep::Add(const double s, const Box2d& adc_box) {
+  if (adc_boxes.size() % kChunkSize == 0) {
+    chunk_bounds.emplace_back();
+    auto& bound = chunk_bounds.back();
+    bound.min_x = adc_box.min_x();
+    bound.max_x = adc_box.max_x();
+    bound.min_y = adc_box.min_y();
+    bound.max_y = adc_box.max_y();
+  } else {
+    auto& bound = chunk_bounds.back();
+    bound.min_x = std::min(bound.min_x, adc_box.min_x());
+    bound.max_x = std::max(bound.max_x, adc_box.max_x());
+    bound.min_y = std::min(bound.min_y, adc_box.min_y());
+    bound.max_y = std::max(bound.max_y, adc_box.max_y());
+  }
+  path_s.push_back(s);
+  adc_boxes.push_back(adc_box);
+}
+
+int StBoundaryMapper::PathSweep::FindFirstOverlap(const Box2d& obs_box) const {
+  for (std::size_t chunk = 0; chunk < chunk_bounds.size(); ++chunk) {
+    // Same rejection test as Box2d::HasOverlap, on the whole chunk.
+    const auto& bound = chunk_bounds[chunk];
+    if (bound.max_x < obs_box.min_x() || bound.min_x > obs_box.max_x() ||
+        bound.max_y < obs_box.min_y() || bound.min_y > obs_box.max_y()) {
+      continue;
+    }
+    const std::size_t end =
+        std::min(adc_boxes.size(), (chunk + 1) * kChunkSize);
+    for (std::size_t i = chunk * kChunkSize; i < end; ++i) {
+      if (obs_box.HasOverlap(adc_boxes[i])) {
+        return static_cast<int>(i);
+      }
+    }
+  }
+  return -1;
+}
+
 StBoundaryMapper::StBoundaryMapper(const SLBoundary& adc_sl_boundary,
                                    const StBoundaryConfig& config,
                                    const ReferenceLine& reference_line,
@@ -71,7 +116,43 @@ StBoundaryMapper::StBoundaryMapper(const SLBoundary& adc_sl_boundary,
       vehicle_param_(common::VehicleConfigHelper::GetConfig().vehicle_param()),
       planning_distance_(planning_distance),
       planning_time_(planning_time),
-      is_change_lane_(is_change_lane) {}
+      is_change_lane_(is_change_lane) {
+  BuildPathSweeps();
+}
+
+void StBoundaryMapper::BuildPathSweeps() {
+  const auto& path_points = path_data_.discretized_path().path_points();
+  if (path_points.empty()) {
+    return;
+  }
+  const double buffer = st_boundary_config_.boundary_buffer();
+  for (const auto& path_point : path_points) {
+    if (path_point.s() > planning_distance_) {
+      break;
+    }
+    path_point_sweep_.Add(path_point.s(), GetAdcBox(path_point, buffer));
+  }
+
+  if (path_points.size() > 2 * default_num_point) {
+    const int ratio = path_points.size() / default_num_point;
+    std::vector<PathPoint> sampled_path_points;
+    for (size_t i = 0; i < path_points.size(); ++i) {
+      if (i % ratio == 0) {
+        sampled_path_points.push_back(path_points[i]);
+      }
+    }
+    sampled_path_.set_path_points(sampled_path_points);
+  } else {
+    sampled_path_.set_path_points(path_points);
+  }
+  const double step_length = vehicle_param_.front_edge_to_center();
+  for (double path_s = 0.0; path_s < sampled_path_.Length();
+       path_s += step_length) {
+    const auto curr_adc_path_point =
+        sampled_path_.Evaluate(path_s + sampled_path_.StartPoint().s());
+    sampled_path_sweep_.Add(path_s, GetAdcBox(curr_adc_path_point, buffer));
+  }
+}
 
 Status StBoundaryMapper::CreateStBoundary(PathDecision* path_decision) const {
   const auto& path_obstacles = path_decision->path_obstacles();
@@ -93,16 +174,13 @@ Status StBoundaryMapper::CreateStBoundary(PathDecision* path_decision) const {
   PathObstacle* stop_obstacle = nullptr;
   ObjectDecisionType stop_decision;
   double min_stop_s = std::numeric_limits<double>::max();
+  std::vector<std::pair<PathObstacle*, const ObjectDecisionType*>>
+      obstacles_to_map;
 
   for (const auto* const_path_obstacle : path_obstacles.Items()) {
     auto* path_obstacle = path_decision->Find(const_path_obstacle->Id());
     if (!path_obstacle->HasLongitudinalDecision()) {
-      if (!MapWithoutDecision(path_obstacle).ok()) {
-        std::string msg = StrCat("Fail to map obstacle ", path_obstacle->Id(),
-                                 " without decision.");
-        AERROR << msg;
-        return Status(ErrorCode::PLANNING_ERROR, msg);
-      }
+      obstacles_to_map.emplace_back(path_obstacle, nullptr);
       continue;
     }
     const auto& decision = path_obstacle->LongitudinalDecision();
@@ -126,17 +204,17 @@ Status StBoundaryMapper::CreateStBoundary(PathDecision* path_decision) const {
       }
     } else if (decision.has_follow() || decision.has_overtake() ||
                decision.has_yield()) {
-      if (!MapWithDecision(path_obstacle, decision).ok()) {
-        AERROR << "Fail to map obstacle " << path_obstacle->Id()
-               << " with decision: " << decision.DebugString();
-        return Status(ErrorCode::PLANNING_ERROR,
-                      "Fail to map overtake/yield decision");
-      }
+      obstacles_to_map.emplace_back(path_obstacle, &decision);
     } else if (!decision.has_ignore()) {
       AWARN << "No mapping for decision: " << decision.DebugString();
     }
   }
 
+  const auto status = MapObstacles(obstacles_to_map);
+  if (!status.ok()) {
+    return status;
+  }
+
   if (stop_obstacle) {
     bool success = MapStopDecision(stop_obstacle, stop_decision);
     if (!success) {
@@ -148,6 +226,53 @@ Status StBoundaryMapper::CreateStBoundary(PathDecision* path_decision) const {
   return Status::OK();
 }
 
+Status StBoundaryMapper::MapObstacles(
+    const std::vector<std::pair<PathObstacle*, const ObjectDecisionType*>>&
+        obstacles) const {
+  auto map_obstacle = [this](PathObstacle* path_obstacle,
+                             const ObjectDecisionType* decision) {
+    if (decision == nullptr) {
+      if (!MapWithoutDecision(path_obstacle).ok()) {
+        std::string msg = StrCat("Fail to map obstacle ", path_obstacle->Id(),
+                                 " without decision.");
+        AERROR << msg;
+        return Status(ErrorCode::PLANNING_ERROR, msg);
+      }
+    } else if (!MapWithDecision(path_obstacle, *decision).ok()) {
+      AERROR << "Fail to map obstacle " << path_obstacle->Id()
+             << " with decision: " << decision->DebugString();
+      return Status(ErrorCode::PLANNING_ERROR,
+                    "Fail to map overtake/yield decision");
+    }
+    return Status::OK();
+  };
+
+  if (!FLAGS_enable_multi_thread_in_st_boundary_mapper) {
+    for (const auto& obstacle : obstacles) {
+      const auto status = map_obstacle(obstacle.first, obstacle.second);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return Status::OK();
+  }
+
+  // Each task only writes the st boundary of its own obstacle.
+  std::vector<std::future<Status>> futures;
+  for (const auto& obstacle : obstacles) {
+    futures.push_back(ThreadPool::pool()->push(
+        std::bind(map_obstacle, obstacle.first, obstacle.second)));
+  }
+  Status status = Status::OK();
+  for (auto& f : futures) {
+    const auto task_status = f.get();
+    if (status.ok() && !task_status.ok()) {
+      status = task_status;
+    }
+  }
+  return status;
+}
+
 Status StBoundaryMapper::CreateStBoundaryWithHistory(
     const ObjectDecisions& history_decisions,
     PathDecision* path_decision) const {
@@ -301,8 +426,7 @@ Status StBoundaryMapper::MapWithoutDecision(PathObstacle* path_obstacle) const {
   std::vector<STPoint> lower_points;
   std::vector<STPoint> upper_points;
 
-  if (!GetOverlapBoundaryPoints(path_data_.discretized_path().path_points(),
-                                *(path_obstacle->obstacle()), &upper_points,
+  if (!GetOverlapBoundaryPoints(*(path_obstacle->obstacle()), &upper_points,
                                 &lower_points)) {
     return Status::OK();
   }
@@ -325,16 +449,14 @@ Status StBoundaryMapper::MapWithoutDecision(PathObstacle* path_obstacle) const {
 }
 
 bool StBoundaryMapper::GetOverlapBoundaryPoints(
-    const std::vector<PathPoint>& path_points, const Obstacle& obstacle,
-    std::vector<STPoint>* upper_points,
+    const Obstacle& obstacle, std::vector<STPoint>* upper_points,
     std::vector<STPoint>* lower_points) const {
   DCHECK_NOTNULL(upper_points);
   DCHECK_NOTNULL(lower_points);
   DCHECK(upper_points->empty());
   DCHECK(lower_points->empty());
-  DCHECK_GT(path_points.size(), 0);
 
-  if (path_points.empty()) {
+  if (path_data_.discretized_path().path_points().empty()) {
     AERROR << "No points in path_data_.discretized_path().";
     return false;
   }
@@ -346,44 +468,22 @@ bool StBoundaryMapper::GetOverlapBoundaryPoints(
             << "] has NO prediction trajectory."
             << obstacle.Perception().ShortDebugString();
     }
-    for (const auto& curr_point_on_path : path_points) {
-      if (curr_point_on_path.s() > planning_distance_) {
-        break;
-      }
-      const Box2d obs_box = obstacle.PerceptionBoundingBox();
-
-      if (CheckOverlap(curr_point_on_path, obs_box,
-                       st_boundary_config_.boundary_buffer())) {
-        const double backward_distance = -vehicle_param_.front_edge_to_center();
-        const double forward_distance = vehicle_param_.length() +
-                                        vehicle_param_.width() +
-                                        obs_box.length() + obs_box.width();
-        double low_s =
-            std::fmax(0.0, curr_point_on_path.s() + backward_distance);
-        double high_s = std::fmin(planning_distance_,
-                                  curr_point_on_path.s() + forward_distance);
-        lower_points->emplace_back(low_s, 0.0);
-        lower_points->emplace_back(low_s, planning_time_);
-        upper_points->emplace_back(high_s, 0.0);
-        upper_points->emplace_back(high_s, planning_time_);
-        break;
-      }
+    const Box2d obs_box = obstacle.PerceptionBoundingBox();
+    const int index = path_point_sweep_.FindFirstOverlap(obs_box);
+    if (index >= 0) {
+      const double curr_s = path_point_sweep_.path_s[index];
+      const double backward_distance = -vehicle_param_.front_edge_to_center();
+      const double forward_distance = vehicle_param_.length() +
+                                      vehicle_param_.width() +
+                                      obs_box.length() + obs_box.width();
+      double low_s = std::fmax(0.0, curr_s + backward_distance);
+      double high_s = std::fmin(planning_distance_, curr_s + forward_distance);
+      lower_points->emplace_back(low_s, 0.0);
+      lower_points->emplace_back(low_s, planning_time_);
+      upper_points->emplace_back(high_s, 0.0);
+      upper_points->emplace_back(high_s, planning_time_);
     }
   } else {
-    const int default_num_point = 50;
-    DiscretizedPath discretized_path;
-    if (path_points.size() > 2 * default_num_point) {
-      const int ratio = path_points.size() / default_num_point;
-      std::vector<PathPoint> sampled_path_points;
-      for (size_t i = 0; i < path_points.size(); ++i) {
-        if (i % ratio == 0) {
-          sampled_path_points.push_back(path_points[i]);
-        }
-      }
-      discretized_path.set_path_points(sampled_path_points);
-    } else {
-      discretized_path.set_path_points(path_points);
-    }
     for (int i = 0; i < trajectory.trajectory_point_size(); ++i) {
       const auto& trajectory_point = trajectory.trajectory_point(i);
       const Box2d obs_box = obstacle.GetBoundingBox(trajectory_point);
@@ -394,64 +494,60 @@ bool StBoundaryMapper::GetOverlapBoundaryPoints(
         continue;
       }
 
+      const int index = sampled_path_sweep_.FindFirstOverlap(obs_box);
+      if (index < 0) {
+        continue;
+      }
+      // found overlap, start searching with higher resolution
+      const double path_s = sampled_path_sweep_.path_s[index];
       const double step_length = vehicle_param_.front_edge_to_center();
-      for (double path_s = 0.0; path_s < discretized_path.Length();
-           path_s += step_length) {
-        const auto curr_adc_path_point = discretized_path.Evaluate(
-            path_s + discretized_path.StartPoint().s());
-        if (CheckOverlap(curr_adc_path_point, obs_box,
-                         st_boundary_config_.boundary_buffer())) {
-          // found overlap, start searching with higher resolution
-          const double backward_distance = -step_length;
-          const double forward_distance = vehicle_param_.length() +
-                                          vehicle_param_.width() +
-                                          obs_box.length() + obs_box.width();
-          const double default_min_step = 0.1;  // in meters
-          const double fine_tuning_step_length = std::fmin(
-              default_min_step, discretized_path.Length() / default_num_point);
-
-          bool find_low = false;
-          bool find_high = false;
-          double low_s = std::fmax(0.0, path_s + backward_distance);
-          double high_s =
-              std::fmin(discretized_path.Length(), path_s + forward_distance);
-
-          while (low_s < high_s) {
-            if (find_low && find_high) {
-              break;
-            }
-            if (!find_low) {
-              const auto& point_low = discretized_path.Evaluate(
-                  low_s + discretized_path.StartPoint().s());
-              if (!CheckOverlap(point_low, obs_box,
-                                st_boundary_config_.boundary_buffer())) {
-                low_s += fine_tuning_step_length;
-              } else {
-                find_low = true;
-              }
-            }
-            if (!find_high) {
-              const auto& point_high = discretized_path.Evaluate(
-                  high_s + discretized_path.StartPoint().s());
-              if (!CheckOverlap(point_high, obs_box,
-                                st_boundary_config_.boundary_buffer())) {
-                high_s -= fine_tuning_step_length;
-              } else {
-                find_high = true;
-              }
-            }
+      const double backward_distance = -step_length;
+      const double forward_distance = vehicle_param_.length() +
+                                      vehicle_param_.width() +
+                                      obs_box.length() + obs_box.width();
+      const double default_min_step = 0.1;  // in meters
+      const double fine_tuning_step_length = std::fmin(
+          default_min_step, sampled_path_.Length() / default_num_point);
+
+      bool find_low = false;
+      bool find_high = false;
+      double low_s = std::fmax(0.0, path_s + backward_distance);
+      double high_s =
+          std::fmin(sampled_path_.Length(), path_s + forward_distance);
+
+      while (low_s < high_s) {
+        if (find_low && find_high) {
+          break;
+        }
+        if (!find_low) {
+          const auto& point_low =
+              sampled_path_.Evaluate(low_s + sampled_path_.StartPoint().s());
+          if (!CheckOverlap(point_low, obs_box,
+                            st_boundary_config_.boundary_buffer())) {
+            low_s += fine_tuning_step_length;
+          } else {
+            find_low = true;
           }
-          if (find_high && find_low) {
-            lower_points->emplace_back(
-                low_s - st_boundary_config_.point_extension(),
-                trajectory_point_time);
-            upper_points->emplace_back(
-                high_s + st_boundary_config_.point_extension(),
-                trajectory_point_time);
+        }
+        if (!find_high) {
+          const auto& point_high =
+              sampled_path_.Evaluate(high_s + sampled_path_.StartPoint().s());
+          if (!CheckOverlap(point_high, obs_box,
+                            st_boundary_config_.boundary_buffer())) {
+            high_s -= fine_tuning_step_length;
+          } else {
+            find_high = true;
           }
-          break;
         }
       }
+      if (find_high && find_low) {
+        lower_points->emplace_back(
+            low_s - st_boundary_config_.point_extension(),
+            trajectory_point_time);
+        upper_points->emplace_back(
+            high_s + st_boundary_config_.point_extension(),
+            trajectory_point_time);
+      }
     }
   }
   DCHECK_EQ(lower_points->size(), upper_points->size());
@@ -468,8 +564,7 @@ Status StBoundaryMapper::MapWithDecision(
   std::vector<STPoint> lower_points;
   std::vector<STPoint> upper_points;
 
-  if (!GetOverlapBoundaryPoints(path_data_.discretized_path().path_points(),
-                                *(path_obstacle->obstacle()), &upper_points,
+  if (!GetOverlapBoundaryPoints(*(path_obstacle->obstacle()), &upper_points,
                                 &lower_points)) {
     return Status::OK();
   }
@@ -520,6 +615,11 @@ Status StBoundaryMapper::MapWithDecision(
 bool StBoundaryMapper::CheckOverlap(const PathPoint& path_point,
                                     const Box2d& obs_box,
                                     const double buffer) const {
+  return obs_box.HasOverlap(GetAdcBox(path_point, buffer));
+}
+
+Box2d StBoundaryMapper::GetAdcBox(const PathPoint& path_point,
+                                  const double buffer) const {
   double left_delta_l = 0.0;
   double right_delta_l = 0.0;
   if (is_change_lane_) {
@@ -541,10 +641,9 @@ bool StBoundaryMapper::CheckOverlap(const PathPoint& path_point,
           .rotate(path_point.theta());
   Vec2d center = Vec2d(path_point.x(), path_point.y()) + vec_to_center;
 
-  const Box2d adc_box =
-      Box2d(center, path_point.theta(), vehicle_param_.length() + 2 * buffer,
-            vehicle_param_.width() + 2 * buffer);
-  return obs_box.HasOverlap(adc_box);
+  return Box2d(center, path_point.theta(),
+               vehicle_param_.length() + 2 * buffer,
+               vehicle_param_.width() + 2 * buffer);
 }
 
 }  // namespace planning
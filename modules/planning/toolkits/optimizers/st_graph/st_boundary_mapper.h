@@ -22,12 +22,15 @@
 #define MODULES_PLANNING_TOOLKITS_OPTIMIZERS_ST_GRAPH_ST_BOUNDARY_MAPPER_H_
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "modules/common/configs/proto/vehicle_config.pb.h"
 #include "modules/planning/proto/st_boundary_config.pb.h"
 
+#include "modules/common/math/box2d.h"
 #include "modules/common/status/status.h"
+#include "modules/planning/common/path/discretized_path.h"
 #include "modules/planning/common/path/path_data.h"
 #include "modules/planning/common/path_decision.h"
 #include "modules/planning/common/speed/st_boundary.h"
@@ -58,20 +61,61 @@ class StBoundaryMapper {
       const ObjectDecisionType& external_decision) const;
 
  private:
+  friend class StBoundaryMapperTest;
   FRIEND_TEST(StBoundaryMapperTest, check_overlap_test);
   bool CheckOverlap(const apollo::common::PathPoint& path_point,
                     const apollo::common::math::Box2d& obs_box,
                     const double buffer) const;
 
+  apollo::common::math::Box2d GetAdcBox(
+      const apollo::common::PathPoint& path_point, const double buffer) const;
+
+  /**
+   * @brief ADC boxes swept along the path, in increasing path_s order. Every
+   * kChunkSize consecutive boxes are bounded by an axis aligned box, so that
+   * an obstacle far away from a part of the path skips it at once.
+   */
+  struct PathSweep {
+    static constexpr std::size_t kChunkSize = 8;
+    struct ChunkBound {
+      double min_x = 0.0;
+      double max_x = 0.0;
+      double min_y = 0.0;
+      double max_y = 0.0;
+    };
+    std::vector<double> path_s;
+    std::vector<apollo::common::math::Box2d> adc_boxes;
+    std::vector<ChunkBound> chunk_bounds;
+
+    void Add(const double s, const apollo::common::math::Box2d& adc_box);
+    /**
+     * @return the index of the first box overlapping with obs_box, or -1.
+     */
+    int FindFirstOverlap(const apollo::common::math::Box2d& obs_box) const;
+  };
+
+  /**
+   * Precomputes the sweeps of the path, shared by all obstacles.
+   */
+  void BuildPathSweeps();
+
   /**
    * Creates valid st boundary upper_points and lower_points
    * If return true, upper_points.size() > 1 and
    * upper_points.size() = lower_points.size()
    */
-  bool GetOverlapBoundaryPoints(
-      const std::vector<apollo::common::PathPoint>& path_points,
-      const Obstacle& obstacle, std::vector<STPoint>* upper_points,
-      std::vector<STPoint>* lower_points) const;
+  bool GetOverlapBoundaryPoints(const Obstacle& obstacle,
+                                std::vector<STPoint>* upper_points,
+                                std::vector<STPoint>* lower_points) const;
+
+  /**
+   * Maps obstacles without a stop decision, in parallel when
+   * FLAGS_enable_multi_thread_in_st_boundary_mapper is set. The decision is
+   * nullptr for obstacles without longitudinal decision.
+   */
+  apollo::common::Status MapObstacles(
+      const std::vector<std::pair<PathObstacle*, const ObjectDecisionType*>>&
+          obstacles) const;
 
   apollo::common::Status MapWithoutDecision(PathObstacle* path_obstacle) const;
 
@@ -90,6 +134,12 @@ class StBoundaryMapper {
   const double planning_distance_;
   const double planning_time_;
   bool is_change_lane_ = false;
+
+  // The path down-sampled for predicted obstacles, and the ADC sweeps on it
+  // with step front_edge_to_center and on the raw path points.
+  DiscretizedPath sampled_path_;
+  PathSweep sampled_path_sweep_;
+  PathSweep path_point_sweep_;
 };
 
 }  // namespace planning
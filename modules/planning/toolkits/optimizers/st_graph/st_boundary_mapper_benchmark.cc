@@ -0,0 +1,153 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Benchmark of StBoundaryMapper::CreateStBoundary with many predicted
+ * obstacles, single threaded and on the planning thread pool.
+ **/
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/util/thread_pool.h"
+#include "modules/planning/common/obstacle.h"
+#include "modules/planning/common/path_decision.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/toolkits/optimizers/st_graph/st_boundary_mapper.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+using apollo::common::FrenetFramePoint;
+using apollo::perception::PerceptionObstacle;
+
+constexpr double kPathLength = 150.0;
+constexpr double kPlanningTime = 8.0;
+constexpr double kPredictionResolution = 0.1;
+
+class StBoundaryMapperScenario {
+ public:
+  explicit StBoundaryMapperScenario(const int num_obstacles) {
+    std::vector<ReferencePoint> ref_points;
+    for (double s = 0.0; s <= kPathLength + 50.0; s += 0.5) {
+      const double heading = std::atan(0.1 * std::cos(s / 50.0));
+      ref_points.emplace_back(
+          hdmap::MapPathPoint({s, 5.0 * std::sin(s / 50.0)}, heading), 0.0,
+          0.0);
+    }
+    reference_line_.reset(new ReferenceLine(ref_points));
+    path_data_.SetReferenceLine(reference_line_.get());
+    std::vector<FrenetFramePoint> ff_points;
+    for (double s = 0.0; s <= kPathLength; s += 0.5) {
+      FrenetFramePoint ff_point;
+      ff_point.set_s(s);
+      ff_point.set_l(0.2 * std::sin(s / 20.0));
+      ff_points.push_back(ff_point);
+    }
+    path_data_.SetFrenetPath(FrenetFramePath(ff_points));
+
+    // Crossing, oncoming and following traffic spread along the path.
+    for (int i = 0; i < num_obstacles; ++i) {
+      const double start_x = kPathLength * (i + 0.5) / num_obstacles;
+      const double start_y = (i % 3 - 1) * 8.0;
+      const double heading =
+          (i % 3 == 1) ? M_PI * (i % 2) : -M_PI_2 * (i % 3 - 1);
+      const double speed = 3.0 + i % 7;
+      PerceptionObstacle perception;
+      perception.set_id(i);
+      perception.mutable_position()->set_x(start_x);
+      perception.mutable_position()->set_y(start_y);
+      perception.set_theta(heading);
+      perception.mutable_velocity()->set_x(speed * std::cos(heading));
+      perception.mutable_velocity()->set_y(speed * std::sin(heading));
+      perception.set_length(4.5);
+      perception.set_width(2.0);
+      perception.set_type(PerceptionObstacle::VEHICLE);
+
+      prediction::Trajectory trajectory;
+      for (double t = 0.0; t <= kPlanningTime; t += kPredictionResolution) {
+        auto* point = trajectory.add_trajectory_point();
+        point->mutable_path_point()->set_x(start_x +
+                                           speed * t * std::cos(heading));
+        point->mutable_path_point()->set_y(start_y +
+                                           speed * t * std::sin(heading));
+        point->mutable_path_point()->set_theta(heading);
+        point->set_v(speed);
+        point->set_relative_time(t);
+      }
+      obstacles_.emplace_back(
+          new Obstacle(std::to_string(i), perception, trajectory));
+      path_decision_.AddPathObstacle(PathObstacle(obstacles_.back().get()));
+    }
+  }
+
+  void Map() {
+    StBoundaryMapper mapper(adc_sl_boundary_, st_boundary_config_,
+                            *reference_line_, path_data_, kPathLength,
+                            kPlanningTime, false);
+    mapper.CreateStBoundary(&path_decision_);
+  }
+
+ private:
+  std::unique_ptr<ReferenceLine> reference_line_;
+  PathData path_data_;
+  SLBoundary adc_sl_boundary_;
+  StBoundaryConfig st_boundary_config_;
+  std::vector<std::unique_ptr<Obstacle>> obstacles_;
+  PathDecision path_decision_;
+};
+
+void BM_CreateStBoundary(benchmark::State& state) {  // NOLINT
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = false;
+  StBoundaryMapperScenario scenario(state.range(0));
+  while (state.KeepRunning()) {
+    scenario.Map();
+  }
+}
+BENCHMARK(BM_CreateStBoundary)->Arg(10)->Arg(50)->Arg(100)->Arg(200);
+
+void BM_CreateStBoundaryMultiThread(benchmark::State& state) {  // NOLINT
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = true;
+  StBoundaryMapperScenario scenario(state.range(0));
+  while (state.KeepRunning()) {
+    scenario.Map();
+  }
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = false;
+}
+BENCHMARK(BM_CreateStBoundaryMultiThread)
+    ->Arg(10)
+    ->Arg(50)
+    ->Arg(100)
+    ->Arg(200);
+
+}  // namespace
+}  // namespace planning
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  apollo::common::util::ThreadPool::Init(
+      FLAGS_max_planning_thread_pool_size);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  apollo::common::util::ThreadPool::Stop();
+  return 0;
+}
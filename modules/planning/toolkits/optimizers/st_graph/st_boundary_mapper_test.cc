@@ -18,13 +18,18 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 #include "modules/common/log.h"
+#include "modules/common/util/thread_pool.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/path_obstacle.h"
+#include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/reference_line/qp_spline_reference_line_smoother.h"
 #include "modules/planning/toolkits/optimizers/st_graph/speed_limit_decider.h"
 
@@ -69,6 +74,178 @@ class StBoundaryMapperTest : public ::testing::Test {
     path_data_.SetFrenetPath(frenet_frame_path_);
   }
 
+  // Static obstacles on the path and vehicles crossing it, spread along it.
+  void AddObstacles(const int num_obstacles, PathDecision* path_decision) {
+    const auto& path_points = path_data_.discretized_path().path_points();
+    for (int i = 0; i < num_obstacles; ++i) {
+      const auto& path_point =
+          path_points[(5 + 13 * i) % (path_points.size() - 5)];
+      const std::string id = std::to_string(obstacles_.size());
+      perception::PerceptionObstacle perception;
+      perception.set_id(static_cast<int>(obstacles_.size()));
+      perception.set_length(4.0);
+      perception.set_width(2.0);
+      if (i % 3 == 0) {
+        perception.mutable_position()->set_x(path_point.x());
+        perception.mutable_position()->set_y(path_point.y());
+        perception.set_theta(path_point.theta());
+        perception.set_type(perception::PerceptionObstacle::UNKNOWN_UNMOVABLE);
+        obstacles_.emplace_back(new Obstacle(id, perception));
+      } else {
+        // Starts beside the path and drives across it.
+        const double heading =
+            path_point.theta() + (i % 2 == 0 ? M_PI_2 : -M_PI_2);
+        const double speed = 2.0 + i % 4;
+        const double start_x = path_point.x() - 10.0 * std::cos(heading);
+        const double start_y = path_point.y() - 10.0 * std::sin(heading);
+        perception.mutable_position()->set_x(start_x);
+        perception.mutable_position()->set_y(start_y);
+        perception.set_theta(heading);
+        perception.mutable_velocity()->set_x(speed * std::cos(heading));
+        perception.mutable_velocity()->set_y(speed * std::sin(heading));
+        perception.set_type(perception::PerceptionObstacle::VEHICLE);
+        prediction::Trajectory trajectory;
+        for (int k = 0; k <= 80; ++k) {
+          const double t = 0.1 * k;
+          auto* point = trajectory.add_trajectory_point();
+          point->mutable_path_point()->set_x(start_x +
+                                             speed * t * std::cos(heading));
+          point->mutable_path_point()->set_y(start_y +
+                                             speed * t * std::sin(heading));
+          point->mutable_path_point()->set_theta(heading);
+          point->set_v(speed);
+          point->set_relative_time(t);
+        }
+        obstacles_.emplace_back(new Obstacle(id, perception, trajectory));
+      }
+      path_decision->AddPathObstacle(PathObstacle(obstacles_.back().get()));
+    }
+  }
+
+  bool GetOverlapBoundaryPoints(const StBoundaryMapper& mapper,
+                                const Obstacle& obstacle,
+                                std::vector<STPoint>* upper_points,
+                                std::vector<STPoint>* lower_points) {
+    return mapper.GetOverlapBoundaryPoints(obstacle, upper_points,
+                                           lower_points);
+  }
+
+  // The search before the path sweeps, which checked the ADC boxes along the
+  // path one after another for each obstacle box.
+  bool GetOverlapBoundaryPointsStepByStep(const StBoundaryMapper& mapper,
+                                          const Obstacle& obstacle,
+                                          std::vector<STPoint>* upper_points,
+                                          std::vector<STPoint>* lower_points) {
+    const auto& path_points = path_data_.discretized_path().path_points();
+    const auto& vehicle_param = mapper.vehicle_param_;
+    const double buffer = mapper.st_boundary_config_.boundary_buffer();
+    const auto& trajectory = obstacle.Trajectory();
+    if (trajectory.trajectory_point_size() == 0) {
+      const common::math::Box2d obs_box = obstacle.PerceptionBoundingBox();
+      for (const auto& curr_point_on_path : path_points) {
+        if (curr_point_on_path.s() > mapper.planning_distance_) {
+          break;
+        }
+        if (mapper.CheckOverlap(curr_point_on_path, obs_box, buffer)) {
+          const double backward_distance =
+              -vehicle_param.front_edge_to_center();
+          const double forward_distance = vehicle_param.length() +
+                                          vehicle_param.width() +
+                                          obs_box.length() + obs_box.width();
+          double low_s =
+              std::fmax(0.0, curr_point_on_path.s() + backward_distance);
+          double high_s = std::fmin(mapper.planning_distance_,
+                                    curr_point_on_path.s() + forward_distance);
+          lower_points->emplace_back(low_s, 0.0);
+          lower_points->emplace_back(low_s, mapper.planning_time_);
+          upper_points->emplace_back(high_s, 0.0);
+          upper_points->emplace_back(high_s, mapper.planning_time_);
+          break;
+        }
+      }
+      return lower_points->size() > 1;
+    }
+
+    const int default_num_point = 50;
+    DiscretizedPath discretized_path;
+    if (path_points.size() > 2 * default_num_point) {
+      const int ratio = path_points.size() / default_num_point;
+      std::vector<common::PathPoint> sampled_path_points;
+      for (size_t i = 0; i < path_points.size(); ++i) {
+        if (i % ratio == 0) {
+          sampled_path_points.push_back(path_points[i]);
+        }
+      }
+      discretized_path.set_path_points(sampled_path_points);
+    } else {
+      discretized_path.set_path_points(path_points);
+    }
+    const double start_s = discretized_path.StartPoint().s();
+    for (const auto& trajectory_point : trajectory.trajectory_point()) {
+      const common::math::Box2d obs_box =
+          obstacle.GetBoundingBox(trajectory_point);
+      if (trajectory_point.relative_time() < -1.0) {
+        continue;
+      }
+      const double step_length = vehicle_param.front_edge_to_center();
+      for (double path_s = 0.0; path_s < discretized_path.Length();
+           path_s += step_length) {
+        if (!mapper.CheckOverlap(discretized_path.Evaluate(path_s + start_s),
+                                 obs_box, buffer)) {
+          continue;
+        }
+        const double forward_distance = vehicle_param.length() +
+                                        vehicle_param.width() +
+                                        obs_box.length() + obs_box.width();
+        const double fine_tuning_step_length =
+            std::fmin(0.1, discretized_path.Length() / default_num_point);
+        bool find_low = false;
+        bool find_high = false;
+        double low_s = std::fmax(0.0, path_s - step_length);
+        double high_s =
+            std::fmin(discretized_path.Length(), path_s + forward_distance);
+        while (low_s < high_s && !(find_low && find_high)) {
+          if (!find_low) {
+            if (!mapper.CheckOverlap(discretized_path.Evaluate(low_s + start_s),
+                                     obs_box, buffer)) {
+              low_s += fine_tuning_step_length;
+            } else {
+              find_low = true;
+            }
+          }
+          if (!find_high) {
+            if (!mapper.CheckOverlap(
+                    discretized_path.Evaluate(high_s + start_s), obs_box,
+                    buffer)) {
+              high_s -= fine_tuning_step_length;
+            } else {
+              find_high = true;
+            }
+          }
+        }
+        if (find_high && find_low) {
+          const double point_extension =
+              mapper.st_boundary_config_.point_extension();
+          lower_points->emplace_back(low_s - point_extension,
+                                     trajectory_point.relative_time());
+          upper_points->emplace_back(high_s + point_extension,
+                                     trajectory_point.relative_time());
+        }
+        break;
+      }
+    }
+    return lower_points->size() > 1;
+  }
+
+  void ExpectSamePoints(const std::vector<STPoint>& expected,
+                        const std::vector<STPoint>& points) {
+    ASSERT_EQ(expected.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      EXPECT_DOUBLE_EQ(expected[i].s(), points[i].s());
+      EXPECT_DOUBLE_EQ(expected[i].t(), points[i].t());
+    }
+  }
+
  protected:
   const std::string map_file =
       "modules/planning/testdata/garage_map/base_map.txt";
@@ -78,6 +255,7 @@ class StBoundaryMapperTest : public ::testing::Test {
   hdmap::LaneInfoConstPtr lane_info_ptr = nullptr;
   PathData path_data_;
   FrenetFramePath frenet_frame_path_;
+  std::vector<std::unique_ptr<Obstacle>> obstacles_;
 };
 
 TEST_F(StBoundaryMapperTest, check_overlap_test) {
@@ -94,5 +272,131 @@ TEST_F(StBoundaryMapperTest, check_overlap_test) {
   EXPECT_TRUE(mapper.CheckOverlap(path_point, box, 0.0));
 }
 
+TEST_F(StBoundaryMapperTest, static_obstacle_on_path) {
+  StBoundaryConfig config;
+  double planning_distance = 70.0;
+  double planning_time = 10.0;
+  SLBoundary adc_sl_boundary;
+
+  const auto& path_point = path_data_.discretized_path().path_points()[20];
+  perception::PerceptionObstacle perception;
+  perception.set_id(1);
+  perception.mutable_position()->set_x(path_point.x());
+  perception.mutable_position()->set_y(path_point.y());
+  perception.set_theta(path_point.theta());
+  perception.set_length(4.0);
+  perception.set_width(2.0);
+  perception.set_type(perception::PerceptionObstacle::UNKNOWN_UNMOVABLE);
+  Obstacle obstacle("1", perception);
+  PathDecision path_decision;
+  path_decision.AddPathObstacle(PathObstacle(&obstacle));
+
+  StBoundaryMapper mapper(adc_sl_boundary, config, *reference_line_, path_data_,
+                          planning_distance, planning_time, false);
+  EXPECT_TRUE(mapper.CreateStBoundary(&path_decision).ok());
+  const auto& st_boundary = path_decision.Find("1")->st_boundary();
+  EXPECT_FALSE(st_boundary.IsEmpty());
+  EXPECT_LT(st_boundary.min_s(), path_point.s());
+  EXPECT_GT(st_boundary.max_s(), path_point.s());
+}
+
+TEST_F(StBoundaryMapperTest, obstacle_with_prediction_trajectory) {
+  StBoundaryConfig config;
+  double planning_distance = 70.0;
+  double planning_time = 10.0;
+  SLBoundary adc_sl_boundary;
+
+  PathDecision path_decision;
+  AddObstacles(2, &path_decision);
+  const Obstacle& obstacle = *obstacles_[1];
+  ASSERT_GT(obstacle.Trajectory().trajectory_point_size(), 0);
+
+  StBoundaryMapper mapper(adc_sl_boundary, config, *reference_line_, path_data_,
+                          planning_distance, planning_time, false);
+  std::vector<STPoint> upper_points;
+  std::vector<STPoint> lower_points;
+  EXPECT_TRUE(GetOverlapBoundaryPoints(mapper, obstacle, &upper_points,
+                                       &lower_points));
+  std::vector<STPoint> expected_upper_points;
+  std::vector<STPoint> expected_lower_points;
+  EXPECT_TRUE(GetOverlapBoundaryPointsStepByStep(
+      mapper, obstacle, &expected_upper_points, &expected_lower_points));
+  ExpectSamePoints(expected_upper_points, upper_points);
+  ExpectSamePoints(expected_lower_points, lower_points);
+
+  EXPECT_TRUE(mapper.CreateStBoundary(&path_decision).ok());
+  const auto& st_boundary = path_decision.Find(obstacle.Id())->st_boundary();
+  EXPECT_FALSE(st_boundary.IsEmpty());
+  EXPECT_GT(st_boundary.min_t(), 0.0);
+  EXPECT_LT(st_boundary.max_t(), planning_time);
+}
+
+TEST_F(StBoundaryMapperTest, same_overlap_points_as_step_by_step) {
+  StBoundaryConfig config;
+  double planning_distance = 70.0;
+  double planning_time = 10.0;
+  SLBoundary adc_sl_boundary;
+
+  PathDecision path_decision;
+  AddObstacles(12, &path_decision);
+  StBoundaryMapper mapper(adc_sl_boundary, config, *reference_line_, path_data_,
+                          planning_distance, planning_time, false);
+  int num_overlapping = 0;
+  for (const auto& obstacle : obstacles_) {
+    std::vector<STPoint> upper_points;
+    std::vector<STPoint> lower_points;
+    const bool overlap = GetOverlapBoundaryPoints(mapper, *obstacle,
+                                                  &upper_points, &lower_points);
+    std::vector<STPoint> expected_upper_points;
+    std::vector<STPoint> expected_lower_points;
+    EXPECT_EQ(GetOverlapBoundaryPointsStepByStep(mapper, *obstacle,
+                                                 &expected_upper_points,
+                                                 &expected_lower_points),
+              overlap);
+    ExpectSamePoints(expected_upper_points, upper_points);
+    ExpectSamePoints(expected_lower_points, lower_points);
+    if (overlap) {
+      ++num_overlapping;
+    }
+  }
+  EXPECT_GT(num_overlapping, 1);
+}
+
+TEST_F(StBoundaryMapperTest, multi_thread_same_as_single_thread) {
+  StBoundaryConfig config;
+  double planning_distance = 70.0;
+  double planning_time = 10.0;
+  SLBoundary adc_sl_boundary;
+
+  PathDecision path_decision;
+  AddObstacles(12, &path_decision);
+  PathDecision expected_path_decision;
+  for (const auto& obstacle : obstacles_) {
+    expected_path_decision.AddPathObstacle(PathObstacle(obstacle.get()));
+  }
+  StBoundaryMapper mapper(adc_sl_boundary, config, *reference_line_, path_data_,
+                          planning_distance, planning_time, false);
+
+  const bool enable_multi_thread =
+      FLAGS_enable_multi_thread_in_st_boundary_mapper;
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = false;
+  EXPECT_TRUE(mapper.CreateStBoundary(&expected_path_decision).ok());
+  common::util::ThreadPool::Init(3);
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = true;
+  EXPECT_TRUE(mapper.CreateStBoundary(&path_decision).ok());
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = enable_multi_thread;
+  common::util::ThreadPool::Stop();
+
+  for (const auto& obstacle : obstacles_) {
+    const auto& expected =
+        expected_path_decision.Find(obstacle->Id())->st_boundary();
+    const auto& st_boundary = path_decision.Find(obstacle->Id())->st_boundary();
+    EXPECT_EQ(expected.IsEmpty(), st_boundary.IsEmpty());
+    EXPECT_EQ(expected.boundary_type(), st_boundary.boundary_type());
+    ExpectSamePoints(expected.upper_points(), st_boundary.upper_points());
+    ExpectSamePoints(expected.lower_points(), st_boundary.lower_points());
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
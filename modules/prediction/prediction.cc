@@ -30,6 +30,7 @@
 #include "modules/common/math/vec2d.h"
 #include "modules/common/time/time.h"
 #include "modules/common/util/file.h"
+#include "modules/common/util/lineage.h"
 #include "modules/prediction/common/feature_output.h"
 #include "modules/prediction/common/prediction_gflags.h"
 #include "modules/prediction/common/prediction_map.h"
@@ -277,6 +278,8 @@ void Prediction::RunOnce(const PerceptionObstacles& perception_obstacles) {
       perception_obstacles.header().camera_timestamp());
   prediction_obstacles.mutable_header()->set_radar_timestamp(
       perception_obstacles.header().radar_timestamp());
+  common::util::AppendLineage(perception_obstacles.header(),
+                              prediction_obstacles.mutable_header());
 
   if (FLAGS_prediction_test_mode) {
     for (auto const& prediction_obstacle :